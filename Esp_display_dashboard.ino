@@ -1,6 +1,15 @@
+#include "debug_config.h"
 #include "debug_display.h"
 #include "ui.h"
 #include "touch_integration.h"
+#include "n2k_decode.h"
+#include "bus_task.h"
+#include "log_writer.h"
+#include "can_capture.h"
+#include "can_replay.h"
+#include "n2k_subs.h"
+#include "c6_link.h"
+#include "chart_query.h"
 
 static uint32_t s_last_ms = 0;
 
@@ -19,6 +28,41 @@ void setup() {
   // Build UI
   ui_init();        // creates the pages/labels
   ui_build_page1(); // draw first page
+
+#if N2K_DECODE_BENCH
+  n2k_decode_benchmark(20000);
+#endif
+#if SD_LOGGING_ENABLE
+  if (!log_writer_start()) {
+    Serial.println("[log] WARN: SD logging disabled (no card)");
+  }
+#endif
+#if C6_LINK_ENABLE
+  if (!c6_link_start(nullptr)) {
+    Serial.println("[c6] WARN: coprocessor link not started");
+  }
+#elif BUS_INGEST_ENABLE
+#ifdef CAN_REPLAY_PATH
+  can_rx_config_t rx;
+  can_rx_default_config(&rx);
+  rx.no_backend = true;
+  const can_replay_config_t replay = {CAN_REPLAY_PATH, CAN_REPLAY_SPEED, 1};
+  if (!bus_task_start(&rx) || !can_replay_start(&replay)) {
+    Serial.println("[replay] WARN: replay not started");
+  }
+#else
+  if (!bus_task_start()) {
+    Serial.println("[bus] WARN: CAN ingest not started");
+  }
+#if CAN_CAPTURE_ENABLE
+  n2k_subs_set_all(N2K_SUB_DIAG, true);   // capture the raw bus, not just subscribed PGNs
+  can_capture_start(CAN_CAPTURE_PATH, CAN_CAPTURE_FORMAT);
+#endif
+#endif
+#endif
+  if (!chart_query_start()) {
+    Serial.println("[chart] WARN: chart queries disabled");
+  }
 }
 
 void loop() {
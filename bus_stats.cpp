@@ -0,0 +1,201 @@
+#include "bus_stats.h"
+#include "n2k_decode.h"
+#include "n2k_id.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string.h>
+
+static_assert((BUS_STATS_PGN_SLOTS & (BUS_STATS_PGN_SLOTS - 1)) == 0, "BUS_STATS_PGN_SLOTS must be a power of two");
+
+// Written by the RX producer only. Counters are totals since boot; rates
+// come from differences, so they never need resetting.
+static std::atomic<uint32_t> s_frames{0};
+static std::atomic<uint32_t> s_std_frames{0};
+static std::atomic<uint32_t> s_bits{0};
+static std::atomic<uint32_t> s_untracked{0};
+static std::atomic<uint32_t> s_src_frames[256];
+static std::atomic<uint32_t> s_pgn_key[BUS_STATS_PGN_SLOTS];   // pgn + 1, 0 = free
+static std::atomic<uint32_t> s_pgn_frames[BUS_STATS_PGN_SLOTS];
+
+// Written by the bus task (bus_stats_tick).
+static std::atomic<uint32_t> s_src_rate[256];                   // frames/s x 100
+static std::atomic<uint32_t> s_pgn_rate[BUS_STATS_PGN_SLOTS];
+static std::atomic<uint32_t> s_rate_x100{0};
+static std::atomic<uint32_t> s_load_x100{0};
+static std::atomic<uint32_t> s_load_peak_x100{0};
+static std::atomic<uint32_t> s_window_ms{0};
+static std::atomic<uint32_t> s_fp[7];
+static std::atomic<uint32_t> s_unknown_pgn{0};
+
+static std::atomic<uint32_t> s_bitrate{250000};
+static std::atomic<uint32_t> s_start_ms{0};
+static std::atomic<bool>     s_started{false};
+
+// Bus task only.
+static uint32_t s_prev_src[256];
+static uint32_t s_prev_pgn[BUS_STATS_PGN_SLOTS];
+static uint32_t s_prev_frames = 0;
+static uint32_t s_prev_bits = 0;
+static uint32_t s_window_start = 0;
+static uint32_t s_last_print = 0;
+
+static inline void bump(std::atomic<uint32_t>& c, uint32_t n = 1) {
+  c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+void bus_stats_begin(uint32_t bitrate, uint32_t now_ms) {
+  s_bitrate.store(bitrate ? bitrate : 250000, std::memory_order_relaxed);
+  if (!s_started.exchange(true)) s_start_ms.store(now_ms, std::memory_order_relaxed);
+}
+
+void bus_stats_feed(const can_frame_t* frame) {
+  bump(s_frames);
+  const uint32_t dlc = frame->dlc > 8 ? 8 : frame->dlc;
+  const bool ext = frame->flags & CAN_FRAME_EXT;
+  // Nominal length incl. ACK, EOF and intermission; RTR frames carry no data.
+  bump(s_bits, (ext ? 67 : 47) + ((frame->flags & CAN_FRAME_RTR) ? 0 : 8 * dlc));
+  if (!ext || (frame->flags & CAN_FRAME_RTR)) {
+    bump(s_std_frames);
+    return;
+  }
+  bump(s_src_frames[frame->id & 0xFF]);
+
+  const uint32_t key = n2k_parse_id(frame->id).pgn + 1;
+  uint32_t h = (key * 2654435761u) >> (32 - __builtin_ctz(BUS_STATS_PGN_SLOTS));
+  for (uint32_t probe = 0; probe < BUS_STATS_PGN_PROBES; ++probe, h = (h + 1) & (BUS_STATS_PGN_SLOTS - 1)) {
+    const uint32_t k = s_pgn_key[h].load(std::memory_order_relaxed);
+    if (k == key) {
+      bump(s_pgn_frames[h]);
+      return;
+    }
+    if (k == 0) {
+      bump(s_pgn_frames[h]);
+      s_pgn_key[h].store(key, std::memory_order_release);
+      return;
+    }
+  }
+  bump(s_untracked);
+}
+
+static uint32_t rate_x100(uint32_t count, uint32_t window_ms) {
+  return (uint32_t)((uint64_t)count * 100000 / window_ms);
+}
+
+void bus_stats_tick(uint32_t now_ms, const n2k_fp_t* fp) {
+  if (!s_window_start) {
+    s_window_start = now_ms ? now_ms : 1;
+    s_last_print = now_ms;
+    return;
+  }
+  const uint32_t window = now_ms - s_window_start;
+  if (window < BUS_STATS_WINDOW_MS) return;
+  s_window_start = now_ms;
+
+  const uint32_t frames = s_frames.load(std::memory_order_relaxed);
+  const uint32_t bits = s_bits.load(std::memory_order_relaxed);
+  s_rate_x100.store(rate_x100(frames - s_prev_frames, window), std::memory_order_relaxed);
+  const uint32_t capacity = (uint32_t)((uint64_t)s_bitrate.load(std::memory_order_relaxed) * window / 1000);
+  const uint32_t load = capacity ? (uint32_t)((uint64_t)(bits - s_prev_bits) * 10000 / capacity) : 0;
+  s_load_x100.store(load, std::memory_order_relaxed);
+  if (load > s_load_peak_x100.load(std::memory_order_relaxed)) s_load_peak_x100.store(load, std::memory_order_relaxed);
+  s_prev_frames = frames;
+  s_prev_bits = bits;
+
+  for (int i = 0; i < 256; ++i) {
+    const uint32_t n = s_src_frames[i].load(std::memory_order_relaxed);
+    s_src_rate[i].store(rate_x100(n - s_prev_src[i], window), std::memory_order_relaxed);
+    s_prev_src[i] = n;
+  }
+  for (int i = 0; i < BUS_STATS_PGN_SLOTS; ++i) {
+    const uint32_t n = s_pgn_frames[i].load(std::memory_order_relaxed);
+    s_pgn_rate[i].store(rate_x100(n - s_prev_pgn[i], window), std::memory_order_relaxed);
+    s_prev_pgn[i] = n;
+  }
+  s_window_ms.store(window, std::memory_order_relaxed);
+
+  if (fp) {
+    n2k_fp_stats_t f;
+    n2k_fp_get_stats(fp, &f);
+    const uint32_t v[7] = {f.completed, f.out_of_order, f.duplicates, f.orphans,
+                           f.abandoned, f.pool_exhausted, f.bad_length};
+    for (int i = 0; i < 7; ++i) s_fp[i].store(v[i], std::memory_order_relaxed);
+  }
+  n2k_decode_stats_t d;
+  n2k_decode_get_stats(&d);
+  s_unknown_pgn.store(d.unknown_pgn, std::memory_order_relaxed);
+
+#if BUS_STATS_PRINT_MS
+  if (now_ms - s_last_print >= BUS_STATS_PRINT_MS) {
+    s_last_print = now_ms;
+    bus_stats_print(10);
+  }
+#endif
+}
+
+void bus_stats_snapshot(bus_stats_snapshot_t* out) {
+  out->uptime_ms = s_started.load() ? plat_millis() - s_start_ms.load(std::memory_order_relaxed) : 0;
+  out->window_ms = s_window_ms.load(std::memory_order_relaxed);
+  out->bitrate = s_bitrate.load(std::memory_order_relaxed);
+  out->frames = s_frames.load(std::memory_order_relaxed);
+  out->std_frames = s_std_frames.load(std::memory_order_relaxed);
+  out->frames_per_s = s_rate_x100.load(std::memory_order_relaxed) / 100.0f;
+  out->load_pct = s_load_x100.load(std::memory_order_relaxed) / 100.0f;
+  out->load_peak_pct = s_load_peak_x100.load(std::memory_order_relaxed) / 100.0f;
+
+  can_rx_stats_t rx;
+  can_rx_get_stats(&rx);
+  out->bus_errors = rx.bus_errors;
+  out->driver_overruns = rx.driver_overruns;
+  out->ring_overruns = rx.ring_overruns;
+  uint32_t* fp[7] = {&out->fp_completed, &out->fp_out_of_order, &out->fp_duplicates, &out->fp_orphans,
+                     &out->fp_abandoned, &out->fp_pool_exhausted, &out->fp_bad_length};
+  for (int i = 0; i < 7; ++i) *fp[i] = s_fp[i].load(std::memory_order_relaxed);
+  out->unknown_pgn = s_unknown_pgn.load(std::memory_order_relaxed);
+  out->pgn_untracked = s_untracked.load(std::memory_order_relaxed);
+
+  out->pgn_count = 0;
+  for (int i = 0; i < BUS_STATS_PGN_SLOTS; ++i) {
+    const uint32_t key = s_pgn_key[i].load(std::memory_order_acquire);
+    if (!key) continue;
+    out->pgns[out->pgn_count++] = {key - 1, s_pgn_frames[i].load(std::memory_order_relaxed),
+                                   s_pgn_rate[i].load(std::memory_order_relaxed) / 100.0f};
+  }
+  std::sort(out->pgns, out->pgns + out->pgn_count, [](const bus_stats_pgn_t& a, const bus_stats_pgn_t& b) {
+    return a.frames_per_s != b.frames_per_s ? a.frames_per_s > b.frames_per_s : a.frames > b.frames;
+  });
+
+  out->src_count = 0;
+  for (int i = 0; i < 256; ++i) {
+    const uint32_t n = s_src_frames[i].load(std::memory_order_relaxed);
+    if (!n) continue;
+    out->srcs[out->src_count++] = {(uint8_t)i, n, s_src_rate[i].load(std::memory_order_relaxed) / 100.0f};
+  }
+  std::sort(out->srcs, out->srcs + out->src_count, [](const bus_stats_src_t& a, const bus_stats_src_t& b) {
+    return a.frames_per_s != b.frames_per_s ? a.frames_per_s > b.frames_per_s : a.frames > b.frames;
+  });
+}
+
+void bus_stats_print(uint8_t top) {
+  static bus_stats_snapshot_t s;   // ~3.8 KB: keep it off the caller's stack
+  bus_stats_snapshot(&s);
+  DBG_LOGI("[bus] %u kbit/s load %.1f%% (peak %.1f%%) %.0f frames/s, %u frames (%u std/rtr) in %u s",
+           (unsigned)(s.bitrate / 1000), (double)s.load_pct, (double)s.load_peak_pct, (double)s.frames_per_s,
+           (unsigned)s.frames, (unsigned)s.std_frames, (unsigned)(s.uptime_ms / 1000));
+  DBG_LOGI("[bus] errors bus=%u driver_ovr=%u ring_ovr=%u | fast-packet ok=%u ooo=%u dup=%u orphan=%u "
+           "abandoned=%u no_slot=%u bad_len=%u | unknown_pgn=%u untracked=%u",
+           (unsigned)s.bus_errors, (unsigned)s.driver_overruns, (unsigned)s.ring_overruns,
+           (unsigned)s.fp_completed, (unsigned)s.fp_out_of_order, (unsigned)s.fp_duplicates,
+           (unsigned)s.fp_orphans, (unsigned)s.fp_abandoned, (unsigned)s.fp_pool_exhausted,
+           (unsigned)s.fp_bad_length, (unsigned)s.unknown_pgn, (unsigned)s.pgn_untracked);
+  for (uint16_t i = 0; i < s.pgn_count && i < top; ++i) {
+    DBG_LOGI("[bus]   pgn %6u %8.1f/s %10u%s", (unsigned)s.pgns[i].pgn, (double)s.pgns[i].frames_per_s,
+             (unsigned)s.pgns[i].frames, n2k_decode_handles(s.pgns[i].pgn) ? "" : "  (not decoded)");
+  }
+  for (uint16_t i = 0; i < s.src_count; ++i) {
+    DBG_LOGI("[bus]   src %3u %8.1f/s %10u", (unsigned)s.srcs[i].src, (double)s.srcs[i].frames_per_s,
+             (unsigned)s.srcs[i].frames);
+  }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "can_rx.h"
+#include "n2k_fast_packet.h"
+#include <stdint.h>
+
+// Bus health and load statistics: per-PGN and per-source frame rates, bus
+// utilization, error/overrun counters and fast-packet failures.
+//
+// can_rx_push() counts every frame the controller delivers (bus_stats_feed:
+// a few relaxed increments and a bounded hash probe, cheap enough for the
+// RX pump). Once per BUS_STATS_WINDOW_MS the bus task turns the counters
+// into rates (bus_stats_tick), and any task can take a consistent-enough
+// snapshot for a diagnostics page or the serial console.
+//
+// Load is estimated from nominal frame lengths without stuff bits (which
+// add up to ~20%), and only frames that pass the acceptance filter are
+// seen (n2k_subs.h); subscribe N2K_SUB_DIAG to everything for a full
+// picture.
+
+#ifndef BUS_STATS_PGN_SLOTS
+  #define BUS_STATS_PGN_SLOTS  64      // distinct PGNs tracked, power of two
+#endif
+#ifndef BUS_STATS_PGN_PROBES
+  #define BUS_STATS_PGN_PROBES 8       // hash probes per frame before counting it untracked
+#endif
+#ifndef BUS_STATS_WINDOW_MS
+  #define BUS_STATS_WINDOW_MS  1000
+#endif
+#ifndef BUS_STATS_PRINT_MS
+  #define BUS_STATS_PRINT_MS   0       // periodic console report from the bus task, 0 = off
+#endif
+
+struct bus_stats_pgn_t {
+  uint32_t pgn;
+  uint32_t frames;
+  float    frames_per_s;    // last window
+};
+
+struct bus_stats_src_t {
+  uint8_t  src;
+  uint32_t frames;
+  float    frames_per_s;
+};
+
+struct bus_stats_snapshot_t {
+  uint32_t uptime_ms;       // since bus_stats_begin()
+  uint32_t window_ms;       // length of the last rate window
+  uint32_t bitrate;
+  uint32_t frames;
+  uint32_t std_frames;      // 11-bit or RTR, not NMEA2000
+  float    frames_per_s;
+  float    load_pct;        // last window
+  float    load_peak_pct;   // highest window since start
+  // Errors and losses (can_rx.h, n2k_fast_packet.h, n2k_decode.h)
+  uint32_t bus_errors;
+  uint32_t driver_overruns;
+  uint32_t ring_overruns;
+  uint32_t fp_completed;
+  uint32_t fp_out_of_order;
+  uint32_t fp_duplicates;
+  uint32_t fp_orphans;
+  uint32_t fp_abandoned;
+  uint32_t fp_pool_exhausted;
+  uint32_t fp_bad_length;
+  uint32_t unknown_pgn;
+  uint32_t pgn_untracked;   // frames of PGNs that found no hash slot
+  // Sorted by rate, busiest first
+  uint16_t        pgn_count;
+  bus_stats_pgn_t pgns[BUS_STATS_PGN_SLOTS];
+  uint16_t        src_count;
+  bus_stats_src_t srcs[256];
+};
+
+// can_rx_begin(): bitrate for the load estimate. Counters run from boot.
+void bus_stats_begin(uint32_t bitrate, uint32_t now_ms);
+// RX producer, per frame.
+void bus_stats_feed(const can_frame_t* frame);
+// Bus task: closes a rate window when due; `fp` is the bus task's
+// reassembler, sampled here because only that task may read it.
+void bus_stats_tick(uint32_t now_ms, const n2k_fp_t* fp);
+
+void bus_stats_snapshot(bus_stats_snapshot_t* out);
+// Console report: totals, errors, the `top` busiest PGNs and all sources.
+void bus_stats_print(uint8_t top);
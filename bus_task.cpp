@@ -0,0 +1,73 @@
+#include "bus_task.h"
+#include "can_rx.h"
+#include "n2k_fast_packet.h"
+#include "n2k_decode.h"
+#include "n2k_subs.h"
+#include "signal_store.h"
+#include "signal_arb.h"
+#include "signal_stale.h"
+#include "bus_stats.h"
+#include "signal_history.h"
+#include "log_writer.h"
+#include "can_replay.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+static n2k_fp_t s_fp;
+static bool     s_started = false;
+
+void bus_publish(signal_id_t sig, float value, uint8_t quality, uint8_t src, uint32_t pgn, uint32_t now_ms) {
+  signal_store_publish(sig, value, quality, src, pgn, now_ms);
+  signal_stale_update(sig, now_ms);
+  signal_history_record(sig, value, now_ms);
+
+  const log_record_t rec = {now_ms, value, (uint8_t)sig, quality, src, 0};
+  log_writer_push(&rec);
+}
+
+static void on_signal(signal_id_t sig, float value, const n2k_msg_t* msg, void*) {
+  const uint32_t now_ms = plat_millis();
+  if (!signal_arb_accept(sig, msg->src, now_ms)) return;
+  bus_publish(sig, value, SIG_QUALITY_OK, msg->src, msg->pgn, now_ms);
+  can_replay_observe(sig, msg->t_us);
+}
+
+static void on_message(const n2k_msg_t* msg, void*) {
+  n2k_decode(msg, on_signal, nullptr);
+}
+
+static void bus_task(void*) {
+  for (;;) {
+    can_frame_t f;
+    bool any = false;
+    const uint32_t now_ms = plat_millis();
+    n2k_subs_poll(now_ms);
+    signal_stale_tick(now_ms);
+    bus_stats_tick(now_ms, &s_fp);
+    while (can_rx_pop(&f)) {
+      if (!n2k_subs_accepts(&f)) continue;
+      n2k_fp_feed(&s_fp, &f);
+      any = true;
+    }
+    if (!any) {
+      n2k_fp_expire(&s_fp, plat_micros());
+      plat_delay_ms(BUS_TASK_IDLE_MS);
+    }
+  }
+}
+
+bool bus_task_start(const can_rx_config_t* cfg) {
+  if (s_started) return true;
+  n2k_fp_init(&s_fp, on_message, nullptr);
+  signal_history_init();
+  signal_history_report();
+  if (log_writer_running()) n2k_subs_set_signals(N2K_SUB_LOGGER, (1u << SIG_COUNT) - 1);
+  if (!can_rx_begin(cfg)) return false;
+  if (!plat_task_start(bus_task, "bus", 6144, BUS_TASK_PRIO, BUS_TASK_CORE, nullptr)) {
+    DBG_LOGE("[bus] ingest task create failed");
+    can_rx_end();
+    return false;
+  }
+  s_started = true;
+  return true;
+}
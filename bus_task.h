@@ -0,0 +1,28 @@
+#pragma once
+
+#include "can_rx.h"
+#include "signals.h"
+#include <stdint.h>
+
+// Bus ingest task: CAN RX ring -> fast-packet reassembly -> PGN decode ->
+// signal_store + signal_history. Runs beside the CAN RX pump so decoding
+// never happens on the LVGL loop.
+
+#ifndef BUS_TASK_PRIO
+  #define BUS_TASK_PRIO     5     // above loop(), below the CAN RX pump
+#endif
+#ifndef BUS_TASK_CORE
+  #define BUS_TASK_CORE     0
+#endif
+#ifndef BUS_TASK_IDLE_MS
+  #define BUS_TASK_IDLE_MS  2     // sleep when the RX ring is empty
+#endif
+
+// Starts CAN RX (default config if null) and the ingest task.
+bool bus_task_start(const can_rx_config_t* cfg = nullptr);
+
+// One accepted value into the signal store, staleness engine, history and
+// SD logger. Called by the bus task, or by the C6 link receiver
+// (c6_link.h) when the coprocessor owns the bus; never both at once, the
+// modules behind it expect a single writer.
+void bus_publish(signal_id_t sig, float value, uint8_t quality, uint8_t src, uint32_t pgn, uint32_t now_ms);
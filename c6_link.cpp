@@ -0,0 +1,416 @@
+#include "c6_link.h"
+#include "c6_sync.h"
+#include "crc32.h"
+#include "bus_task.h"
+#include "signal_history.h"
+#include "signal_stale.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <atomic>
+#include <string.h>
+
+static_assert(C6_LINK_MAX_RAW < 0xFFFF, "message length must fit 16 bits");
+static_assert(C6_LINK_BATCH_MAX >= 1, "C6_LINK_MAX_BODY too small for a batch");
+
+uint32_t c6_link_signal_hash(void) {
+  uint32_t h = 2166136261u;
+  for (const signal_meta_t& m : k_signal_meta) {
+    const char* strs[2] = {m.key, m.unit};
+    for (const char* p : strs) {
+      for (; *p; ++p) h = (h ^ (uint8_t)*p) * 16777619u;
+      h = (h ^ 0xFFu) * 16777619u;   // separator
+    }
+  }
+  return h;
+}
+
+// ---- COBS ----
+
+static size_t cobs_encode(const uint8_t* in, size_t len, uint8_t* out) {
+  size_t code_at = 0, o = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < len; ++i) {
+    if (in[i]) {
+      out[o++] = in[i];
+      if (++code != 0xFF) continue;
+    }
+    out[code_at] = code;
+    code_at = o++;
+    code = 1;
+  }
+  out[code_at] = code;
+  return o;
+}
+
+// In place (the output never overtakes the input). SIZE_MAX if malformed.
+static size_t cobs_decode(uint8_t* buf, size_t len) {
+  size_t r = 0, w = 0;
+  while (r < len) {
+    const uint8_t code = buf[r++];
+    if (!code || r + code - 1 > len) return SIZE_MAX;
+    for (uint8_t i = 1; i < code; ++i) buf[w++] = buf[r++];
+    if (code != 0xFF && r < len) buf[w++] = 0;
+  }
+  return w;
+}
+
+// ---- Encoder ----
+
+void c6_link_tx_init(c6_link_tx_t* tx) {
+  memset(tx, 0, sizeof(*tx));
+}
+
+// Body already at tx->raw + header.
+static size_t encode_raw(c6_link_tx_t* tx, uint8_t type, size_t len) {
+  const c6_link_hdr_t hdr = {C6_LINK_SCHEMA_VERSION, type, tx->seq++, plat_micros()};
+  memcpy(tx->raw, &hdr, sizeof(hdr));
+  const uint32_t crc = crc32_update(0, tx->raw, sizeof(hdr) + len);
+  memcpy(tx->raw + sizeof(hdr) + len, &crc, sizeof(crc));
+  const size_t n = cobs_encode(tx->raw, sizeof(hdr) + len + sizeof(crc), tx->wire);
+  tx->wire[n] = 0;
+  return n + 1;
+}
+
+size_t c6_link_encode(c6_link_tx_t* tx, uint8_t type, const void* body, size_t len) {
+  if (len > C6_LINK_MAX_BODY) return 0;
+  if (len) memmove(tx->raw + sizeof(c6_link_hdr_t), body, len);
+  return encode_raw(tx, type, len);
+}
+
+size_t c6_link_encode_hello(c6_link_tx_t* tx) {
+  const c6_link_hello_t hello = {SIG_COUNT, C6_LINK_MAX_BODY, c6_link_signal_hash()};
+  return c6_link_encode(tx, C6_LINK_HELLO, &hello, sizeof(hello));
+}
+
+static c6_link_signal_t* batch_entries(c6_link_tx_t* tx) {
+  return (c6_link_signal_t*)(tx->raw + sizeof(c6_link_hdr_t) + sizeof(c6_link_batch_t));
+}
+
+bool c6_link_batch_add(c6_link_tx_t* tx, signal_id_t sig, float value, uint8_t quality, uint8_t src,
+                       uint32_t pgn, uint16_t age_ms) {
+  if (tx->batch_count >= C6_LINK_BATCH_MAX) return false;
+  batch_entries(tx)[tx->batch_count++] = {value, (pgn << 8) | sig, src, quality, age_ms};
+  return true;
+}
+
+size_t c6_link_encode_batch(c6_link_tx_t* tx) {
+  if (!tx->batch_count) return 0;
+  const c6_link_batch_t b = {tx->batch_count, tx->batch_dropped};
+  memcpy(tx->raw + sizeof(c6_link_hdr_t), &b, sizeof(b));
+  const size_t n = encode_raw(tx, C6_LINK_SIGNALS, sizeof(b) + tx->batch_count * sizeof(c6_link_signal_t));
+  tx->batch_count = tx->batch_dropped = 0;
+  return n;
+}
+
+// ---- Decoder ----
+
+void c6_link_rx_init(c6_link_rx_t* rx, c6_link_msg_cb_t cb, void* ctx) {
+  memset(rx, 0, sizeof(*rx));
+  rx->cb = cb;
+  rx->ctx = ctx;
+}
+
+static void rx_message(c6_link_rx_t* rx) {
+  const size_t n = cobs_decode(rx->buf, rx->len);
+  if (n == SIZE_MAX || n < sizeof(c6_link_hdr_t) + 4) {
+    rx->stats.framing_errors++;
+    return;
+  }
+  if (n > C6_LINK_MAX_RAW) {
+    rx->stats.oversize++;
+    return;
+  }
+  uint32_t crc;
+  memcpy(&crc, rx->buf + n - 4, sizeof(crc));
+  if (crc32_update(0, rx->buf, n - 4) != crc) {
+    rx->stats.crc_errors++;
+    return;
+  }
+  const c6_link_hdr_t* hdr = (const c6_link_hdr_t*)rx->buf;
+  if (hdr->schema != C6_LINK_SCHEMA_VERSION) {
+    rx->stats.schema_mismatch++;
+    return;
+  }
+  if (rx->synced && hdr->seq != rx->next_seq) rx->stats.lost += (uint16_t)(hdr->seq - rx->next_seq);
+  rx->synced = true;
+  rx->next_seq = hdr->seq + 1;
+  rx->stats.messages++;
+  if (rx->cb) rx->cb(hdr, rx->buf + sizeof(*hdr), (uint16_t)(n - sizeof(*hdr) - 4), rx->ctx);
+}
+
+void c6_link_rx_feed(c6_link_rx_t* rx, const uint8_t* data, size_t len) {
+  rx->stats.bytes += (uint32_t)len;
+  for (size_t i = 0; i < len; ++i) {
+    const uint8_t b = data[i];
+    if (b) {
+      if (rx->len < sizeof(rx->buf)) {
+        rx->buf[rx->len++] = b;
+      } else {
+        rx->overflow = true;
+      }
+      continue;
+    }
+    if (rx->overflow) {
+      rx->stats.oversize++;
+    } else if (rx->len) {
+      rx_message(rx);
+    }
+    rx->len = 0;
+    rx->overflow = false;
+  }
+}
+
+// ---- P4 receiver service ----
+
+static c6_link_rx_t          s_rx;
+static c6_link_tx_t          s_tx;
+static int                   s_port = -1;
+static std::atomic<bool>     s_peer_ok{false};
+static std::atomic<uint32_t> s_signals{0};
+static std::atomic<uint32_t> s_sender_dropped{0};
+static std::atomic<uint32_t> s_last_rx_ms{0};
+static std::atomic<uint32_t> s_rx_stats[7];   // mirror of s_rx.stats for other tasks
+static c6_sync_rx_t          s_sync;
+static uint32_t              s_last_resync = 0;
+static std::atomic<uint32_t> s_sync_stats[3];  // keyframes, deltas, gaps
+static std::atomic<uint32_t> s_resyncs{0};
+
+static inline void bump(std::atomic<uint32_t>& c, uint32_t n = 1) {
+  c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+static bool hello_matches(const uint8_t* body, uint16_t len) {
+  c6_link_hello_t h;
+  if (len < sizeof(h)) return false;
+  memcpy(&h, body, sizeof(h));
+  return h.signal_count == SIG_COUNT && h.signal_hash == c6_link_signal_hash() && h.max_body <= C6_LINK_MAX_BODY;
+}
+
+static void on_sync_publish(signal_id_t sig, float value, uint8_t quality, uint8_t src, uint32_t pgn, void* ctx) {
+  bus_publish(sig, value, quality, src, pgn, *(const uint32_t*)ctx);
+  bump(s_signals);
+}
+
+static void on_link_message(const c6_link_hdr_t* hdr, const uint8_t* body, uint16_t len, void*) {
+  const uint32_t now_ms = plat_millis();
+  s_last_rx_ms.store(now_ms, std::memory_order_relaxed);
+  if (hdr->type == C6_LINK_HELLO) {
+    const bool ok = hello_matches(body, len);
+    if (!ok) s_rx.stats.schema_mismatch++;
+    if (ok != s_peer_ok.load()) {
+      DBG_LOGI("[c6] peer %s", ok ? "connected" : "schema mismatch; ignoring its data");
+      c6_sync_rx_init(&s_sync);   // a (re)started C6 begins with a keyframe
+    }
+    s_peer_ok.store(ok);
+    return;
+  }
+  if (hdr->type == C6_LINK_KEYFRAME || hdr->type == C6_LINK_DELTA) {
+    if (!s_peer_ok.load(std::memory_order_relaxed)) return;
+    if (!c6_sync_rx_apply(&s_sync, hdr->type, body, len, on_sync_publish, (void*)&now_ms) &&
+        now_ms - s_last_resync >= C6_SYNC_RESYNC_MS) {
+      s_last_resync = now_ms;
+      c6_link_port_write(s_port, s_tx.wire, c6_link_encode(&s_tx, C6_LINK_RESYNC, nullptr, 0));
+      bump(s_resyncs);
+    }
+    const uint32_t v[3] = {s_sync.stats.keyframes, s_sync.stats.deltas, s_sync.stats.gaps};
+    for (int i = 0; i < 3; ++i) s_sync_stats[i].store(v[i], std::memory_order_relaxed);
+    return;
+  }
+  if (hdr->type != C6_LINK_SIGNALS || !s_peer_ok.load(std::memory_order_relaxed) || len < sizeof(c6_link_batch_t)) return;
+  const c6_link_batch_t* b = (const c6_link_batch_t*)body;
+  const uint16_t count = (uint16_t)((len - sizeof(*b)) / sizeof(c6_link_signal_t));
+  const c6_link_signal_t* e = (const c6_link_signal_t*)(body + sizeof(*b));
+  for (uint16_t i = 0; i < count && i < b->count; ++i) {
+    const uint8_t sig = (uint8_t)e[i].pgn_sig;
+    if (sig >= SIG_COUNT) continue;
+    bus_publish((signal_id_t)sig, e[i].value, e[i].quality, e[i].src, e[i].pgn_sig >> 8, now_ms - e[i].age_ms);
+  }
+  bump(s_signals, count);
+  if (b->dropped) bump(s_sender_dropped, b->dropped);
+}
+
+static void c6_link_task(void*) {
+  alignas(4) static uint8_t chunk[256];
+  uint32_t last_hello = plat_millis() - C6_LINK_HELLO_MS;
+  for (;;) {
+    const uint32_t now = plat_millis();
+    if (!s_peer_ok.load(std::memory_order_relaxed) && now - last_hello >= C6_LINK_HELLO_MS) {
+      const size_t n = c6_link_encode_hello(&s_tx);
+      c6_link_port_write(s_port, s_tx.wire, n);
+      last_hello = now;
+    }
+    const int n = c6_link_port_read(s_port, chunk, sizeof(chunk), 20);
+    if (n > 0) {
+      c6_link_rx_feed(&s_rx, chunk, (size_t)n);
+      const c6_link_rx_stats_t& st = s_rx.stats;
+      const uint32_t v[7] = {st.messages, st.bytes, st.crc_errors, st.framing_errors,
+                             st.oversize, st.schema_mismatch, st.lost};
+      for (int i = 0; i < 7; ++i) s_rx_stats[i].store(v[i], std::memory_order_relaxed);
+    }
+    signal_stale_tick(plat_millis());
+  }
+}
+
+bool c6_link_start(const char* dev) {
+  if (s_port >= 0) return true;
+  s_port = c6_link_port_open(dev, C6_LINK_BAUD);
+  if (s_port < 0) {
+    DBG_LOGW("[c6] cannot open link port");
+    return false;
+  }
+  signal_history_init();
+  c6_link_rx_init(&s_rx, on_link_message, nullptr);
+  c6_link_tx_init(&s_tx);
+  if (!plat_task_start(c6_link_task, "c6_link", 4096, C6_LINK_RX_TASK_PRIO, -1, nullptr)) {
+    c6_link_port_close(s_port);
+    s_port = -1;
+    return false;
+  }
+  DBG_LOGI("[c6] link up at %u baud, schema %u, signal hash %08X", (unsigned)C6_LINK_BAUD,
+           (unsigned)C6_LINK_SCHEMA_VERSION, (unsigned)c6_link_signal_hash());
+  return true;
+}
+
+void c6_link_get_stats(c6_link_stats_t* out) {
+  uint32_t* f[7] = {&out->rx.messages, &out->rx.bytes, &out->rx.crc_errors, &out->rx.framing_errors,
+                    &out->rx.oversize, &out->rx.schema_mismatch, &out->rx.lost};
+  for (int i = 0; i < 7; ++i) *f[i] = s_rx_stats[i].load(std::memory_order_relaxed);
+  out->signals = s_signals.load(std::memory_order_relaxed);
+  out->sender_dropped = s_sender_dropped.load(std::memory_order_relaxed);
+  out->last_rx_ms = s_last_rx_ms.load(std::memory_order_relaxed);
+  out->peer_ok = s_peer_ok.load(std::memory_order_relaxed);
+  out->keyframes = s_sync_stats[0].load(std::memory_order_relaxed);
+  out->deltas = s_sync_stats[1].load(std::memory_order_relaxed);
+  out->sync_gaps = s_sync_stats[2].load(std::memory_order_relaxed);
+  out->resync_requests = s_resyncs.load(std::memory_order_relaxed);
+}
+
+void c6_link_report(void) {
+  c6_link_stats_t s;
+  c6_link_get_stats(&s);
+  DBG_LOGI("[c6] peer=%s msgs=%u bytes=%u signals=%u lost=%u crc=%u framing=%u oversize=%u schema=%u "
+           "sender_dropped=%u | sync key=%u delta=%u gaps=%u resync=%u",
+           s.peer_ok ? "ok" : "none", (unsigned)s.rx.messages, (unsigned)s.rx.bytes, (unsigned)s.signals,
+           (unsigned)s.rx.lost, (unsigned)s.rx.crc_errors, (unsigned)s.rx.framing_errors,
+           (unsigned)s.rx.oversize, (unsigned)s.rx.schema_mismatch, (unsigned)s.sender_dropped,
+           (unsigned)s.keyframes, (unsigned)s.deltas, (unsigned)s.sync_gaps, (unsigned)s.resync_requests);
+}
+
+#if !defined(ARDUINO)
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+struct bench_rx_t {
+  uint32_t              signals;
+  uint32_t              batches;
+  std::vector<uint32_t> latency_us;   // per batch, encode -> decoded
+};
+
+static void bench_on_message(const c6_link_hdr_t* hdr, const uint8_t* body, uint16_t len, void* ctx) {
+  bench_rx_t* b = (bench_rx_t*)ctx;
+  if (hdr->type != C6_LINK_SIGNALS || len < sizeof(c6_link_batch_t)) return;
+  b->signals += ((const c6_link_batch_t*)body)->count;
+  b->batches++;
+  b->latency_us.push_back(plat_micros() - hdr->t_us);
+}
+
+static bool write_all(int port, const uint8_t* p, size_t n) {
+  while (n) {
+    const int w = c6_link_port_write(port, p, n);
+    if (w <= 0) return false;
+    p += w;
+    n -= (size_t)w;
+  }
+  return true;
+}
+
+void c6_link_bench(uint32_t seconds, uint32_t signals_per_s, uint32_t corrupt_every) {
+  int master, slave;
+  if (!c6_link_port_pty_pair(&master, &slave)) {
+    DBG_LOGW("[c6] bench: no pty pair");
+    return;
+  }
+  static c6_link_rx_t rx;
+  static bench_rx_t res;
+  res = bench_rx_t{};
+  res.latency_us.reserve(1 << 20);
+  c6_link_rx_init(&rx, bench_on_message, &res);
+
+  // Sender (the C6): batches as values arrive, flushes full batches and at
+  // least every 10 ms, like a decoder forwarding bus traffic.
+  uint64_t sent_bytes = 0, sent_signals = 0, corrupted = 0;
+  std::atomic<bool> done{false};
+  std::thread sender([&] {
+    static c6_link_tx_t tx;
+    c6_link_tx_init(&tx);
+    uint32_t msgs = 0, x = 1;
+    const uint32_t t0 = plat_millis();
+    const uint32_t per_tick = signals_per_s ? (signals_per_s + 99) / 100 : (uint32_t)C6_LINK_BATCH_MAX;
+    auto send = [&](size_t n) {
+      if (corrupt_every && ++msgs % corrupt_every == 0) {
+        x = x * 1664525u + 1013904223u;
+        tx.wire[(x >> 8) % (n - 1)] ^= (uint8_t)(1u << ((x >> 4) & 7));
+        corrupted++;
+      }
+      sent_bytes += n;
+      write_all(slave, tx.wire, n);
+    };
+    for (uint32_t tick = 0; plat_millis() - t0 < seconds * 1000u; ++tick) {
+      for (uint32_t i = 0; i < per_tick; ++i) {
+        const signal_id_t sig = (signal_id_t)(sent_signals % SIG_COUNT);
+        if (!c6_link_batch_add(&tx, sig, (float)i, 1, 0x10, 127488, 0)) {
+          send(c6_link_encode_batch(&tx));
+          c6_link_batch_add(&tx, sig, (float)i, 1, 0x10, 127488, 0);
+        }
+        sent_signals++;
+      }
+      if (size_t n = c6_link_encode_batch(&tx)) send(n);
+      if (signals_per_s) {
+        const uint32_t due = t0 + (tick + 1) * 10;
+        const int32_t wait = (int32_t)(due - plat_millis());
+        if (wait > 0) plat_delay_ms((uint32_t)wait);
+      }
+    }
+    done.store(true);
+  });
+
+  alignas(4) static uint8_t chunk[4096];
+  const uint32_t t0 = plat_micros();
+  uint32_t idle_since = 0;
+  for (;;) {
+    const int n = c6_link_port_read(master, chunk, sizeof(chunk), 20);
+    if (n > 0) {
+      c6_link_rx_feed(&rx, chunk, (size_t)n);
+      idle_since = 0;
+    } else if (done.load()) {
+      if (!idle_since) idle_since = plat_millis();
+      if (plat_millis() - idle_since > 200) break;
+    }
+  }
+  const uint32_t wall_us = plat_micros() - t0;
+  sender.join();
+  c6_link_port_close(master);
+  c6_link_port_close(slave);
+
+  std::vector<uint32_t>& lat = res.latency_us;
+  std::sort(lat.begin(), lat.end());
+  auto pct = [&](uint32_t p) { return lat.empty() ? 0u : lat[std::min(lat.size() - 1, lat.size() * p / 100)]; };
+  const double secs = (double)wall_us / 1e6;
+  const double uart_s = (double)sent_bytes * 10 / C6_LINK_BAUD;
+  DBG_LOGI("[c6] bench %u s, %s: sent %llu signals in %llu bytes (%.2f B/signal), received %u signals in %u batches",
+           (unsigned)seconds, signals_per_s ? "paced" : "max rate", (unsigned long long)sent_signals,
+           (unsigned long long)sent_bytes, sent_signals ? (double)sent_bytes / sent_signals : 0.0,
+           (unsigned)res.signals, (unsigned)res.batches);
+  DBG_LOGI("[c6]   pty %.0f signals/s %.2f MB/s; at %u baud the UART needs %.2f s (%.0f%% of the run)",
+           res.signals / secs, sent_bytes / secs / 1e6, (unsigned)C6_LINK_BAUD, uart_s, 100.0 * uart_s / secs);
+  DBG_LOGI("[c6]   latency encode->decoded us p50=%u p99=%u max=%u", (unsigned)pct(50), (unsigned)pct(99),
+           lat.empty() ? 0u : (unsigned)lat.back());
+  DBG_LOGI("[c6]   corrupted=%llu crc=%u framing=%u oversize=%u lost=%u", (unsigned long long)corrupted,
+           (unsigned)rx.stats.crc_errors, (unsigned)rx.stats.framing_errors, (unsigned)rx.stats.oversize,
+           (unsigned)rx.stats.lost);
+}
+
+#endif  // !ARDUINO
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "signals.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// P4 <-> C6 coprocessor link (NMEA2000_SD_LOGGING_PLAN.md, option B: the C6
+// owns CAN + NMEA2000 decoding and forwards normalized signals).
+//
+// Wire format: each message is COBS-encoded and terminated by a 0x00 byte,
+// so a receiver resynchronizes on the next delimiter after any corruption.
+// Decoded, a message is
+//   c6_link_hdr_t (8 bytes) | body | CRC-32 of header + body (crc32.h)
+// Both chips are little-endian; structs are sent as laid out here.
+// Sequence numbers count every message per direction; gaps are reported as
+// lost messages. Signals travel either as per-value batches (below) or as
+// keyframe + delta state sync (c6_sync.h). The header carries
+// C6_LINK_SCHEMA_VERSION and HELLO carries a hash of the signal table
+// (signals.h), so a C6 built against a different signal list is rejected
+// instead of mislabelling values.
+//
+// Buffers are 4-byte aligned and messages are decoded in place, so batch
+// entries are read straight out of the receive buffer and the encoder's
+// output goes to the UART (or its DMA) without another copy.
+//
+// Transport: c6_link_port_* below. On the P4 a UART (c6_link_uart.cpp), on
+// a Linux host any tty, e.g. one side of a pty pair (c6_link_posix.cpp),
+// with the same protocol code on both.
+
+#define C6_LINK_SCHEMA_VERSION 2
+
+#ifndef C6_LINK_MAX_BODY
+  #define C6_LINK_MAX_BODY      496    // bytes; a 41-signal batch
+#endif
+#ifndef C6_LINK_BAUD
+  #define C6_LINK_BAUD          2000000
+#endif
+#ifndef C6_LINK_RX_TASK_PRIO
+  #define C6_LINK_RX_TASK_PRIO  5      // takes the bus task's place
+#endif
+#ifndef C6_LINK_HELLO_MS
+  #define C6_LINK_HELLO_MS      1000   // HELLO resend period until the peer's arrives
+#endif
+
+enum c6_link_type_t : uint8_t {
+  C6_LINK_HELLO = 1,
+  C6_LINK_SIGNALS,
+  C6_LINK_HEARTBEAT,
+  C6_LINK_KEYFRAME,   // state sync (c6_sync.h)
+  C6_LINK_DELTA,
+  C6_LINK_RESYNC,     // P4 -> C6: send a keyframe, no body
+};
+
+struct c6_link_hdr_t {
+  uint8_t  schema;      // C6_LINK_SCHEMA_VERSION
+  uint8_t  type;        // c6_link_type_t
+  uint16_t seq;
+  uint32_t t_us;        // sender plat_micros() when encoded
+};
+static_assert(sizeof(c6_link_hdr_t) == 8, "c6_link_hdr_t is part of the wire format");
+
+struct c6_link_hello_t {
+  uint16_t signal_count;   // SIG_COUNT
+  uint16_t max_body;       // C6_LINK_MAX_BODY
+  uint32_t signal_hash;    // c6_link_signal_hash()
+};
+
+struct c6_link_batch_t {
+  uint16_t count;
+  uint16_t dropped;        // values the sender could not queue since the last batch
+};
+
+struct c6_link_signal_t {
+  float    value;
+  uint32_t pgn_sig;        // pgn << 8 | signal_id_t
+  uint8_t  src;
+  uint8_t  quality;        // signal_quality_t
+  uint16_t age_ms;         // decoded this long before the batch was sent
+};
+static_assert(sizeof(c6_link_signal_t) == 12, "c6_link_signal_t is part of the wire format");
+
+#define C6_LINK_BATCH_MAX ((C6_LINK_MAX_BODY - sizeof(c6_link_batch_t)) / sizeof(c6_link_signal_t))
+// Raw message and worst-case COBS encoding incl. delimiter, rounded to 4.
+#define C6_LINK_MAX_RAW   (sizeof(c6_link_hdr_t) + C6_LINK_MAX_BODY + 4)
+#define C6_LINK_MAX_WIRE  (((C6_LINK_MAX_RAW + C6_LINK_MAX_RAW / 254 + 2) + 3) & ~3u)
+
+// FNV-1a over the signal keys and units, in order.
+uint32_t c6_link_signal_hash(void);
+
+// ---- Encoder ----
+
+struct c6_link_tx_t {
+  alignas(4) uint8_t raw[C6_LINK_MAX_RAW];
+  alignas(4) uint8_t wire[C6_LINK_MAX_WIRE];
+  uint16_t seq;
+  uint16_t batch_count;
+  uint16_t batch_dropped;   // sender's own queue losses, reported with the next batch
+};
+
+void c6_link_tx_init(c6_link_tx_t* tx);
+// Encodes one message into tx->wire; returns its length (0 if the body is
+// too large).
+size_t c6_link_encode(c6_link_tx_t* tx, uint8_t type, const void* body, size_t len);
+size_t c6_link_encode_hello(c6_link_tx_t* tx);
+
+// Signal batch, built in place in tx->raw. add() returns false when the
+// batch is full: encode it with c6_link_encode_batch() and retry.
+bool   c6_link_batch_add(c6_link_tx_t* tx, signal_id_t sig, float value, uint8_t quality, uint8_t src,
+                         uint32_t pgn, uint16_t age_ms);
+size_t c6_link_encode_batch(c6_link_tx_t* tx);   // 0 if the batch is empty
+
+// ---- Decoder ----
+
+struct c6_link_rx_stats_t {
+  uint32_t messages;
+  uint32_t bytes;
+  uint32_t crc_errors;
+  uint32_t framing_errors;   // bad COBS or shorter than a header
+  uint32_t oversize;         // longer than C6_LINK_MAX_RAW, discarded
+  uint32_t schema_mismatch;  // wrong header version or HELLO signal hash
+  uint32_t lost;             // sequence gaps
+};
+
+// `body` points into the receive buffer (4-byte aligned) and is valid for
+// the duration of the callback.
+typedef void (*c6_link_msg_cb_t)(const c6_link_hdr_t* hdr, const uint8_t* body, uint16_t len, void* ctx);
+
+struct c6_link_rx_t {
+  alignas(4) uint8_t buf[C6_LINK_MAX_WIRE];
+  uint16_t           len;
+  bool               overflow;
+  bool               synced;      // a message was received; seq is valid
+  uint16_t           next_seq;
+  c6_link_msg_cb_t   cb;
+  void*              ctx;
+  c6_link_rx_stats_t stats;
+};
+
+void c6_link_rx_init(c6_link_rx_t* rx, c6_link_msg_cb_t cb, void* ctx);
+void c6_link_rx_feed(c6_link_rx_t* rx, const uint8_t* data, size_t len);
+
+// ---- Transport ----
+
+// Opens `dev` (ignored on the P4, which uses the UART in pins_config.h) in
+// raw 8N1 mode. Returns a handle >= 0, or -1.
+int  c6_link_port_open(const char* dev, uint32_t baud);
+int  c6_link_port_write(int port, const uint8_t* data, size_t len);
+// Waits up to timeout_ms for at least one byte; returns bytes read, 0 on
+// timeout, -1 on error.
+int  c6_link_port_read(int port, uint8_t* data, size_t cap, uint32_t timeout_ms);
+void c6_link_port_close(int port);
+#if !defined(ARDUINO)
+// Host: a connected pty pair in raw mode (master, slave).
+bool c6_link_port_pty_pair(int* a, int* b);
+#endif
+
+// ---- P4 receiver service ----
+
+struct c6_link_stats_t {
+  c6_link_rx_stats_t rx;
+  uint32_t signals;          // published through bus_publish()
+  uint32_t sender_dropped;   // reported by the C6 in batches
+  uint32_t last_rx_ms;
+  bool     peer_ok;          // HELLO received with a matching schema
+  // State sync (c6_sync.h)
+  uint32_t keyframes;
+  uint32_t deltas;
+  uint32_t sync_gaps;
+  uint32_t resync_requests;
+};
+
+// Starts the RX task: sends HELLO until the C6 answers, then publishes
+// every received signal (batches or state sync frames) through
+// bus_publish() and ticks the staleness engine. Use instead of
+// bus_task_start(), not beside it.
+bool c6_link_start(const char* dev);
+void c6_link_get_stats(c6_link_stats_t* out);
+void c6_link_report(void);
+
+#if !defined(ARDUINO)
+// Host only: one pty pair stands in for the UART. A sender thread plays the
+// C6, batching `signals_per_s` values (0 = as fast as possible) for
+// `seconds`; the receiver decodes in this thread. Every `corrupt_every`-th
+// message gets one byte flipped (0 = never) to exercise CRC and resync.
+// Logs throughput, UART time at C6_LINK_BAUD, latency p50/p99/max and
+// errors. Driver: tests/run_host_tests.sh c6_link_bench.
+void c6_link_bench(uint32_t seconds, uint32_t signals_per_s, uint32_t corrupt_every);
+#endif
@@ -0,0 +1,87 @@
+// Host transport for c6_link: any tty (a USB-UART wired to a C6 dev board)
+// or a pty pair for loopback benchmarks.
+#if !defined(ARDUINO)
+
+#include "c6_link.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+static bool make_raw(int fd, uint32_t baud) {
+  struct termios tio;
+  if (tcgetattr(fd, &tio) != 0) return false;
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  speed_t speed = B115200;
+#ifdef B2000000
+  if (baud >= 2000000) speed = B2000000;
+  else
+#endif
+  if (baud >= 921600) speed = B921600;
+  else if (baud >= 460800) speed = B460800;
+  cfsetspeed(&tio, speed);
+  return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+int c6_link_port_open(const char* dev, uint32_t baud) {
+  if (!dev) return -1;
+  const int fd = open(dev, O_RDWR | O_NOCTTY);
+  if (fd < 0) return -1;
+  if (!make_raw(fd, baud)) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int c6_link_port_write(int port, const uint8_t* data, size_t len) {
+  size_t done = 0;
+  while (done < len) {
+    const ssize_t n = write(port, data + done, len - done);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN) {
+        struct pollfd p = {port, POLLOUT, 0};
+        poll(&p, 1, 100);
+        continue;
+      }
+      return done ? (int)done : -1;
+    }
+    done += (size_t)n;
+  }
+  return (int)done;
+}
+
+int c6_link_port_read(int port, uint8_t* data, size_t cap, uint32_t timeout_ms) {
+  struct pollfd p = {port, POLLIN, 0};
+  const int r = poll(&p, 1, (int)timeout_ms);
+  if (r <= 0) return r == 0 || errno == EINTR ? 0 : -1;
+  const ssize_t n = read(port, data, cap);
+  if (n < 0) return errno == EINTR || errno == EAGAIN ? 0 : -1;
+  return (int)n;
+}
+
+void c6_link_port_close(int port) {
+  if (port >= 0) close(port);
+}
+
+bool c6_link_port_pty_pair(int* a, int* b) {
+  const int m = posix_openpt(O_RDWR | O_NOCTTY);
+  if (m < 0) return false;
+  const char* name = (grantpt(m) == 0 && unlockpt(m) == 0) ? ptsname(m) : nullptr;
+  const int s = name ? open(name, O_RDWR | O_NOCTTY) : -1;
+  if (s < 0 || !make_raw(m, C6_LINK_BAUD) || !make_raw(s, C6_LINK_BAUD)) {
+    if (s >= 0) close(s);
+    close(m);
+    return false;
+  }
+  *a = m;
+  *b = s;
+  return true;
+}
+
+#endif  // !ARDUINO
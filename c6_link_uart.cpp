@@ -0,0 +1,57 @@
+// ESP32-P4 transport for c6_link: one UART to the C6 (pins_config.h).
+#if defined(ARDUINO)
+
+#include "c6_link.h"
+#include "pins_config.h"
+#include "logging_policy.h"
+
+#include "driver/uart.h"
+
+#ifndef C6_LINK_UART_BUF
+  #define C6_LINK_UART_BUF 4096   // driver RX/TX ring, bytes; ~20 ms at 2 Mbit/s
+#endif
+
+int c6_link_port_open(const char*, uint32_t baud) {
+  const uart_port_t port = (uart_port_t)C6_LINK_UART_NUM;
+  uart_config_t cfg = {};
+  cfg.baud_rate = (int)baud;
+  cfg.data_bits = UART_DATA_8_BITS;
+  cfg.parity = UART_PARITY_DISABLE;
+  cfg.stop_bits = UART_STOP_BITS_1;
+  cfg.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+  cfg.source_clk = UART_SCLK_DEFAULT;
+  if (uart_driver_install(port, C6_LINK_UART_BUF, C6_LINK_UART_BUF, 0, nullptr, 0) != ESP_OK) return -1;
+  if (uart_param_config(port, &cfg) != ESP_OK ||
+      uart_set_pin(port, C6_LINK_TX_PIN, C6_LINK_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) != ESP_OK) {
+    DBG_LOGW("[c6] uart %d config failed", (int)port);
+    uart_driver_delete(port);
+    return -1;
+  }
+  return (int)port;
+}
+
+int c6_link_port_write(int port, const uint8_t* data, size_t len) {
+  return uart_write_bytes((uart_port_t)port, data, len);
+}
+
+// Block for the first byte only, then take whatever else is buffered, so a
+// batch is handed to the decoder as soon as it lands.
+int c6_link_port_read(int port, uint8_t* data, size_t cap, uint32_t timeout_ms) {
+  size_t avail = 0;
+  uart_get_buffered_data_len((uart_port_t)port, &avail);
+  if (!avail) {
+    const int n = uart_read_bytes((uart_port_t)port, data, 1, pdMS_TO_TICKS(timeout_ms));
+    if (n <= 0) return n;
+    uart_get_buffered_data_len((uart_port_t)port, &avail);
+    if (!avail || cap == 1) return 1;
+    const int m = uart_read_bytes((uart_port_t)port, data + 1, avail < cap - 1 ? avail : cap - 1, 0);
+    return m < 0 ? 1 : 1 + m;
+  }
+  return uart_read_bytes((uart_port_t)port, data, avail < cap ? avail : cap, 0);
+}
+
+void c6_link_port_close(int port) {
+  uart_driver_delete((uart_port_t)port);
+}
+
+#endif  // ARDUINO
@@ -0,0 +1,158 @@
+#include "c6_sync.h"
+
+#include <string.h>
+
+static inline bool slot_equal(const c6_sync_slot_t& a, const c6_sync_slot_t& b) {
+  return memcmp(&a, &b, sizeof(a)) == 0;   // bitwise: NaN == NaN, -0 != 0
+}
+
+// ---- Sender ----
+
+void c6_sync_tx_init(c6_sync_tx_t* tx) {
+  memset(tx, 0, sizeof(*tx));
+  tx->key_due = true;
+}
+
+void c6_sync_tx_update(c6_sync_tx_t* tx, signal_id_t sig, float value, uint8_t quality, uint8_t src,
+                       uint32_t pgn) {
+  if (sig >= SIG_COUNT) return;
+  tx->cur[sig] = {value, c6_sync_meta_pack(pgn, src, quality)};
+  tx->valid |= 1u << sig;
+  tx->fresh |= 1u << sig;
+}
+
+void c6_sync_tx_request_keyframe(c6_sync_tx_t* tx) {
+  tx->key_due = true;
+}
+
+size_t c6_sync_tx_frame(c6_sync_tx_t* tx, c6_link_tx_t* link, uint32_t now_ms) {
+  if (!tx->valid) return 0;
+  const bool key = tx->key_due || now_ms - tx->last_key_ms >= C6_SYNC_KEYFRAME_MS;
+  c6_sync_hdr_t hdr = {tx->frame, 0, tx->fresh, tx->valid, tx->valid};
+  if (!key) {
+    if (!tx->fresh) return 0;   // the receiver's table is current
+    uint32_t values = 0, meta = 0;
+    for (uint32_t m = tx->fresh; m; m &= m - 1) {
+      const int i = __builtin_ctz(m);
+      const bool known = tx->sent_valid & (1u << i);
+      if (!known || memcmp(&tx->cur[i].value, &tx->sent[i].value, sizeof(float))) values |= 1u << i;
+      if (!known || tx->cur[i].meta != tx->sent[i].meta) meta |= 1u << i;
+    }
+    hdr.values = values;
+    hdr.meta = meta;
+  }
+
+  alignas(4) uint8_t body[C6_SYNC_MAX_BODY];
+  memcpy(body, &hdr, sizeof(hdr));
+  uint8_t* p = body + sizeof(hdr);
+  for (uint32_t m = hdr.values; m; m &= m - 1) {
+    memcpy(p, &tx->cur[__builtin_ctz(m)].value, 4);
+    p += 4;
+  }
+  for (uint32_t m = hdr.meta; m; m &= m - 1) {
+    memcpy(p, &tx->cur[__builtin_ctz(m)].meta, 4);
+    p += 4;
+  }
+  const size_t n = c6_link_encode(link, key ? C6_LINK_KEYFRAME : C6_LINK_DELTA, body, (size_t)(p - body));
+  if (!n) return 0;
+
+  for (uint32_t m = hdr.values | hdr.meta; m; m &= m - 1) {
+    const int i = __builtin_ctz(m);
+    tx->sent[i] = tx->cur[i];
+  }
+  tx->sent_valid |= hdr.values & hdr.meta;
+  tx->fresh = 0;
+  tx->frame++;
+  if (key) {
+    tx->key_due = false;
+    tx->last_key_ms = now_ms;
+    tx->stats.keyframes++;
+  } else {
+    tx->stats.deltas++;
+  }
+  tx->stats.bytes += (uint32_t)n;
+  return n;
+}
+
+// ---- Receiver ----
+
+void c6_sync_rx_init(c6_sync_rx_t* rx) {
+  memset(rx, 0, sizeof(*rx));
+}
+
+bool c6_sync_rx_apply(c6_sync_rx_t* rx, uint8_t type, const uint8_t* body, uint16_t len,
+                      c6_sync_publish_fn publish, void* ctx) {
+  const bool key = type == C6_LINK_KEYFRAME;
+  c6_sync_hdr_t hdr;
+  if (len < sizeof(hdr)) {
+    rx->stats.malformed++;
+    rx->synced = false;
+    return false;
+  }
+  memcpy(&hdr, body, sizeof(hdr));
+  const uint32_t all = (uint32_t)((1ull << SIG_COUNT) - 1);
+  const size_t need = sizeof(hdr) + 4 * (__builtin_popcount(hdr.values) + __builtin_popcount(hdr.meta));
+  // A keyframe carries every slot it marks; a delta only fresh ones.
+  if (len != need || ((hdr.fresh | hdr.values | hdr.meta) & ~all) ||
+      (key ? hdr.values != hdr.meta || (hdr.fresh & ~hdr.values) : ((hdr.values | hdr.meta) & ~hdr.fresh))) {
+    rx->stats.malformed++;
+    rx->synced = false;
+    return false;
+  }
+
+  uint32_t to_publish = hdr.fresh;
+  c6_sync_slot_t before[SIG_COUNT];
+  const uint32_t before_valid = rx->valid;
+  if (key) {
+    memcpy(before, rx->slot, sizeof(before));
+    rx->valid = hdr.values;
+    rx->stats.keyframes++;
+  } else {
+    if (!rx->synced) {
+      rx->stats.discarded++;
+      return false;
+    }
+    if (hdr.frame != rx->next_frame) {
+      rx->stats.gaps++;
+      rx->synced = false;
+      return false;
+    }
+    // Only next in line can a delta be checked against the table: a slot
+    // the receiver does not hold yet must come with value and meta.
+    if (hdr.fresh & ~(rx->valid | (hdr.values & hdr.meta))) {
+      rx->stats.malformed++;
+      rx->synced = false;
+      return false;
+    }
+    rx->valid |= hdr.values & hdr.meta;
+    rx->stats.deltas++;
+  }
+  rx->synced = true;
+  rx->next_frame = hdr.frame + 1;
+
+  const uint8_t* p = body + sizeof(hdr);
+  for (uint32_t m = hdr.values; m; m &= m - 1) {
+    memcpy(&rx->slot[__builtin_ctz(m)].value, p, 4);
+    p += 4;
+  }
+  for (uint32_t m = hdr.meta; m; m &= m - 1) {
+    memcpy(&rx->slot[__builtin_ctz(m)].meta, p, 4);
+    p += 4;
+  }
+  // After a resync, values whose deltas were lost are news too.
+  if (key) {
+    for (uint32_t m = hdr.values & ~to_publish; m; m &= m - 1) {
+      const int i = __builtin_ctz(m);
+      if (!(before_valid & (1u << i)) || !slot_equal(before[i], rx->slot[i])) to_publish |= 1u << i;
+    }
+  }
+  if (publish) {
+    for (uint32_t m = to_publish; m; m &= m - 1) {
+      const int i = __builtin_ctz(m);
+      const uint32_t meta = rx->slot[i].meta;
+      publish((signal_id_t)i, rx->slot[i].value, (uint8_t)(meta >> 26), (uint8_t)(meta >> 18), meta & 0x3FFFF, ctx);
+    }
+  }
+  rx->stats.published += __builtin_popcount(to_publish);
+  return true;
+}
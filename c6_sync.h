@@ -0,0 +1,119 @@
+#pragma once
+
+#include "c6_link.h"
+#include "signals.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Signal table state sync over the coprocessor link (c6_link.h).
+//
+// Instead of one batch entry per decoded value, the C6 keeps a copy of the
+// signal table and sends it once per C6_SYNC_PERIOD_MS:
+//   KEYFRAME  every slot it holds, periodically and on request;
+//   DELTA     only slots whose value or source metadata changed since the
+//             previous frame, as bitmaps followed by the changed values.
+// Body layout (both types):
+//   c6_sync_hdr_t | float per `values` bit | meta word per `meta` bit
+// in slot order. `fresh` marks slots the bus updated since the previous
+// frame even if the value is unchanged; only those (plus, in a keyframe,
+// slots that differ from the receiver's table) are published on the P4, so
+// a silent sensor still goes stale there although keyframes keep repeating
+// its last value.
+//
+// Deltas chain on the previous frame. The receiver tracks the frame number
+// and, on any gap or malformed frame, drops deltas until the next keyframe
+// and asks for one (C6_LINK_RESYNC); periodic keyframes cover a lost
+// request. Publish timestamps are the P4's receive time, so they are late
+// by up to one period plus the link latency.
+
+#ifndef C6_SYNC_PERIOD_MS
+  #define C6_SYNC_PERIOD_MS     50     // frame cadence; >= the fastest PGN rate
+#endif
+#ifndef C6_SYNC_KEYFRAME_MS
+  #define C6_SYNC_KEYFRAME_MS   2000   // periodic keyframe, bounds recovery if a RESYNC is lost
+#endif
+#ifndef C6_SYNC_RESYNC_MS
+  #define C6_SYNC_RESYNC_MS     100    // min spacing of RESYNC requests from the receiver
+#endif
+
+static_assert(SIG_COUNT <= 32, "c6_sync bitmaps are 32 bits");
+
+struct c6_sync_hdr_t {
+  uint16_t frame;      // +1 per frame of either type
+  uint16_t reserved;
+  uint32_t fresh;      // updated on the bus since the previous frame
+  uint32_t values;     // a float follows for each bit
+  uint32_t meta;       // a meta word follows for each bit
+};
+static_assert(sizeof(c6_sync_hdr_t) == 16, "c6_sync_hdr_t is part of the wire format");
+
+// pgn (18 bits) | src << 18 | quality << 26
+static inline uint32_t c6_sync_meta_pack(uint32_t pgn, uint8_t src, uint8_t quality) {
+  return (pgn & 0x3FFFF) | (uint32_t)src << 18 | (uint32_t)(quality & 0x3F) << 26;
+}
+
+#define C6_SYNC_MAX_BODY (sizeof(c6_sync_hdr_t) + SIG_COUNT * 8)
+static_assert(C6_SYNC_MAX_BODY <= C6_LINK_MAX_BODY, "a keyframe must fit one link message");
+
+struct c6_sync_slot_t {
+  float    value;
+  uint32_t meta;
+};
+
+// ---- Sender (the C6) ----
+
+struct c6_sync_tx_stats_t {
+  uint32_t keyframes;
+  uint32_t deltas;
+  uint32_t bytes;       // wire bytes of both, incl. link framing
+};
+
+struct c6_sync_tx_t {
+  c6_sync_slot_t     cur[SIG_COUNT];
+  c6_sync_slot_t     sent[SIG_COUNT];   // as the receiver holds them
+  uint32_t           valid;             // cur[] slots that hold a value
+  uint32_t           sent_valid;
+  uint32_t           fresh;
+  uint16_t           frame;
+  bool               key_due;
+  uint32_t           last_key_ms;
+  c6_sync_tx_stats_t stats;
+};
+
+void c6_sync_tx_init(c6_sync_tx_t* tx);
+// Per decoded value.
+void c6_sync_tx_update(c6_sync_tx_t* tx, signal_id_t sig, float value, uint8_t quality, uint8_t src,
+                       uint32_t pgn);
+// Next frame on a C6_LINK_RESYNC.
+void c6_sync_tx_request_keyframe(c6_sync_tx_t* tx);
+// Once per C6_SYNC_PERIOD_MS: encodes a keyframe or delta into link->wire
+// and returns its length, or 0 when there is nothing to send.
+size_t c6_sync_tx_frame(c6_sync_tx_t* tx, c6_link_tx_t* link, uint32_t now_ms);
+
+// ---- Receiver (the P4) ----
+
+struct c6_sync_rx_stats_t {
+  uint32_t keyframes;
+  uint32_t deltas;
+  uint32_t gaps;          // frame number jumps; resync needed
+  uint32_t discarded;     // deltas dropped while waiting for a keyframe
+  uint32_t malformed;
+  uint32_t published;
+};
+
+struct c6_sync_rx_t {
+  c6_sync_slot_t     slot[SIG_COUNT];
+  uint32_t           valid;
+  uint16_t           next_frame;
+  bool               synced;
+  c6_sync_rx_stats_t stats;
+};
+
+typedef void (*c6_sync_publish_fn)(signal_id_t sig, float value, uint8_t quality, uint8_t src, uint32_t pgn,
+                                   void* ctx);
+
+void c6_sync_rx_init(c6_sync_rx_t* rx);
+// Applies a C6_LINK_KEYFRAME or C6_LINK_DELTA body and publishes its fresh
+// or changed slots. Returns false when the table is out of sync: send a RESYNC.
+bool c6_sync_rx_apply(c6_sync_rx_t* rx, uint8_t type, const uint8_t* body, uint16_t len,
+                      c6_sync_publish_fn publish, void* ctx);
@@ -0,0 +1,328 @@
+#include "can_capture.h"
+#include "spsc_ring.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <atomic>
+#include <string.h>
+
+static spsc_ring<can_frame_t, CAN_CAPTURE_RING_SIZE> s_ring;
+static std::atomic<bool> s_active{false};        // producer copies frames
+static std::atomic<bool> s_stop{false};
+static std::atomic<bool> s_task_alive{false};
+
+// Capture-task state.
+static log_file_t*          s_file = nullptr;
+static can_capture_format_t s_format = CAN_CAPTURE_CANDUMP;
+static int64_t              s_start_utc_us = 0;
+static uint64_t             s_elapsed_us = 0;     // unwrapped frame time since the first frame
+static uint32_t             s_prev_t_us = 0;
+static bool                 s_have_first = false;
+static char                 s_out[4096];
+static uint16_t             s_out_len = 0;
+
+static std::atomic<uint32_t> s_frames{0}, s_bytes{0}, s_write_errors{0};
+
+static const char k_hex[] = "0123456789ABCDEF";
+
+// One candump line (with '\n') for a frame; returns its length (< 64).
+static uint16_t format_candump(char* out, uint64_t t_us, const can_frame_t* f) {
+  int n = snprintf(out, 48, (f->flags & CAN_FRAME_EXT) ? "(%llu.%06u) %s %08X#" : "(%llu.%06u) %s %03X#",
+                   (unsigned long long)(t_us / 1000000), (unsigned)(t_us % 1000000), CAN_CAPTURE_IFNAME,
+                   (unsigned)f->id);
+  if (f->flags & CAN_FRAME_RTR) {
+    out[n++] = 'R';
+  } else {
+    for (uint8_t i = 0; i < f->dlc && i < 8; ++i) {
+      out[n++] = k_hex[f->data[i] >> 4];
+      out[n++] = k_hex[f->data[i] & 0x0F];
+    }
+  }
+  out[n++] = '\n';
+  return (uint16_t)n;
+}
+
+static void flush_out(void) {
+  if (!s_out_len) return;
+  if (log_storage_write(s_file, s_out, s_out_len) == (int32_t)s_out_len) {
+    s_bytes.fetch_add(s_out_len, std::memory_order_relaxed);
+  } else {
+    s_write_errors.fetch_add(1, std::memory_order_relaxed);
+  }
+  s_out_len = 0;
+}
+
+static void append_frame(const can_frame_t* f) {
+  if (s_have_first) s_elapsed_us += (uint32_t)(f->t_us - s_prev_t_us);
+  s_have_first = true;
+  s_prev_t_us = f->t_us;
+
+  if (s_format == CAN_CAPTURE_BINARY) {
+    if (s_out_len + sizeof(can_capture_record_t) > sizeof(s_out)) flush_out();
+    can_capture_record_t rec = {};
+    rec.t_us = s_elapsed_us;
+    rec.id = f->id;
+    rec.dlc = f->dlc;
+    rec.flags = ((f->flags & CAN_FRAME_EXT) ? CAN_CAPTURE_REC_EXT : 0) |
+                ((f->flags & CAN_FRAME_RTR) ? CAN_CAPTURE_REC_RTR : 0);
+    memcpy(rec.data, f->data, 8);
+    memcpy(s_out + s_out_len, &rec, sizeof(rec));
+    s_out_len += sizeof(rec);
+  } else {
+    if (s_out_len + 64u > sizeof(s_out)) flush_out();
+    s_out_len += format_candump(s_out + s_out_len, (uint64_t)s_start_utc_us + s_elapsed_us, f);
+  }
+  s_frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void can_capture_task(void*) {
+  uint32_t last_flush = plat_millis();
+  for (;;) {
+    const bool stop = s_stop.load();
+    can_frame_t f;
+    uint32_t n = 0;
+    while (s_ring.pop(&f)) {
+      append_frame(&f);
+      n++;
+    }
+    const uint32_t now = plat_millis();
+    if (stop || now - last_flush >= CAN_CAPTURE_FLUSH_MS) {
+      flush_out();
+      last_flush = now;
+    }
+    if (stop) break;
+    if (!n) plat_delay_ms(10);
+  }
+  log_storage_sync(s_file);
+  log_storage_close(s_file);
+  s_file = nullptr;
+  s_task_alive.store(false);
+  plat_task_exit();
+}
+
+bool can_capture_start(const char* rel_path, can_capture_format_t format) {
+  if (s_task_alive.load() || !log_storage_begin()) return false;
+  char dir[96];
+  strncpy(dir, rel_path, sizeof(dir) - 1);
+  dir[sizeof(dir) - 1] = '\0';
+  char* slash = strrchr(dir, '/');
+  if (slash) {
+    *slash = '\0';
+    log_storage_mkdirs(dir);
+  }
+  s_file = log_storage_open(rel_path, LOG_OPEN_TRUNC);
+  if (!s_file) {
+    DBG_LOGW("[can] capture: cannot create %s", rel_path);
+    return false;
+  }
+  can_frame_t stale;
+  while (s_ring.pop(&stale)) {}
+  s_format = format;
+  s_start_utc_us = plat_utc_ms() * 1000;
+  s_elapsed_us = 0;
+  s_have_first = false;
+  s_out_len = 0;
+  s_frames.store(0);
+  s_bytes.store(0);
+  s_write_errors.store(0);
+
+  if (format == CAN_CAPTURE_BINARY) {
+    const can_capture_header_t h = {CAN_CAPTURE_MAGIC, 1, sizeof(can_capture_record_t), s_start_utc_us};
+    memcpy(s_out, &h, sizeof(h));
+    s_out_len = sizeof(h);
+  }
+  s_stop.store(false);
+  s_task_alive.store(true);
+  if (!plat_task_start(can_capture_task, "can_cap", 4096, CAN_CAPTURE_TASK_PRIO, -1, nullptr)) {
+    s_task_alive.store(false);
+    log_storage_close(s_file);
+    s_file = nullptr;
+    return false;
+  }
+  s_active.store(true);
+  DBG_LOGI("[can] capture -> %s (%s)", rel_path, format == CAN_CAPTURE_BINARY ? "binary" : "candump");
+  return true;
+}
+
+void can_capture_stop(void) {
+  if (!s_task_alive.load()) return;
+  s_active.store(false);
+  s_stop.store(true);
+  while (s_task_alive.load()) plat_delay_ms(10);
+  can_capture_stats_t st;
+  can_capture_get_stats(&st);
+  DBG_LOGI("[can] capture stopped: %u frames, %u bytes, %u dropped, %u write errors", (unsigned)st.frames,
+           (unsigned)st.bytes, (unsigned)st.dropped, (unsigned)st.write_errors);
+}
+
+bool can_capture_running(void) {
+  return s_active.load(std::memory_order_relaxed);
+}
+
+void can_capture_get_stats(can_capture_stats_t* out) {
+  out->frames = s_frames.load(std::memory_order_relaxed);
+  out->dropped = s_ring.overruns();
+  out->bytes = s_bytes.load(std::memory_order_relaxed);
+  out->write_errors = s_write_errors.load(std::memory_order_relaxed);
+  out->ring_high_water = s_ring.high_water();
+}
+
+void can_capture_feed(const can_frame_t* frame) {
+  if (s_active.load(std::memory_order_relaxed)) s_ring.push(*frame);
+}
+
+// ---- Reading ----
+
+bool can_log_open(can_log_reader_t* r, const char* rel_path) {
+  memset(r, 0, sizeof(*r));
+  r->file = log_storage_open(rel_path, LOG_OPEN_READ);
+  if (!r->file) return false;
+  can_capture_header_t h;
+  if (log_storage_read(r->file, &h, sizeof(h)) == (int32_t)sizeof(h) && h.magic == CAN_CAPTURE_MAGIC) {
+    if (h.record_bytes != sizeof(can_capture_record_t)) {
+      DBG_LOGW("[can] %s: unsupported record size %u", rel_path, (unsigned)h.record_bytes);
+      can_log_close(r);
+      return false;
+    }
+    r->binary = true;
+    r->start_utc_us = h.start_utc_us;
+    return true;
+  }
+  return log_storage_seek(r->file, 0);
+}
+
+static int hex_val(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+// "(sec.usec) iface ID#DATA" with a 3-digit standard or 8-digit extended
+// ID; DATA is hex byte pairs or R for a remote frame. "##" is CAN FD.
+static bool parse_candump(const char* s, can_frame_t* f, uint64_t* t_us) {
+  if (*s++ != '(') return false;
+  uint64_t sec = 0, usec = 0;
+  int frac = 0;
+  while (*s >= '0' && *s <= '9') sec = sec * 10 + (uint64_t)(*s++ - '0');
+  if (*s++ != '.') return false;
+  while (*s >= '0' && *s <= '9') {
+    if (frac++ < 6) usec = usec * 10 + (uint64_t)(*s - '0');
+    s++;
+  }
+  while (frac++ < 6) usec *= 10;
+  if (*s++ != ')') return false;
+  while (*s == ' ') s++;
+  while (*s && *s != ' ') s++;   // interface
+  while (*s == ' ') s++;
+
+  uint32_t id = 0;
+  int digits = 0, v;
+  while ((v = hex_val(*s)) >= 0) {
+    id = (id << 4) | (uint32_t)v;
+    s++;
+    digits++;
+  }
+  if (*s++ != '#' || *s == '#' || (digits != 3 && digits != 8)) return false;
+
+  memset(f, 0, sizeof(*f));
+  f->id = id;
+  f->flags = digits == 8 ? CAN_FRAME_EXT : 0;
+  if (*s == 'R' || *s == 'r') {
+    f->flags |= CAN_FRAME_RTR;
+  } else {
+    while (f->dlc < 8) {
+      const int hi = hex_val(s[0]);
+      const int lo = hi < 0 ? -1 : hex_val(s[1]);
+      if (lo < 0) break;
+      f->data[f->dlc++] = (uint8_t)(hi << 4 | lo);
+      s += 2;
+    }
+  }
+  *t_us = sec * 1000000 + usec;
+  return true;
+}
+
+bool can_log_next(can_log_reader_t* r, can_frame_t* frame, uint64_t* t_us) {
+  if (!r->file) return false;
+  if (r->binary) {
+    can_capture_record_t rec;
+    if (log_storage_read(r->file, &rec, sizeof(rec)) != (int32_t)sizeof(rec)) return false;
+    memset(frame, 0, sizeof(*frame));
+    frame->id = rec.id;
+    frame->dlc = rec.dlc > 8 ? 8 : rec.dlc;
+    frame->flags = ((rec.flags & CAN_CAPTURE_REC_EXT) ? CAN_FRAME_EXT : 0) |
+                   ((rec.flags & CAN_CAPTURE_REC_RTR) ? CAN_FRAME_RTR : 0);
+    memcpy(frame->data, rec.data, 8);
+    *t_us = (uint64_t)r->start_utc_us + rec.t_us;
+    return true;
+  }
+  for (;;) {
+    // Find the next complete line, refilling the buffer as needed.
+    char* nl = (char*)memchr(r->buf + r->pos, '\n', r->len - r->pos);
+    if (!nl) {
+      const uint16_t keep = r->len - r->pos;
+      if (keep == sizeof(r->buf) - 1) {
+        r->pos = r->len = 0;   // overlong line: skip it
+        r->bad_lines++;
+        continue;
+      }
+      memmove(r->buf, r->buf + r->pos, keep);
+      const int32_t got = log_storage_read(r->file, r->buf + keep, sizeof(r->buf) - 1 - keep);
+      r->pos = 0;
+      r->len = keep + (got > 0 ? (uint16_t)got : 0);
+      if (got <= 0) {
+        if (!keep) return false;
+        r->buf[r->len++] = '\n';   // last line without a newline
+      }
+      continue;
+    }
+    *nl = '\0';
+    const char* line = r->buf + r->pos;
+    r->pos = (uint16_t)(nl + 1 - r->buf);
+    r->line++;
+    if (!*line || *line == '\r') continue;
+    if (parse_candump(line, frame, t_us)) return true;
+    if (r->bad_lines++ < 3) DBG_LOGW("[can] capture line %u not parsed", (unsigned)r->line);
+  }
+}
+
+void can_log_close(can_log_reader_t* r) {
+  if (r->file) log_storage_close(r->file);
+  r->file = nullptr;
+}
+
+int32_t can_capture_convert(const char* rel_bin_path, const char* rel_log_path) {
+  can_log_reader_t* r = (can_log_reader_t*)malloc(sizeof(can_log_reader_t));
+  if (!r) return -1;
+  if (!can_log_open(r, rel_bin_path) || !r->binary) {
+    can_log_close(r);
+    free(r);
+    return -1;
+  }
+  log_file_t* out = log_storage_open(rel_log_path, LOG_OPEN_TRUNC);
+  if (!out) {
+    can_log_close(r);
+    free(r);
+    return -1;
+  }
+  static char buf[4096];
+  uint16_t len = 0;
+  int32_t n = 0;
+  bool ok = true;
+  can_frame_t f;
+  uint64_t t_us;
+  while (ok && can_log_next(r, &f, &t_us)) {
+    if (len + 64u > sizeof(buf)) {
+      ok = log_storage_write(out, buf, len) == (int32_t)len;
+      len = 0;
+    }
+    len += format_candump(buf + len, t_us, &f);
+    n++;
+  }
+  if (ok && len) ok = log_storage_write(out, buf, len) == (int32_t)len;
+  log_storage_close(out);
+  can_log_close(r);
+  free(r);
+  return ok ? n : -1;
+}
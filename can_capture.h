@@ -0,0 +1,104 @@
+#pragma once
+
+#include "can_rx.h"
+#include "log_storage.h"
+#include <stdint.h>
+
+// Raw CAN frame capture and capture-file reading.
+//
+// While a capture runs, can_rx_push() also copies every frame into a
+// capture ring; a low-priority task drains it to a file through
+// log_storage.h (the SD card on the P4, ./sdcard on a host). Two formats:
+//   - candump text, as written by `candump -l`:
+//       (1697640000.123456) can0 09F80123#0102030405060708
+//   - binary: a 16-byte header then fixed 24-byte records. About 4x cheaper
+//     to write than text; can_capture_convert() turns it into candump text.
+// Timestamps are UTC when the clock is set at capture start, otherwise
+// seconds since the capture started. A full capture ring drops frames (the
+// RX path never waits on the card); they are counted.
+//
+// can_log_open()/can_log_next() read either format back (can_replay.h).
+
+#ifndef CAN_CAPTURE_RING_SIZE
+  #define CAN_CAPTURE_RING_SIZE   1024     // frames, power of two
+#endif
+#ifndef CAN_CAPTURE_IFNAME
+  #define CAN_CAPTURE_IFNAME      "can0"   // interface column of candump lines
+#endif
+#ifndef CAN_CAPTURE_FLUSH_MS
+  #define CAN_CAPTURE_FLUSH_MS    500
+#endif
+#ifndef CAN_CAPTURE_TASK_PRIO
+  #define CAN_CAPTURE_TASK_PRIO   2
+#endif
+
+enum can_capture_format_t : uint8_t {
+  CAN_CAPTURE_CANDUMP = 0,
+  CAN_CAPTURE_BINARY,
+};
+
+#define CAN_CAPTURE_MAGIC  0x50414343u   // "CCAP"
+
+struct can_capture_header_t {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_bytes;
+  int64_t  start_utc_us;   // 0 = clock unset, timestamps relative
+};
+static_assert(sizeof(can_capture_header_t) == 16, "can_capture_header_t is part of the file format");
+
+enum : uint8_t {
+  CAN_CAPTURE_REC_EXT = 1u << 0,
+  CAN_CAPTURE_REC_RTR = 1u << 1,
+};
+
+struct can_capture_record_t {
+  uint64_t t_us;           // since start_utc_us
+  uint32_t id;
+  uint8_t  dlc;
+  uint8_t  flags;          // CAN_CAPTURE_REC_*
+  uint8_t  reserved[2];
+  uint8_t  data[8];
+};
+static_assert(sizeof(can_capture_record_t) == 24, "can_capture_record_t is part of the file format");
+
+struct can_capture_stats_t {
+  uint32_t frames;         // written to the file
+  uint32_t dropped;        // capture ring full
+  uint32_t bytes;
+  uint32_t write_errors;
+  uint32_t ring_high_water;
+};
+
+// Starts capturing to `rel_path` (created or truncated). False if storage
+// is unavailable or a capture is already running.
+bool can_capture_start(const char* rel_path, can_capture_format_t format);
+// Flushes and closes the file; returns once the capture task has finished.
+void can_capture_stop(void);
+bool can_capture_running(void);
+void can_capture_get_stats(can_capture_stats_t* out);
+
+// RX producer side (can_rx_push); a no-op unless a capture is running.
+void can_capture_feed(const can_frame_t* frame);
+
+// Binary capture -> candump text. Returns frames converted, -1 on error.
+int32_t can_capture_convert(const char* rel_bin_path, const char* rel_log_path);
+
+// ---- Reading captures (either format, detected from the first bytes) ----
+
+struct can_log_reader_t {
+  log_file_t* file;
+  bool        binary;
+  int64_t     start_utc_us;   // binary header
+  uint32_t    line;           // candump: current line, for error messages
+  uint32_t    bad_lines;      // unparsable or CAN FD lines skipped
+  uint16_t    pos;
+  uint16_t    len;
+  char        buf[512];
+};
+
+bool can_log_open(can_log_reader_t* r, const char* rel_path);
+// Next frame and its capture time in µs (UTC or relative). `frame->t_us`
+// is left 0; the replayer stamps it when the frame is injected.
+bool can_log_next(can_log_reader_t* r, can_frame_t* frame, uint64_t* t_us);
+void can_log_close(can_log_reader_t* r);
@@ -0,0 +1,238 @@
+#include "can_replay.h"
+#include "can_capture.h"
+#include "can_rx.h"
+#include "n2k_decode.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <atomic>
+#include <string.h>
+
+// Injection-to-publish latency histogram: 4 sub-buckets per power of two
+// (about 19% resolution), enough for p50/p95/p99 without storing samples.
+static constexpr int LAT_BUCKETS = 32 * 4;
+
+static std::atomic<bool>     s_observe{false};
+static std::atomic<uint32_t> s_lat_hist[LAT_BUCKETS];
+static std::atomic<uint32_t> s_lat_max{0};
+static std::atomic<uint32_t> s_sig_updates[SIG_COUNT];
+static std::atomic<uint32_t> s_signals{0};
+
+static std::atomic<bool> s_task_alive{false};
+static std::atomic<bool> s_cancel{false};
+static can_replay_config_t s_task_cfg;
+static char                s_task_path[96];
+static can_replay_report_t s_last_report;
+static can_log_reader_t    s_reader;
+
+static inline void bump(std::atomic<uint32_t>& c) {
+  c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+static int lat_bucket(uint32_t us) {
+  if (us < 4) return (int)us;
+  const int msb = 31 - __builtin_clz(us);
+  return msb * 4 + (int)((us >> (msb - 2)) & 3);
+}
+
+static uint32_t lat_bucket_upper(int b) {
+  if (b < 4) return (uint32_t)b;
+  const int msb = b / 4;
+  return (uint32_t)((4u + (uint32_t)(b & 3) + 1) << (msb - 2)) - 1;
+}
+
+void can_replay_observe(signal_id_t sig, uint32_t frame_t_us) {
+  if (!s_observe.load(std::memory_order_relaxed) || sig >= SIG_COUNT) return;
+  const uint32_t us = plat_micros() - frame_t_us;
+  bump(s_lat_hist[lat_bucket(us)]);
+  if (us > s_lat_max.load(std::memory_order_relaxed)) s_lat_max.store(us, std::memory_order_relaxed);
+  bump(s_sig_updates[sig]);
+  bump(s_signals);
+}
+
+static void reset_observer(void) {
+  for (auto& b : s_lat_hist) b.store(0, std::memory_order_relaxed);
+  for (auto& c : s_sig_updates) c.store(0, std::memory_order_relaxed);
+  s_lat_max.store(0, std::memory_order_relaxed);
+  s_signals.store(0, std::memory_order_relaxed);
+}
+
+static void fill_latency(can_replay_report_t* r) {
+  uint32_t total = 0;
+  for (auto& b : s_lat_hist) total += b.load(std::memory_order_relaxed);
+  const uint32_t want[3] = {total / 2, total - total / 20, total - total / 100};
+  uint32_t* out[3] = {&r->latency_p50_us, &r->latency_p95_us, &r->latency_p99_us};
+  uint32_t seen = 0;
+  int k = 0;
+  for (int b = 0; b < LAT_BUCKETS && k < 3; ++b) {
+    seen += s_lat_hist[b].load(std::memory_order_relaxed);
+    while (k < 3 && seen > 0 && seen >= want[k]) *out[k++] = lat_bucket_upper(b);
+  }
+  r->latency_max_us = s_lat_max.load(std::memory_order_relaxed);
+}
+
+// Monotonic µs since `start`, unwrapping the 32-bit plat_micros().
+struct wall_clock_t {
+  uint32_t last;
+  uint64_t elapsed;
+  uint64_t now() {
+    const uint32_t t = plat_micros();
+    elapsed += (uint32_t)(t - last);
+    last = t;
+    return elapsed;
+  }
+};
+
+// Pushes one frame, waiting while the ring is full. Room is checked first so
+// the frame goes through can_rx_push(), and thus a running capture and the
+// bus statistics, exactly once. False if the decoder did not drain anything
+// for CAN_REPLAY_STALL_MS.
+static bool inject(can_frame_t* f, can_replay_report_t* r) {
+  if (can_rx_pending() >= CAN_RX_RING_SIZE) {
+    r->ring_full_waits++;
+    const uint32_t since = plat_millis();
+    while (can_rx_pending() >= CAN_RX_RING_SIZE) {
+      if (plat_millis() - since >= CAN_REPLAY_STALL_MS || s_cancel.load(std::memory_order_relaxed)) return false;
+      plat_delay_ms(1);
+    }
+  }
+  // Only this task produces, so the room cannot disappear before the push.
+  f->t_us = plat_micros();
+  return can_rx_push(f);
+}
+
+bool can_replay_run(const can_replay_config_t* cfg, can_replay_report_t* r) {
+  memset(r, 0, sizeof(*r));
+  if (!log_storage_begin()) return false;
+  if (!can_log_open(&s_reader, cfg->path)) {
+    DBG_LOGW("[replay] cannot open %s", cfg->path);
+    return false;
+  }
+  // The ring takes one producer: stop a live backend until the replay ends.
+  can_rx_config_t live;
+  const bool restore = can_rx_get_config(&live) && !live.no_backend;
+  can_rx_end();
+  can_rx_config_t ring_only;
+  can_rx_default_config(&ring_only);
+  ring_only.no_backend = true;
+  can_rx_begin(&ring_only);
+
+  n2k_decode_stats_t d0, d1;
+  n2k_decode_get_stats(&d0);
+  reset_observer();
+  s_observe.store(true);
+
+  const uint16_t loops = cfg->loops ? cfg->loops : 1;
+  wall_clock_t wall = {plat_micros(), 0};
+  uint64_t pass_offset_us = 0, span_us = 0;
+  bool ok = true;
+  for (uint16_t pass = 0; ok && pass < loops; ++pass) {
+    if (pass && !can_log_open(&s_reader, cfg->path)) break;
+    can_frame_t f;
+    uint64_t t_us, first_us = 0;
+    bool first = true;
+    while (ok && can_log_next(&s_reader, &f, &t_us)) {
+      if (first) {
+        first_us = t_us;
+        first = false;
+      }
+      const uint64_t rec_us = t_us >= first_us ? t_us - first_us : 0;
+      if (rec_us > span_us) span_us = rec_us;
+      if (cfg->speed > 0) {
+        // Sleep to within ~2 ms of the due time, then spin.
+        const uint64_t due = (uint64_t)((double)(pass_offset_us + rec_us) / cfg->speed);
+        uint64_t now = wall.now();
+        for (; now < due; now = wall.now()) {
+          if (due - now >= 2000) plat_delay_ms((uint32_t)((due - now) / 1000) - 1);
+        }
+        if (now > due + 1000) {
+          r->late_frames++;
+          if (now - due > r->max_late_us) r->max_late_us = (uint32_t)(now - due);
+        }
+      }
+      if (!inject(&f, r) || s_cancel.load(std::memory_order_relaxed)) {
+        ok = false;
+        break;
+      }
+      r->frames++;
+    }
+    r->bad_lines += s_reader.bad_lines;
+    can_log_close(&s_reader);
+    pass_offset_us += span_us + 1000;
+  }
+
+  // Wait for the bus task to drain what is queued.
+  const uint32_t since = plat_millis();
+  while (can_rx_pending() && plat_millis() - since < CAN_REPLAY_STALL_MS) plat_delay_ms(1);
+  r->stalled = can_rx_pending() != 0 || (!ok && !s_cancel.load());
+  const uint64_t wall_us = wall.now();
+  s_observe.store(false);
+  if (restore) {
+    can_rx_end();
+    if (!can_rx_begin(&live)) DBG_LOGW("[replay] live CAN backend did not restart");
+  }
+
+  n2k_decode_get_stats(&d1);
+  r->recorded_ms = (uint32_t)(((uint64_t)loops * span_us) / 1000);
+  r->wall_ms = (uint32_t)(wall_us / 1000);
+  r->frames_per_s = wall_us ? (uint32_t)((uint64_t)r->frames * 1000000 / wall_us) : 0;
+  r->messages = d1.messages - d0.messages;
+  r->signals = s_signals.load(std::memory_order_relaxed);
+  fill_latency(r);
+  const double recorded_s = (double)loops * span_us / 1e6;
+  for (int s = 0; s < SIG_COUNT; ++s) {
+    r->update_hz[s] = recorded_s > 0 ? (float)(s_sig_updates[s].load(std::memory_order_relaxed) / recorded_s) : 0;
+  }
+  if (r->stalled) DBG_LOGW("[replay] decoder stopped draining the RX ring; is the bus task running?");
+  return !r->stalled;
+}
+
+void can_replay_log_report(const can_replay_report_t* r) {
+  DBG_LOGI("[replay] %u frames in %u ms (recorded %u ms): %u frames/s, %u msgs, %u signals, "
+           "waits=%u late=%u max_late_us=%u bad_lines=%u%s",
+           (unsigned)r->frames, (unsigned)r->wall_ms, (unsigned)r->recorded_ms, (unsigned)r->frames_per_s,
+           (unsigned)r->messages, (unsigned)r->signals, (unsigned)r->ring_full_waits, (unsigned)r->late_frames,
+           (unsigned)r->max_late_us, (unsigned)r->bad_lines, r->stalled ? " STALLED" : "");
+  DBG_LOGI("[replay] latency frame->publish us p50<=%u p95<=%u p99<=%u max=%u", (unsigned)r->latency_p50_us,
+           (unsigned)r->latency_p95_us, (unsigned)r->latency_p99_us, (unsigned)r->latency_max_us);
+  for (int s = 0; s < SIG_COUNT; ++s) {
+    if (r->update_hz[s] > 0) DBG_LOGI("[replay]   %-16s %7.2f Hz", k_signal_meta[s].key, (double)r->update_hz[s]);
+  }
+}
+
+static void can_replay_task(void*) {
+  can_replay_report_t r;
+  can_replay_run(&s_task_cfg, &r);
+  s_last_report = r;
+  can_replay_log_report(&r);
+  s_task_alive.store(false);
+  plat_task_exit();
+}
+
+bool can_replay_start(const can_replay_config_t* cfg) {
+  if (s_task_alive.load() || !cfg->path) return false;
+  strncpy(s_task_path, cfg->path, sizeof(s_task_path) - 1);
+  s_task_path[sizeof(s_task_path) - 1] = '\0';
+  s_task_cfg = *cfg;
+  s_task_cfg.path = s_task_path;
+  s_cancel.store(false);
+  s_task_alive.store(true);
+  if (!plat_task_start(can_replay_task, "replay", 6144, CAN_REPLAY_TASK_PRIO, -1, nullptr)) {
+    s_task_alive.store(false);
+    return false;
+  }
+  return true;
+}
+
+bool can_replay_running(void) {
+  return s_task_alive.load();
+}
+
+void can_replay_stop(void) {
+  s_cancel.store(true);
+  while (s_task_alive.load()) plat_delay_ms(10);
+}
+
+void can_replay_get_report(can_replay_report_t* out) {
+  *out = s_last_report;
+}
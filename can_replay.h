@@ -0,0 +1,66 @@
+#pragma once
+
+#include "signals.h"
+#include <stdint.h>
+
+// Replays a raw CAN capture (can_capture.h, candump text or binary) into the
+// CAN RX ring, so the whole ingest path (reassembly, decode, signal store,
+// history, SD logger) runs on recorded traffic, on the P4 or on a host.
+//
+// Pacing follows the capture timestamps at `speed` times real time, or as
+// fast as the bus task drains the ring with speed 0; frames are never
+// dropped, the replayer waits on a full ring instead. Each injected frame
+// is stamped with plat_micros(), so the bus task's callback
+// (can_replay_observe) measures injection-to-publish latency.
+//
+// The RX ring has a single producer: a live backend is stopped for the
+// replay and restarted, with its acceptance filters, when it ends. For a
+// replay-only setup start the bus task with can_rx_config_t::no_backend.
+
+#ifndef CAN_REPLAY_TASK_PRIO
+  #define CAN_REPLAY_TASK_PRIO  4      // below the bus task
+#endif
+#ifndef CAN_REPLAY_STALL_MS
+  #define CAN_REPLAY_STALL_MS   2000   // give up if the ring does not drain for this long
+#endif
+
+struct can_replay_config_t {
+  const char* path;      // relative to the storage root
+  float       speed;     // 1 = recorded pace, N = N times faster, 0 = max
+  uint16_t    loops;     // passes over the file (0 = 1)
+};
+
+struct can_replay_report_t {
+  uint32_t frames;
+  uint32_t bad_lines;          // unparsable capture lines skipped
+  uint32_t ring_full_waits;    // injection waited for the decoder
+  uint32_t late_frames;        // paced: injected more than 1 ms after due
+  uint32_t max_late_us;
+  uint32_t recorded_ms;        // capture span, all passes
+  uint32_t wall_ms;            // first injection until the ring drained
+  uint32_t frames_per_s;       // end-to-end ingest throughput
+  uint32_t messages;           // decoded PGNs (n2k_decode.h)
+  uint32_t signals;            // values published
+  uint32_t latency_p50_us;     // frame injection -> signal published
+  uint32_t latency_p95_us;
+  uint32_t latency_p99_us;
+  uint32_t latency_max_us;
+  float    update_hz[SIG_COUNT];   // per second of recorded time
+  bool     stalled;            // decoder stopped draining; replay aborted
+};
+
+// Blocking replay in the caller's task. False if the file cannot be read
+// or the decoder stalled.
+bool can_replay_run(const can_replay_config_t* cfg, can_replay_report_t* out);
+
+// Background replay; the report is logged when it finishes. `cfg->path` is
+// copied.
+bool can_replay_start(const can_replay_config_t* cfg);
+bool can_replay_running(void);
+void can_replay_stop(void);
+void can_replay_get_report(can_replay_report_t* out);   // last finished replay
+void can_replay_log_report(const can_replay_report_t* r);
+
+// Bus task, once per published signal: `frame_t_us` is the receive stamp of
+// the frame that completed the message. A no-op unless a replay is running.
+void can_replay_observe(signal_id_t sig, uint32_t frame_t_us);
@@ -0,0 +1,154 @@
+#include "can_rx.h"
+#include "can_capture.h"
+#include "bus_stats.h"
+#include "spsc_ring.h"
+#include "pins_config.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <atomic>
+#include <string.h>
+
+static spsc_ring<can_frame_t, CAN_RX_RING_SIZE> s_ring;
+static std::atomic<uint32_t> s_rx_frames{0};
+static bool s_running = false;
+static bool s_backend = false;
+static can_rx_config_t s_cfg;                              // of the running ring
+static can_id_filter_t s_filters[CAN_RX_MAX_FILTERS];      // last requested set
+static uint8_t         s_filter_count = 0;
+
+void can_rx_default_config(can_rx_config_t* cfg) {
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->tx_pin = CAN_TX_PIN;
+  cfg->rx_pin = CAN_RX_PIN;
+  cfg->bitrate = 250000;
+  cfg->listen_only = false;
+  cfg->ifname = "vcan0";
+  cfg->no_backend = false;
+}
+
+bool can_rx_begin(const can_rx_config_t* cfg) {
+  if (s_running) return true;
+  can_rx_config_t defaults;
+  if (!cfg) {
+    can_rx_default_config(&defaults);
+    cfg = &defaults;
+  }
+  bus_stats_begin(cfg->bitrate, plat_millis());
+  s_cfg = *cfg;
+  if (cfg->no_backend) {
+    s_running = true;
+    s_backend = false;
+    DBG_LOGI("[can] rx ring only (no backend), ring=%u frames", (unsigned)CAN_RX_RING_SIZE);
+    return true;
+  }
+  s_running = s_backend = can_backend_begin(cfg);
+  if (s_running && s_filter_count) {
+    // Filters requested while the backend was stopped (e.g. during a replay).
+    can_id_filter_t applied[CAN_RX_MAX_FILTERS];
+    can_backend_set_filters(s_filters, s_filter_count, applied);
+  }
+  if (s_running) {
+    DBG_LOGI("[can] rx started: %u bit/s, ring=%u frames", (unsigned)cfg->bitrate,
+             (unsigned)CAN_RX_RING_SIZE);
+  } else {
+    DBG_LOGW("[can] rx backend failed to start");
+  }
+  return s_running;
+}
+
+bool can_rx_get_config(can_rx_config_t* out) {
+  if (s_running) *out = s_cfg;
+  return s_running;
+}
+
+void can_rx_end(void) {
+  if (!s_running) return;
+  if (s_backend) can_backend_end();
+  s_running = s_backend = false;
+}
+
+int can_rx_set_filters(const can_id_filter_t* filters, uint8_t count, can_id_filter_t* applied) {
+  if (count > CAN_RX_MAX_FILTERS) count = 0;   // too many to express: accept all
+  if (count) memcpy(s_filters, filters, count * sizeof(filters[0]));
+  s_filter_count = count;
+  if (!s_backend) return -1;
+  return can_backend_set_filters(filters, count, applied);
+}
+
+static uint64_t span_of(uint32_t mask) {
+  return 1ull << (29 - __builtin_popcount(mask & 0x1FFFFFFFu));
+}
+
+static can_id_filter_t join(const can_id_filter_t& a, const can_id_filter_t& b) {
+  const uint32_t mask = a.mask & b.mask & ~(a.id ^ b.id);
+  return {a.id & mask, mask};
+}
+
+uint8_t can_filters_merge(const can_id_filter_t* in, uint8_t n, uint32_t settable,
+                          can_id_filter_t* out, uint8_t max_out) {
+  if (!max_out) return 0;
+  can_id_filter_t f[CAN_RX_MAX_FILTERS];
+  if (n > CAN_RX_MAX_FILTERS) n = CAN_RX_MAX_FILTERS;
+  for (uint8_t i = 0; i < n; ++i) {
+    f[i].mask = in[i].mask & settable & 0x1FFFFFFFu;
+    f[i].id = in[i].id & f[i].mask;
+  }
+  // Agglomerative: O(n^3) for n <= 64, only run when subscriptions change.
+  while (n > max_out) {
+    uint8_t bi = 0, bj = 1;
+    int64_t best = INT64_MAX;
+    for (uint8_t i = 0; i < n; ++i) {
+      for (uint8_t j = i + 1; j < n; ++j) {
+        const int64_t grow = (int64_t)span_of(join(f[i], f[j]).mask) - (int64_t)span_of(f[i].mask) -
+                             (int64_t)span_of(f[j].mask);
+        if (grow < best) {
+          best = grow;
+          bi = i;
+          bj = j;
+        }
+      }
+    }
+    f[bi] = join(f[bi], f[bj]);
+    f[bj] = f[--n];
+  }
+  memcpy(out, f, n * sizeof(f[0]));
+  return n;
+}
+
+uint64_t can_filters_span(const can_id_filter_t* f, uint8_t n) {
+  uint64_t span = 0;
+  for (uint8_t i = 0; i < n; ++i) span += span_of(f[i].mask);
+  return span;
+}
+
+bool can_filters_match(const can_id_filter_t* f, uint8_t n, uint32_t id) {
+  for (uint8_t i = 0; i < n; ++i) {
+    if (((id ^ f[i].id) & f[i].mask) == 0) return true;
+  }
+  return false;
+}
+
+bool can_rx_push(const can_frame_t* frame) {
+  can_capture_feed(frame);
+  bus_stats_feed(frame);
+  if (!s_ring.push(*frame)) return false;
+  s_rx_frames.store(s_rx_frames.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  return true;
+}
+
+bool can_rx_pop(can_frame_t* out) {
+  return s_ring.pop(out);
+}
+
+uint32_t can_rx_pending(void) {
+  return s_ring.size();
+}
+
+void can_rx_get_stats(can_rx_stats_t* out) {
+  memset(out, 0, sizeof(*out));
+  out->rx_frames = s_rx_frames.load(std::memory_order_relaxed);
+  out->ring_overruns = s_ring.overruns();
+  out->ring_high_water = s_ring.high_water();
+  if (s_backend) can_backend_poll_stats(out);
+}
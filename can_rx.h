@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+
+// CAN receive layer (TJA1050 transceiver, NMEA2000 at 250 kbit/s).
+//
+// A backend receives frames, timestamps them and pushes them into one
+// fixed-capacity SPSC ring; the bus decoder pops them. Backends:
+//   - ESP32-P4: TWAI driver + high-priority RX pump task   (can_twai.cpp)
+//   - Linux host: SocketCAN (e.g. vcan0) reader thread     (can_socketcan.cpp)
+//   - none: frames come from can_rx_push() only (replay, can_replay.h)
+
+#ifndef CAN_RX_RING_SIZE
+  #define CAN_RX_RING_SIZE 512   // ~270 ms of a saturated 250 kbit/s bus
+#endif
+
+enum : uint8_t {
+  CAN_FRAME_EXT = 1u << 0,   // 29-bit identifier
+  CAN_FRAME_RTR = 1u << 1,
+};
+
+struct can_frame_t {
+  uint32_t t_us;      // receive timestamp (plat_micros)
+  uint32_t id;
+  uint8_t  dlc;
+  uint8_t  flags;
+  uint8_t  data[8];
+};
+
+struct can_rx_config_t {
+  int         tx_pin;
+  int         rx_pin;
+  uint32_t    bitrate;
+  bool        listen_only;
+  const char* ifname;     // SocketCAN interface (host backend)
+  bool        no_backend; // ring fed by can_rx_push() only
+};
+
+struct can_rx_stats_t {
+  uint32_t rx_frames;        // pushed into the ring
+  uint32_t ring_overruns;    // dropped because the decoder fell behind
+  uint32_t ring_high_water;
+  uint32_t driver_overruns;  // dropped by the controller/driver queue
+  uint32_t bus_errors;
+};
+
+// Acceptance filter on the 29-bit identifier: an extended data frame passes
+// if (frame.id & mask) == (id & mask).
+struct can_id_filter_t {
+  uint32_t id;
+  uint32_t mask;
+};
+
+#ifndef CAN_RX_MAX_FILTERS
+  #define CAN_RX_MAX_FILTERS 64
+#endif
+
+void can_rx_default_config(can_rx_config_t* cfg);
+
+bool can_rx_begin(const can_rx_config_t* cfg);
+void can_rx_end(void);
+// Configuration the ring was started with; false if it is stopped.
+bool can_rx_get_config(can_rx_config_t* out);
+
+// Consumer side (bus decoder task).
+bool     can_rx_pop(can_frame_t* out);
+uint32_t can_rx_pending(void);
+void     can_rx_get_stats(can_rx_stats_t* out);
+
+// Replaces the backend's acceptance filters (count 0 = accept everything).
+// A backend with fewer or narrower filter slots than requested widens them
+// (can_filters_merge), so it always accepts a superset. Returns the number
+// of filters programmed, written to `applied` if non-null (up to
+// CAN_RX_MAX_FILTERS), or -1 if the backend cannot filter. The last set is
+// kept and programmed again when a backend (re)starts. Not concurrent with
+// can_rx_begin()/can_rx_end().
+int can_rx_set_filters(const can_id_filter_t* filters, uint8_t count, can_id_filter_t* applied);
+
+// Merges `n` filters into at most `max_out` that compare only the bits in
+// `settable`, greedily joining the pair that adds the fewest accepted IDs.
+// Returns the number written.
+uint8_t can_filters_merge(const can_id_filter_t* in, uint8_t n, uint32_t settable,
+                          can_id_filter_t* out, uint8_t max_out);
+// Distinct 29-bit IDs accepted by the filters (overlaps counted twice).
+uint64_t can_filters_span(const can_id_filter_t* f, uint8_t n);
+bool     can_filters_match(const can_id_filter_t* f, uint8_t n, uint32_t id);
+
+// Producer side, for backends and replay only: one producer at a time.
+// Also feeds a running raw capture (can_capture.h).
+bool can_rx_push(const can_frame_t* frame);
+
+// Implemented by the active backend.
+bool can_backend_begin(const can_rx_config_t* cfg);
+void can_backend_end(void);
+void can_backend_poll_stats(can_rx_stats_t* stats);
+int  can_backend_set_filters(const can_id_filter_t* filters, uint8_t count, can_id_filter_t* applied);
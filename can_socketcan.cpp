@@ -0,0 +1,143 @@
+// SocketCAN backend for can_rx on a Linux host (vcan0 or a USB-CAN adapter).
+//
+//   sudo modprobe vcan && sudo ip link add dev vcan0 type vcan && sudo ip link set up vcan0
+//   canplayer / cangen vcan0 -e -g 0 ...   // saturate the bus
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include "can_rx.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <atomic>
+#include <errno.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static int                   s_fd = -1;
+static std::atomic<bool>     s_stop{false};
+static std::atomic<bool>     s_reader_alive{false};
+static std::atomic<uint32_t> s_driver_overruns{0};
+static std::atomic<uint32_t> s_bus_errors{0};
+
+static void can_socketcan_reader(void*) {
+  while (!s_stop.load(std::memory_order_relaxed)) {
+    struct can_frame raw;
+    char ctrl[CMSG_SPACE(sizeof(uint32_t))];
+    struct iovec iov = {&raw, sizeof(raw)};
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl;
+    msg.msg_controllen = sizeof(ctrl);
+    const ssize_t n = recvmsg(s_fd, &msg, 0);
+    if (n != (ssize_t)sizeof(raw)) {
+      if (n < 0 && errno == EINTR) continue;
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) continue;  // SO_RCVTIMEO tick
+      if (!s_stop.load()) DBG_LOGW("[can] socketcan read failed: %s", strerror(errno));
+      break;
+    }
+    // SO_RXQ_OVFL: cumulative frames the kernel dropped on this socket.
+    for (struct cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+      if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_RXQ_OVFL) {
+        uint32_t dropped;
+        memcpy(&dropped, CMSG_DATA(c), sizeof(dropped));
+        s_driver_overruns.store(dropped, std::memory_order_relaxed);
+      }
+    }
+    if (raw.can_id & CAN_ERR_FLAG) {
+      s_bus_errors.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+
+    can_frame_t f;
+    f.t_us = plat_micros();
+    f.id = raw.can_id & ((raw.can_id & CAN_EFF_FLAG) ? CAN_EFF_MASK : CAN_SFF_MASK);
+    f.dlc = raw.can_dlc > 8 ? 8 : raw.can_dlc;
+    f.flags = ((raw.can_id & CAN_EFF_FLAG) ? CAN_FRAME_EXT : 0) | ((raw.can_id & CAN_RTR_FLAG) ? CAN_FRAME_RTR : 0);
+    memcpy(f.data, raw.data, 8);
+    can_rx_push(&f);
+  }
+  s_reader_alive.store(false);
+}
+
+bool can_backend_begin(const can_rx_config_t* cfg) {
+  s_fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+  if (s_fd < 0) {
+    DBG_LOGE("[can] socket(PF_CAN) failed: %s", strerror(errno));
+    return false;
+  }
+
+  struct ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, cfg->ifname ? cfg->ifname : "vcan0", IFNAMSIZ - 1);
+  struct sockaddr_can addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.can_family = AF_CAN;
+  if (ioctl(s_fd, SIOCGIFINDEX, &ifr) < 0 ||
+      (addr.can_ifindex = ifr.ifr_ifindex, bind(s_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0)) {
+    DBG_LOGE("[can] bind %s failed: %s", ifr.ifr_name, strerror(errno));
+    close(s_fd);
+    s_fd = -1;
+    return false;
+  }
+
+  // Large kernel buffer so a slow consumer shows up as ring overruns, and a
+  // receive timeout so the reader notices can_rx_end().
+  int rcvbuf = 1 << 20;
+  setsockopt(s_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  struct timeval tv = {0, 100000};
+  setsockopt(s_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  int on = 1;
+  setsockopt(s_fd, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on));
+  can_err_mask_t err_mask = CAN_ERR_MASK;
+  setsockopt(s_fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &err_mask, sizeof(err_mask));
+
+  s_stop.store(false);
+  s_reader_alive.store(true);
+  plat_task_start(can_socketcan_reader, "can_rx", 0, 0, -1, nullptr);
+  DBG_LOGI("[can] socketcan on %s", ifr.ifr_name);
+  return true;
+}
+
+void can_backend_end(void) {
+  s_stop.store(true);
+  while (s_reader_alive.load()) plat_delay_ms(10);
+  close(s_fd);
+  s_fd = -1;
+}
+
+// The kernel filters in the socket, any number of them; error frames are
+// governed by CAN_RAW_ERR_FILTER and unaffected.
+int can_backend_set_filters(const can_id_filter_t* filters, uint8_t count, can_id_filter_t* applied) {
+  if (s_fd < 0) return -1;
+  struct can_filter kf[CAN_RX_MAX_FILTERS];
+  for (uint8_t i = 0; i < count; ++i) {
+    kf[i].can_id = (filters[i].id & CAN_EFF_MASK) | CAN_EFF_FLAG;
+    kf[i].can_mask = (filters[i].mask & CAN_EFF_MASK) | CAN_EFF_FLAG | CAN_RTR_FLAG;
+  }
+  if (!count) {
+    kf[0].can_id = 0;
+    kf[0].can_mask = 0;
+  }
+  if (setsockopt(s_fd, SOL_CAN_RAW, CAN_RAW_FILTER, kf, (socklen_t)((count ? count : 1) * sizeof(kf[0]))) < 0) {
+    DBG_LOGW("[can] CAN_RAW_FILTER: %s", strerror(errno));
+    return -1;
+  }
+  if (applied && count) memcpy(applied, filters, count * sizeof(filters[0]));
+  return count;
+}
+
+void can_backend_poll_stats(can_rx_stats_t* stats) {
+  stats->driver_overruns = s_driver_overruns.load(std::memory_order_relaxed);
+  stats->bus_errors = s_bus_errors.load(std::memory_order_relaxed);
+}
+
+#endif  // __linux__ && !ARDUINO
@@ -0,0 +1,179 @@
+// TWAI (ESP32-P4 on-chip CAN controller) backend for can_rx.
+#if defined(ARDUINO)
+
+#include "can_rx.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include "driver/twai.h"
+#include <atomic>
+#include <string.h>
+
+#ifndef CAN_TWAI_DRIVER_QUEUE
+  #define CAN_TWAI_DRIVER_QUEUE 64
+#endif
+#ifndef CAN_TWAI_TASK_PRIO
+  #define CAN_TWAI_TASK_PRIO (configMAX_PRIORITIES - 2)   // above LVGL and loop()
+#endif
+#ifndef CAN_TWAI_TASK_CORE
+  #define CAN_TWAI_TASK_CORE 0
+#endif
+
+static std::atomic<bool>     s_stop{false};
+static std::atomic<bool>     s_pump_alive{false};
+static std::atomic<uint32_t> s_driver_overruns{0};
+static std::atomic<uint32_t> s_bus_errors{0};
+
+static void refresh_driver_counters() {
+  twai_status_info_t st;
+  if (twai_get_status_info(&st) != ESP_OK) return;
+  s_driver_overruns.store(st.rx_missed_count + st.rx_overrun_count, std::memory_order_relaxed);
+  s_bus_errors.store(st.bus_error_count, std::memory_order_relaxed);
+}
+
+// The driver ISR fills its own queue; this task drains it into the SPSC ring
+// with the receive timestamp, so the decoder never touches the driver.
+static void can_twai_pump_task(void*) {
+  uint32_t since_status = 0;
+  while (!s_stop.load(std::memory_order_relaxed)) {
+    twai_message_t msg;
+    const esp_err_t err = twai_receive(&msg, pdMS_TO_TICKS(100));
+    if (err == ESP_OK) {
+      can_frame_t f;
+      f.t_us = plat_micros();
+      f.id = msg.identifier;
+      f.dlc = msg.data_length_code > 8 ? 8 : msg.data_length_code;
+      f.flags = (msg.extd ? CAN_FRAME_EXT : 0) | (msg.rtr ? CAN_FRAME_RTR : 0);
+      memcpy(f.data, msg.data, 8);
+      can_rx_push(&f);
+      if (++since_status < 256) continue;
+    }
+    since_status = 0;
+    refresh_driver_counters();
+  }
+  s_pump_alive.store(false);
+  plat_task_exit();
+}
+
+static bool timing_for(uint32_t bitrate, twai_timing_config_t* t) {
+  switch (bitrate) {
+    case 125000:  { twai_timing_config_t c = TWAI_TIMING_CONFIG_125KBITS(); *t = c; return true; }
+    case 250000:  { twai_timing_config_t c = TWAI_TIMING_CONFIG_250KBITS(); *t = c; return true; }
+    case 500000:  { twai_timing_config_t c = TWAI_TIMING_CONFIG_500KBITS(); *t = c; return true; }
+    case 1000000: { twai_timing_config_t c = TWAI_TIMING_CONFIG_1MBITS();   *t = c; return true; }
+    default: return false;
+  }
+}
+
+// Kept for driver reinstalls when the acceptance filter changes.
+static twai_general_config_t s_g_config;
+static twai_timing_config_t  s_t_config;
+static twai_filter_config_t  s_f_config;
+
+static bool start_driver(void) {
+  esp_err_t err = twai_driver_install(&s_g_config, &s_t_config, &s_f_config);
+  if (err != ESP_OK) {
+    DBG_LOGE("[can] twai_driver_install failed: %s", esp_err_to_name(err));
+    return false;
+  }
+  err = twai_start();
+  if (err != ESP_OK) {
+    DBG_LOGE("[can] twai_start failed: %s", esp_err_to_name(err));
+    twai_driver_uninstall();
+    return false;
+  }
+
+  s_stop.store(false);
+  s_pump_alive.store(true);
+  if (!plat_task_start(can_twai_pump_task, "can_rx", 4096, CAN_TWAI_TASK_PRIO, CAN_TWAI_TASK_CORE, nullptr)) {
+    s_pump_alive.store(false);
+    twai_stop();
+    twai_driver_uninstall();
+    DBG_LOGE("[can] rx pump task create failed");
+    return false;
+  }
+  return true;
+}
+
+static void stop_driver(void) {
+  s_stop.store(true);
+  while (s_pump_alive.load()) plat_delay_ms(10);
+  twai_stop();
+  twai_driver_uninstall();
+}
+
+bool can_backend_begin(const can_rx_config_t* cfg) {
+  if (!timing_for(cfg->bitrate, &s_t_config)) {
+    DBG_LOGE("[can] unsupported bitrate %u", (unsigned)cfg->bitrate);
+    return false;
+  }
+  const twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT(
+      (gpio_num_t)cfg->tx_pin, (gpio_num_t)cfg->rx_pin,
+      cfg->listen_only ? TWAI_MODE_LISTEN_ONLY : TWAI_MODE_NORMAL);
+  s_g_config = g_config;
+  s_g_config.rx_queue_len = CAN_TWAI_DRIVER_QUEUE;
+  s_g_config.tx_queue_len = 4;
+  const twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+  s_f_config = f_config;
+
+  if (!start_driver()) return false;
+  DBG_LOGI("[can] twai tx=%d rx=%d %s", cfg->tx_pin, cfg->rx_pin, cfg->listen_only ? "listen-only" : "normal");
+  return true;
+}
+
+void can_backend_end(void) {
+  stop_driver();
+}
+
+// The controller has one acceptance filter: either a single filter over
+// the full 29-bit ID, or two filters over ID bits 28..13 only (dual mode).
+// Code/mask registers are left-aligned and a mask bit of 1 means "don't
+// care". The mode that accepts fewer IDs wins.
+static constexpr uint32_t DUAL_SETTABLE = 0x1FFFE000u;
+
+int can_backend_set_filters(const can_id_filter_t* filters, uint8_t count, can_id_filter_t* applied) {
+  const twai_filter_config_t accept_all = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+  twai_filter_config_t fc = accept_all;
+  can_id_filter_t single, dual[2];
+  uint8_t used = 0;
+  if (count) {
+    can_filters_merge(filters, count, 0x1FFFFFFFu, &single, 1);
+    const uint8_t n_dual = can_filters_merge(filters, count, DUAL_SETTABLE, dual, 2);
+    if (n_dual == 2 && can_filters_span(dual, 2) < can_filters_span(&single, 1)) {
+      fc.single_filter = false;
+      fc.acceptance_code = ((dual[0].id >> 13) << 16) | ((dual[1].id >> 13) & 0xFFFF);
+      fc.acceptance_mask = ((~dual[0].mask >> 13) << 16) | ((~dual[1].mask >> 13) & 0xFFFF);
+      used = 2;
+      if (applied) memcpy(applied, dual, sizeof(dual));
+    } else {
+      fc.single_filter = true;
+      fc.acceptance_code = single.id << 3;
+      fc.acceptance_mask = (~single.mask << 3) | 0x7;   // RTR and unused bits: don't care
+      used = 1;
+      if (applied) *applied = single;
+    }
+  }
+  if (fc.acceptance_code == s_f_config.acceptance_code && fc.acceptance_mask == s_f_config.acceptance_mask &&
+      fc.single_filter == s_f_config.single_filter) {
+    return used;
+  }
+  // No runtime filter update in the driver: reinstall. Frames arriving in
+  // the few ms this takes are lost.
+  stop_driver();
+  s_f_config = fc;
+  if (!start_driver()) {
+    s_f_config = accept_all;
+    start_driver();
+    return -1;
+  }
+  DBG_LOGI("[can] twai filter %s code=%08X mask=%08X", fc.single_filter ? "single" : "dual",
+           (unsigned)fc.acceptance_code, (unsigned)fc.acceptance_mask);
+  return used;
+}
+
+void can_backend_poll_stats(can_rx_stats_t* stats) {
+  stats->driver_overruns = s_driver_overruns.load(std::memory_order_relaxed);
+  stats->bus_errors = s_bus_errors.load(std::memory_order_relaxed);
+}
+
+#endif  // ARDUINO
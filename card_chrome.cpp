@@ -0,0 +1,274 @@
+#include "card_chrome.h"
+#include "raster_util.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <string.h>
+
+struct chrome_slot_t {
+  lv_img_dsc_t      img;
+  uint32_t          key;
+  uint16_t          refs;
+  card_chrome_dsc_t dsc;     // what the image was rendered from
+  lv_color_t        outer;
+};
+
+struct chrome_card_t {
+  lv_obj_t*          card;
+  card_chrome_dsc_t  dsc;
+  lv_color_t         outer;    // backdrop in the corners, from the parent
+  int8_t             slot;     // -1 when no image is bound
+  lv_obj_t*          caption;  // live chrome for the uncached fallback
+  lv_obj_t*          divider;
+  chrome_card_t*     next;
+};
+
+static chrome_slot_t  s_slots[CARD_CHROME_CACHE_SLOTS];
+static chrome_card_t* s_cards = nullptr;
+static size_t         s_cache_bytes = 0;
+
+static uint32_t fnv1a(uint32_t h, const void* data, size_t len) {
+  const uint8_t* p = (const uint8_t*)data;
+  for (size_t i = 0; i < len; ++i) h = (h ^ p[i]) * 16777619u;
+  return h;
+}
+
+// Field by field: the descriptor has padding, and the caption is hashed by
+// content so equal captions from different literals share an image.
+static uint32_t chrome_key(const card_chrome_dsc_t* d, lv_color_t outer, lv_coord_t w, lv_coord_t h) {
+  const lv_coord_t coords[] = {w, h, d->caption_x, d->caption_y, d->radius, d->outline_width, d->divider_height,
+                               d->divider_bottom, d->pad_left, d->pad_right, d->pad_bottom};
+  const uint32_t colors[] = {outer.full, d->caption_color.full, d->bg_color.full, d->outline_color.full,
+                             d->accent_color.full};
+  const lv_opa_t opas[] = {d->outline_opa, d->accent_opa};
+  uint32_t k = 2166136261u;
+  k = fnv1a(k, coords, sizeof(coords));
+  k = fnv1a(k, colors, sizeof(colors));
+  k = fnv1a(k, opas, sizeof(opas));
+  k = fnv1a(k, &d->caption_font, sizeof(d->caption_font));
+  if (d->caption) k = fnv1a(k, d->caption, strlen(d->caption));
+  return k;
+}
+
+static bool same_color(lv_color_t a, lv_color_t b) { return a.full == b.full; }
+
+// Full comparison behind a key match, so a hash collision cannot hand out
+// another card's image.
+static bool chrome_same(const chrome_slot_t* s, const card_chrome_dsc_t* d, lv_color_t outer) {
+  const card_chrome_dsc_t* e = &s->dsc;
+  const bool captions = (!e->caption || !d->caption) ? e->caption == d->caption : strcmp(e->caption, d->caption) == 0;
+  return captions && e->caption_font == d->caption_font && same_color(e->caption_color, d->caption_color) &&
+         e->caption_x == d->caption_x && e->caption_y == d->caption_y && same_color(e->bg_color, d->bg_color) &&
+         e->radius == d->radius && same_color(e->outline_color, d->outline_color) &&
+         e->outline_opa == d->outline_opa && e->outline_width == d->outline_width &&
+         same_color(e->accent_color, d->accent_color) && e->accent_opa == d->accent_opa &&
+         e->divider_height == d->divider_height && e->divider_bottom == d->divider_bottom &&
+         e->pad_left == d->pad_left && e->pad_right == d->pad_right && e->pad_bottom == d->pad_bottom &&
+         same_color(s->outer, outer);
+}
+
+static void render_chrome(const card_chrome_dsc_t* d, lv_color_t outer, raster_buf_t* b) {
+  raster_fill(b, outer);
+
+  lv_area_t a = {0, 0, (lv_coord_t)(b->w - 1), (lv_coord_t)(b->h - 1)};
+  if (d->outline_width > 0 && d->outline_opa > 0) {
+    raster_round_rect(b, &a, d->radius, d->bg_color, LV_OPA_COVER);
+    raster_round_rect(b, &a, d->radius, d->outline_color, d->outline_opa);
+    a.x1 += d->outline_width; a.y1 += d->outline_width;
+    a.x2 -= d->outline_width; a.y2 -= d->outline_width;
+    const lv_coord_t inner_r = (d->radius > d->outline_width) ? d->radius - d->outline_width : 0;
+    raster_round_rect(b, &a, inner_r, d->bg_color, LV_OPA_COVER);
+  } else {
+    raster_round_rect(b, &a, d->radius, d->bg_color, LV_OPA_COVER);
+  }
+
+  if (d->divider_height > 0) {
+    lv_area_t div;
+    div.x1 = d->pad_left;
+    div.x2 = b->w - 1 - d->pad_right;
+    div.y2 = b->h - 1 - d->pad_bottom - d->divider_bottom;
+    div.y1 = div.y2 - d->divider_height + 1;
+    raster_round_rect(b, &div, 0, d->accent_color, d->accent_opa);
+  }
+
+  if (d->caption && d->caption_font) {
+    raster_text(b, d->caption_x, d->caption_y, d->caption_font, d->caption, d->caption_color);
+  }
+}
+
+static void slot_release(int8_t idx) {
+  if (idx < 0) return;
+  chrome_slot_t* s = &s_slots[idx];
+  if (s->refs && --s->refs) return;
+  lv_img_cache_invalidate_src(&s->img);
+  s_cache_bytes -= s->img.data_size;
+  plat_free((void*)s->img.data);
+  memset(s, 0, sizeof(*s));
+}
+
+static int8_t slot_acquire(const card_chrome_dsc_t* d, lv_color_t outer, lv_coord_t w, lv_coord_t h) {
+  const uint32_t key = chrome_key(d, outer, w, h);
+  int8_t free_idx = -1;
+  for (int8_t i = 0; i < CARD_CHROME_CACHE_SLOTS; ++i) {
+    chrome_slot_t* s = &s_slots[i];
+    if (s->refs && s->key == key && s->img.header.w == (uint32_t)w && s->img.header.h == (uint32_t)h &&
+        chrome_same(s, d, outer)) {
+      s->refs++;
+      return i;
+    }
+    if (!s->refs && free_idx < 0) free_idx = i;
+  }
+  if (free_idx < 0) return -1;
+
+  const uint32_t bytes = (uint32_t)w * (uint32_t)h * sizeof(lv_color_t);
+  lv_color_t* px = (lv_color_t*)plat_psram_alloc(bytes);
+  if (!px) return -1;
+
+  raster_buf_t buf = {px, w, h};
+  render_chrome(d, outer, &buf);
+
+  chrome_slot_t* s = &s_slots[free_idx];
+  s->img.header.always_zero = 0;
+  s->img.header.cf = LV_IMG_CF_TRUE_COLOR;
+  s->img.header.w = w;
+  s->img.header.h = h;
+  s->img.data_size = bytes;
+  s->img.data = (const uint8_t*)px;
+  s->key = key;
+  s->refs = 1;
+  s->dsc = *d;
+  s->outer = outer;
+  s_cache_bytes += bytes;
+  return free_idx;
+}
+
+// The colour the rounded corners blend into: the background of the nearest
+// opaque ancestor, or of the screen if none is.
+static lv_color_t backdrop_color(lv_obj_t* card) {
+  lv_obj_t* top = card;
+  for (lv_obj_t* p = lv_obj_get_parent(card); p; p = lv_obj_get_parent(p)) {
+    if (lv_obj_get_style_bg_opa(p, LV_PART_MAIN) >= LV_OPA_COVER) return lv_obj_get_style_bg_color(p, LV_PART_MAIN);
+    top = p;
+  }
+  return lv_obj_get_style_bg_color(top, LV_PART_MAIN);
+}
+
+// Uncached look: LVGL draws the same outline, caption and divider live.
+static void show_live_chrome(chrome_card_t* c, bool show) {
+  const card_chrome_dsc_t* d = &c->dsc;
+  if (show && !c->caption && d->caption && d->caption_font) {
+    // Children sit in the content area; the descriptor is relative to the card.
+    c->caption = lv_label_create(c->card);
+    lv_obj_set_style_text_font(c->caption, d->caption_font, 0);
+    lv_obj_set_style_text_color(c->caption, d->caption_color, 0);
+    lv_label_set_text_static(c->caption, d->caption);
+    lv_label_set_long_mode(c->caption, LV_LABEL_LONG_CLIP);
+    lv_obj_set_width(c->caption, LV_PCT(100));
+    lv_obj_set_pos(c->caption, d->caption_x - lv_obj_get_style_pad_left(c->card, LV_PART_MAIN),
+                   d->caption_y - lv_obj_get_style_pad_top(c->card, LV_PART_MAIN));
+  }
+  if (show && !c->divider && d->divider_height > 0) {
+    c->divider = lv_obj_create(c->card);
+    lv_obj_remove_style_all(c->divider);
+    lv_obj_clear_flag(c->divider, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_style_bg_color(c->divider, d->accent_color, 0);
+    lv_obj_set_style_bg_opa(c->divider, d->accent_opa, 0);
+    lv_obj_set_size(c->divider, LV_PCT(100), d->divider_height);
+    lv_obj_align(c->divider, LV_ALIGN_BOTTOM_LEFT, 0, -d->divider_bottom);
+  }
+  lv_obj_t* const live[2] = {c->caption, c->divider};
+  for (lv_obj_t* o : live) {
+    if (!o) continue;
+    if (show) lv_obj_clear_flag(o, LV_OBJ_FLAG_HIDDEN);
+    else lv_obj_add_flag(o, LV_OBJ_FLAG_HIDDEN);
+  }
+  lv_obj_set_style_outline_color(c->card, d->outline_color, 0);
+  lv_obj_set_style_outline_opa(c->card, d->outline_opa, 0);
+  lv_obj_set_style_outline_width(c->card, show ? d->outline_width : 0, 0);
+}
+
+static void bind_card(chrome_card_t* c) {
+  const lv_coord_t w = lv_obj_get_width(c->card);
+  const lv_coord_t h = lv_obj_get_height(c->card);
+  if (w <= 0 || h <= 0) return;
+
+  const int8_t old = c->slot;
+  c->outer = backdrop_color(c->card);
+  c->slot = slot_acquire(&c->dsc, c->outer, w, h);
+  slot_release(old);
+
+  if (c->slot >= 0) {
+    lv_obj_set_style_bg_opa(c->card, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_radius(c->card, 0, 0);
+    lv_obj_set_style_bg_img_src(c->card, &s_slots[c->slot].img, 0);
+    lv_obj_set_style_bg_img_opa(c->card, LV_OPA_COVER, 0);
+    show_live_chrome(c, false);
+  } else {
+    // Cache full or out of PSRAM: fall back to styled background and objects.
+    DBG_LOGW("[chrome] no cache slot for %dx%d card, drawing uncached", (int)w, (int)h);
+    lv_obj_set_style_bg_img_src(c->card, nullptr, 0);
+    lv_obj_set_style_bg_color(c->card, c->dsc.bg_color, 0);
+    lv_obj_set_style_bg_opa(c->card, LV_OPA_COVER, 0);
+    lv_obj_set_style_radius(c->card, c->dsc.radius, 0);
+    show_live_chrome(c, true);
+  }
+  lv_obj_invalidate(c->card);
+}
+
+static void chrome_event_cb(lv_event_t* e) {
+  chrome_card_t* c = (chrome_card_t*)lv_event_get_user_data(e);
+  switch (lv_event_get_code(e)) {
+    case LV_EVENT_SIZE_CHANGED:
+      bind_card(c);
+      break;
+    case LV_EVENT_COVER_CHECK:
+      // The cached image is opaque edge to edge, so parents need not be drawn.
+      if (c->slot >= 0) {
+        lv_cover_check_info_t* info = (lv_cover_check_info_t*)lv_event_get_param(e);
+        lv_area_t coords;
+        lv_obj_get_coords(c->card, &coords);
+        if (info->res != LV_COVER_RES_MASKED && _lv_area_is_in(info->area, &coords, 0)) {
+          info->res = LV_COVER_RES_COVER;
+        }
+      }
+      break;
+    case LV_EVENT_DELETE: {
+      slot_release(c->slot);
+      chrome_card_t** pp = &s_cards;
+      while (*pp && *pp != c) pp = &(*pp)->next;
+      if (*pp) *pp = c->next;
+      lv_mem_free(c);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void card_chrome_attach(lv_obj_t* card, const card_chrome_dsc_t* dsc) {
+  chrome_card_t* c = (chrome_card_t*)lv_mem_alloc(sizeof(chrome_card_t));
+  if (!c) return;
+  c->card = card;
+  memcpy(&c->dsc, dsc, sizeof(c->dsc));
+  c->slot = -1;
+  c->caption = nullptr;
+  c->divider = nullptr;
+  c->next = s_cards;
+  s_cards = c;
+
+  lv_obj_set_style_outline_width(card, 0, 0);
+  lv_obj_add_event_cb(card, chrome_event_cb, LV_EVENT_ALL, c);
+  bind_card(c);
+}
+
+void card_chrome_invalidate_all(void) {
+  for (chrome_card_t* c = s_cards; c; c = c->next) {
+    slot_release(c->slot);
+    c->slot = -1;
+  }
+  for (chrome_card_t* c = s_cards; c; c = c->next) bind_card(c);
+}
+
+size_t card_chrome_cache_bytes(void) {
+  return s_cache_bytes;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "lvgl.h"
+#include <stddef.h>
+
+// Cached static card chrome.
+//
+// The background, rounded corners, outline, accent divider and caption of a
+// metric card never change, yet LVGL's software renderer redraws them (with
+// radius masks and blending) whenever a value label inside the card is
+// invalidated. card_chrome rasterizes that chrome once into an opaque RGB565
+// image per (size, look) and installs it as the card's background image, so
+// redraws become a plain blit and only the dynamic labels are blended on top.
+//
+// The corners blend into the nearest opaque ancestor's background. Images
+// are rebuilt when a card is resized and on card_chrome_invalidate_all()
+// (theme/style change). If no cache slot or PSRAM is left, the card falls
+// back to LVGL styles plus live caption and divider objects.
+
+#ifndef CARD_CHROME_CACHE_SLOTS
+  #define CARD_CHROME_CACHE_SLOTS 12
+#endif
+
+struct card_chrome_dsc_t {
+  const char*       caption;        // must outlive the card (string literal)
+  const lv_font_t*  caption_font;
+  lv_color_t        caption_color;
+  lv_coord_t        caption_x;      // caption pen position, relative to the card
+  lv_coord_t        caption_y;
+
+  lv_color_t        bg_color;
+  lv_coord_t        radius;
+  lv_color_t        outline_color;
+  lv_opa_t          outline_opa;
+  lv_coord_t        outline_width;  // drawn inside the card edge
+
+  lv_color_t        accent_color;   // divider along the bottom of the content area
+  lv_opa_t          accent_opa;
+  lv_coord_t        divider_height;
+  lv_coord_t        divider_bottom; // gap between divider and content bottom
+  lv_coord_t        pad_left;
+  lv_coord_t        pad_right;
+  lv_coord_t        pad_bottom;
+};
+
+// Attach cached chrome to a card. The card must not carry its own bg/outline
+// styles; the descriptor is copied.
+void card_chrome_attach(lv_obj_t* card, const card_chrome_dsc_t* dsc);
+
+// Drop every cached image and rebuild attached cards (call after theme changes).
+void card_chrome_invalidate_all(void);
+
+// PSRAM currently held by cached chrome images.
+size_t card_chrome_cache_bytes(void);
@@ -0,0 +1,133 @@
+#include "chart_cache.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <atomic>
+#include <string.h>
+
+struct chart_cache_entry_t {
+  chart_cache_key_t key;
+  bool              used;
+  uint8_t           stage;
+  uint16_t          settled;
+  int64_t           first_col;
+  int64_t           clock_off_ms;
+  uint32_t          last_use;
+  history_bucket_t* cols;
+};
+
+// Worker task only.
+static chart_cache_entry_t s_entries[CHART_CACHE_ENTRIES];
+static uint16_t            s_max_columns = 0;
+static uint32_t            s_use_clock = 0;
+
+static std::atomic<uint32_t> s_lookups{0};
+static std::atomic<uint32_t> s_hits{0};
+static std::atomic<uint32_t> s_evictions{0};
+static std::atomic<uint32_t> s_edge_columns{0};
+static std::atomic<uint32_t> s_reused_columns{0};
+static std::atomic<uint32_t> s_entries_used{0};
+
+static inline void bump(std::atomic<uint32_t>& c, uint32_t n = 1) {
+  c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+static bool key_equal(const chart_cache_key_t& a, const chart_cache_key_t& b) {
+  return a.sig == b.sig && a.tier == b.tier && a.columns == b.columns && a.span_s == b.span_s;
+}
+
+bool chart_cache_init(uint16_t max_columns) {
+  if (s_max_columns) return true;
+  for (chart_cache_entry_t& e : s_entries) {
+    e.cols = (history_bucket_t*)plat_psram_alloc(max_columns * sizeof(history_bucket_t));
+    if (!e.cols) {
+      DBG_LOGW("[chart] cache: out of memory");
+      for (chart_cache_entry_t& f : s_entries) {
+        plat_free(f.cols);
+        f.cols = nullptr;
+      }
+      return false;
+    }
+    e.used = false;
+  }
+  s_max_columns = max_columns;
+  return true;
+}
+
+static chart_cache_entry_t* find(const chart_cache_key_t* key) {
+  for (chart_cache_entry_t& e : s_entries) {
+    if (e.used && key_equal(e.key, *key)) return &e;
+  }
+  return nullptr;
+}
+
+static void drop(chart_cache_entry_t* e) {
+  e->used = false;
+  s_entries_used.store(s_entries_used.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+}
+
+uint16_t chart_cache_get(const chart_cache_key_t* key, int64_t first_col, int64_t clock_off_ms,
+                         history_bucket_t* out, uint8_t* stage) {
+  if (!s_max_columns) return 0;
+  bump(s_lookups);
+  chart_cache_entry_t* e = find(key);
+  if (!e) return 0;
+  const int64_t drift = clock_off_ms - e->clock_off_ms;
+  const int64_t shift = first_col - e->first_col;
+  if (drift > CHART_CACHE_CLOCK_SLACK_MS || drift < -CHART_CACHE_CLOCK_SLACK_MS || shift < 0) {
+    drop(e);
+    return 0;
+  }
+  if (shift >= e->settled) return 0;   // window moved past everything stored
+
+  const uint16_t n = (uint16_t)(e->settled - shift);
+  memcpy(out, e->cols + shift, n * sizeof(history_bucket_t));
+  e->last_use = ++s_use_clock;
+  if (stage) *stage = e->stage;
+  bump(s_hits);
+  bump(s_reused_columns, n);
+  bump(s_edge_columns, key->columns - n);
+  return n;
+}
+
+void chart_cache_put(const chart_cache_key_t* key, int64_t first_col, uint16_t settled, int64_t clock_off_ms,
+                     uint8_t stage, const history_bucket_t* cols) {
+  if (!s_max_columns || key->columns > s_max_columns || !settled) return;
+  chart_cache_entry_t* e = find(key);
+  if (!e) {
+    e = &s_entries[0];
+    for (chart_cache_entry_t& c : s_entries) {
+      if (!c.used) {
+        e = &c;
+        break;
+      }
+      if (c.last_use < e->last_use) e = &c;
+    }
+    if (e->used) bump(s_evictions);
+    else bump(s_entries_used);
+  }
+  e->key = *key;
+  e->used = true;
+  e->stage = stage;
+  e->settled = settled > key->columns ? key->columns : settled;
+  e->first_col = first_col;
+  e->clock_off_ms = clock_off_ms;
+  e->last_use = ++s_use_clock;
+  memcpy(e->cols, cols, e->settled * sizeof(history_bucket_t));
+}
+
+void chart_cache_clear(void) {
+  for (chart_cache_entry_t& e : s_entries) e.used = false;
+  s_entries_used.store(0, std::memory_order_relaxed);
+}
+
+void chart_cache_get_stats(chart_cache_stats_t* out) {
+  out->lookups = s_lookups.load(std::memory_order_relaxed);
+  out->hits = s_hits.load(std::memory_order_relaxed);
+  out->misses = out->lookups - out->hits;
+  out->evictions = s_evictions.load(std::memory_order_relaxed);
+  out->edge_columns = s_edge_columns.load(std::memory_order_relaxed);
+  out->reused_columns = s_reused_columns.load(std::memory_order_relaxed);
+  out->entries_used = (uint16_t)s_entries_used.load(std::memory_order_relaxed);
+  out->bytes = s_max_columns ? CHART_CACHE_ENTRIES * s_max_columns * (uint32_t)sizeof(history_bucket_t) : 0;
+}
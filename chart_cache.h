@@ -0,0 +1,64 @@
+#pragma once
+
+#include "signal_history.h"
+#include <stdint.h>
+
+// LRU cache of decimated chart windows for the chart query worker
+// (chart_query.h), keyed by signal, window span, column count and tier.
+//
+// Chart windows are aligned to absolute multiples of the column width, so
+// as time moves on a cached window only shifts: every column that had
+// settled when it was stored is reused as is, and only the newest edge
+// (columns ending less than CHART_CACHE_SETTLE_MS before the request, or
+// not in the entry at all) is recomputed. Flipping between pages and
+// window chips therefore costs a copy and a few RAM-history columns
+// instead of a rescan.
+//
+// Entries live in PSRAM, CHART_CACHE_ENTRIES of them with room for
+// `max_columns` each. Worker task only, except chart_cache_get_stats().
+
+#ifndef CHART_CACHE_ENTRIES
+  #define CHART_CACHE_ENTRIES    12     // e.g. 3 windows x 4 graph pages
+#endif
+#ifndef CHART_CACHE_SETTLE_MS
+  #define CHART_CACHE_SETTLE_MS  3000   // a column is final once it ended this long ago
+#endif
+#ifndef CHART_CACHE_CLOCK_SLACK_MS
+  #define CHART_CACHE_CLOCK_SLACK_MS 1000   // UTC vs plat_millis() drift before entries are dropped
+#endif
+
+struct chart_cache_key_t {
+  uint8_t  sig;
+  int8_t   tier;        // finest tier the window uses (log_rollup_pick_tier)
+  uint16_t columns;
+  uint32_t span_s;
+};
+
+struct chart_cache_stats_t {
+  uint32_t lookups;
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  uint32_t edge_columns;   // recomputed on hits
+  uint32_t reused_columns;
+  uint16_t entries_used;
+  uint32_t bytes;          // PSRAM held
+};
+
+bool chart_cache_init(uint16_t max_columns);
+
+// Copies the settled columns of a cached window starting at absolute column
+// `first_col` (time / column width) into `out` and returns how many there
+// are; the caller computes out[n..columns). 0 on a miss. `clock_off_ms` is
+// the window clock minus plat_millis(); entries taken under a different
+// offset (clock set or stepped since) miss. `stage` receives what the
+// stored result was built from (chart_query_stage_t).
+uint16_t chart_cache_get(const chart_cache_key_t* key, int64_t first_col, int64_t clock_off_ms,
+                         history_bucket_t* out, uint8_t* stage);
+
+// Stores a complete window; its first `settled` columns are final.
+void chart_cache_put(const chart_cache_key_t* key, int64_t first_col, uint16_t settled, int64_t clock_off_ms,
+                     uint8_t stage, const history_bucket_t* cols);
+
+void chart_cache_clear(void);
+void chart_cache_get_stats(chart_cache_stats_t* out);
@@ -0,0 +1,369 @@
+#include "chart_query.h"
+#include "chart_cache.h"
+#include "log_rollup.h"
+#include "log_storage.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+
+// Request mailbox, written by the UI only: id << 48 | sig << 40 |
+// columns << 24 | span_s (24 bits). One word, so the worker never sees a
+// torn request and a newer one simply overwrites an unread older one.
+static std::atomic<uint64_t> s_request{0};
+static std::atomic<uint32_t> s_request_ms{0};
+static uint16_t              s_last_id = 0;        // UI only
+
+// Results: lock-free triple buffer. The worker fills s_back and swaps it
+// with the middle slot; the UI swaps the middle slot into s_front when it
+// is marked fresh.
+#define CHART_FRESH 4
+static chart_query_result_t* s_buf[3];
+static std::atomic<uint8_t>  s_middle{1};
+static uint8_t               s_back = 0;           // worker only
+static uint8_t               s_front = 2;          // UI only
+
+// Worker scratch: RAM columns, the scan in progress and the last complete
+// SD stage.
+static history_bucket_t* s_ram;
+static history_bucket_t* s_cur;
+static history_bucket_t* s_best;
+
+static std::atomic<uint32_t> s_requests{0};
+static std::atomic<uint32_t> s_superseded{0};
+static std::atomic<uint32_t> s_results{0};
+static std::atomic<uint32_t> s_first_ms_last{0};
+static std::atomic<uint32_t> s_first_ms_max{0};
+static std::atomic<uint32_t> s_final_ms_last{0};
+static bool                  s_started = false;
+
+static inline void bump(std::atomic<uint32_t>& c) {
+  c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+static inline uint16_t request_id(uint64_t req) { return (uint16_t)(req >> 48); }
+
+struct chart_job_t {
+  uint16_t    id;
+  signal_id_t sig;
+  uint16_t    columns;
+  uint16_t    sd_cols;        // columns older than RAM coverage
+  uint16_t    settled;        // columns ended CHART_CACHE_SETTLE_MS ago
+  uint32_t    span_s;
+  uint32_t    t0_ms;
+  uint32_t    t0_us;          // worker picked the request up
+  int64_t     first_col;      // absolute index of column 0
+  int64_t     clock_off_ms;   // window clock minus plat_millis()
+  chart_cache_key_t key;
+  uint32_t    last_publish_ms;
+  uint8_t     stage;
+  int8_t      tier;
+  bool        scanning;       // s_cur is being filled
+  bool        have_best;
+  bool        cached;         // columns before the edge came from the cache
+  bool        cacheable;      // store the final result
+};
+
+static void publish(chart_job_t* j, bool partial, bool final) {
+  chart_query_result_t* r = s_buf[s_back];
+  uint16_t filled = 0;
+  for (uint16_t c = 0; c < j->columns; ++c) {
+    const history_bucket_t* b = &s_ram[c];
+    if (!b->count && c < j->sd_cols) {
+      if (j->scanning && s_cur[c].count) b = &s_cur[c];
+      else if (j->have_best) b = &s_best[c];
+    }
+    r->col[c] = *b;
+    filled += b->count ? 1 : 0;
+  }
+  r->id = j->id;
+  r->sig = j->sig;
+  r->stage = j->stage;
+  r->tier = j->tier;
+  r->partial = partial;
+  r->final = final;
+  r->columns = j->columns;
+  r->filled = filled;
+  r->span_s = j->span_s;
+  r->cached = j->cached;
+  r->elapsed_ms = plat_millis() - j->t0_ms;
+  r->work_us = plat_micros() - j->t0_us;
+  if (final && j->cacheable) chart_cache_put(&j->key, j->first_col, j->settled, j->clock_off_ms, j->stage, r->col);
+  s_back = s_middle.exchange(s_back | CHART_FRESH, std::memory_order_acq_rel) & 3;
+  j->last_publish_ms = plat_millis();
+  bump(s_results);
+}
+
+static bool superseded(const chart_job_t* j) {
+  return request_id(s_request.load(std::memory_order_acquire)) != j->id;
+}
+
+static bool on_progress(void* ctx) {
+  chart_job_t* j = (chart_job_t*)ctx;
+  if (superseded(j)) return false;
+  if (plat_millis() - j->last_publish_ms >= CHART_QUERY_PARTIAL_MS) publish(j, true, false);
+  return true;
+}
+
+static void note_final(const chart_job_t* j) {
+  s_final_ms_last.store(plat_millis() - j->t0_ms, std::memory_order_relaxed);
+}
+
+static void run(uint64_t req) {
+  chart_job_t j = {};
+  j.id = request_id(req);
+  j.sig = (signal_id_t)(uint8_t)(req >> 40);
+  j.columns = (uint16_t)(req >> 24);
+  j.span_s = (uint32_t)(req & 0xFFFFFF);
+  j.t0_ms = s_request_ms.load(std::memory_order_relaxed);
+  j.t0_us = plat_micros();
+  j.stage = CHART_QUERY_RAM;
+  j.tier = -1;
+  const uint32_t now_ms = plat_millis();
+  const int64_t utc_now = plat_utc_ms();
+
+  // Columns are aligned to absolute multiples of their width (UTC once the
+  // clock is set, uptime before), so as time moves on a window only shifts
+  // and its settled columns stay valid in the cache.
+  const int64_t t_now = utc_now ? utc_now : (int64_t)now_ms;
+  int64_t col_ms = (int64_t)j.span_s * 1000 / j.columns;
+  if (col_ms < 1) col_ms = 1;
+  const int64_t span_ms = col_ms * j.columns;
+  j.clock_off_ms = t_now - now_ms;
+  j.first_col = t_now / col_ms - j.columns + 1;
+  const int64_t from_t = j.first_col * col_ms;
+  int64_t settled = (t_now - CHART_CACHE_SETTLE_MS) / col_ms - j.first_col;
+  j.settled = (uint16_t)(settled < 0 ? 0 : settled > j.columns ? j.columns : settled);
+  const int target = log_rollup_pick_tier(span_ms, j.columns);
+  j.key = {(uint8_t)j.sig, (int8_t)target, j.columns, j.span_s};
+
+  // Cached columns land in s_ram and count as RAM below: they already hold
+  // the merged result, so only the newest edge is decimated again.
+  memset(s_ram, 0, j.columns * sizeof(history_bucket_t));
+  uint8_t cached_stage = CHART_QUERY_RAM;
+  uint16_t c0 = chart_cache_get(&j.key, j.first_col, j.clock_off_ms, s_ram, &cached_stage);
+  j.cached = c0 > 0;
+  if (!j.cached) {
+    // RAM: only the columns its ring can span, so long windows stay within
+    // the wrap-safe range of millisecond timestamps.
+    const int64_t ram_cols = ((int64_t)k_signal_meta[j.sig].hist_span_s * 1000 + col_ms - 1) / col_ms;
+    c0 = ram_cols < j.columns ? (uint16_t)(j.columns - ram_cols) : 0;
+  }
+  signal_history_decimate(j.sig, (uint32_t)(from_t + c0 * col_ms - j.clock_off_ms),
+                          (uint32_t)(from_t + span_ms - j.clock_off_ms), s_ram + c0, (uint16_t)(j.columns - c0));
+
+  if (j.cached) {
+    // The edge is newer than anything the SD log can add.
+    j.stage = cached_stage;
+    j.tier = cached_stage == CHART_QUERY_RAM ? -1 : (int8_t)target;
+    j.cacheable = true;
+    publish(&j, false, true);
+    note_final(&j);
+    return;
+  }
+
+  uint16_t first_ram = j.columns;
+  for (uint16_t c = 0; c < j.columns; ++c) {
+    if (s_ram[c].count) {
+      first_ram = c;
+      break;
+    }
+  }
+  j.sd_cols = first_ram;
+  const bool ram_only = !first_ram || !utc_now || !log_storage_ready();
+  // A window RAM covers entirely is complete; one cut short by a missing
+  // clock or card is not worth keeping.
+  j.cacheable = !first_ram;
+  publish(&j, false, ram_only);
+  const uint32_t first_ms = plat_millis() - j.t0_ms;
+  s_first_ms_last.store(first_ms, std::memory_order_relaxed);
+  if (first_ms > s_first_ms_max.load(std::memory_order_relaxed)) s_first_ms_max.store(first_ms, std::memory_order_relaxed);
+  if (ram_only) {
+    note_final(&j);
+    return;
+  }
+
+  // SD, coarse to fine, for the columns before RAM coverage.
+  const int64_t sd_to = from_t + j.sd_cols * col_ms;
+  if (j.settled < j.sd_cols) j.settled = j.sd_cols;   // before boot nothing new arrives
+  j.cacheable = false;
+  for (int tier = LOG_ROLLUP_TIERS - 1; tier >= target; --tier) {
+    if (superseded(&j)) {
+      bump(s_superseded);
+      return;
+    }
+    memset(s_cur, 0, j.sd_cols * sizeof(history_bucket_t));
+    j.stage = tier < 0 ? CHART_QUERY_RAW : CHART_QUERY_ROLLUP;
+    j.tier = (int8_t)tier;
+    j.scanning = true;
+    if (!log_rollup_decimate_tier(j.sig, from_t, sd_to, s_cur, j.sd_cols, tier, on_progress, &j)) {
+      bump(s_superseded);
+      return;
+    }
+    history_bucket_t* t = s_best;
+    s_best = s_cur;
+    s_cur = t;
+    j.scanning = false;
+    j.have_best = true;
+    j.cacheable = tier == target;
+    publish(&j, false, tier == target);
+  }
+  note_final(&j);
+}
+
+static void chart_query_task(void*) {
+  uint16_t done_id = 0;
+  for (;;) {
+    const uint64_t req = s_request.load(std::memory_order_acquire);
+    if (!request_id(req) || request_id(req) == done_id) {
+      plat_delay_ms(CHART_QUERY_IDLE_MS);
+      continue;
+    }
+    run(req);
+    done_id = request_id(req);
+  }
+}
+
+bool chart_query_start(void) {
+  if (s_started) return true;
+  const size_t cols = CHART_QUERY_MAX_COLUMNS * sizeof(history_bucket_t);
+  for (int i = 0; i < 3; ++i) s_buf[i] = (chart_query_result_t*)plat_psram_alloc(sizeof(chart_query_result_t));
+  s_ram = (history_bucket_t*)plat_psram_alloc(cols);
+  s_cur = (history_bucket_t*)plat_psram_alloc(cols);
+  s_best = (history_bucket_t*)plat_psram_alloc(cols);
+  if (!s_buf[0] || !s_buf[1] || !s_buf[2] || !s_ram || !s_cur || !s_best) {
+    DBG_LOGW("[chart] out of memory");
+    return false;
+  }
+  for (int i = 0; i < 3; ++i) memset(s_buf[i], 0, sizeof(chart_query_result_t));
+  chart_cache_init(CHART_QUERY_MAX_COLUMNS);   // without it every request is a miss
+  if (!plat_task_start(chart_query_task, "chart_q", 6144, CHART_QUERY_TASK_PRIO, CHART_QUERY_TASK_CORE, nullptr)) {
+    return false;
+  }
+  s_started = true;
+  return true;
+}
+
+uint16_t chart_query_request(signal_id_t sig, uint32_t span_s, uint16_t columns) {
+  if (++s_last_id == 0) s_last_id = 1;
+  if (columns > CHART_QUERY_MAX_COLUMNS) columns = CHART_QUERY_MAX_COLUMNS;
+  if (!columns) columns = 1;
+  if (span_s > 0xFFFFFF) span_s = 0xFFFFFF;
+  if (!span_s) span_s = 1;
+  s_request_ms.store(plat_millis(), std::memory_order_relaxed);
+  s_request.store((uint64_t)s_last_id << 48 | (uint64_t)(sig < SIG_COUNT ? sig : 0) << 40 |
+                      (uint64_t)columns << 24 | span_s,
+                  std::memory_order_release);
+  bump(s_requests);
+  return s_last_id;
+}
+
+const chart_query_result_t* chart_query_poll(void) {
+  if (!s_started || !(s_middle.load(std::memory_order_acquire) & CHART_FRESH)) return nullptr;
+  s_front = s_middle.exchange(s_front, std::memory_order_acq_rel) & 3;
+  const chart_query_result_t* r = s_buf[s_front];
+  return r->id == s_last_id ? r : nullptr;
+}
+
+void chart_query_get_stats(chart_query_stats_t* out) {
+  out->requests = s_requests.load(std::memory_order_relaxed);
+  out->superseded = s_superseded.load(std::memory_order_relaxed);
+  out->results = s_results.load(std::memory_order_relaxed);
+  out->first_ms_last = s_first_ms_last.load(std::memory_order_relaxed);
+  out->first_ms_max = s_first_ms_max.load(std::memory_order_relaxed);
+  out->final_ms_last = s_final_ms_last.load(std::memory_order_relaxed);
+}
+
+#if !defined(ARDUINO)
+
+static const char* stage_name(const chart_query_result_t* r) {
+  if (r->stage == CHART_QUERY_RAM) return "ram";
+  if (r->stage == CHART_QUERY_RAW) return "raw";
+  return k_log_rollup_tiers[r->tier].name;
+}
+
+// Polls like the UI timer would and logs every result for request `id`
+// (only the final one if `label` is null). Returns the worker time of the
+// final result in us.
+static uint32_t bench_follow(uint16_t id, const char* label) {
+  const uint32_t t0 = plat_millis();
+  for (;;) {
+    const chart_query_result_t* r = chart_query_poll();
+    if (r && r->id == id) {
+      if (label) {
+        DBG_LOGI("[chart] %-4s %5u ms  %-3s%s %3u/%u columns%s%s", label, (unsigned)r->elapsed_ms, stage_name(r),
+                 r->partial ? " (partial)" : "          ", (unsigned)r->filled, (unsigned)r->columns,
+                 r->final ? "  final" : "", r->cached ? " (cached)" : "");
+      }
+      if (r->final) return r->work_us;
+    }
+    if (plat_millis() - t0 > 30000) {
+      DBG_LOGW("[chart] %s: no final result after 30 s", label ? label : "flip");
+      return 0;
+    }
+    plat_delay_ms(1);
+  }
+}
+
+void chart_query_benchmark(uint32_t ram_minutes) {
+  if (!signal_history_init() || !chart_query_start()) return;
+  static const signal_id_t k_pages[] = {SIG_RPM, SIG_PACK_VOLTAGE, SIG_WIND_SPEED, SIG_COOLANT_TEMP};
+  const uint32_t now = plat_millis();
+  for (signal_id_t sig : k_pages) {
+    const uint32_t period = k_signal_meta[sig].hist_period_ms;
+    for (uint32_t t = ram_minutes * 60000; t >= period; t -= period) {
+      signal_history_record(sig, 1500.0f + (float)(t % 7000) / 20.0f, now - t);
+    }
+  }
+
+  log_storage_set_read_latency(300, 200);   // roughly a 4-bit SDMMC card behind FATFS
+  static const uint32_t k_hours[] = {6, 12, 24, 1};
+  for (uint32_t h : k_hours) {
+    char label[8];
+    snprintf(label, sizeof(label), "%uh", (unsigned)h);
+    bench_follow(chart_query_request(SIG_RPM, h * 3600, 720), label);
+  }
+
+  // Chip taps faster than the SD stages finish: only the last one completes.
+  chart_cache_clear();
+  chart_query_stats_t before;
+  chart_query_get_stats(&before);
+  chart_query_request(SIG_RPM, 1 * 3600, 720);
+  plat_delay_ms(15);
+  chart_query_request(SIG_RPM, 6 * 3600, 720);
+  plat_delay_ms(15);
+  bench_follow(chart_query_request(SIG_RPM, 24 * 3600, 720), "tap");
+  chart_query_stats_t s;
+  chart_query_get_stats(&s);
+  DBG_LOGI("[chart] taps: 3 requests, %u superseded; first result max %u ms",
+           (unsigned)(s.superseded - before.superseded), (unsigned)s.first_ms_max);
+
+  // Page and chip flips: the first pass fills the cache, later ones only
+  // decimate the newest edge of each window.
+  static const uint32_t k_windows_h[] = {6, 12, 24};
+  for (int pass = 0; pass < 3; ++pass) {
+    uint32_t total_us = 0, max_us = 0, n = 0;
+    for (signal_id_t sig : k_pages) {
+      for (uint32_t h : k_windows_h) {
+        const uint32_t us = bench_follow(chart_query_request(sig, h * 3600, 720), nullptr);
+        total_us += us;
+        if (us > max_us) max_us = us;
+        ++n;
+      }
+    }
+    DBG_LOGI("[chart] flip pass %d: %u windows, mean %u us, max %u us", pass, (unsigned)n,
+             (unsigned)(total_us / n), (unsigned)max_us);
+    plat_delay_ms(1000);
+  }
+  chart_cache_stats_t cs;
+  chart_cache_get_stats(&cs);
+  DBG_LOGI("[chart] cache: %u lookups, %u hits (%u%%), %u evictions, %u/%u columns recomputed on hits, %u/%u entries, %u KB",
+           (unsigned)cs.lookups, (unsigned)cs.hits, (unsigned)(cs.lookups ? cs.hits * 100 / cs.lookups : 0),
+           (unsigned)cs.evictions, (unsigned)cs.edge_columns, (unsigned)(cs.edge_columns + cs.reused_columns),
+           (unsigned)cs.entries_used, (unsigned)CHART_CACHE_ENTRIES, (unsigned)(cs.bytes / 1024));
+  log_storage_set_read_latency(0, 0);
+}
+
+#endif  // !ARDUINO
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "signals.h"
+#include "signal_history.h"
+#include <stdint.h>
+
+// Asynchronous chart window queries for graph pages.
+//
+// The UI asks for a window with chart_query_request() and never touches the
+// SD card; a worker task answers in stages, each a complete set of columns
+// that replaces the previous one on screen:
+//   1. RAM history (signal_history.h), typically a few ms after the request;
+//   2. the coarsest rollup tier (log_rollup.h) for the part of the window
+//      older than RAM;
+//   3. finer tiers down to the one log_rollup_pick_tier() chooses for the
+//      span, or raw records for short windows. While a tier scans, the
+//      partial result is republished every CHART_QUERY_PARTIAL_MS with the
+//      coarser columns standing in for the part not read yet.
+// Columns that RAM covers always come from RAM: it is at least as fine as
+// any tier and holds the newest data, which rollups only get once a bucket
+// closes.
+//
+// Windows are aligned to whole columns and complete results go into the
+// LRU cache (chart_cache.h); asking for a cached window again only
+// decimates its newest edge and answers with one final result.
+//
+// A new request supersedes the running one; the worker notices between
+// file reads and abandons it, and chart_query_poll() only hands out results
+// for the newest request. The worker is the only task that runs SD queries
+// (log_query.h and the query side of log_rollup.h are single-threaded).
+
+#ifndef CHART_QUERY_MAX_COLUMNS
+  #define CHART_QUERY_MAX_COLUMNS  800
+#endif
+#ifndef CHART_QUERY_PARTIAL_MS
+  #define CHART_QUERY_PARTIAL_MS   50    // partial result cadence during a long scan
+#endif
+#ifndef CHART_QUERY_IDLE_MS
+  #define CHART_QUERY_IDLE_MS      5     // worker poll period for new requests
+#endif
+#ifndef CHART_QUERY_TASK_PRIO
+  #define CHART_QUERY_TASK_PRIO    2     // below the bus and log writer tasks
+#endif
+#ifndef CHART_QUERY_TASK_CORE
+  #define CHART_QUERY_TASK_CORE    1
+#endif
+
+enum chart_query_stage_t : uint8_t {
+  CHART_QUERY_RAM = 0,
+  CHART_QUERY_ROLLUP,     // `tier` is the rollup tier of the SD part
+  CHART_QUERY_RAW,
+};
+
+struct chart_query_result_t {
+  uint16_t         id;          // from chart_query_request()
+  signal_id_t      sig;
+  uint8_t          stage;       // chart_query_stage_t
+  int8_t           tier;
+  bool             partial;     // a scan is still filling columns in
+  bool             final;       // no further results for this request
+  uint16_t         columns;
+  uint16_t         filled;      // columns with data
+  uint32_t         span_s;
+  bool             cached;      // all but the newest edge came from the cache
+  uint32_t         elapsed_ms;  // request to publish
+  uint32_t         work_us;     // worker time spent on the request so far
+  history_bucket_t col[CHART_QUERY_MAX_COLUMNS];   // oldest first, ends now
+};
+
+struct chart_query_stats_t {
+  uint32_t requests;
+  uint32_t superseded;          // abandoned for a newer request
+  uint32_t results;
+  uint32_t first_ms_last;       // request to first (RAM) result
+  uint32_t first_ms_max;
+  uint32_t final_ms_last;
+};
+
+// Allocates the result buffers (PSRAM) and starts the worker.
+bool chart_query_start(void);
+
+// UI: chart `sig` over the last `span_s` seconds in `columns` columns
+// (clamped to CHART_QUERY_MAX_COLUMNS). Returns the request id.
+uint16_t chart_query_request(signal_id_t sig, uint32_t span_s, uint16_t columns);
+
+// UI: the newest result for the newest request if it has not been returned
+// yet, else nullptr. Valid until the next call.
+const chart_query_result_t* chart_query_poll(void);
+
+void chart_query_get_stats(chart_query_stats_t* out);
+
+#if !defined(ARDUINO)
+// Host only: run after log_query_benchmark() has written synthetic logs.
+// Seeds `ram_minutes` of history for the benchmark's signals, then, with SD-like read latency
+// (log_storage_set_read_latency), times the stages of 1h..24h requests and
+// a burst of chip taps that supersede each other, then flips between graph
+// pages and windows to show the cache.
+void chart_query_benchmark(uint32_t ram_minutes);
+#endif
@@ -0,0 +1,22 @@
+#include "crc32.h"
+
+// Table is built at compile time so concurrent first use needs no guard.
+struct crc32_table_t {
+  uint32_t v[256];
+  constexpr crc32_table_t() : v() {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+      v[i] = c;
+    }
+  }
+};
+
+static constexpr crc32_table_t k_crc32;
+
+uint32_t crc32_update(uint32_t crc, const void* data, size_t len) {
+  const uint8_t* p = (const uint8_t*)data;
+  crc = ~crc;
+  while (len--) crc = k_crc32.v[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32 (IEEE 802.3, reflected, poly 0xEDB88320) for log blocks and link
+// frames. Chain calls by passing the previous result; start with 0.
+uint32_t crc32_update(uint32_t crc, const void* data, size_t len);
@@ -7,3 +7,79 @@
 
 // Use custom Orbitron fonts (LVGL v8 font .c files must be in your sketch folder)
 #define USE_ORBITRON          1
+
+// Render static metric-card chrome once into cached images (card_chrome.h).
+// Set to 0 to compare per-update render cost against plain LVGL styles.
+#ifndef UI_CARD_CHROME_CACHE
+  #define UI_CARD_CHROME_CACHE  1
+#endif
+
+// Draw large card values through the pre-rasterized digit atlas
+// (numeric_readout.h) instead of lv_label.
+#ifndef UI_NUMERIC_READOUT
+  #define UI_NUMERIC_READOUT    1
+#endif
+
+// Serve compressed Orbitron glyphs from a decompressed PSRAM LRU cache
+// (glyph_cache.h). GLYPH_CACHE_BENCH=1 logs a cached vs uncached timing of
+// the dashboard strings once at startup.
+#ifndef UI_GLYPH_CACHE
+  #define UI_GLYPH_CACHE        1
+#endif
+#ifndef GLYPH_CACHE_BENCH
+  #define GLYPH_CACHE_BENCH     0
+#endif
+
+// Log NMEA2000 decode throughput (n2k_decode.h) once at boot.
+#ifndef N2K_DECODE_BENCH
+  #define N2K_DECODE_BENCH      0
+#endif
+
+// Start CAN RX + NMEA2000 decode (bus_task.h) at boot; cards poll the
+// signal store every UI_SIGNAL_POLL_MS.
+#ifndef BUS_INGEST_ENABLE
+  #define BUS_INGEST_ENABLE     1
+#endif
+#ifndef UI_SIGNAL_POLL_MS
+  #define UI_SIGNAL_POLL_MS     100
+#endif
+
+// Graph pages draw results of the chart query worker (chart_query.h), polled
+// every UI_CHART_POLL_MS; charts have UI_CHART_COLUMNS points.
+#ifndef UI_CHART_POLL_MS
+  #define UI_CHART_POLL_MS      20
+#endif
+#ifndef UI_CHART_COLUMNS
+  #define UI_CHART_COLUMNS      360
+#endif
+
+// Receive decoded signals from an ESP32-C6 over UART (c6_link.h) instead
+// of running CAN ingest on the P4. Takes precedence over BUS_INGEST_ENABLE.
+#ifndef C6_LINK_ENABLE
+  #define C6_LINK_ENABLE        0
+#endif
+
+// Log decoded signals to SD (log_writer.h). Without a card the dashboard
+// runs from RAM history only.
+#ifndef SD_LOGGING_ENABLE
+  #define SD_LOGGING_ENABLE     1
+#endif
+
+// Raw CAN capture from boot (can_capture.h) to CAN_CAPTURE_PATH on the SD
+// card, as candump text or, with CAN_CAPTURE_BINARY, the compact binary format.
+#ifndef CAN_CAPTURE_ENABLE
+  #define CAN_CAPTURE_ENABLE    0
+#endif
+#ifndef CAN_CAPTURE_PATH
+  #define CAN_CAPTURE_PATH      "can/capture.log"
+#endif
+#ifndef CAN_CAPTURE_FORMAT
+  #define CAN_CAPTURE_FORMAT    CAN_CAPTURE_CANDUMP
+#endif
+
+// Define CAN_REPLAY_PATH (e.g. "can/voyage.log") to feed a recorded capture
+// through the ingest path instead of the live bus (can_replay.h); the report
+// is logged when it ends. CAN_REPLAY_SPEED: 1 = recorded pace, 0 = max.
+#ifndef CAN_REPLAY_SPEED
+  #define CAN_REPLAY_SPEED      1.0f
+#endif
@@ -49,6 +49,11 @@ static constexpr int LOGICAL_H    = ORIENTATION_LOGICAL_HEIGHT;
 #endif
 
 static void my_flush(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p);
+static void my_monitor(lv_disp_drv_t* drv, uint32_t time_ms, uint32_t px);
+
+// Flush time accumulated during the current refresh, so the monitor callback
+// can split LVGL's refresh time into render and flush cost.
+static uint32_t s_refr_flush_us = 0;
 
 // Lightweight retry wrapper for draw (throttled)
 static esp_err_t draw_bitmap_retry(int x1, int y1, int x2, int y2, const void* data) {
@@ -192,6 +197,7 @@ bool dbg_display_init(void) {
   drv.hor_res   = LOGICAL_W;
   drv.ver_res   = LOGICAL_H;
   drv.flush_cb  = my_flush;
+  drv.monitor_cb = my_monitor;
   drv.draw_buf  = &s_draw;
   drv.full_refresh = 0;
   s_disp = lv_disp_drv_register(&drv);
@@ -255,6 +261,7 @@ static void my_flush(lv_disp_drv_t* drv, const lv_area_t* a, lv_color_t* color_p
   }
 
   const uint32_t elapsed = micros() - t0;
+  s_refr_flush_us += elapsed;
   flush_total_us += elapsed;
   if (elapsed > flush_max_us) flush_max_us = elapsed;
   flush_count++;
@@ -273,3 +280,33 @@ static void my_flush(lv_disp_drv_t* drv, const lv_area_t* a, lv_color_t* color_p
 
   lv_disp_flush_ready(drv);
 }
+
+// ============ Per-refresh render cost (LVGL monitor callback) ============
+// LVGL reports whole-refresh time in ms; subtracting our own flush time leaves
+// the software render cost. Compare builds with UI_CARD_CHROME_CACHE=0/1.
+static void my_monitor(lv_disp_drv_t* drv, uint32_t time_ms, uint32_t px) {
+  (void)drv;
+  static uint32_t refr_count = 0;
+  static uint64_t render_total_us = 0;
+  static uint32_t render_max_us = 0;
+  static uint64_t px_total = 0;
+
+  const uint32_t refr_us = time_ms * 1000u;
+  const uint32_t render_us = (refr_us > s_refr_flush_us) ? (refr_us - s_refr_flush_us) : 0;
+  s_refr_flush_us = 0;
+
+  refr_count++;
+  render_total_us += render_us;
+  px_total += px;
+  if (render_us > render_max_us) render_max_us = render_us;
+
+  if (DBG_LOG_ENABLED(DBG_LOG_TRACE) || (DBG_LOG_ENABLED(DBG_LOG_INFO) && (refr_count % 60 == 0))) {
+    DBG_LOGI("[render] #%lu px=%u render_us=%u avg=%u max=%u avg_px=%u",
+             static_cast<unsigned long>(refr_count),
+             (unsigned)px,
+             (unsigned)render_us,
+             (unsigned)(render_total_us / refr_count),
+             (unsigned)render_max_us,
+             (unsigned)(px_total / refr_count));
+  }
+}
@@ -0,0 +1,211 @@
+#include "glyph_cache.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <string.h>
+
+static constexpr int16_t  NIL = -1;
+static constexpr uint16_t HASH_SIZE = 512;   // power of two, >= 2x slots
+
+static_assert((HASH_SIZE & (HASH_SIZE - 1)) == 0, "HASH_SIZE must be a power of two");
+static_assert(HASH_SIZE >= 2 * GLYPH_CACHE_SLOTS, "hash table too small for slot count");
+
+struct wrapped_font_t {
+  lv_font_t        font;   // must stay first: callbacks receive &font
+  const lv_font_t* base;
+  uint8_t          id;
+};
+
+struct glyph_entry_t {
+  uint32_t letter;
+  uint8_t  font_id;
+  int16_t  lru_prev;
+  int16_t  lru_next;
+  int16_t  chain_next;
+};
+
+static wrapped_font_t s_fonts[GLYPH_CACHE_MAX_FONTS];
+static uint8_t        s_font_count = 0;
+
+static glyph_entry_t  s_entries[GLYPH_CACHE_SLOTS];
+static int16_t        s_buckets[HASH_SIZE];
+static uint8_t*       s_slab = nullptr;
+static int16_t        s_lru_head = NIL;   // most recently used
+static int16_t        s_lru_tail = NIL;   // eviction candidate
+static uint16_t       s_used = 0;
+static glyph_cache_stats_t s_stats;
+
+static inline uint16_t bucket_of(uint8_t font_id, uint32_t letter) {
+  return (uint16_t)(((letter * 2654435761u) ^ (font_id * 40503u)) & (HASH_SIZE - 1));
+}
+
+static inline uint8_t* slot_data(int16_t idx) {
+  return s_slab + (size_t)idx * GLYPH_CACHE_SLOT_BYTES;
+}
+
+static void lru_unlink(int16_t i) {
+  glyph_entry_t* e = &s_entries[i];
+  if (e->lru_prev != NIL) s_entries[e->lru_prev].lru_next = e->lru_next; else s_lru_head = e->lru_next;
+  if (e->lru_next != NIL) s_entries[e->lru_next].lru_prev = e->lru_prev; else s_lru_tail = e->lru_prev;
+  e->lru_prev = e->lru_next = NIL;
+}
+
+static void lru_push_front(int16_t i) {
+  glyph_entry_t* e = &s_entries[i];
+  e->lru_prev = NIL;
+  e->lru_next = s_lru_head;
+  if (s_lru_head != NIL) s_entries[s_lru_head].lru_prev = i;
+  s_lru_head = i;
+  if (s_lru_tail == NIL) s_lru_tail = i;
+}
+
+static void chain_remove(int16_t i) {
+  const glyph_entry_t* e = &s_entries[i];
+  int16_t* pp = &s_buckets[bucket_of(e->font_id, e->letter)];
+  while (*pp != NIL && *pp != i) pp = &s_entries[*pp].chain_next;
+  if (*pp == i) *pp = e->chain_next;
+}
+
+static int16_t lookup(uint8_t font_id, uint32_t letter) {
+  for (int16_t i = s_buckets[bucket_of(font_id, letter)]; i != NIL; i = s_entries[i].chain_next) {
+    if (s_entries[i].letter == letter && s_entries[i].font_id == font_id) return i;
+  }
+  return NIL;
+}
+
+static int16_t take_slot() {
+  if (s_used < GLYPH_CACHE_SLOTS) return (int16_t)s_used++;
+  const int16_t victim = s_lru_tail;
+  lru_unlink(victim);
+  chain_remove(victim);
+  s_stats.evictions++;
+  return victim;
+}
+
+static const uint8_t* cached_get_bitmap(const lv_font_t* font, uint32_t letter) {
+  const wrapped_font_t* wf = (const wrapped_font_t*)font;
+
+  int16_t i = lookup(wf->id, letter);
+  if (i != NIL) {
+    s_stats.hits++;
+    if (s_lru_head != i) {
+      lru_unlink(i);
+      lru_push_front(i);
+    }
+    return slot_data(i);
+  }
+
+  s_stats.misses++;
+  const uint8_t* bmp = wf->base->get_glyph_bitmap(wf->base, letter);
+  if (!bmp) return nullptr;
+
+  lv_font_glyph_dsc_t g;
+  if (!wf->base->get_glyph_dsc(wf->base, &g, letter, 0)) return bmp;
+  const uint8_t bpp = g.bpp ? g.bpp : 4;
+  const size_t bytes = ((size_t)g.box_w * g.box_h * bpp + 7) / 8;
+  if (bytes == 0 || bytes > GLYPH_CACHE_SLOT_BYTES) {
+    s_stats.bypass++;
+    return bmp;
+  }
+
+  // The base font returns a shared decompression buffer; keep our own copy.
+  i = take_slot();
+  memcpy(slot_data(i), bmp, bytes);
+  glyph_entry_t* e = &s_entries[i];
+  e->letter = letter;
+  e->font_id = wf->id;
+  const uint16_t b = bucket_of(wf->id, letter);
+  e->chain_next = s_buckets[b];
+  s_buckets[b] = i;
+  lru_push_front(i);
+  return slot_data(i);
+}
+
+static bool ensure_slab() {
+  if (s_slab) return true;
+  s_slab = (uint8_t*)plat_psram_alloc((size_t)GLYPH_CACHE_SLOTS * GLYPH_CACHE_SLOT_BYTES);
+  if (!s_slab) {
+    DBG_LOGW("[glyph] cache slab alloc failed (%u bytes), fonts stay uncached",
+             (unsigned)(GLYPH_CACHE_SLOTS * GLYPH_CACHE_SLOT_BYTES));
+    return false;
+  }
+  glyph_cache_clear();
+  DBG_LOGI("[glyph] cache ready: %u slots x %u bytes", (unsigned)GLYPH_CACHE_SLOTS,
+           (unsigned)GLYPH_CACHE_SLOT_BYTES);
+  return true;
+}
+
+const lv_font_t* glyph_cache_wrap(const lv_font_t* base) {
+  if (!base) return base;
+  for (uint8_t i = 0; i < s_font_count; ++i) {
+    if (s_fonts[i].base == base) return &s_fonts[i].font;
+  }
+  if (s_font_count >= GLYPH_CACHE_MAX_FONTS || !ensure_slab()) return base;
+
+  wrapped_font_t* wf = &s_fonts[s_font_count];
+  wf->font = *base;
+  wf->font.get_glyph_bitmap = cached_get_bitmap;
+  wf->base = base;
+  wf->id = s_font_count++;
+  return &wf->font;
+}
+
+void glyph_cache_clear(void) {
+  for (uint16_t i = 0; i < HASH_SIZE; ++i) s_buckets[i] = NIL;
+  memset(s_entries, 0, sizeof(s_entries));
+  s_lru_head = s_lru_tail = NIL;
+  s_used = 0;
+}
+
+void glyph_cache_get_stats(glyph_cache_stats_t* out) {
+  *out = s_stats;
+  out->entries = s_used;
+  out->capacity = GLYPH_CACHE_SLOTS;
+}
+
+void glyph_cache_reset_stats(void) {
+  memset(&s_stats, 0, sizeof(s_stats));
+}
+
+static uint32_t fetch_strings(const lv_font_t* font, const char* const* strings, uint16_t count,
+                              uint16_t iterations) {
+  uint32_t sink = 0;
+  const uint32_t t0 = plat_micros();
+  for (uint16_t it = 0; it < iterations; ++it) {
+    for (uint16_t s = 0; s < count; ++s) {
+      uint32_t i = 0;
+      uint32_t letter;
+      while ((letter = _lv_txt_encoded_next(strings[s], &i)) != 0) {
+        lv_font_glyph_dsc_t g;
+        if (!lv_font_get_glyph_dsc(font, &g, letter, 0)) continue;
+        const uint8_t* bmp = lv_font_get_glyph_bitmap(g.resolved_font ? g.resolved_font : font, letter);
+        if (bmp) sink += bmp[0];
+      }
+    }
+  }
+  (void)sink;
+  return plat_micros() - t0;
+}
+
+void glyph_cache_benchmark(const lv_font_t* base, const char* const* strings, uint16_t count,
+                           uint16_t iterations) {
+  const lv_font_t* cached = glyph_cache_wrap(base);
+  if (cached == base) {
+    DBG_LOGW("[glyph] bench skipped: cache unavailable");
+    return;
+  }
+
+  glyph_cache_stats_t before;
+  glyph_cache_get_stats(&before);
+
+  const uint32_t us_plain = fetch_strings(base, strings, count, iterations);
+  fetch_strings(cached, strings, count, 1);  // warm
+  const uint32_t us_cached = fetch_strings(cached, strings, count, iterations);
+
+  glyph_cache_stats_t after;
+  glyph_cache_get_stats(&after);
+  DBG_LOGI("[glyph][bench] line_h=%d strings=%u iters=%u decompress_us=%u cached_us=%u hits=%u misses=%u",
+           (int)base->line_height, (unsigned)count, (unsigned)iterations,
+           (unsigned)us_plain, (unsigned)us_cached,
+           (unsigned)(after.hits - before.hits), (unsigned)(after.misses - before.misses));
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "lvgl.h"
+#include <stdint.h>
+
+// Bounded LRU cache of decompressed glyph bitmaps.
+//
+// The Orbitron fonts are built with LV_USE_FONT_COMPRESSED=1, so every glyph
+// draw decompresses its RLE bitmap again. glyph_cache_wrap() returns a copy of
+// a font whose get_glyph_bitmap callback serves bitmaps from a PSRAM slab,
+// keyed by (font, codepoint). Glyphs larger than a slot bypass the cache.
+
+#ifndef GLYPH_CACHE_SLOTS
+  #define GLYPH_CACHE_SLOTS       256
+#endif
+#ifndef GLYPH_CACHE_SLOT_BYTES
+  #define GLYPH_CACHE_SLOT_BYTES  1280   // fits a 48 px glyph at 4 bpp
+#endif
+#ifndef GLYPH_CACHE_MAX_FONTS
+  #define GLYPH_CACHE_MAX_FONTS   4
+#endif
+
+struct glyph_cache_stats_t {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  uint32_t bypass;     // glyphs too large for a slot
+  uint16_t entries;
+  uint16_t capacity;
+};
+
+// Returns a cached view of `base`, or `base` itself if the cache is unavailable.
+const lv_font_t* glyph_cache_wrap(const lv_font_t* base);
+
+void glyph_cache_get_stats(glyph_cache_stats_t* out);
+void glyph_cache_reset_stats(void);
+
+// Drop every cached bitmap (e.g. after swapping font assets).
+void glyph_cache_clear(void);
+
+// Fetches the bitmaps of `strings` through the uncached and the cached font for
+// `iterations` rounds and logs both timings, i.e. what compression costs.
+void glyph_cache_benchmark(const lv_font_t* base, const char* const* strings, uint16_t count,
+                           uint16_t iterations);
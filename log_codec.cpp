@@ -0,0 +1,280 @@
+#include "log_codec.h"
+
+#include <math.h>
+#include <string.h>
+
+static_assert(SIG_COUNT <= 32, "signal id must fit the 5-bit DOD tag");
+
+static constexpr uint8_t TAG_SIG_MASK = 0x1F;
+static constexpr uint8_t TAG_META     = 0x20;
+static constexpr uint8_t TAG_RAWF     = 0x40;
+
+static inline uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static inline int64_t  unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+static inline uint8_t put_varint(uint8_t* p, uint64_t v) {
+  uint8_t n = 0;
+  while (v >= 0x80) {
+    p[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  p[n++] = (uint8_t)v;
+  return n;
+}
+
+static inline bool get_varint(const uint8_t* p, uint16_t len, uint16_t* pos, uint64_t* out) {
+  uint64_t v = 0;
+  for (uint8_t shift = 0; shift < 64; shift += 7) {
+    if (*pos >= len) return false;
+    const uint8_t b = p[(*pos)++];
+    v |= (uint64_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) {
+      *out = v;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Fixed-point form shared with signal_history.cpp: round(value * scale).
+static inline bool to_fixed(uint8_t sig, float value, int32_t* q) {
+  if (sig >= SIG_COUNT || !isfinite(value)) return false;
+  const float f = roundf(value * k_signal_meta[sig].fixed_scale);
+  if (!(fabsf(f) < 2147483520.0f)) return false;
+  *q = (int32_t)f;
+  return true;
+}
+
+void log_encoder_reset(log_encoder_t* e, uint8_t codec, uint32_t base_ms) {
+  e->codec = codec;
+  e->bytes = 0;
+  e->count = 0;
+  e->prev_t = base_ms;
+  e->prev_delta = 0;
+  memset(e->prev_q, 0, sizeof(e->prev_q));
+  memset(e->meta, 0xFF, sizeof(e->meta));
+}
+
+bool log_encoder_append(log_encoder_t* e, uint8_t* payload, uint16_t cap, const log_record_t* rec) {
+  if (e->codec == LOG_CODEC_RAW) {
+    if (e->bytes + sizeof(log_record_t) > cap) return false;
+    memcpy(payload + e->bytes, rec, sizeof(log_record_t));
+    e->bytes += sizeof(log_record_t);
+    e->count++;
+    return true;
+  }
+
+  const uint8_t sig = rec->sig & TAG_SIG_MASK;
+  const bool tracked = sig < SIG_COUNT;
+  const uint16_t meta = (uint16_t)(rec->quality << 8 | rec->src);
+  int32_t q = 0;
+  const bool fixed = to_fixed(sig, rec->value, &q);
+
+  uint8_t tmp[LOG_CODEC_MAX_RECORD_BYTES];
+  uint8_t n = 0;
+  uint8_t tag = sig;
+  if (!tracked || meta != e->meta[sig]) tag |= TAG_META;
+  if (!fixed) tag |= TAG_RAWF;
+  tmp[n++] = tag;
+  if (tag & TAG_META) {
+    tmp[n++] = rec->quality;
+    tmp[n++] = rec->src;
+  }
+  const int32_t delta = (int32_t)(rec->t_ms - e->prev_t);
+  n += put_varint(tmp + n, zigzag((int64_t)delta - e->prev_delta));
+  if (fixed) {
+    n += put_varint(tmp + n, zigzag((int64_t)q - e->prev_q[sig]));
+  } else {
+    memcpy(tmp + n, &rec->value, sizeof(float));
+    n += sizeof(float);
+  }
+  if (e->bytes + n > cap) return false;
+
+  memcpy(payload + e->bytes, tmp, n);
+  e->bytes += n;
+  e->count++;
+  e->prev_t = rec->t_ms;
+  e->prev_delta = delta;
+  if (tracked) {
+    e->meta[sig] = meta;
+    if (fixed) e->prev_q[sig] = q;
+  }
+  return true;
+}
+
+static int decode_dod(const log_block_header_t* h, const uint8_t* p, log_record_t* out, uint16_t max) {
+  const uint16_t len = h->payload_bytes;
+  uint16_t pos = 0;
+  uint32_t prev_t = h->base_ms;
+  int32_t prev_delta = 0;
+  int32_t prev_q[SIG_COUNT] = {};
+  uint16_t meta[SIG_COUNT];
+  memset(meta, 0xFF, sizeof(meta));
+
+  for (uint16_t i = 0; i < h->count; ++i) {
+    if (i >= max || pos >= len) return -1;
+    log_record_t& r = out[i];
+    const uint8_t tag = p[pos++];
+    const uint8_t sig = tag & TAG_SIG_MASK;
+    const bool tracked = sig < SIG_COUNT;
+    if (tag & TAG_META) {
+      if (pos + 2 > len) return -1;
+      r.quality = p[pos++];
+      r.src = p[pos++];
+    } else {
+      if (!tracked || meta[sig] == 0xFFFF) return -1;
+      r.quality = (uint8_t)(meta[sig] >> 8);
+      r.src = (uint8_t)meta[sig];
+    }
+
+    uint64_t v;
+    if (!get_varint(p, len, &pos, &v)) return -1;
+    const int32_t delta = (int32_t)((int64_t)prev_delta + unzigzag(v));
+    r.t_ms = prev_t + (uint32_t)delta;
+    prev_t = r.t_ms;
+    prev_delta = delta;
+
+    if (tag & TAG_RAWF) {
+      if (pos + sizeof(float) > len) return -1;
+      memcpy(&r.value, p + pos, sizeof(float));
+      pos += sizeof(float);
+    } else {
+      if (!tracked || !get_varint(p, len, &pos, &v)) return -1;
+      const int32_t q = (int32_t)((int64_t)prev_q[sig] + unzigzag(v));
+      prev_q[sig] = q;
+      r.value = (float)q / k_signal_meta[sig].fixed_scale;
+    }
+    r.sig = sig;
+    r.reserved = 0;
+    if (tracked) meta[sig] = (uint16_t)(r.quality << 8 | r.src);
+  }
+  return pos == len ? h->count : -1;
+}
+
+int log_block_decode(const uint8_t* block, log_record_t* out, uint16_t max) {
+  const log_block_header_t* h = (const log_block_header_t*)block;
+  const uint8_t* payload = block + sizeof(log_block_header_t);
+  switch (h->codec) {
+    case LOG_CODEC_RAW:
+      if (h->count > max || h->payload_bytes != h->count * sizeof(log_record_t)) return -1;
+      memcpy(out, payload, h->payload_bytes);
+      return h->count;
+    case LOG_CODEC_DOD:
+      return decode_dod(h, payload, out, max);
+    default:
+      return -1;
+  }
+}
+
+#if !defined(ARDUINO)
+#include "platform.h"
+#include "logging_policy.h"
+#include <vector>
+
+// Synthetic voyage: engine steps between cruise settings, boat speed follows
+// RPM, heading/COG wander with autopilot noise, wind gusts, battery drains
+// slowly, position advances. Rates follow typical N2K transmit intervals.
+static void synth_voyage(uint32_t hours, std::vector<log_record_t>* out) {
+  static const float k_rate_hz[SIG_COUNT] = {10, 2, 1, 5, 10, 0.1f, 1, 2, 1, 2, 2, 0.5f, 1, 1};
+  uint32_t lcg = 12345;
+  auto rnd = [&lcg]() { lcg = lcg * 1664525u + 1013904223u; return (float)(lcg >> 8) / 16777216.0f - 0.5f; };
+
+  double next_ms[SIG_COUNT] = {};
+  const double end_ms = hours * 3600000.0;
+  float rpm = 0, target = 1500, heading = 90, soc = 95, lat = 59.3f, lon = 18.1f, wind = 12;
+  for (;;) {
+    int s = 0;
+    for (int i = 1; i < SIG_COUNT; ++i) if (next_ms[i] < next_ms[s]) s = i;
+    const double t = next_ms[s];
+    if (t >= end_ms) break;
+    next_ms[s] += 1000.0 / k_rate_hz[s];
+
+    if (fmod(t, 600000.0) < 1.0) target = (float)(800 + 700 * (int)(3 * (rnd() + 0.5f)));
+    float v = 0;
+    switch (s) {
+      case SIG_RPM:          rpm += (target - rpm) * 0.02f; v = roundf((rpm + 4 * rnd()) * 4) / 4; break;
+      case SIG_STW:          v = rpm * 0.0045f + 0.05f * rnd(); break;
+      case SIG_SOG:          v = rpm * 0.0045f + 0.3f + 0.05f * rnd(); break;
+      case SIG_COG:          v = heading + 2 * rnd(); break;
+      case SIG_HEADING:      heading = fmodf(heading + 0.02f * rnd() + 360, 360); v = heading; break;
+      case SIG_SOC:          soc -= 0.001f; v = roundf(soc * 2) / 2; break;
+      case SIG_PACK_VOLTAGE: v = 330 + soc * 0.8f - rpm * 0.002f + 0.05f * rnd(); break;
+      case SIG_PACK_CURRENT: v = rpm * 0.05f + 2 * rnd(); break;
+      case SIG_XTE:          v = 0.02f * rnd(); break;
+      case SIG_WIND_SPEED:   wind += 0.2f * rnd(); v = wind + 1.5f * rnd(); break;
+      case SIG_WIND_ANGLE:   v = 45 + 10 * rnd(); break;
+      case SIG_COOLANT_TEMP: v = 40 + rpm * 0.01f; break;
+      case SIG_LAT:          lat += 1e-6f * rpm * 0.0045f; v = lat; break;
+      case SIG_LON:          lon += 2e-6f * rpm * 0.0045f; v = lon; break;
+    }
+    log_record_t r = {};
+    r.t_ms = (uint32_t)t + (uint32_t)(2.5f + 2 * rnd());
+    r.value = v;
+    r.sig = (uint8_t)s;
+    r.quality = 1;
+    r.src = (uint8_t)(s < 5 ? 0x10 : 0x20 + s);
+    out->push_back(r);
+  }
+}
+
+void log_codec_benchmark(uint32_t hours) {
+  std::vector<log_record_t> recs;
+  synth_voyage(hours, &recs);
+  static uint8_t block[LOG_BLOCK_BYTES];
+  static log_record_t decoded[LOG_CODEC_MAX_RECORDS];
+  std::vector<uint8_t> blocks;
+
+  for (uint8_t codec : {LOG_CODEC_RAW, LOG_CODEC_DOD}) {
+    blocks.clear();
+    log_encoder_t enc;
+    log_block_header_t* h = (log_block_header_t*)block;
+    uint8_t* payload = block + sizeof(log_block_header_t);
+
+    const uint32_t t0 = plat_micros();
+    size_t i = 0;
+    while (i < recs.size()) {
+      memset(block, 0, sizeof(block));
+      h->magic = LOG_BLOCK_MAGIC;
+      h->version = LOG_FORMAT_VERSION;
+      h->codec = codec;
+      h->base_ms = recs[i].t_ms;
+      log_encoder_reset(&enc, codec, recs[i].t_ms);
+      while (i < recs.size() && log_encoder_append(&enc, payload, LOG_BLOCK_PAYLOAD, &recs[i])) i++;
+      h->count = enc.count;
+      h->payload_bytes = enc.bytes;
+      h->last_ms = recs[i - 1].t_ms;
+      log_block_seal(block);
+      blocks.insert(blocks.end(), block, block + LOG_BLOCK_BYTES);
+    }
+    const uint32_t enc_us = plat_micros() - t0;
+
+    const uint32_t t1 = plat_micros();
+    size_t n = 0, mismatches = 0;
+    for (size_t b = 0; b < blocks.size(); b += LOG_BLOCK_BYTES) {
+      const int got = log_block_decode(&blocks[b], decoded, LOG_CODEC_MAX_RECORDS);
+      if (got < 0) {
+        mismatches++;
+        continue;
+      }
+      for (int k = 0; k < got; ++k, ++n) {
+        const log_record_t& a = recs[n];
+        const log_record_t& d = decoded[k];
+        int32_t q;
+        const float want = (codec == LOG_CODEC_DOD && to_fixed(a.sig, a.value, &q))
+                               ? (float)q / k_signal_meta[a.sig].fixed_scale : a.value;
+        if (d.t_ms != a.t_ms || d.sig != a.sig || d.src != a.src || d.quality != a.quality || d.value != want)
+          mismatches++;
+      }
+    }
+    const uint32_t dec_us = plat_micros() - t1;
+
+    const double mb = recs.size() * sizeof(log_record_t) / 1e6;
+    DBG_LOGI("[codec] %s: %u h, %u records, %u blocks (%.1f MB/day), %.2f B/record, ratio %.2fx, "
+             "encode %.0f MB/s, decode %.0f MB/s, mismatches %u",
+             codec == LOG_CODEC_RAW ? "raw" : "dod", (unsigned)hours, (unsigned)recs.size(),
+             (unsigned)(blocks.size() / LOG_BLOCK_BYTES), blocks.size() * 24.0 / hours / 1e6,
+             (double)blocks.size() / recs.size(), recs.size() * sizeof(log_record_t) / (double)blocks.size(),
+             mb / (enc_us / 1e6), mb / (dec_us / 1e6), (unsigned)mismatches + (unsigned)(recs.size() - n));
+  }
+}
+#endif
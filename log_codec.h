@@ -0,0 +1,50 @@
+#pragma once
+
+#include "log_format.h"
+#include "signals.h"
+#include <stdint.h>
+
+// Block payload codecs for the SD signal log.
+//
+// LOG_CODEC_DOD packs each record as
+//
+//   tag      sig (bits 0-4) | META (bit 5) | RAWF (bit 6)
+//   [META]   quality, src               when they differ from the signal's
+//                                       previous record in this block
+//   time     zig-zag varint of the delta-of-delta of t_ms
+//   value    RAWF ? float32 : zig-zag varint of the delta of
+//            round(value * fixed_scale) from the signal's previous value
+//
+// All state starts from the block header (base_ms), so each block decodes
+// on its own and index seeks still land on a decodable boundary. Values are
+// kept at the signal's fixed_scale (signals.h), the same precision as RAM
+// history; non-finite or out-of-range values fall back to a raw float.
+
+#define LOG_CODEC_MAX_RECORD_BYTES  24
+// Upper bound on records a DOD block can hold (3-byte minimum record).
+#define LOG_CODEC_MAX_RECORDS       (LOG_BLOCK_PAYLOAD / 3)
+
+struct log_encoder_t {
+  uint8_t  codec;
+  uint16_t bytes;
+  uint16_t count;
+  uint32_t prev_t;
+  int32_t  prev_delta;
+  int32_t  prev_q[SIG_COUNT];
+  uint16_t meta[SIG_COUNT];   // quality << 8 | src, 0xFFFF = none yet
+};
+
+void log_encoder_reset(log_encoder_t* e, uint8_t codec, uint32_t base_ms);
+// Appends one record to `payload` (capacity `cap`); false if it does not fit.
+bool log_encoder_append(log_encoder_t* e, uint8_t* payload, uint16_t cap, const log_record_t* rec);
+
+// Decodes a validated block (any codec). Returns the record count, or -1 if
+// the payload is malformed or holds more than `max` records.
+int log_block_decode(const uint8_t* block, log_record_t* out, uint16_t max);
+
+#if !defined(ARDUINO)
+// Host only: encodes `hours` of a synthetic voyage with both codecs and logs
+// compression ratio plus encode/decode throughput. Driver:
+// tests/run_host_tests.sh log_codec_bench.
+void log_codec_benchmark(uint32_t hours);
+#endif
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+// On-SD signal log format (little-endian).
+//
+//   logs/YYYYMMDD/signals_NN.bin  = sequence of LOG_BLOCK_BYTES blocks
+//   logs/YYYYMMDD/index.idx       = sparse time index (log_index.h)
+//   block = log_block_header_t + payload (records), zero padded
+//
+// Blocks are self-contained: the header carries the time range, record
+// count and a CRC-32 over header (crc field zeroed) + payload, so any block
+// can be validated and decoded on its own.
+
+#define LOG_BLOCK_BYTES     4096
+#define LOG_BLOCK_MAGIC     0x31424C4Eu   // "NLB1"
+#define LOG_FORMAT_VERSION  1
+
+enum log_codec_t : uint8_t {
+  LOG_CODEC_RAW = 0,   // payload is log_record_t[count]
+  LOG_CODEC_DOD = 1,   // delta-of-delta time + fixed-point value deltas (log_codec.h)
+};
+
+struct log_record_t {
+  uint32_t t_ms;      // monotonic plat_millis()
+  float    value;
+  uint8_t  sig;       // signal_id_t
+  uint8_t  quality;   // signal_quality_t
+  uint8_t  src;       // NMEA2000 source address
+  uint8_t  reserved;
+};
+static_assert(sizeof(log_record_t) == 12, "log_record_t is part of the file format");
+
+struct log_block_header_t {
+  uint32_t magic;
+  uint8_t  version;
+  uint8_t  codec;
+  uint16_t utc_ms;         // sub-second part of utc_s
+  uint32_t seq;            // block number within the segment
+  uint32_t base_ms;        // first record time
+  uint32_t last_ms;        // last record time
+  uint32_t utc_s;          // wall clock at the first record (0 = clock unset)
+  uint16_t count;
+  uint16_t payload_bytes;
+  uint32_t crc32;
+};
+static_assert(sizeof(log_block_header_t) == 32, "log_block_header_t is part of the file format");
+
+#define LOG_BLOCK_PAYLOAD      (LOG_BLOCK_BYTES - sizeof(log_block_header_t))
+#define LOG_BLOCK_MAX_RECORDS  (LOG_BLOCK_PAYLOAD / sizeof(log_record_t))   // LOG_CODEC_RAW
+
+// Fills in crc32 for a finished block.
+void log_block_seal(uint8_t* block);
+// Magic, version, sizes and CRC check.
+bool log_block_valid(const uint8_t* block);
+
+// Wall-clock time of a record in this block, or -1 if the clock was unset.
+static inline int64_t log_block_utc_ms(const log_block_header_t* h, uint32_t t_ms) {
+  if (!h->utc_s) return -1;
+  return (int64_t)h->utc_s * 1000 + h->utc_ms + (uint32_t)(t_ms - h->base_ms);
+}
+
+// Days are numbered from the Unix epoch; names are "YYYYMMDD" (UTC).
+static inline uint32_t log_day_of(int64_t utc_ms) {
+  return (uint32_t)(utc_ms / 86400000);
+}
+
+static inline void log_day_name(char out[9], uint32_t day) {
+  const time_t t = (time_t)day * 86400;
+  struct tm tm_utc;
+  gmtime_r(&t, &tm_utc);
+  strftime(out, 9, "%Y%m%d", &tm_utc);
+}
+
+static inline void log_day_dir(char* out, size_t cap, const char* day) {
+  snprintf(out, cap, "logs/%s", day);
+}
+
+static inline void log_segment_path(char* out, size_t cap, const char* day, uint8_t nn) {
+  snprintf(out, cap, "logs/%s/signals_%02u.bin", day, (unsigned)nn);
+}
+
+static inline void log_index_path(char* out, size_t cap, const char* day) {
+  snprintf(out, cap, "logs/%s/index.idx", day);
+}
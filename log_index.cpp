@@ -0,0 +1,120 @@
+#include "log_index.h"
+#include "log_format.h"
+#include "log_storage.h"
+#include "crc32.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <string.h>
+
+struct index_slot_t {
+  uint32_t           day;
+  uint32_t           count;
+  uint32_t           file_bytes;   // bytes of index.idx consumed so far
+  uint32_t           last_used;
+  bool               loaded;
+  log_index_entry_t* entries;      // LOG_INDEX_MAX_ENTRIES, PSRAM
+};
+
+static index_slot_t s_slots[LOG_INDEX_CACHE_DAYS];
+static uint32_t     s_use_clock = 0;
+
+static uint16_t entry_check(const log_index_entry_t* e) {
+  return (uint16_t)crc32_update(0, e, offsetof(log_index_entry_t, check));
+}
+
+void log_index_entry_seal(log_index_entry_t* e) {
+  e->reserved = 0;
+  e->check = entry_check(e);
+}
+
+bool log_index_entry_valid(const log_index_entry_t* e) {
+  return e->check == entry_check(e);
+}
+
+static index_slot_t* slot_for(uint32_t day) {
+  index_slot_t* victim = &s_slots[0];
+  for (auto& s : s_slots) {
+    if (s.loaded && s.day == day) return &s;
+    if (!s.loaded || s.last_used < victim->last_used) victim = &s;
+  }
+  if (!victim->entries) {
+    victim->entries = (log_index_entry_t*)plat_psram_alloc(LOG_INDEX_MAX_ENTRIES * sizeof(log_index_entry_t));
+    if (!victim->entries) {
+      DBG_LOGE("[idx] cache alloc failed");
+      return nullptr;
+    }
+  }
+  victim->day = day;
+  victim->count = 0;
+  victim->file_bytes = 0;
+  victim->loaded = true;
+  return victim;
+}
+
+// Loads the day on first use; afterwards only reads entries appended since
+// (today's index keeps growing while the writer runs).
+static index_slot_t* load_day(uint32_t day) {
+  index_slot_t* s = slot_for(day);
+  if (!s) return nullptr;
+  s->last_used = ++s_use_clock;
+
+  char name[9], path[48];
+  log_day_name(name, day);
+  log_index_path(path, sizeof(path), name);
+  log_file_t* f = log_storage_open(path, LOG_OPEN_READ);
+  if (!f) return s;
+
+  const int32_t size = log_storage_size(f);
+  if (size > 0 && (uint32_t)size < s->file_bytes) {   // rewritten by recovery
+    s->count = 0;
+    s->file_bytes = 0;
+  }
+  if (size > 0 && (uint32_t)size > s->file_bytes + sizeof(log_index_entry_t) - 1 &&
+      log_storage_seek(f, s->file_bytes)) {
+    log_index_entry_t buf[64];
+    bool torn = false;
+    while (!torn && s->count < LOG_INDEX_MAX_ENTRIES) {
+      const int32_t n = log_storage_read(f, buf, sizeof(buf));
+      const uint32_t got = n > 0 ? (uint32_t)n / sizeof(log_index_entry_t) : 0;
+      if (!got) break;
+      for (uint32_t i = 0; i < got && s->count < LOG_INDEX_MAX_ENTRIES; ++i) {
+        if (!log_index_entry_valid(&buf[i])) {   // torn tail: retry it next time
+          torn = true;
+          break;
+        }
+        s->entries[s->count++] = buf[i];
+        s->file_bytes += sizeof(log_index_entry_t);
+      }
+    }
+  }
+  log_storage_close(f);
+  return s;
+}
+
+bool log_index_seek(uint32_t day, int64_t utc_ms, uint8_t* seg, uint32_t* offset) {
+  const index_slot_t* s = load_day(day);
+  if (!s || !s->count) return false;
+
+  // Last entry with utc_s * 1000 + 1000 <= utc_ms. The block's first record
+  // is at most 999 ms after utc_s, so it cannot skip records in the window.
+  uint32_t lo = 0, hi = s->count;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if ((int64_t)s->entries[mid].utc_s * 1000 + 1000 <= utc_ms) lo = mid + 1;
+    else hi = mid;
+  }
+  if (!lo) return false;
+  *seg = s->entries[lo - 1].seg;
+  *offset = s->entries[lo - 1].offset;
+  return true;
+}
+
+uint32_t log_index_entries(uint32_t day) {
+  const index_slot_t* s = load_day(day);
+  return s ? s->count : 0;
+}
+
+void log_index_invalidate(void) {
+  for (auto& s : s_slots) s.loaded = false;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+// Sparse time index for SD signal logs (NMEA2000_SD_LOGGING_PLAN.md, 5.3).
+//
+// The writer appends one entry per day directory (logs/YYYYMMDD/index.idx)
+// at the first block of every segment and then at most every
+// LOG_INDEX_INTERVAL_S, always after the data it points to is written.
+// Readers load a day's index lazily into a small PSRAM cache and binary
+// search it, so a window query costs one index lookup plus a seek instead of
+// a scan. Entries are in write order; a clock stepped backwards mid-day
+// only makes the search start earlier than necessary.
+//
+// The reader side (lookup/cache) is not thread-safe: use it from one query
+// thread.
+
+#ifndef LOG_INDEX_INTERVAL_S
+  #define LOG_INDEX_INTERVAL_S  10
+#endif
+#ifndef LOG_INDEX_CACHE_DAYS
+  #define LOG_INDEX_CACHE_DAYS  2
+#endif
+#define LOG_INDEX_MAX_ENTRIES   (86400 / LOG_INDEX_INTERVAL_S + 1024)
+
+struct log_index_entry_t {
+  uint32_t utc_s;      // log_block_header_t::utc_s of the indexed block
+  uint32_t offset;     // byte offset of the block in the segment
+  uint8_t  seg;        // segment number NN
+  uint8_t  reserved;
+  uint16_t check;      // low 16 bits of CRC-32 over the bytes above
+};
+static_assert(sizeof(log_index_entry_t) == 12, "log_index_entry_t is part of the file format");
+
+void log_index_entry_seal(log_index_entry_t* e);
+bool log_index_entry_valid(const log_index_entry_t* e);
+
+// Finds the last indexed block of `day` that starts at least one second
+// before `utc_ms` (so no record at or after utc_ms precedes it).
+// Returns false if the day has no such entry.
+bool log_index_seek(uint32_t day, int64_t utc_ms, uint8_t* seg, uint32_t* offset);
+
+// Number of entries currently loaded for `day` (loads it if needed).
+uint32_t log_index_entries(uint32_t day);
+
+// Drops all cached days (e.g. after recovery rewrote an index).
+void log_index_invalidate(void);
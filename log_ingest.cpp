@@ -0,0 +1,114 @@
+#include "log_ingest.h"
+#include "log_writer.h"
+#include "spsc_ring.h"
+#include "logging_policy.h"
+
+#include <atomic>
+#include <math.h>
+
+static spsc_ring<log_record_t, LOG_QUEUE_CRIT_DEPTH> s_crit;
+static spsc_ring<log_record_t, LOG_QUEUE_DEPTH>      s_shared;
+
+// Shared-ring fill at which each class stops being admitted.
+static constexpr uint32_t k_budget[SIG_CLASS_COUNT] = {
+  LOG_QUEUE_DEPTH,
+  LOG_QUEUE_DEPTH * LOG_INGEST_BUDGET_NORMAL_PCT / 100,
+  LOG_QUEUE_DEPTH * LOG_INGEST_BUDGET_BULK_PCT / 100,
+};
+static_assert(LOG_INGEST_BUDGET_BULK_PCT <= LOG_INGEST_BUDGET_NORMAL_PCT &&
+              LOG_INGEST_BUDGET_NORMAL_PCT < 100, "budgets must leave shared-ring room for critical records");
+
+static const float k_display_step[] = {1.0f, 0.1f, 0.01f, 0.001f, 1e-4f, 1e-5f, 1e-6f};
+
+// Producer-side decimation state: the last record admitted per signal.
+struct last_admitted_t {
+  uint32_t t_ms;
+  float    value;
+  bool     valid;
+};
+static last_admitted_t s_last[SIG_COUNT];
+
+// Published counters (written by the producer, read anywhere).
+static std::atomic<uint32_t> s_accepted[SIG_CLASS_COUNT], s_decimated[SIG_CLASS_COUNT], s_dropped[SIG_CLASS_COUNT];
+static std::atomic<uint32_t> s_crit_spilled{0};
+
+static inline void bump(std::atomic<uint32_t>& c) {
+  c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+// Pressure policy for one non-critical record; true if it should be queued.
+static bool admit(const log_record_t* rec, signal_class_t cls, uint32_t fill) {
+  const uint32_t level = fill * 4 / k_budget[cls];   // 0..3 below budget
+  const last_admitted_t& last = s_last[rec->sig];
+  if (!level || !last.valid) return true;
+
+  const uint32_t dt = rec->t_ms - last.t_ms;
+  if (dt < ((uint32_t)LOG_INGEST_MIN_INTERVAL_MS << (level - 1))) return false;
+  const uint8_t dec = k_signal_meta[rec->sig].decimals;
+  const float step = k_display_step[dec < 6 ? dec : 6] * level;
+  return dt >= LOG_INGEST_HEARTBEAT_MS || !(fabsf(rec->value - last.value) < step);
+}
+
+bool log_ingest_push(const log_record_t* rec) {
+  if (rec->sig >= SIG_COUNT) return false;
+  const signal_class_t cls = k_signal_meta[rec->sig].log_class;
+
+  bool queued;
+  if (cls == SIG_CLASS_CRITICAL) {
+    queued = s_crit.push(*rec);
+    if (!queued && s_shared.push(*rec)) {
+      queued = true;
+      bump(s_crit_spilled);
+    }
+  } else {
+    const uint32_t fill = s_shared.size();
+    if (fill >= k_budget[cls]) {
+      queued = false;
+    } else if (!admit(rec, cls, fill)) {
+      bump(s_decimated[cls]);
+      return false;
+    } else {
+      queued = s_shared.push(*rec);
+    }
+  }
+  if (!queued) {
+    bump(s_dropped[cls]);
+    return false;
+  }
+  s_last[rec->sig] = {rec->t_ms, rec->value, true};
+  bump(s_accepted[cls]);
+  return true;
+}
+
+bool log_ingest_pop(log_record_t* out) {
+  const log_record_t* c = s_crit.front();
+  const log_record_t* s = s_shared.front();
+  if (c && (!s || (int32_t)(c->t_ms - s->t_ms) <= 0)) return s_crit.pop(out);
+  return s && s_shared.pop(out);
+}
+
+void log_ingest_get_stats(log_ingest_stats_t* out) {
+  for (int c = 0; c < SIG_CLASS_COUNT; ++c) {
+    out->cls[c].accepted = s_accepted[c].load(std::memory_order_relaxed);
+    out->cls[c].decimated = s_decimated[c].load(std::memory_order_relaxed);
+    out->cls[c].dropped = s_dropped[c].load(std::memory_order_relaxed);
+  }
+  out->crit_spilled = s_crit_spilled.load(std::memory_order_relaxed);
+  out->crit_depth = s_crit.size();
+  out->crit_high_water = s_crit.high_water();
+  out->shared_depth = s_shared.size();
+  out->shared_high_water = s_shared.high_water();
+}
+
+void log_ingest_report(void) {
+  log_ingest_stats_t s;
+  log_ingest_get_stats(&s);
+  DBG_LOGI("[log] ingest acc/dec/drop crit=%u/%u/%u normal=%u/%u/%u bulk=%u/%u/%u spill=%u crit_q=%u/%u hw=%u shared_q=%u/%u hw=%u",
+           (unsigned)s.cls[SIG_CLASS_CRITICAL].accepted, (unsigned)s.cls[SIG_CLASS_CRITICAL].decimated,
+           (unsigned)s.cls[SIG_CLASS_CRITICAL].dropped, (unsigned)s.cls[SIG_CLASS_NORMAL].accepted,
+           (unsigned)s.cls[SIG_CLASS_NORMAL].decimated, (unsigned)s.cls[SIG_CLASS_NORMAL].dropped,
+           (unsigned)s.cls[SIG_CLASS_BULK].accepted, (unsigned)s.cls[SIG_CLASS_BULK].decimated,
+           (unsigned)s.cls[SIG_CLASS_BULK].dropped, (unsigned)s.crit_spilled, (unsigned)s.crit_depth,
+           (unsigned)LOG_QUEUE_CRIT_DEPTH, (unsigned)s.crit_high_water, (unsigned)s.shared_depth,
+           (unsigned)LOG_QUEUE_DEPTH, (unsigned)s.shared_high_water);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "log_format.h"
+#include "signals.h"
+#include <stdint.h>
+
+// Priority-aware ingest queue between the bus task and the SD writer
+// (NMEA2000_SD_LOGGING_PLAN.md, section 6: never drop critical signals,
+// downsample non-critical high-rate signals first).
+//
+// Two SPSC rings: a reserved one for SIG_CLASS_CRITICAL and a shared one of
+// LOG_QUEUE_DEPTH for everything else. Each non-critical class has a budget,
+// the shared-ring fill at which it stops being admitted (BULK before NORMAL),
+// so the top of the shared ring stays free for critical records that
+// overflow their own ring. Below its budget a class is thinned adaptively:
+// past a quarter of the budget each signal keeps at most one sample per
+// LOG_INGEST_MIN_INTERVAL_MS (doubling with each further quarter) and drops
+// changes smaller than one display step, with a heartbeat so a flat signal
+// still gets logged. Critical records are only lost if both rings are full.
+//
+// Single producer (log_writer_push), single consumer (the writer task). The
+// consumer pops the older head of the two rings, so records leave in
+// timestamp order.
+
+#ifndef LOG_QUEUE_CRIT_DEPTH
+  #define LOG_QUEUE_CRIT_DEPTH          512    // records, power of two
+#endif
+#ifndef LOG_INGEST_BUDGET_NORMAL_PCT
+  #define LOG_INGEST_BUDGET_NORMAL_PCT  75     // of LOG_QUEUE_DEPTH
+#endif
+#ifndef LOG_INGEST_BUDGET_BULK_PCT
+  #define LOG_INGEST_BUDGET_BULK_PCT    50
+#endif
+#ifndef LOG_INGEST_MIN_INTERVAL_MS
+  #define LOG_INGEST_MIN_INTERVAL_MS    100    // per-signal spacing at the first pressure level
+#endif
+#ifndef LOG_INGEST_HEARTBEAT_MS
+  #define LOG_INGEST_HEARTBEAT_MS       2000   // deadband never holds a signal back longer
+#endif
+
+struct log_ingest_class_stats_t {
+  uint32_t accepted;
+  uint32_t decimated;   // thinned by the pressure policy
+  uint32_t dropped;     // over budget, or both rings full (critical)
+};
+
+struct log_ingest_stats_t {
+  log_ingest_class_stats_t cls[SIG_CLASS_COUNT];
+  uint32_t crit_spilled;        // critical records queued in the shared ring
+  uint32_t crit_depth;
+  uint32_t crit_high_water;
+  uint32_t shared_depth;
+  uint32_t shared_high_water;
+};
+
+// Producer. Returns true if the record was queued.
+bool log_ingest_push(const log_record_t* rec);
+
+// Consumer. Oldest queued record of either ring.
+bool log_ingest_pop(log_record_t* out);
+
+void log_ingest_get_stats(log_ingest_stats_t* out);
+void log_ingest_report(void);
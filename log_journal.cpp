@@ -0,0 +1,222 @@
+#include "log_journal.h"
+#include "log_format.h"
+#include "log_index.h"
+#include "log_rollup.h"
+#include "log_storage.h"
+#include "crc32.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define LOG_JOURNAL_MAGIC  0x4A4C4E31u   // "1NLJ"
+#define LOG_JOURNAL_PATH   "logs/journal.bin"
+
+static log_file_t* s_jf = nullptr;
+static uint32_t    s_gen = 0;
+static bool        s_dirty = false;
+
+static uint32_t slot_crc(const log_journal_slot_t* s) {
+  return crc32_update(0, s, offsetof(log_journal_slot_t, crc32));
+}
+
+bool log_journal_commit(uint32_t day, uint8_t seg, uint32_t seg_bytes) {
+  if (!s_jf) {
+    if (!log_storage_mkdirs("logs")) return false;
+    s_jf = log_storage_open(LOG_JOURNAL_PATH, LOG_OPEN_RW);
+    if (!s_jf) return false;
+  }
+  log_journal_slot_t s = {};
+  s.magic = LOG_JOURNAL_MAGIC;
+  s.gen = ++s_gen;
+  s.day = day;
+  s.seg = seg;
+  s.seg_bytes = seg_bytes;
+  const int64_t utc = plat_utc_ms();
+  s.utc_s = (uint32_t)(utc / 1000);
+  s.crc32 = slot_crc(&s);
+  // Ping-pong: never overwrite the slot holding the previous commit.
+  if (!log_storage_seek(s_jf, (s.gen & 1) * sizeof(s))) return false;
+  if (log_storage_write(s_jf, &s, sizeof(s)) != (int32_t)sizeof(s)) return false;
+  s_dirty = true;
+  return true;
+}
+
+bool log_journal_sync(void) {
+  if (!s_jf || !s_dirty) return true;
+  s_dirty = false;
+  return log_storage_sync(s_jf);
+}
+
+// ---- Recovery ----
+
+static bool read_at(log_file_t* f, uint32_t offset, void* buf, uint32_t len) {
+  return log_storage_seek(f, offset) && log_storage_read(f, buf, len) == (int32_t)len;
+}
+
+static int32_t file_size(const char* path) {
+  log_file_t* f = log_storage_open(path, LOG_OPEN_READ);
+  if (!f) return -1;
+  const int32_t size = log_storage_size(f);
+  log_storage_close(f);
+  return size;
+}
+
+// Keeps the longest prefix ending in a valid block, looking at no more than
+// LOG_RECOVERY_MAX_BLOCKS tail blocks. Returns the recovered length.
+static uint32_t recover_segment(const char* path, log_recovery_report_t* rep) {
+  log_file_t* f = log_storage_open(path, LOG_OPEN_READ);
+  if (!f) return 0;
+  const uint32_t size = (uint32_t)log_storage_size(f);
+  uint32_t end = size - size % LOG_BLOCK_BYTES;
+
+  static uint8_t block[LOG_BLOCK_BYTES];
+  for (uint16_t n = 0; end && n < LOG_RECOVERY_MAX_BLOCKS; ++n) {
+    rep->blocks_checked++;
+    if (read_at(f, end - LOG_BLOCK_BYTES, block, LOG_BLOCK_BYTES) && log_block_valid(block)) break;
+    end -= LOG_BLOCK_BYTES;
+  }
+  log_storage_close(f);
+
+  if (end != size) {
+    log_storage_truncate(path, end);
+    rep->truncated_bytes += size - end;
+    DBG_LOGW("[log] recovery: %s truncated %u -> %u", path, (unsigned)size, (unsigned)end);
+  }
+  return end;
+}
+
+typedef bool (*record_ok_fn)(const void* rec, void* ctx);
+
+// Drops a torn partial record and up to LOG_RECOVERY_MAX_BLOCKS trailing
+// records that fail `ok`. Returns the number of records dropped.
+static uint16_t recover_records(const char* path, uint32_t rec_size, record_ok_fn ok, void* ctx,
+                                log_recovery_report_t* rep) {
+  log_file_t* f = log_storage_open(path, LOG_OPEN_READ);
+  if (!f) return 0;
+  const uint32_t size = (uint32_t)log_storage_size(f);
+  uint32_t end = size - size % rec_size;
+  uint16_t dropped = 0;
+  uint8_t rec[32];
+  while (end && dropped < LOG_RECOVERY_MAX_BLOCKS) {
+    if (read_at(f, end - rec_size, rec, rec_size) && ok(rec, ctx)) break;
+    end -= rec_size;
+    dropped++;
+  }
+  log_storage_close(f);
+
+  if (end != size) {
+    log_storage_truncate(path, end);
+    rep->truncated_bytes += size - end;
+  }
+  return dropped;
+}
+
+struct seg_sizes_t {
+  uint8_t  first;      // journaled segment
+  uint8_t  count;
+  uint32_t bytes[4];
+};
+
+static bool index_entry_ok(const void* rec, void* ctx) {
+  const log_index_entry_t* e = (const log_index_entry_t*)rec;
+  const seg_sizes_t* s = (const seg_sizes_t*)ctx;
+  if (!log_index_entry_valid(e)) return false;
+  if (e->seg < s->first) return true;
+  if (e->seg >= s->first + s->count) return false;
+  return e->offset + LOG_BLOCK_BYTES <= s->bytes[e->seg - s->first];
+}
+
+static bool rollup_ok(const void* rec, void*) {
+  return log_rollup_bucket_valid((const log_rollup_bucket_t*)rec);
+}
+
+static void recover_rollups(uint32_t day, log_recovery_report_t* rep) {
+  char path[64];
+  for (int t = 0; t < LOG_ROLLUP_TIERS; ++t) {
+    log_rollup_path(path, sizeof(path), day, t);
+    rep->rollups_dropped += recover_records(path, sizeof(log_rollup_bucket_t), rollup_ok, nullptr, rep);
+  }
+}
+
+// Checks segment `seg` of `day`, any opened after it, and the day's index and
+// rollup tails. Returns the recovered length of segment `seg`.
+static uint32_t recover_day(uint32_t day, uint8_t seg, log_recovery_report_t* rep) {
+  char name[9], path[64];
+  log_day_name(name, day);
+  seg_sizes_t sizes = {seg, 0, {}};
+  for (uint8_t nn = seg; sizes.count < 4 && nn < 100; ++nn) {
+    log_segment_path(path, sizeof(path), name, nn);
+    if (nn != seg && file_size(path) < 0) break;
+    sizes.bytes[sizes.count++] = recover_segment(path, rep);
+  }
+  log_index_path(path, sizeof(path), name);
+  rep->index_dropped += recover_records(path, sizeof(log_index_entry_t), index_entry_ok, &sizes, rep);
+  recover_rollups(day, rep);
+  return sizes.bytes[0];
+}
+
+bool log_recovery_run(log_recovery_report_t* rep) {
+  const uint32_t t0 = plat_micros();
+  memset(rep, 0, sizeof(*rep));
+
+  log_journal_slot_t best = {};
+  log_file_t* jf = log_storage_open(LOG_JOURNAL_PATH, LOG_OPEN_READ);
+  if (jf) {
+    log_journal_slot_t slots[2];
+    for (int i = 0; i < 2; ++i) {
+      if (!read_at(jf, i * sizeof(log_journal_slot_t), &slots[i], sizeof(slots[i]))) continue;
+      const log_journal_slot_t& s = slots[i];
+      if (s.magic == LOG_JOURNAL_MAGIC && s.crc32 == slot_crc(&s) && s.gen > best.gen) best = s;
+    }
+    log_storage_close(jf);
+  }
+  char name[9], path[64];
+  if (best.gen) {
+    s_gen = best.gen;
+    rep->journal_found = true;
+  } else {
+    // No commit yet (new card, or cut before the first one): check today's
+    // newest segment with nothing known to be committed.
+    const int64_t now = plat_utc_ms();
+    best.day = log_day_of(now);
+    log_day_name(name, best.day);
+    log_segment_path(path, sizeof(path), name, 0);
+    if (file_size(path) < 0) {
+      rep->elapsed_us = plat_micros() - t0;
+      return false;
+    }
+    for (best.seg = 0; best.seg < 99; ++best.seg) {
+      log_segment_path(path, sizeof(path), name, best.seg + 1);
+      if (file_size(path) < 0) break;
+    }
+  }
+  rep->day = best.day;
+  rep->seg = best.seg;
+  rep->committed_bytes = best.seg_bytes;
+  log_day_name(name, best.day);
+
+  rep->recovered_bytes = recover_day(best.day, best.seg, rep);
+  if (rep->recovered_bytes < best.seg_bytes) {
+    rep->lost_bytes = best.seg_bytes - rep->recovered_bytes;
+    DBG_LOGW("[log] recovery: %u committed bytes lost in %s segment %u", (unsigned)rep->lost_bytes, name,
+             (unsigned)best.seg);
+  }
+  // The writer journals a segment before writing to it, so the next day only
+  // holds data if that commit was lost; its tail is checked all the same.
+  char next[9];
+  log_day_name(next, best.day + 1);
+  log_segment_path(path, sizeof(path), next, 0);
+  if (file_size(path) >= 0) recover_day(best.day + 1, 0, rep);
+  // The rollup buckets that end at midnight are appended after the writer
+  // has moved on to the new day.
+  if (best.day) recover_rollups(best.day - 1, rep);
+  log_index_invalidate();
+
+  rep->elapsed_us = plat_micros() - t0;
+  DBG_LOGI("[log] recovery: %s seg %u committed %u, kept %u, truncated %u B, %u blocks checked, %u us", name,
+           (unsigned)best.seg, (unsigned)best.seg_bytes, (unsigned)rep->recovered_bytes,
+           (unsigned)rep->truncated_bytes, (unsigned)rep->blocks_checked, (unsigned)rep->elapsed_us);
+  return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+
+// Commit journal and boot-time tail recovery for the SD signal log.
+//
+// logs/journal.bin holds two fixed slots written ping-pong. After each
+// batch the writer stores {day, segment, committed bytes} with a generation
+// number and CRC in the older slot, so a torn journal write still leaves
+// the previous commit intact. Journal fsync follows the data fsync.
+//
+// The writer also commits each segment it opens before writing to it, so
+// the journaled day is the newest one holding data.
+//
+// At boot, recovery reads the newest valid slot and checks only the tail of
+// the journaled day: the last block of the active segment (walking back
+// over at most LOG_RECOVERY_MAX_BLOCKS torn blocks), any segment opened
+// after it, and the tail records of index.idx and the rollup files. The
+// following day (in case that segment commit was lost) and the previous
+// day's rollups (the buckets ending at midnight) get the same check. Torn
+// writes are truncated so appending resumes on a clean boundary. The cost
+// does not depend on how much is logged. Without a journal (new card, or a
+// cut before the first commit) today's newest segment is checked instead.
+
+#ifndef LOG_RECOVERY_MAX_BLOCKS
+  #define LOG_RECOVERY_MAX_BLOCKS  16
+#endif
+
+struct log_journal_slot_t {
+  uint32_t magic;
+  uint32_t gen;
+  uint32_t day;          // days since epoch (log_format.h)
+  uint8_t  seg;
+  uint8_t  reserved[3];
+  uint32_t seg_bytes;    // committed length of the segment
+  uint32_t utc_s;        // commit time (0 = clock unset)
+  uint32_t reserved2;
+  uint32_t crc32;
+};
+static_assert(sizeof(log_journal_slot_t) == 32, "log_journal_slot_t is part of the file format");
+
+struct log_recovery_report_t {
+  bool     journal_found;
+  uint32_t day;
+  uint8_t  seg;
+  uint32_t committed_bytes;
+  uint32_t recovered_bytes;     // active segment length after recovery
+  uint32_t truncated_bytes;     // torn or uncommitted tails removed (all files)
+  uint32_t lost_bytes;          // committed bytes that did not survive
+  uint16_t blocks_checked;
+  uint16_t index_dropped;
+  uint16_t rollups_dropped;
+  uint32_t elapsed_us;
+};
+
+// Writer task only.
+bool log_journal_commit(uint32_t day, uint8_t seg, uint32_t seg_bytes);
+bool log_journal_sync(void);
+
+// Runs once before the writer starts; also seeds the journal generation.
+// Returns false if nothing needed checking.
+bool log_recovery_run(log_recovery_report_t* out);
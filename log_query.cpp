@@ -0,0 +1,249 @@
+#include "log_query.h"
+#include "log_index.h"
+#include "log_codec.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <string.h>
+
+bool log_query_open(log_query_t* q, int64_t from_utc_ms, int64_t to_utc_ms, uint32_t sig_mask) {
+  memset(q, 0, sizeof(*q));
+  q->from_ms = from_utc_ms;
+  q->to_ms = to_utc_ms;
+  q->sig_mask = sig_mask;
+  if (to_utc_ms <= from_utc_ms || from_utc_ms < 0) {
+    q->done = true;
+    return false;
+  }
+  q->block = (uint8_t*)plat_psram_alloc(LOG_BLOCK_BYTES);
+  q->recs = (log_record_t*)plat_psram_alloc(LOG_CODEC_MAX_RECORDS * sizeof(log_record_t));
+  if (!q->block || !q->recs) {
+    log_query_close(q);
+    return false;
+  }
+
+  q->day = log_day_of(from_utc_ms);
+  q->last_day = log_day_of(to_utc_ms - 1);
+
+  // A window that starts before the day's first entry may still begin in
+  // the previous day's last blocks (batches spill over midnight).
+  uint8_t seg = 0;
+  uint32_t offset = 0;
+  if (log_index_seek(q->day, from_utc_ms, &seg, &offset)) {
+    q->indexed = true;
+  } else if (q->day > 0 && log_index_seek(q->day - 1, from_utc_ms, &seg, &offset)) {
+    q->day--;
+    q->indexed = true;
+  }
+  q->seg = seg;
+  q->offset = offset;
+  return true;
+}
+
+static void close_file(log_query_t* q) {
+  log_storage_close(q->f);
+  q->f = nullptr;
+}
+
+// Reads the next valid block that may overlap the window.
+static bool load_block(log_query_t* q) {
+  while (!q->done) {
+    if (!q->f) {
+      if (q->day > q->last_day) break;
+      char name[9], path[64];
+      log_day_name(name, q->day);
+      log_segment_path(path, sizeof(path), name, q->seg);
+      q->f = log_storage_open(path, LOG_OPEN_READ);
+      if (!q->f) {   // past the day's last segment
+        q->day++;
+        q->seg = 0;
+        q->offset = 0;
+        continue;
+      }
+      if (q->offset && !log_storage_seek(q->f, q->offset)) {
+        close_file(q);
+        q->seg++;
+        q->offset = 0;
+        continue;
+      }
+    }
+
+    if (log_storage_read(q->f, q->block, LOG_BLOCK_BYTES) != LOG_BLOCK_BYTES) {
+      close_file(q);
+      q->seg++;
+      q->offset = 0;
+      continue;
+    }
+    q->offset += LOG_BLOCK_BYTES;
+    q->blocks_read++;
+
+    if (!log_block_valid(q->block)) {
+      q->bad_blocks++;
+      continue;
+    }
+    const log_block_header_t* h = (const log_block_header_t*)q->block;
+    if (!h->utc_s || log_block_utc_ms(h, h->last_ms) < q->from_ms) continue;
+    if (log_block_utc_ms(h, h->base_ms) >= q->to_ms) break;
+    const int n = log_block_decode(q->block, q->recs, LOG_CODEC_MAX_RECORDS);
+    if (n < 0) {
+      q->bad_blocks++;
+      continue;
+    }
+    q->pos = 0;
+    q->n = (uint16_t)n;
+    return true;
+  }
+  q->done = true;
+  return false;
+}
+
+bool log_query_next(log_query_t* q, log_record_t* rec, int64_t* utc_ms) {
+  if (!q->block) return false;
+  for (;;) {
+    const log_block_header_t* h = (const log_block_header_t*)q->block;
+    while (q->pos < q->n) {
+      *rec = q->recs[q->pos++];
+      const int64_t t = log_block_utc_ms(h, rec->t_ms);
+      if (t < q->from_ms) continue;
+      if (t >= q->to_ms) {
+        q->done = true;
+        return false;
+      }
+      if (q->sig_mask && !(q->sig_mask & (1u << rec->sig))) continue;
+      q->records++;
+      *utc_ms = t;
+      return true;
+    }
+    if (!load_block(q)) return false;
+  }
+}
+
+void log_query_close(log_query_t* q) {
+  close_file(q);
+  plat_free(q->block);
+  plat_free(q->recs);
+  q->block = nullptr;
+  q->recs = nullptr;
+  q->done = true;
+}
+
+#if !defined(ARDUINO)
+#include "log_writer.h"
+#include "log_rollup.h"
+#include "signals.h"
+
+// Synthetic log in the writer's format: one record every 1000/rate_hz ms,
+// every other one RPM, the rest cycling through the other signals.
+static void write_synthetic_day(uint32_t day, uint32_t rate_hz, uint32_t* t_ms) {
+  char name[9], path[64];
+  log_day_name(name, day);
+  log_day_dir(path, sizeof(path), name);
+  log_storage_mkdirs(path);
+  log_index_path(path, sizeof(path), name);
+  log_storage_remove(path);
+  log_file_t* idx = log_storage_open(path, LOG_OPEN_APPEND);
+
+  static uint8_t block[LOG_BLOCK_BYTES];
+  const uint64_t per_day = 86400ull * rate_hz;
+  uint64_t i = 0;
+  uint8_t seg = 0;
+  uint32_t last_indexed = 0;
+  while (i < per_day) {
+    log_segment_path(path, sizeof(path), name, seg);
+    log_file_t* f = log_storage_open(path, LOG_OPEN_TRUNC);
+    uint32_t offset = 0;
+    bool seg_start = true;
+    while (i < per_day && offset + LOG_BLOCK_BYTES <= LOG_SEGMENT_BYTES) {
+      memset(block, 0, sizeof(block));
+      log_block_header_t* h = (log_block_header_t*)block;
+      const int64_t utc = (int64_t)day * 86400000 + (int64_t)(i * 1000 / rate_hz);
+      h->magic = LOG_BLOCK_MAGIC;
+      h->version = LOG_FORMAT_VERSION;
+      h->codec = LOG_BLOCK_CODEC;
+      h->seq = offset / LOG_BLOCK_BYTES;
+      h->utc_s = (uint32_t)(utc / 1000);
+      h->utc_ms = (uint16_t)(utc % 1000);
+      h->base_ms = *t_ms;
+      const uint64_t i0 = i;
+      log_encoder_t enc;
+      log_encoder_reset(&enc, LOG_BLOCK_CODEC, *t_ms);
+      while (i < per_day) {
+        log_record_t r = {};
+        r.t_ms = *t_ms + (uint32_t)((i - i0) * 1000 / rate_hz);
+        r.sig = (i & 1) ? (uint8_t)(1 + (i / 2) % (SIG_COUNT - 1)) : (uint8_t)SIG_RPM;
+        r.value = (float)(i % 3000);
+        r.quality = 1;
+        if (!log_encoder_append(&enc, block + sizeof(log_block_header_t), LOG_BLOCK_PAYLOAD, &r)) break;
+        log_rollup_add(r.sig, (int64_t)day * 86400000 + (int64_t)(i * 1000 / rate_hz), r.value);
+        h->last_ms = r.t_ms;
+        i++;
+      }
+      *t_ms += (uint32_t)((i - i0) * 1000 / rate_hz);
+      h->count = enc.count;
+      h->payload_bytes = enc.bytes;
+      log_block_seal(block);
+      log_storage_write(f, block, LOG_BLOCK_BYTES);
+
+      if (seg_start || h->utc_s >= last_indexed + LOG_INDEX_INTERVAL_S) {
+        log_index_entry_t e = {h->utc_s, offset, seg, 0, 0};
+        log_index_entry_seal(&e);
+        log_storage_write(idx, &e, sizeof(e));
+        last_indexed = h->utc_s;
+        seg_start = false;
+      }
+      offset += LOG_BLOCK_BYTES;
+    }
+    log_storage_close(f);
+    seg++;
+  }
+  log_storage_close(idx);
+}
+
+void log_query_benchmark(uint32_t days, uint32_t rate_hz) {
+  if (!log_storage_begin() || !days || !rate_hz) return;
+  const uint32_t last_day = log_day_of(plat_utc_ms());
+  const uint32_t first_day = last_day - days + 1;
+
+  const uint32_t g0 = plat_millis();
+  uint32_t t_ms = 0;
+  for (uint32_t d = first_day; d <= last_day; ++d) write_synthetic_day(d, rate_hz, &t_ms);
+  log_rollup_tick((int64_t)(last_day + 2) * 86400000);
+  log_rollup_sync();
+  DBG_LOGI("[query] synthetic log: %u days @ %u rec/s in %u ms", (unsigned)days, (unsigned)rate_hz,
+           (unsigned)(plat_millis() - g0));
+
+  const int64_t end_ms = (int64_t)(last_day + 1) * 86400000;
+  static const uint32_t k_hours[] = {1, 6, 24};
+  for (int pass = 0; pass < 2; ++pass) {
+    for (uint32_t hours : k_hours) {
+      if (!pass) log_index_invalidate();
+      const uint32_t t0 = plat_micros();
+      log_query_t q;
+      log_query_open(&q, end_ms - (int64_t)hours * 3600000, end_ms, 1u << SIG_RPM);
+      log_record_t r;
+      int64_t utc;
+      while (log_query_next(&q, &r, &utc)) {}
+      log_query_close(&q);
+      const uint32_t us = plat_micros() - t0;
+      DBG_LOGI("[query] %s %2uh RPM: %u records, %u blocks (%u KB), bad=%u, indexed=%d, %u.%03u ms",
+               pass ? "warm" : "cold", (unsigned)hours, (unsigned)q.records, (unsigned)q.blocks_read,
+               (unsigned)(q.blocks_read * (LOG_BLOCK_BYTES / 1024)), (unsigned)q.bad_blocks,
+               (int)q.indexed, (unsigned)(us / 1000), (unsigned)(us % 1000));
+    }
+  }
+
+  // Chart columns: rollup tier (or raw) picked per window.
+  static const uint32_t k_chart_hours[] = {1, 6, 24, 7 * 24, 30 * 24};
+  static history_bucket_t cols[720];
+  for (uint32_t hours : k_chart_hours) {
+    if (hours > days * 24) break;
+    int tier = -1;
+    const uint32_t t0 = plat_micros();
+    const uint16_t filled = log_rollup_decimate(SIG_RPM, end_ms - (int64_t)hours * 3600000, end_ms, cols, 720, &tier);
+    const uint32_t us = plat_micros() - t0;
+    DBG_LOGI("[query] chart %4uh RPM x720: tier %s, %u columns, %u.%03u ms", (unsigned)hours,
+             tier < 0 ? "raw" : k_log_rollup_tiers[tier].name, (unsigned)filled, (unsigned)(us / 1000),
+             (unsigned)(us % 1000));
+  }
+}
+#endif
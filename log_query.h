@@ -0,0 +1,49 @@
+#pragma once
+
+#include "log_format.h"
+#include "log_storage.h"
+#include <stdint.h>
+
+// Time-window reads over SD signal logs.
+//
+// log_query_open() uses the sparse index (log_index.h) to seek straight to
+// the block that contains the window start, then log_query_next() streams
+// records forward across blocks, segments and day directories until the
+// window end. Blocks that fail their CRC or do not decode are skipped and
+// counted. Blocks written while the clock was unset carry no UTC and are not
+// returned.
+
+struct log_query_t {
+  int64_t     from_ms;        // UTC window [from_ms, to_ms)
+  int64_t     to_ms;
+  uint32_t    sig_mask;       // bit per signal_id_t, 0 = all
+  uint32_t    day;
+  uint32_t    last_day;
+  uint32_t    offset;
+  uint8_t     seg;
+  bool        done;
+  uint16_t    pos;
+  uint16_t    n;              // decoded records in `recs`
+  log_file_t* f;
+  uint8_t*    block;          // LOG_BLOCK_BYTES
+  log_record_t* recs;         // LOG_CODEC_MAX_RECORDS
+
+  // Diagnostics.
+  uint32_t    blocks_read;
+  uint32_t    bad_blocks;
+  uint32_t    records;
+  bool        indexed;        // start position came from the index
+};
+
+bool log_query_open(log_query_t* q, int64_t from_utc_ms, int64_t to_utc_ms, uint32_t sig_mask);
+// Next record in the window; false at the end.
+bool log_query_next(log_query_t* q, log_record_t* rec, int64_t* utc_ms);
+void log_query_close(log_query_t* q);
+
+#if !defined(ARDUINO)
+// Host only: writes `days` of synthetic logs ending today under the storage
+// root (`rate_hz` records/s spread over all signals, with rollups), then
+// times cold and warm 1h/6h/24h raw RPM window reads and 1h..30d chart
+// decimation (log_rollup.h). Driver: tests/run_host_tests.sh log_query_bench.
+void log_query_benchmark(uint32_t days, uint32_t rate_hz);
+#endif
@@ -0,0 +1,245 @@
+#include "log_rollup.h"
+#include "log_format.h"
+#include "log_query.h"
+#include "log_storage.h"
+#include "crc32.h"
+#include "logging_policy.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+struct rollup_acc_t {
+  float    min;
+  float    max;
+  double   sum;
+  uint32_t count;
+};
+
+// Writer-task state.
+static rollup_acc_t s_acc[LOG_ROLLUP_TIERS][SIG_COUNT];
+static uint32_t     s_cur_start[LOG_ROLLUP_TIERS];   // open bucket start, 0 = none
+static log_file_t*  s_file[LOG_ROLLUP_TIERS];
+static uint32_t     s_file_day[LOG_ROLLUP_TIERS];
+static bool         s_dirty[LOG_ROLLUP_TIERS];
+
+static uint16_t bucket_check(const log_rollup_bucket_t* b) {
+  return (uint16_t)crc32_update(0, b, offsetof(log_rollup_bucket_t, check));
+}
+
+bool log_rollup_bucket_valid(const log_rollup_bucket_t* b) {
+  return b->check == bucket_check(b);
+}
+
+void log_rollup_path(char* out, size_t cap, uint32_t day, int tier) {
+  char name[9];
+  log_day_name(name, day);
+  snprintf(out, cap, "logs/%s/rollup_%s.bin", name, k_log_rollup_tiers[tier].name);
+}
+
+static log_file_t* tier_file(int tier, uint32_t day) {
+  if (s_file[tier] && s_file_day[tier] == day) return s_file[tier];
+  if (s_file[tier]) {
+    log_storage_sync(s_file[tier]);
+    log_storage_close(s_file[tier]);
+    s_file[tier] = nullptr;
+  }
+  char path[64], name[9];
+  log_day_name(name, day);
+  log_day_dir(path, sizeof(path), name);
+  if (!log_storage_mkdirs(path)) return nullptr;
+  log_rollup_path(path, sizeof(path), day, tier);
+  s_file[tier] = log_storage_open(path, LOG_OPEN_APPEND);
+  s_file_day[tier] = day;
+  return s_file[tier];
+}
+
+// Writes every signal's bucket for the tier's open period and resets them.
+static void emit(int tier) {
+  const uint32_t start = s_cur_start[tier];
+  if (!start) return;
+  log_rollup_bucket_t out[SIG_COUNT];
+  uint16_t n = 0;
+  for (uint8_t sig = 0; sig < SIG_COUNT; ++sig) {
+    rollup_acc_t& a = s_acc[tier][sig];
+    if (!a.count) continue;
+    log_rollup_bucket_t& b = out[n++];
+    b.start_s = start;
+    b.min = a.min;
+    b.max = a.max;
+    b.mean = (float)(a.sum / a.count);
+    b.count = a.count;
+    b.sig = sig;
+    b.tier = (uint8_t)tier;
+    b.check = bucket_check(&b);
+    a.count = 0;
+  }
+  if (!n || !log_storage_ready()) return;
+  log_file_t* f = tier_file(tier, start / 86400);
+  if (f && log_storage_write(f, out, n * sizeof(log_rollup_bucket_t)) > 0) s_dirty[tier] = true;
+}
+
+void log_rollup_add(uint8_t sig, int64_t utc_ms, float value) {
+  if (utc_ms <= 0 || sig >= SIG_COUNT || isnan(value)) return;
+  const uint32_t s = (uint32_t)(utc_ms / 1000);
+  for (int t = 0; t < LOG_ROLLUP_TIERS; ++t) {
+    const uint32_t start = s - s % k_log_rollup_tiers[t].period_s;
+    // A record from an earlier period (clock stepped back) folds into the
+    // open bucket rather than rewriting history.
+    if (start > s_cur_start[t]) {
+      emit(t);
+      s_cur_start[t] = start;
+    }
+    rollup_acc_t& a = s_acc[t][sig];
+    if (!a.count) {
+      a.min = a.max = value;
+      a.sum = 0;
+    } else {
+      if (value < a.min) a.min = value;
+      if (value > a.max) a.max = value;
+    }
+    a.sum += value;
+    a.count++;
+  }
+}
+
+void log_rollup_tick(int64_t now_utc_ms) {
+  if (now_utc_ms <= 0) return;
+  const uint32_t now_s = (uint32_t)(now_utc_ms / 1000);
+  for (int t = 0; t < LOG_ROLLUP_TIERS; ++t) {
+    if (s_cur_start[t] && now_s >= s_cur_start[t] + k_log_rollup_tiers[t].period_s + LOG_ROLLUP_GRACE_S) {
+      emit(t);
+      s_cur_start[t] = 0;
+    }
+  }
+}
+
+void log_rollup_sync(void) {
+  for (int t = 0; t < LOG_ROLLUP_TIERS; ++t) {
+    if (s_file[t] && s_dirty[t]) log_storage_sync(s_file[t]);
+    s_dirty[t] = false;
+  }
+}
+
+// ---- Queries ----
+
+int log_rollup_pick_tier(int64_t span_ms, uint16_t columns) {
+  if (!columns) return -1;
+  for (int t = LOG_ROLLUP_TIERS - 1; t >= 0; --t) {
+    if ((int64_t)k_log_rollup_tiers[t].period_s * 1000 * columns <= span_ms) return t;
+  }
+  return -1;
+}
+
+static void add_to_column(history_bucket_t* col, float min, float max, float last, uint32_t count) {
+  if (!col->count) {
+    col->min = min;
+    col->max = max;
+  } else {
+    if (min < col->min) col->min = min;
+    if (max > col->max) col->max = max;
+  }
+  col->last = last;
+  col->count = (uint16_t)(col->count + count > 0xFFFF ? 0xFFFF : col->count + count);
+}
+
+// First bucket with start_s >= start in a start-sorted tier file.
+static uint32_t lower_bound(log_file_t* f, uint32_t n, uint32_t start) {
+  uint32_t lo = 0, hi = n;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    log_rollup_bucket_t b;
+    if (!log_storage_seek(f, mid * sizeof(b)) || log_storage_read(f, &b, sizeof(b)) != sizeof(b)) return n;
+    if (b.start_s < start) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+static bool decimate_tier(int tier, signal_id_t id, int64_t from_ms, int64_t to_ms,
+                          history_bucket_t* out, uint16_t columns, log_rollup_progress_fn progress, void* ctx) {
+  const uint32_t period = k_log_rollup_tiers[tier].period_s;
+  const int64_t span = to_ms - from_ms;
+  const uint32_t first_start = (uint32_t)((from_ms / 1000 + period - 1) / period * period);
+
+  for (uint32_t day = log_day_of(from_ms); day <= log_day_of(to_ms - 1); ++day) {
+    char path[64];
+    log_rollup_path(path, sizeof(path), day, tier);
+    log_file_t* f = log_storage_open(path, LOG_OPEN_READ);
+    if (!f) continue;
+    const int32_t size = log_storage_size(f);
+    const uint32_t n = size > 0 ? (uint32_t)size / sizeof(log_rollup_bucket_t) : 0;
+    uint32_t i = lower_bound(f, n, first_start);
+    log_storage_seek(f, i * sizeof(log_rollup_bucket_t));
+
+    log_rollup_bucket_t buf[64];
+    bool done = false;
+    while (!done && i < n) {
+      if (progress && !progress(ctx)) {
+        log_storage_close(f);
+        return false;
+      }
+      const int32_t got = log_storage_read(f, buf, sizeof(buf));
+      if (got <= 0) break;
+      for (uint32_t k = 0; k < (uint32_t)got / sizeof(log_rollup_bucket_t); ++k, ++i) {
+        const log_rollup_bucket_t& b = buf[k];
+        if (!log_rollup_bucket_valid(&b)) continue;
+        const int64_t t = (int64_t)b.start_s * 1000;
+        if (t >= to_ms) {
+          done = true;
+          break;
+        }
+        if (b.sig != id || t < from_ms) continue;
+        const uint16_t c = (uint16_t)((t - from_ms) * columns / span);
+        add_to_column(&out[c], b.min, b.max, b.mean, b.count);
+      }
+    }
+    log_storage_close(f);
+    if (done) break;
+  }
+  return true;
+}
+
+static bool decimate_raw(signal_id_t id, int64_t from_ms, int64_t to_ms,
+                         history_bucket_t* out, uint16_t columns, log_rollup_progress_fn progress, void* ctx) {
+  const int64_t span = to_ms - from_ms;
+  log_query_t q;
+  if (!log_query_open(&q, from_ms, to_ms, 1u << id)) return true;
+  log_record_t r;
+  int64_t t;
+  bool ok = true;
+  uint32_t blocks = q.blocks_read;
+  while (log_query_next(&q, &r, &t)) {
+    add_to_column(&out[(t - from_ms) * columns / span], r.value, r.value, r.value, 1);
+    if (progress && q.blocks_read != blocks) {
+      blocks = q.blocks_read;
+      if (!progress(ctx)) {
+        ok = false;
+        break;
+      }
+    }
+  }
+  log_query_close(&q);
+  return ok;
+}
+
+bool log_rollup_decimate_tier(signal_id_t id, int64_t from_ms, int64_t to_ms, history_bucket_t* out,
+                              uint16_t columns, int tier, log_rollup_progress_fn progress, void* ctx) {
+  if (!columns || to_ms <= from_ms || id >= SIG_COUNT || tier >= LOG_ROLLUP_TIERS) return true;
+  return tier < 0 ? decimate_raw(id, from_ms, to_ms, out, columns, progress, ctx)
+                  : decimate_tier(tier, id, from_ms, to_ms, out, columns, progress, ctx);
+}
+
+uint16_t log_rollup_decimate(signal_id_t id, int64_t from_ms, int64_t to_ms,
+                             history_bucket_t* out, uint16_t columns, int* tier_used) {
+  if (!columns || to_ms <= from_ms || id >= SIG_COUNT) return 0;
+  memset(out, 0, columns * sizeof(history_bucket_t));
+
+  const int tier = log_rollup_pick_tier(to_ms - from_ms, columns);
+  if (tier_used) *tier_used = tier;
+  log_rollup_decimate_tier(id, from_ms, to_ms, out, columns, tier);
+
+  uint16_t filled = 0;
+  for (uint16_t c = 0; c < columns; ++c) filled += out[c].count ? 1 : 0;
+  return filled;
+}
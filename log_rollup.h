@@ -0,0 +1,79 @@
+#pragma once
+
+#include "signals.h"
+#include "signal_history.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Multi-resolution rollups of the SD signal log.
+//
+// The writer task feeds every logged record into per-signal accumulators
+// for each tier and appends closed buckets (min/max/mean/count) to
+// logs/YYYYMMDD/rollup_<tier>.bin, so long chart windows read a few
+// thousand pre-aggregated buckets instead of millions of raw records.
+// Buckets are aligned to absolute UTC multiples of the tier period and
+// written in start order. The still-open bucket of each tier is not on disk
+// yet; the newest edge of a chart comes from RAM history.
+//
+// Writer-side functions are called from the writer task only; the query
+// side can run on any one thread.
+
+#define LOG_ROLLUP_TIERS  3
+
+#ifndef LOG_ROLLUP_GRACE_S
+  #define LOG_ROLLUP_GRACE_S  2   // close an idle bucket this long after its end
+#endif
+
+struct log_rollup_tier_t {
+  uint32_t    period_s;
+  const char* name;        // file suffix
+};
+
+static constexpr log_rollup_tier_t k_log_rollup_tiers[LOG_ROLLUP_TIERS] = {
+  {10,  "10s"},
+  {60,  "1m"},
+  {600, "10m"},
+};
+
+struct log_rollup_bucket_t {
+  uint32_t start_s;   // UTC, multiple of the tier period
+  float    min;
+  float    max;
+  float    mean;
+  uint32_t count;
+  uint8_t  sig;
+  uint8_t  tier;
+  uint16_t check;     // low 16 bits of CRC-32 over the bytes above
+};
+static_assert(sizeof(log_rollup_bucket_t) == 24, "log_rollup_bucket_t is part of the file format");
+
+bool log_rollup_bucket_valid(const log_rollup_bucket_t* b);
+void log_rollup_path(char* out, size_t cap, uint32_t day, int tier);
+
+// ---- Writer task ----
+void log_rollup_add(uint8_t sig, int64_t utc_ms, float value);
+void log_rollup_tick(int64_t now_utc_ms);   // closes buckets idle past their end
+void log_rollup_sync(void);
+
+// ---- Queries ----
+
+// Coarsest tier that still gives at least one bucket per column, or -1 if
+// the window needs raw records.
+int log_rollup_pick_tier(int64_t span_ms, uint16_t columns);
+
+// Chart columns over the UTC window [from_ms, to_ms), like
+// signal_history_decimate(). `last` is the mean of the newest bucket in the
+// column. Uses the tier from log_rollup_pick_tier(), falling back to raw
+// records (log_query.h) for short windows. Returns columns with data.
+uint16_t log_rollup_decimate(signal_id_t id, int64_t from_ms, int64_t to_ms,
+                             history_bucket_t* out, uint16_t columns, int* tier_used = nullptr);
+
+// Called between file reads of a scan; return false to stop it.
+typedef bool (*log_rollup_progress_fn)(void* ctx);
+
+// One explicit tier (-1 = raw records) added into `out`, which is not
+// cleared, so a caller can fill a window piecewise or refine an earlier
+// result in place. Returns false if `progress` stopped the scan.
+bool log_rollup_decimate_tier(signal_id_t id, int64_t from_ms, int64_t to_ms, history_bucket_t* out,
+                              uint16_t columns, int tier, log_rollup_progress_fn progress = nullptr,
+                              void* ctx = nullptr);
@@ -0,0 +1,191 @@
+#include "log_storage.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(ARDUINO)
+  #include <SD_MMC.h>
+  #include "pins_config.h"
+  static const char* s_root = "/sdcard";
+#else
+  static char     s_root_buf[128] = "sdcard";
+  static const char* s_root = s_root_buf;
+  static uint32_t s_spike_every = 0;
+  static uint32_t s_spike_ms = 0;
+  static uint32_t s_write_count = 0;
+  static uint32_t s_read_us = 0;       // per read call
+  static uint32_t s_read_us_per_kb = 0;
+  static uint32_t s_cut_after = 0;     // power cut on this write (0 = off)
+  static uint32_t s_cut_keep = 0;
+  static uint32_t s_cut_writes = 0;
+  static bool     s_power_lost = false;
+#endif
+
+static bool s_ready = false;
+
+static void full_path(const char* rel, char* out, size_t cap) {
+  snprintf(out, cap, "%s/%s", s_root, rel);
+}
+
+static inline FILE* fp(log_file_t* f) { return (FILE*)f; }
+
+bool log_storage_begin(void) {
+  if (s_ready) return true;
+#if defined(ARDUINO)
+  SD_MMC.setPins(SD_CLK_PIN, SD_CMD_PIN, SD_D0_PIN, SD_D1_PIN, SD_D2_PIN, SD_D3_PIN);
+  if (!SD_MMC.begin(s_root, false, false)) {
+    DBG_LOGW("[sd] mount failed");
+    return false;
+  }
+  DBG_LOGI("[sd] mounted %s, %u MB", s_root, (unsigned)(SD_MMC.cardSize() / (1024 * 1024)));
+#else
+  mkdir(s_root, 0755);
+#endif
+  s_ready = true;
+  return true;
+}
+
+bool log_storage_ready(void) {
+  return s_ready;
+}
+
+const char* log_storage_root(void) {
+  return s_root;
+}
+
+log_file_t* log_storage_open(const char* rel_path, log_open_mode_t mode) {
+  char path[192];
+  full_path(rel_path, path, sizeof(path));
+  FILE* f = nullptr;
+  switch (mode) {
+    case LOG_OPEN_READ:   f = fopen(path, "rb"); break;
+    case LOG_OPEN_APPEND: f = fopen(path, "ab"); break;
+    case LOG_OPEN_TRUNC:  f = fopen(path, "wb"); break;
+    case LOG_OPEN_RW:
+      f = fopen(path, "r+b");
+      if (!f) f = fopen(path, "w+b");
+      break;
+  }
+  // Callers write whole blocks; skip the stdio copy.
+  if (f && mode != LOG_OPEN_READ) setvbuf(f, nullptr, _IONBF, 0);
+  return (log_file_t*)f;
+}
+
+int32_t log_storage_write(log_file_t* f, const void* data, size_t len) {
+#if !defined(ARDUINO)
+  if (s_spike_every && ++s_write_count % s_spike_every == 0) plat_delay_ms(s_spike_ms);
+  if (s_power_lost) return -1;
+  if (s_cut_after && ++s_cut_writes == s_cut_after) {
+    s_power_lost = true;
+    fwrite(data, 1, len < s_cut_keep ? len : s_cut_keep, fp(f));
+    return -1;
+  }
+#endif
+  const size_t n = fwrite(data, 1, len, fp(f));
+  return (n == len) ? (int32_t)n : -1;
+}
+
+int32_t log_storage_read(log_file_t* f, void* buf, size_t len) {
+#if !defined(ARDUINO)
+  if (s_read_us || s_read_us_per_kb) {
+    std::this_thread::sleep_for(std::chrono::microseconds(s_read_us + len * s_read_us_per_kb / 1024));
+  }
+#endif
+  const size_t n = fread(buf, 1, len, fp(f));
+  return (n == 0 && ferror(fp(f))) ? -1 : (int32_t)n;
+}
+
+bool log_storage_seek(log_file_t* f, uint32_t offset) {
+  return fseek(fp(f), (long)offset, SEEK_SET) == 0;
+}
+
+int32_t log_storage_size(log_file_t* f) {
+  struct stat st;
+  if (fstat(fileno(fp(f)), &st) != 0) return -1;
+  return (int32_t)st.st_size;
+}
+
+bool log_storage_sync(log_file_t* f) {
+#if !defined(ARDUINO)
+  if (s_power_lost) return false;
+#endif
+  if (fflush(fp(f)) != 0) return false;
+  return fsync(fileno(fp(f))) == 0;
+}
+
+void log_storage_close(log_file_t* f) {
+  if (f) fclose(fp(f));
+}
+
+bool log_storage_mkdirs(const char* rel_dir) {
+  char path[192];
+  full_path(rel_dir, path, sizeof(path));
+  for (char* p = path + strlen(s_root) + 1; *p; ++p) {
+    if (*p != '/') continue;
+    *p = '\0';
+    if (mkdir(path, 0755) != 0 && errno != EEXIST) return false;
+    *p = '/';
+  }
+  return mkdir(path, 0755) == 0 || errno == EEXIST;
+}
+
+bool log_storage_exists(const char* rel_path) {
+  char path[192];
+  full_path(rel_path, path, sizeof(path));
+  struct stat st;
+  return stat(path, &st) == 0;
+}
+
+bool log_storage_remove(const char* rel_path) {
+  char path[192];
+  full_path(rel_path, path, sizeof(path));
+  return unlink(path) == 0;
+}
+
+bool log_storage_rename(const char* rel_from, const char* rel_to) {
+  char from[192], to[192];
+  full_path(rel_from, from, sizeof(from));
+  full_path(rel_to, to, sizeof(to));
+  return rename(from, to) == 0;
+}
+
+bool log_storage_truncate(const char* rel_path, uint32_t size) {
+#if !defined(ARDUINO)
+  if (s_power_lost) return false;
+#endif
+  char path[192];
+  full_path(rel_path, path, sizeof(path));
+  return truncate(path, (off_t)size) == 0;
+}
+
+#if !defined(ARDUINO)
+void log_storage_set_root(const char* dir) {
+  snprintf(s_root_buf, sizeof(s_root_buf), "%s", dir);
+}
+
+void log_storage_set_latency_spikes(uint32_t every_n_writes, uint32_t spike_ms) {
+  s_spike_every = every_n_writes;
+  s_spike_ms = spike_ms;
+}
+
+void log_storage_set_read_latency(uint32_t us_per_read, uint32_t us_per_kb) {
+  s_read_us = us_per_read;
+  s_read_us_per_kb = us_per_kb;
+}
+
+void log_storage_set_power_cut(uint32_t on_write, uint32_t keep_bytes) {
+  s_cut_after = on_write;
+  s_cut_keep = keep_bytes;
+  s_cut_writes = 0;
+  s_power_lost = false;
+}
+
+bool log_storage_power_lost(void) {
+  return s_power_lost;
+}
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// File storage for the SD logger.
+//
+// On the P4 the card is mounted with SD_MMC at /sdcard and accessed through
+// the ESP-IDF VFS (POSIX/stdio), so the same code runs against a normal
+// directory on a Linux host. The host build can inject write-latency spikes
+// to show that producers and the UI never wait on storage.
+//
+// Paths are relative to the storage root, e.g. "logs/20261018/signals_00.bin".
+
+typedef struct log_file_s log_file_t;
+
+enum log_open_mode_t : uint8_t {
+  LOG_OPEN_READ = 0,
+  LOG_OPEN_APPEND,    // create if missing, writes go to the end
+  LOG_OPEN_RW,        // read/write an existing file (create if missing)
+  LOG_OPEN_TRUNC,     // create or truncate, write only
+};
+
+bool        log_storage_begin(void);
+bool        log_storage_ready(void);
+const char* log_storage_root(void);
+
+log_file_t* log_storage_open(const char* rel_path, log_open_mode_t mode);
+int32_t     log_storage_write(log_file_t* f, const void* data, size_t len);
+int32_t     log_storage_read(log_file_t* f, void* buf, size_t len);
+bool        log_storage_seek(log_file_t* f, uint32_t offset);
+int32_t     log_storage_size(log_file_t* f);
+bool        log_storage_sync(log_file_t* f);
+void        log_storage_close(log_file_t* f);
+
+bool log_storage_mkdirs(const char* rel_dir);
+bool log_storage_exists(const char* rel_path);
+bool log_storage_remove(const char* rel_path);
+bool log_storage_rename(const char* rel_from, const char* rel_to);
+bool log_storage_truncate(const char* rel_path, uint32_t size);
+
+#if !defined(ARDUINO)
+// Host only: storage root directory (default "./sdcard").
+void log_storage_set_root(const char* dir);
+// Host only: every `every_n_writes`-th write sleeps `spike_ms` first (0 = off).
+void log_storage_set_latency_spikes(uint32_t every_n_writes, uint32_t spike_ms);
+// Host only: every read sleeps `us_per_read` + `us_per_kb` per KiB, to
+// approximate SD card read times (0, 0 = off).
+void log_storage_set_read_latency(uint32_t us_per_read, uint32_t us_per_kb);
+// Host only: the `on_write`-th write from now persists only its first
+// `keep_bytes`, then every write/sync/truncate fails as if power was cut.
+void log_storage_set_power_cut(uint32_t on_write, uint32_t keep_bytes);
+bool log_storage_power_lost(void);
+#endif
@@ -0,0 +1,373 @@
+#include "log_writer.h"
+#include "log_storage.h"
+#include "log_index.h"
+#include "log_rollup.h"
+#include "log_codec.h"
+#include "log_journal.h"
+#include "log_ingest.h"
+#include "crc32.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string.h>
+
+#ifndef LOG_STATS_INTERVAL_MS
+  #define LOG_STATS_INTERVAL_MS 60000
+#endif
+
+static constexpr uint16_t LAT_WINDOW = 256;
+
+static std::atomic<bool>     s_running{false};
+
+// Writer-task state.
+static uint8_t*    s_batch = nullptr;        // LOG_BATCH_BLOCKS * LOG_BLOCK_BYTES
+static uint16_t    s_closed = 0;             // sealed blocks at the front of s_batch
+static uint16_t    s_open_count = 0;         // records in the open block
+static log_encoder_t s_enc;                  // payload encoder of the open block
+static uint32_t    s_open_since_ms = 0;
+static uint32_t    s_pending_since_ms = 0;   // first sealed block not yet written
+static log_file_t* s_seg = nullptr;
+static uint32_t    s_seg_bytes = 0;
+static uint8_t     s_seg_nn = 0;
+static char        s_seg_day[9] = "";
+static log_file_t* s_idx = nullptr;          // index.idx of s_seg_day
+static uint32_t    s_idx_last_utc = 0;
+static bool        s_idx_force = false;      // index the next block (segment start)
+static uint32_t    s_last_sync_ms = 0;
+static bool        s_dirty = false;
+
+static uint32_t s_lat_us[LAT_WINDOW];
+static uint16_t s_lat_n = 0;
+static uint16_t s_lat_pos = 0;
+
+// Published counters (written by the writer task, read anywhere).
+static std::atomic<uint32_t> s_blocks_written{0}, s_bytes_written{0}, s_segments_opened{0};
+static std::atomic<uint32_t> s_write_errors{0}, s_write_p50{0}, s_write_p95{0}, s_write_max{0};
+static std::atomic<uint32_t> s_sync_count{0}, s_sync_max{0}, s_sync_errors{0};
+
+// ---- Block format ----
+
+void log_block_seal(uint8_t* block) {
+  log_block_header_t* h = (log_block_header_t*)block;
+  h->crc32 = 0;
+  uint32_t crc = crc32_update(0, block, sizeof(log_block_header_t));
+  crc = crc32_update(crc, block + sizeof(log_block_header_t), h->payload_bytes);
+  h->crc32 = crc;
+}
+
+bool log_block_valid(const uint8_t* block) {
+  log_block_header_t h;
+  memcpy(&h, block, sizeof(h));
+  if (h.magic != LOG_BLOCK_MAGIC || h.version != LOG_FORMAT_VERSION) return false;
+  if (h.payload_bytes > LOG_BLOCK_PAYLOAD) return false;
+  const uint32_t stored = h.crc32;
+  h.crc32 = 0;
+  uint32_t crc = crc32_update(0, &h, sizeof(h));
+  crc = crc32_update(crc, block + sizeof(h), h.payload_bytes);
+  return crc == stored;
+}
+
+// ---- Writer ----
+
+static inline uint8_t* block_at(uint16_t i) {
+  return s_batch + (size_t)i * LOG_BLOCK_BYTES;
+}
+
+static void record_latency(uint32_t us) {
+  s_lat_us[s_lat_pos] = us;
+  s_lat_pos = (uint16_t)((s_lat_pos + 1) % LAT_WINDOW);
+  if (s_lat_n < LAT_WINDOW) s_lat_n++;
+  if (us > s_write_max.load(std::memory_order_relaxed)) s_write_max.store(us, std::memory_order_relaxed);
+
+  uint32_t sorted[LAT_WINDOW];
+  memcpy(sorted, s_lat_us, s_lat_n * sizeof(uint32_t));
+  std::sort(sorted, sorted + s_lat_n);
+  s_write_p50.store(sorted[(s_lat_n - 1) / 2], std::memory_order_relaxed);
+  s_write_p95.store(sorted[((uint32_t)s_lat_n * 95 - 1) / 100], std::memory_order_relaxed);
+}
+
+static void close_segment() {
+  if (!s_seg) return;
+  log_storage_sync(s_seg);
+  log_storage_close(s_seg);
+  s_seg = nullptr;
+  if (s_idx) {
+    log_storage_sync(s_idx);
+    log_storage_close(s_idx);
+    s_idx = nullptr;
+  }
+  log_journal_sync();
+  s_dirty = false;
+}
+
+// Opens the day's first segment with room left, appending to a partial one,
+// and journals it before any data goes in: recovery starts from the journaled
+// day, so a later day must never hold blocks the journal does not know about.
+static bool open_segment(uint32_t day_no) {
+  close_segment();
+  char day[9], path[64];
+  log_day_name(day, day_no);
+  log_day_dir(path, sizeof(path), day);
+  if (!log_storage_mkdirs(path)) return false;
+
+  uint8_t nn = (strcmp(day, s_seg_day) == 0) ? s_seg_nn : 0;
+  for (; nn < 100; ++nn) {
+    log_segment_path(path, sizeof(path), day, nn);
+    if (!log_storage_exists(path)) break;
+    log_file_t* f = log_storage_open(path, LOG_OPEN_READ);
+    const int32_t size = f ? log_storage_size(f) : -1;
+    log_storage_close(f);
+    if (size >= 0 && (uint32_t)size + LOG_BLOCK_BYTES <= LOG_SEGMENT_BYTES) break;
+  }
+  if (nn >= 100) return false;
+
+  // Drop a torn trailing block so appended blocks stay aligned.
+  if (log_storage_exists(path)) {
+    log_file_t* f = log_storage_open(path, LOG_OPEN_READ);
+    const int32_t size = f ? log_storage_size(f) : -1;
+    log_storage_close(f);
+    if (size > 0 && size % LOG_BLOCK_BYTES) log_storage_truncate(path, size - size % LOG_BLOCK_BYTES);
+  }
+
+  s_seg = log_storage_open(path, LOG_OPEN_APPEND);
+  if (!s_seg) return false;
+
+  char idx_path[64];
+  log_index_path(idx_path, sizeof(idx_path), day);
+  s_idx = log_storage_open(idx_path, LOG_OPEN_APPEND);
+  s_idx_force = true;
+  s_seg_bytes = (uint32_t)log_storage_size(s_seg);
+  s_seg_nn = nn;
+  memcpy(s_seg_day, day, sizeof(s_seg_day));
+  s_segments_opened.fetch_add(1, std::memory_order_relaxed);
+  log_journal_commit(day_no, s_seg_nn, s_seg_bytes);
+  log_journal_sync();
+  DBG_LOGI("[log] segment %s (%u bytes)", path, (unsigned)s_seg_bytes);
+  return true;
+}
+
+static void open_block() {
+  uint8_t* b = block_at(s_closed);
+  memset(b, 0, LOG_BLOCK_BYTES);
+  log_block_header_t* h = (log_block_header_t*)b;
+  h->magic = LOG_BLOCK_MAGIC;
+  h->version = LOG_FORMAT_VERSION;
+  h->codec = LOG_BLOCK_CODEC;
+  s_open_count = 0;
+}
+
+static void seal_block() {
+  if (!s_open_count) return;
+  log_block_header_t* h = (log_block_header_t*)block_at(s_closed);
+  h->count = s_open_count;
+  h->payload_bytes = s_enc.bytes;
+  if (!s_closed) s_pending_since_ms = plat_millis();
+  s_closed++;
+  s_open_count = 0;
+}
+
+// Index entries for the batch just written at `base_offset`; written after
+// the data so an entry never points past the end of the segment.
+static void append_index(uint32_t base_offset) {
+  if (!s_idx) return;
+  log_index_entry_t entries[LOG_BATCH_BLOCKS];
+  uint16_t n = 0;
+  for (uint16_t i = 0; i < s_closed; ++i) {
+    const log_block_header_t* h = (const log_block_header_t*)block_at(i);
+    if (!h->utc_s) continue;
+    const bool due = h->utc_s >= s_idx_last_utc + LOG_INDEX_INTERVAL_S || h->utc_s < s_idx_last_utc;
+    if (!s_idx_force && !due) continue;
+    log_index_entry_t& e = entries[n++];
+    e.utc_s = h->utc_s;
+    e.offset = base_offset + (uint32_t)i * LOG_BLOCK_BYTES;
+    e.seg = s_seg_nn;
+    log_index_entry_seal(&e);
+    s_idx_last_utc = h->utc_s;
+    s_idx_force = false;
+  }
+  if (n && log_storage_write(s_idx, entries, n * sizeof(log_index_entry_t)) < 0)
+    s_write_errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void flush_batch() {
+  if (!s_closed) return;
+
+  // The batch goes to the day of its first block.
+  const log_block_header_t* first = (const log_block_header_t*)block_at(0);
+  const uint32_t day_no = first->utc_s ? first->utc_s / 86400 : log_day_of(plat_utc_ms());
+  char day[9];
+  log_day_name(day, day_no);
+  const uint32_t bytes = (uint32_t)s_closed * LOG_BLOCK_BYTES;
+  if (!s_seg || strcmp(day, s_seg_day) != 0 || s_seg_bytes + bytes > LOG_SEGMENT_BYTES) {
+    if (strcmp(day, s_seg_day) == 0 && s_seg) s_seg_nn++;
+    if (!open_segment(day_no)) s_write_errors.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Storage unavailable: the batch is dropped and ingest carries on.
+  if (s_seg) {
+    for (uint16_t i = 0; i < s_closed; ++i) {
+      ((log_block_header_t*)block_at(i))->seq = s_seg_bytes / LOG_BLOCK_BYTES + i;
+      log_block_seal(block_at(i));
+    }
+
+    const uint32_t t0 = plat_micros();
+    const int32_t n = log_storage_write(s_seg, s_batch, bytes);
+    record_latency(plat_micros() - t0);
+
+    if (n != (int32_t)bytes) {
+      s_write_errors.fetch_add(1, std::memory_order_relaxed);
+      close_segment();
+    } else {
+      append_index(s_seg_bytes);
+      s_seg_bytes += bytes;
+      log_journal_commit(day_no, s_seg_nn, s_seg_bytes);
+      s_dirty = true;
+      s_blocks_written.fetch_add(s_closed, std::memory_order_relaxed);
+      s_bytes_written.fetch_add(bytes, std::memory_order_relaxed);
+    }
+  }
+
+  // Carry the open block to the front of the batch.
+  const bool carry = s_open_count != 0;
+  if (carry) memcpy(block_at(0), block_at(s_closed), LOG_BLOCK_BYTES);
+  s_closed = 0;
+  if (!carry) open_block();
+}
+
+static void append_record(const log_record_t* r) {
+  log_block_header_t* h = (log_block_header_t*)block_at(s_closed);
+  if (!s_open_count) {
+    const int64_t utc = plat_utc_ms();
+    h->utc_s = (uint32_t)(utc / 1000);
+    h->utc_ms = (uint16_t)(utc % 1000);
+    h->base_ms = r->t_ms;
+    log_encoder_reset(&s_enc, LOG_BLOCK_CODEC, r->t_ms);
+    s_open_since_ms = plat_millis();
+  }
+  if (!log_encoder_append(&s_enc, block_at(s_closed) + sizeof(log_block_header_t), LOG_BLOCK_PAYLOAD, r)) {
+    // Block full: seal it and start the next one with this record.
+    seal_block();
+    if (s_closed >= LOG_BATCH_BLOCKS) flush_batch();
+    else open_block();
+    append_record(r);
+    return;
+  }
+  s_open_count = s_enc.count;
+  h->last_ms = r->t_ms;
+  log_rollup_add(r->sig, log_block_utc_ms(h, r->t_ms), r->value);
+}
+
+static void log_writer_task(void*) {
+  uint32_t last_stats_ms = plat_millis();
+  for (;;) {
+    log_record_t r;
+    uint32_t drained = 0;
+    while (drained < 512 && log_ingest_pop(&r)) {
+      append_record(&r);
+      drained++;
+    }
+
+    const uint32_t now = plat_millis();
+    if (s_open_count && now - s_open_since_ms >= LOG_BLOCK_MAX_AGE_MS) {
+      seal_block();
+      if (s_closed >= LOG_BATCH_BLOCKS) flush_batch();
+      else open_block();
+    }
+    if (s_closed && now - s_pending_since_ms >= LOG_FLUSH_INTERVAL_MS) flush_batch();
+    log_rollup_tick(plat_utc_ms());
+
+    if (s_dirty && now - s_last_sync_ms >= LOG_SYNC_INTERVAL_MS) {
+      const uint32_t t0 = plat_micros();
+      if (!log_storage_sync(s_seg)) s_sync_errors.fetch_add(1, std::memory_order_relaxed);
+      if (s_idx) log_storage_sync(s_idx);
+      log_rollup_sync();
+      log_journal_sync();   // after the data it describes
+      const uint32_t us = plat_micros() - t0;
+      s_sync_count.fetch_add(1, std::memory_order_relaxed);
+      if (us > s_sync_max.load(std::memory_order_relaxed)) s_sync_max.store(us, std::memory_order_relaxed);
+      s_last_sync_ms = now;
+      s_dirty = false;
+    }
+
+    if (now - last_stats_ms >= LOG_STATS_INTERVAL_MS) {
+      log_writer_report();
+      last_stats_ms = now;
+    }
+    if (!drained) plat_delay_ms(20);
+  }
+}
+
+bool log_writer_start(void) {
+  if (s_running.load()) return true;
+  if (!log_storage_begin()) return false;
+
+  // Bounded tail check of the last journaled segment before appending.
+  log_recovery_report_t rec;
+  log_recovery_run(&rec);
+
+  s_batch = (uint8_t*)plat_psram_alloc((size_t)LOG_BATCH_BLOCKS * LOG_BLOCK_BYTES);
+  if (!s_batch) {
+    DBG_LOGE("[log] batch buffer alloc failed");
+    return false;
+  }
+  s_closed = 0;
+  open_block();
+  s_last_sync_ms = plat_millis();
+
+  if (!plat_task_start(log_writer_task, "sd_log", 6144, LOG_WRITER_PRIO, LOG_WRITER_CORE, nullptr)) {
+    DBG_LOGE("[log] writer task create failed");
+    plat_free(s_batch);
+    s_batch = nullptr;
+    return false;
+  }
+  s_running.store(true);
+  return true;
+}
+
+bool log_writer_running(void) {
+  return s_running.load(std::memory_order_relaxed);
+}
+
+bool log_writer_push(const log_record_t* rec) {
+  if (!s_running.load(std::memory_order_relaxed)) return false;
+  return log_ingest_push(rec);
+}
+
+void log_writer_get_stats(log_writer_stats_t* out) {
+  log_ingest_stats_t in;
+  log_ingest_get_stats(&in);
+  out->records_in = 0;
+  out->records_decimated = 0;
+  out->records_dropped = 0;
+  for (int c = 0; c < SIG_CLASS_COUNT; ++c) {
+    out->records_in += in.cls[c].accepted;
+    out->records_decimated += in.cls[c].decimated;
+    out->records_dropped += in.cls[c].dropped;
+  }
+  out->queue_depth = in.crit_depth + in.shared_depth;
+  out->queue_high_water = in.shared_high_water;
+  out->blocks_written = s_blocks_written.load(std::memory_order_relaxed);
+  out->bytes_written = s_bytes_written.load(std::memory_order_relaxed);
+  out->segments_opened = s_segments_opened.load(std::memory_order_relaxed);
+  out->write_errors = s_write_errors.load(std::memory_order_relaxed);
+  out->write_p50_us = s_write_p50.load(std::memory_order_relaxed);
+  out->write_p95_us = s_write_p95.load(std::memory_order_relaxed);
+  out->write_max_us = s_write_max.load(std::memory_order_relaxed);
+  out->sync_count = s_sync_count.load(std::memory_order_relaxed);
+  out->sync_max_us = s_sync_max.load(std::memory_order_relaxed);
+  out->sync_errors = s_sync_errors.load(std::memory_order_relaxed);
+}
+
+void log_writer_report(void) {
+  log_writer_stats_t s;
+  log_writer_get_stats(&s);
+  DBG_LOGI("[log] in=%u dec=%u drop=%u q=%u/%u hw=%u blocks=%u seg=%u err=%u write_us p50=%u p95=%u max=%u sync n=%u max_us=%u err=%u",
+           (unsigned)s.records_in, (unsigned)s.records_decimated, (unsigned)s.records_dropped,
+           (unsigned)s.queue_depth, (unsigned)(LOG_QUEUE_DEPTH + LOG_QUEUE_CRIT_DEPTH), (unsigned)s.queue_high_water, (unsigned)s.blocks_written,
+           (unsigned)s.segments_opened, (unsigned)s.write_errors, (unsigned)s.write_p50_us,
+           (unsigned)s.write_p95_us, (unsigned)s.write_max_us, (unsigned)s.sync_count,
+           (unsigned)s.sync_max_us, (unsigned)s.sync_errors);
+  log_ingest_report();
+}
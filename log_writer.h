@@ -0,0 +1,69 @@
+#pragma once
+
+#include "log_format.h"
+#include <stdint.h>
+
+// Batched append-only SD logger (NMEA2000_SD_LOGGING_PLAN.md, section 6).
+//
+// Producers push records into a bounded lock-free queue (log_ingest.h,
+// which thins non-critical signals under pressure) and never touch storage.
+// The writer task packs them into preallocated block-aligned buffers and
+// writes whole blocks, several per call, to logs/YYYYMMDD/signals_NN.bin,
+// rotating segments by size and by day.
+
+#ifndef LOG_QUEUE_DEPTH
+  #define LOG_QUEUE_DEPTH        2048      // records, power of two; non-critical + overflow
+#endif
+#ifndef LOG_BATCH_BLOCKS
+  #define LOG_BATCH_BLOCKS       4         // blocks per write call
+#endif
+#ifndef LOG_BLOCK_CODEC
+  #define LOG_BLOCK_CODEC        LOG_CODEC_DOD   // log_codec.h; LOG_CODEC_RAW keeps full floats
+#endif
+#ifndef LOG_SEGMENT_BYTES
+  #define LOG_SEGMENT_BYTES      (16u * 1024u * 1024u)
+#endif
+#ifndef LOG_FLUSH_INTERVAL_MS
+  #define LOG_FLUSH_INTERVAL_MS  250       // write closed blocks at least this often
+#endif
+#ifndef LOG_BLOCK_MAX_AGE_MS
+  #define LOG_BLOCK_MAX_AGE_MS   5000      // close a partial block after this (bounds loss)
+#endif
+#ifndef LOG_SYNC_INTERVAL_MS
+  #define LOG_SYNC_INTERVAL_MS   2000
+#endif
+#ifndef LOG_WRITER_PRIO
+  #define LOG_WRITER_PRIO        3
+#endif
+#ifndef LOG_WRITER_CORE
+  #define LOG_WRITER_CORE        0
+#endif
+
+struct log_writer_stats_t {
+  uint32_t records_in;
+  uint32_t records_decimated;  // thinned under pressure (log_ingest.h)
+  uint32_t records_dropped;    // over class budget or queue full
+  uint32_t queue_depth;
+  uint32_t queue_high_water;   // shared ring
+  uint32_t blocks_written;
+  uint32_t bytes_written;
+  uint32_t segments_opened;
+  uint32_t write_errors;
+  uint32_t write_p50_us;      // over the last 256 write calls
+  uint32_t write_p95_us;
+  uint32_t write_max_us;      // since start
+  uint32_t sync_count;
+  uint32_t sync_max_us;
+  uint32_t sync_errors;
+};
+
+// Mounts storage and starts the writer task. Returns false (and pushes are
+// ignored) if storage is unavailable.
+bool log_writer_start(void);
+bool log_writer_running(void);
+
+// Single producer (the bus task). Never blocks; false if decimated or dropped.
+bool log_writer_push(const log_record_t* rec);
+
+void log_writer_get_stats(log_writer_stats_t* out);
+void log_writer_report(void);
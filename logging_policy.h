@@ -1,6 +1,14 @@
 #pragma once
 
-#include <Arduino.h>
+#if defined(ARDUINO)
+  #include <Arduino.h>
+  #define DBG_LOG_PRINTF(...) Serial.printf(__VA_ARGS__)
+#else
+  // Host builds of the data-path modules (bus decode, logging) print to stdout.
+  #include <stdint.h>
+  #include <stdio.h>
+  #define DBG_LOG_PRINTF(...) printf(__VA_ARGS__)
+#endif
 
 // Runtime/build-time logging policy.
 enum dbg_log_level_t : uint8_t {
@@ -37,7 +45,7 @@ static inline void dbg_set_runtime_log_level(dbg_log_level_t level) {
 
 #define DBG_LOG_ENABLED(level) ((level) <= dbg_runtime_log_level())
 
-#define DBG_LOGE(fmt, ...) do { if (DBG_LOG_ENABLED(DBG_LOG_ERROR)) Serial.printf("[ERROR] " fmt "\n", ##__VA_ARGS__); } while (0)
-#define DBG_LOGW(fmt, ...) do { if (DBG_LOG_ENABLED(DBG_LOG_WARN))  Serial.printf("[WARN] "  fmt "\n", ##__VA_ARGS__); } while (0)
-#define DBG_LOGI(fmt, ...) do { if (DBG_LOG_ENABLED(DBG_LOG_INFO))  Serial.printf("[INFO] "  fmt "\n", ##__VA_ARGS__); } while (0)
-#define DBG_LOGT(fmt, ...) do { if (DBG_LOG_ENABLED(DBG_LOG_TRACE)) Serial.printf("[TRACE] " fmt "\n", ##__VA_ARGS__); } while (0)
+#define DBG_LOGE(fmt, ...) do { if (DBG_LOG_ENABLED(DBG_LOG_ERROR)) DBG_LOG_PRINTF("[ERROR] " fmt "\n", ##__VA_ARGS__); } while (0)
+#define DBG_LOGW(fmt, ...) do { if (DBG_LOG_ENABLED(DBG_LOG_WARN))  DBG_LOG_PRINTF("[WARN] "  fmt "\n", ##__VA_ARGS__); } while (0)
+#define DBG_LOGI(fmt, ...) do { if (DBG_LOG_ENABLED(DBG_LOG_INFO))  DBG_LOG_PRINTF("[INFO] "  fmt "\n", ##__VA_ARGS__); } while (0)
+#define DBG_LOGT(fmt, ...) do { if (DBG_LOG_ENABLED(DBG_LOG_TRACE)) DBG_LOG_PRINTF("[TRACE] " fmt "\n", ##__VA_ARGS__); } while (0)
@@ -0,0 +1,309 @@
+#include "n2k_decode.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <string.h>
+#include <utility>
+
+// ---- Descriptors ----
+
+struct n2k_field_t {
+  uint16_t bit_offset;   // from the start of the payload, little-endian
+  uint8_t  bits;         // 0 = unused (no selector)
+  bool     is_signed;
+  float    resolution;   // SI units per LSB
+};
+
+static constexpr n2k_field_t NONE()                                { return {0, 0, false, 1.0f}; }
+static constexpr n2k_field_t BITS(uint16_t off, uint8_t n)         { return {off, n, false, 1.0f}; }
+static constexpr n2k_field_t U8(uint16_t off, float res = 1.0f)    { return {off, 8, false, res}; }
+static constexpr n2k_field_t U16(uint16_t off, float res)          { return {off, 16, false, res}; }
+static constexpr n2k_field_t I16(uint16_t off, float res)          { return {off, 16, true, res}; }
+static constexpr n2k_field_t I32(uint16_t off, float res)          { return {off, 32, true, res}; }
+static constexpr n2k_field_t I64(uint16_t off, float res)          { return {off, 64, true, res}; }
+
+struct n2k_signal_map_t {
+  signal_id_t signal;
+  n2k_field_t field;
+  float       scale;    // SI -> display unit
+  float       offset;
+};
+
+struct n2k_pgn_desc_t {
+  uint32_t                pgn;
+  n2k_field_t             select;        // instance/reference that must match
+  uint32_t                select_value;
+  const n2k_signal_map_t* map;
+  uint8_t                 count;
+};
+
+static constexpr float MS_TO_KN  = 1.943844f;
+static constexpr float RAD_TO_DEG = 57.2957795f;
+static constexpr float M_TO_NM   = 1.0f / 1852.0f;
+static constexpr float K_TO_C    = -273.15f;
+
+#define N2K_PGN_DESC(name, pgn, select, value) \
+  static constexpr n2k_pgn_desc_t name = {pgn, select, value, name##_map, sizeof(name##_map) / sizeof(name##_map[0])}
+
+// 127250 Vessel Heading: SID, heading, deviation, variation, reference.
+static constexpr n2k_signal_map_t k_127250_map[] = {
+  {SIG_HEADING, U16(8, 1e-4f), RAD_TO_DEG, 0.0f},
+};
+N2K_PGN_DESC(k_127250, 127250, NONE(), 0);
+
+// 127488 Engine Parameters, Rapid Update (engine instance 0).
+static constexpr n2k_signal_map_t k_127488_map[] = {
+  {SIG_RPM, U16(8, 0.25f), 1.0f, 0.0f},
+};
+N2K_PGN_DESC(k_127488, 127488, U8(0), 0);
+
+// 127489 Engine Parameters, Dynamic (fast-packet, engine instance 0).
+static constexpr n2k_signal_map_t k_127489_map[] = {
+  {SIG_COOLANT_TEMP, U16(40, 0.01f), 1.0f, K_TO_C},
+};
+N2K_PGN_DESC(k_127489, 127489, U8(0), 0);
+
+// 127506 DC Detailed Status (fast-packet, DC instance 0).
+static constexpr n2k_signal_map_t k_127506_map[] = {
+  {SIG_SOC, U8(24), 1.0f, 0.0f},
+};
+N2K_PGN_DESC(k_127506, 127506, U8(8), 0);
+
+// 127508 Battery Status (battery instance 0).
+static constexpr n2k_signal_map_t k_127508_map[] = {
+  {SIG_PACK_VOLTAGE, U16(8, 0.01f), 1.0f, 0.0f},
+  {SIG_PACK_CURRENT, I16(24, 0.1f), 1.0f, 0.0f},
+};
+N2K_PGN_DESC(k_127508, 127508, U8(0), 0);
+
+// 128259 Speed: SID, speed through water, speed over ground, type.
+static constexpr n2k_signal_map_t k_128259_map[] = {
+  {SIG_STW, U16(8, 0.01f), MS_TO_KN, 0.0f},
+};
+N2K_PGN_DESC(k_128259, 128259, NONE(), 0);
+
+// 129025 Position, Rapid Update.
+static constexpr n2k_signal_map_t k_129025_map[] = {
+  {SIG_LAT, I32(0, 1e-7f), 1.0f, 0.0f},
+  {SIG_LON, I32(32, 1e-7f), 1.0f, 0.0f},
+};
+N2K_PGN_DESC(k_129025, 129025, NONE(), 0);
+
+// 129026 COG & SOG, Rapid Update (true reference only).
+static constexpr n2k_signal_map_t k_129026_map[] = {
+  {SIG_COG, U16(16, 1e-4f), RAD_TO_DEG, 0.0f},
+  {SIG_SOG, U16(32, 0.01f), MS_TO_KN, 0.0f},
+};
+N2K_PGN_DESC(k_129026, 129026, BITS(8, 2), 0);
+
+// 129029 GNSS Position Data (fast-packet).
+static constexpr n2k_signal_map_t k_129029_map[] = {
+  {SIG_LAT, I64(56, 1e-16f), 1.0f, 0.0f},
+  {SIG_LON, I64(120, 1e-16f), 1.0f, 0.0f},
+};
+N2K_PGN_DESC(k_129029, 129029, NONE(), 0);
+
+// 129283 Cross Track Error.
+static constexpr n2k_signal_map_t k_129283_map[] = {
+  {SIG_XTE, I32(16, 0.01f), M_TO_NM, 0.0f},
+};
+N2K_PGN_DESC(k_129283, 129283, NONE(), 0);
+
+// 130306 Wind Data (apparent reference only).
+static constexpr n2k_signal_map_t k_130306_map[] = {
+  {SIG_WIND_SPEED, U16(8, 0.01f), MS_TO_KN, 0.0f},
+  {SIG_WIND_ANGLE, U16(24, 1e-4f), RAD_TO_DEG, 0.0f},
+};
+N2K_PGN_DESC(k_130306, 130306, BITS(40, 3), 2);
+
+// ---- Field extraction ----
+
+enum field_status_t : uint8_t { FIELD_OK, FIELD_NA, FIELD_SHORT };
+
+static n2k_decode_stats_t s_stats;
+
+// All-ones marks "not available"; for fields of a byte or more, all-ones
+// minus one marks "out of range". Signed fields use the largest positive value.
+template <uint16_t OFF, uint8_t BITS, bool SIGNED>
+static inline field_status_t read_field(const n2k_msg_t* msg, int64_t* out) {
+  static_assert(BITS >= 1 && BITS <= 64, "field width out of range");
+  static_assert(OFF % 8 == 0 || BITS <= 56, "unaligned fields are limited to 56 bits");
+  constexpr uint16_t first = OFF / 8;
+  constexpr uint8_t  shift = OFF % 8;
+  constexpr uint8_t  nbytes = (shift + BITS + 7) / 8;
+  constexpr uint64_t mask = (BITS == 64) ? ~0ull : ((1ull << (BITS % 64)) - 1);
+
+  if (msg->len < first + nbytes) return FIELD_SHORT;
+  const uint8_t* p = msg->data + first;
+  uint64_t v = 0;
+  for (int i = nbytes - 1; i >= 0; --i) v = (v << 8) | p[i];
+  v = (v >> shift) & mask;
+
+  if constexpr (SIGNED) {
+    constexpr uint64_t na = mask >> 1;
+    if (v == na || (BITS >= 8 && v == na - 1)) return FIELD_NA;
+    if constexpr (BITS < 64) {
+      if ((v >> (BITS - 1)) & 1) v |= ~mask;
+    }
+  } else {
+    if (v == mask || (BITS >= 8 && v == mask - 1)) return FIELD_NA;
+  }
+  *out = (int64_t)v;
+  return FIELD_OK;
+}
+
+template <const n2k_pgn_desc_t& D, size_t I>
+static inline void emit_field(const n2k_msg_t* msg, n2k_signal_sink_t sink, void* ctx, int* emitted) {
+  constexpr n2k_signal_map_t M = D.map[I];
+  constexpr float k = M.field.resolution * M.scale;
+  int64_t raw;
+  switch (read_field<M.field.bit_offset, M.field.bits, M.field.is_signed>(msg, &raw)) {
+    case FIELD_OK:
+      sink(M.signal, (float)raw * k + M.offset, msg, ctx);
+      (*emitted)++;
+      break;
+    case FIELD_NA:
+      s_stats.not_available++;
+      break;
+    case FIELD_SHORT:
+      s_stats.short_payload++;
+      break;
+  }
+}
+
+template <const n2k_pgn_desc_t& D, size_t... I>
+static inline int decode_fields(const n2k_msg_t* msg, n2k_signal_sink_t sink, void* ctx, std::index_sequence<I...>) {
+  int emitted = 0;
+  (emit_field<D, I>(msg, sink, ctx, &emitted), ...);
+  return emitted;
+}
+
+template <const n2k_pgn_desc_t& D>
+static int decode_pgn(const n2k_msg_t* msg, n2k_signal_sink_t sink, void* ctx) {
+  if constexpr (D.select.bits != 0) {
+    int64_t sel;
+    if (read_field<D.select.bit_offset, D.select.bits, false>(msg, &sel) != FIELD_OK ||
+        sel != (int64_t)D.select_value) {
+      s_stats.filtered++;
+      return 0;
+    }
+  }
+  return decode_fields<D>(msg, sink, ctx, std::make_index_sequence<D.count>{});
+}
+
+// ---- Dispatch ----
+
+struct n2k_dispatch_t {
+  uint32_t pgn;
+  int (*decode)(const n2k_msg_t*, n2k_signal_sink_t, void*);
+  uint32_t signals;   // 1 << signal_id_t for each mapped field
+};
+
+static constexpr uint32_t signal_mask(const n2k_pgn_desc_t& d) {
+  uint32_t m = 0;
+  for (uint8_t i = 0; i < d.count; ++i) m |= 1u << d.map[i].signal;
+  return m;
+}
+
+#define N2K_DISPATCH(desc) {desc.pgn, decode_pgn<desc>, signal_mask(desc)}
+
+static constexpr n2k_dispatch_t k_dispatch[] = {
+  N2K_DISPATCH(k_127250),
+  N2K_DISPATCH(k_127488),
+  N2K_DISPATCH(k_127489),
+  N2K_DISPATCH(k_127506),
+  N2K_DISPATCH(k_127508),
+  N2K_DISPATCH(k_128259),
+  N2K_DISPATCH(k_129025),
+  N2K_DISPATCH(k_129026),
+  N2K_DISPATCH(k_129029),
+  N2K_DISPATCH(k_129283),
+  N2K_DISPATCH(k_130306),
+};
+static constexpr uint16_t DISPATCH_COUNT = sizeof(k_dispatch) / sizeof(k_dispatch[0]);
+
+static constexpr bool dispatch_sorted(uint16_t i) {
+  return i + 1 >= DISPATCH_COUNT || (k_dispatch[i].pgn < k_dispatch[i + 1].pgn && dispatch_sorted(i + 1));
+}
+static_assert(dispatch_sorted(0), "k_dispatch must be sorted by PGN with no duplicates");
+
+static const n2k_dispatch_t* find_pgn(uint32_t pgn) {
+  uint16_t lo = 0, hi = DISPATCH_COUNT;
+  while (lo < hi) {
+    const uint16_t mid = (lo + hi) / 2;
+    if (k_dispatch[mid].pgn < pgn) lo = mid + 1; else hi = mid;
+  }
+  return (lo < DISPATCH_COUNT && k_dispatch[lo].pgn == pgn) ? &k_dispatch[lo] : nullptr;
+}
+
+int n2k_decode(const n2k_msg_t* msg, n2k_signal_sink_t sink, void* ctx) {
+  const n2k_dispatch_t* d = find_pgn(msg->pgn);
+  if (!d) {
+    s_stats.unknown_pgn++;
+    return -1;
+  }
+  s_stats.messages++;
+  const int n = d->decode(msg, sink, ctx);
+  s_stats.signals += (uint32_t)n;
+  return n;
+}
+
+bool n2k_decode_handles(uint32_t pgn) {
+  return find_pgn(pgn) != nullptr;
+}
+
+uint16_t n2k_decode_pgn_count(void) {
+  return DISPATCH_COUNT;
+}
+
+uint32_t n2k_decode_pgn_at(uint16_t i) {
+  return (i < DISPATCH_COUNT) ? k_dispatch[i].pgn : 0;
+}
+
+uint32_t n2k_decode_pgn_signals(uint32_t pgn) {
+  const n2k_dispatch_t* d = find_pgn(pgn);
+  return d ? d->signals : 0;
+}
+
+void n2k_decode_get_stats(n2k_decode_stats_t* out) {
+  *out = s_stats;
+}
+
+void n2k_decode_reset_stats(void) {
+  memset(&s_stats, 0, sizeof(s_stats));
+}
+
+// ---- Benchmark ----
+
+static void bench_sink(signal_id_t, float value, const n2k_msg_t*, void* ctx) {
+  *(float*)ctx += value;
+}
+
+void n2k_decode_benchmark(uint32_t iterations) {
+  // One zeroed payload long enough for every PGN; instance/reference
+  // selectors of 0 match, byte 5 = 2 selects apparent wind.
+  uint8_t payload[48];
+  memset(payload, 0, sizeof(payload));
+  payload[5] = 2;
+
+  n2k_msg_t msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.data = payload;
+  msg.len = sizeof(payload);
+
+  float sink = 0.0f;
+  uint32_t signals = 0;
+  const uint32_t t0 = plat_micros();
+  for (uint32_t it = 0; it < iterations; ++it) {
+    payload[1] = (uint8_t)it;
+    for (uint16_t i = 0; i < DISPATCH_COUNT; ++i) {
+      msg.pgn = k_dispatch[i].pgn;
+      signals += (uint32_t)n2k_decode(&msg, bench_sink, &sink);
+    }
+  }
+  const uint32_t us = plat_micros() - t0;
+  const uint32_t msgs = iterations * DISPATCH_COUNT;
+  DBG_LOGI("[n2k][bench] msgs=%u signals=%u us=%u rate=%u msg/s (sink=%d)", (unsigned)msgs,
+           (unsigned)signals, (unsigned)us, (unsigned)(us ? (uint64_t)msgs * 1000000u / us : 0),
+           (int)sink);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "n2k_id.h"
+#include "signals.h"
+#include <stdint.h>
+
+// NMEA2000 PGN -> signal decoding.
+//
+// Field layouts live in constexpr descriptor tables (n2k_decode.cpp); each
+// PGN gets a decoder instantiated from its table, so bit offsets, widths,
+// resolutions and "not available" sentinels are compile-time constants and
+// fields are read straight from the message payload. Dispatch is a sorted
+// PGN table checked by static_assert and searched by bisection.
+
+typedef void (*n2k_signal_sink_t)(signal_id_t sig, float value, const n2k_msg_t* msg, void* ctx);
+
+struct n2k_decode_stats_t {
+  uint32_t messages;       // handled PGNs
+  uint32_t unknown_pgn;
+  uint32_t filtered;       // instance/reference did not match
+  uint32_t signals;        // values emitted
+  uint32_t not_available;  // field carried an NA/error sentinel
+  uint32_t short_payload;  // field beyond the received length
+};
+
+// Decodes `msg` and reports each valid field to `sink`.
+// Returns the number of signals emitted, or -1 if the PGN is not handled.
+int n2k_decode(const n2k_msg_t* msg, n2k_signal_sink_t sink, void* ctx);
+
+bool     n2k_decode_handles(uint32_t pgn);
+uint16_t n2k_decode_pgn_count(void);
+uint32_t n2k_decode_pgn_at(uint16_t i);
+// Signals (1 << signal_id_t) the PGN can emit; 0 if not handled.
+uint32_t n2k_decode_pgn_signals(uint32_t pgn);
+
+void n2k_decode_get_stats(n2k_decode_stats_t* out);
+void n2k_decode_reset_stats(void);
+
+// Decodes a synthetic mix of every handled PGN `iterations` times and logs
+// messages per second.
+void n2k_decode_benchmark(uint32_t iterations);
@@ -0,0 +1,176 @@
+#include "n2k_fast_packet.h"
+
+#include <string.h>
+
+static_assert(N2K_FP_SLOTS >= 1 && N2K_FP_SLOTS <= 64, "slot pool is tracked in a 64-bit mask");
+
+static constexpr uint32_t EXPIRE_PERIOD_US = 100000;
+
+static inline int ctz64(uint64_t v) { return __builtin_ctzll(v); }
+
+static void slot_release(n2k_fp_t* fp, int i) {
+  fp->used_mask &= ~(1ull << i);
+  fp->stats.in_flight--;
+}
+
+static int slot_find(const n2k_fp_t* fp, uint8_t src, uint32_t pgn, uint8_t seq) {
+  for (uint64_t m = fp->used_mask; m; m &= m - 1) {
+    const int i = ctz64(m);
+    const n2k_fp_slot_t* s = &fp->slots[i];
+    if (s->src == src && s->pgn == pgn && s->seq == seq) return i;
+  }
+  return -1;
+}
+
+static int slot_alloc(n2k_fp_t* fp) {
+  const uint64_t all = ~0ull >> (64 - N2K_FP_SLOTS);
+  const uint64_t free_mask = ~fp->used_mask & all;
+  if (!free_mask) return -1;
+  const int i = ctz64(free_mask);
+  fp->used_mask |= 1ull << i;
+  if (++fp->stats.in_flight > fp->stats.in_flight_high_water) {
+    fp->stats.in_flight_high_water = fp->stats.in_flight;
+  }
+  return i;
+}
+
+static void deliver(n2k_fp_t* fp, int i) {
+  const n2k_fp_slot_t* s = &fp->slots[i];
+  n2k_msg_t msg;
+  msg.pgn = s->pgn;
+  msg.t_us = s->t_last_us;
+  msg.data = s->data;
+  msg.len = s->total_len;
+  msg.prio = s->prio;
+  msg.src = s->src;
+  msg.dst = s->dst;
+  fp->stats.completed++;
+  if (fp->cb) fp->cb(&msg, fp->cb_ctx);
+  slot_release(fp, i);
+}
+
+static void on_first_frame(n2k_fp_t* fp, const n2k_id_t* id, const can_frame_t* f, uint8_t seq) {
+  const uint8_t total = f->data[1];
+  uint8_t n = (f->dlc > 2) ? (uint8_t)(f->dlc - 2) : 0;
+  if (n > 6) n = 6;
+  if (n > total) n = total;
+  if (f->dlc < 2 || total == 0 || total > N2K_FP_MAX_LEN || (n < 6 && n < total)) {
+    fp->stats.bad_length++;
+    return;
+  }
+
+  int i = slot_find(fp, id->src, id->pgn, seq);
+  if (i >= 0) {
+    n2k_fp_slot_t* s = &fp->slots[i];
+    if (s->next_frame == 1 && s->total_len == total && memcmp(s->data, &f->data[2], n) == 0) {
+      fp->stats.duplicates++;
+      return;
+    }
+    fp->stats.abandoned++;   // sender restarted this sequence id
+  } else {
+    i = slot_alloc(fp);
+    if (i < 0) {
+      fp->stats.pool_exhausted++;
+      return;
+    }
+  }
+
+  n2k_fp_slot_t* s = &fp->slots[i];
+  s->pgn = id->pgn;
+  s->src = id->src;
+  s->dst = id->dst;
+  s->prio = id->prio;
+  s->seq = seq;
+  s->total_len = total;
+  s->t_last_us = f->t_us;
+  s->next_frame = 1;
+  memcpy(s->data, &f->data[2], n);
+  s->received = n;
+  if (s->received >= total) deliver(fp, i);
+}
+
+static void on_next_frame(n2k_fp_t* fp, const n2k_id_t* id, const can_frame_t* f, uint8_t seq, uint8_t counter) {
+  const int i = slot_find(fp, id->src, id->pgn, seq);
+  if (i < 0) {
+    fp->stats.orphans++;
+    return;
+  }
+  n2k_fp_slot_t* s = &fp->slots[i];
+  if (counter < s->next_frame) {
+    fp->stats.duplicates++;
+    return;
+  }
+  if (counter > s->next_frame) {
+    fp->stats.out_of_order++;
+    slot_release(fp, i);
+    return;
+  }
+
+  const uint8_t remaining = (uint8_t)(s->total_len - s->received);
+  uint8_t n = (uint8_t)(f->dlc - 1);
+  if (n > 7) n = 7;
+  if (n > remaining) n = remaining;
+  if (n < 7 && n < remaining) {
+    fp->stats.bad_length++;
+    slot_release(fp, i);
+    return;
+  }
+  memcpy(&s->data[s->received], &f->data[1], n);
+  s->received = (uint8_t)(s->received + n);
+  s->next_frame++;
+  s->t_last_us = f->t_us;
+  if (s->received >= s->total_len) deliver(fp, i);
+}
+
+void n2k_fp_init(n2k_fp_t* fp, n2k_msg_cb_t cb, void* ctx) {
+  memset(fp, 0, sizeof(*fp));
+  fp->cb = cb;
+  fp->cb_ctx = ctx;
+}
+
+void n2k_fp_feed(n2k_fp_t* fp, const can_frame_t* f) {
+  if (!(f->flags & CAN_FRAME_EXT) || (f->flags & CAN_FRAME_RTR)) return;
+
+  if ((uint32_t)(f->t_us - fp->last_expire_us) >= EXPIRE_PERIOD_US) {
+    n2k_fp_expire(fp, f->t_us);
+  }
+
+  const n2k_id_t id = n2k_parse_id(f->id);
+  if (!n2k_is_fast_packet(id.pgn)) {
+    n2k_msg_t msg;
+    msg.pgn = id.pgn;
+    msg.t_us = f->t_us;
+    msg.data = f->data;
+    msg.len = f->dlc;
+    msg.prio = id.prio;
+    msg.src = id.src;
+    msg.dst = id.dst;
+    fp->stats.single_frames++;
+    if (fp->cb) fp->cb(&msg, fp->cb_ctx);
+    return;
+  }
+
+  if (f->dlc < 1) {
+    fp->stats.bad_length++;
+    return;
+  }
+  const uint8_t seq = f->data[0] >> 5;
+  const uint8_t counter = f->data[0] & 0x1F;
+  if (counter == 0) on_first_frame(fp, &id, f, seq);
+  else on_next_frame(fp, &id, f, seq, counter);
+}
+
+void n2k_fp_expire(n2k_fp_t* fp, uint32_t now_us) {
+  fp->last_expire_us = now_us;
+  for (uint64_t m = fp->used_mask; m; m &= m - 1) {
+    const int i = ctz64(m);
+    if ((uint32_t)(now_us - fp->slots[i].t_last_us) > N2K_FP_TIMEOUT_US) {
+      fp->stats.abandoned++;
+      slot_release(fp, i);
+    }
+  }
+}
+
+void n2k_fp_get_stats(const n2k_fp_t* fp, n2k_fp_stats_t* out) {
+  *out = fp->stats;
+}
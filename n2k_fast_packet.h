@@ -0,0 +1,72 @@
+#pragma once
+
+#include "can_rx.h"
+#include "n2k_id.h"
+#include <stdint.h>
+
+// NMEA2000 fast-packet reassembly over a fixed slot pool (no heap).
+//
+// Frame 0:  [seq<<5 | 0] [total_len] [6 data bytes]
+// Frame n:  [seq<<5 | n] [7 data bytes]
+//
+// Packets in flight are keyed by (source, PGN, sequence id), so interleaved
+// transfers from many senders reassemble independently. Completed payloads
+// (and single-frame PGNs) go to the callback as an n2k_msg_t pointing into
+// the slot or the CAN frame; nothing is copied after reassembly.
+
+#ifndef N2K_FP_SLOTS
+  #define N2K_FP_SLOTS 48          // concurrent transfers in flight (<= 64)
+#endif
+#ifndef N2K_FP_TIMEOUT_US
+  #define N2K_FP_TIMEOUT_US 750000 // max gap between frames of one packet
+#endif
+
+#define N2K_FP_MAX_LEN 223         // 6 + 31 * 7
+
+typedef void (*n2k_msg_cb_t)(const n2k_msg_t* msg, void* ctx);
+
+struct n2k_fp_stats_t {
+  uint32_t single_frames;
+  uint32_t completed;       // fast-packets delivered
+  uint32_t out_of_order;    // frame counter skipped ahead; packet dropped
+  uint32_t duplicates;      // repeated frame ignored
+  uint32_t orphans;         // continuation without a frame 0
+  uint32_t abandoned;       // timed out or restarted before completion
+  uint32_t pool_exhausted;  // frame 0 dropped, no free slot
+  uint32_t bad_length;      // total length 0 or > 223, or short frame
+  uint16_t in_flight;
+  uint16_t in_flight_high_water;
+};
+
+struct n2k_fp_slot_t {
+  uint32_t pgn;
+  uint32_t t_last_us;
+  uint8_t  src;
+  uint8_t  dst;
+  uint8_t  prio;
+  uint8_t  seq;
+  uint8_t  total_len;
+  uint8_t  received;
+  uint8_t  next_frame;
+  uint8_t  data[N2K_FP_MAX_LEN];
+};
+
+struct n2k_fp_t {
+  n2k_fp_slot_t  slots[N2K_FP_SLOTS];
+  uint64_t       used_mask;
+  uint32_t       last_expire_us;
+  n2k_msg_cb_t   cb;
+  void*          cb_ctx;
+  n2k_fp_stats_t stats;
+};
+
+void n2k_fp_init(n2k_fp_t* fp, n2k_msg_cb_t cb, void* ctx);
+
+// Feed one received CAN frame (standard-ID and RTR frames are ignored).
+void n2k_fp_feed(n2k_fp_t* fp, const can_frame_t* frame);
+
+// Abandon transfers idle for longer than N2K_FP_TIMEOUT_US. n2k_fp_feed()
+// calls this every 100 ms of frame time; call it directly on a quiet bus.
+void n2k_fp_expire(n2k_fp_t* fp, uint32_t now_us);
+
+void n2k_fp_get_stats(const n2k_fp_t* fp, n2k_fp_stats_t* out);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+
+// NMEA2000 / J1939 29-bit identifier helpers and the message view handed to
+// decoders.
+//
+//   28..26 priority | 25..24 EDP/DP | 23..16 PF | 15..8 PS | 7..0 source
+//
+// PF < 240 (PDU1): PS is the destination and not part of the PGN.
+// PF >= 240 (PDU2): PS is the group extension, destination is global (255).
+
+#define N2K_ADDR_GLOBAL 255
+
+struct n2k_id_t {
+  uint32_t pgn;
+  uint8_t  prio;
+  uint8_t  src;
+  uint8_t  dst;
+};
+
+static inline n2k_id_t n2k_parse_id(uint32_t can_id) {
+  n2k_id_t id;
+  const uint8_t pf = (uint8_t)(can_id >> 16);
+  const uint8_t ps = (uint8_t)(can_id >> 8);
+  const uint32_t dp = (can_id >> 24) & 0x03;
+  id.prio = (uint8_t)((can_id >> 26) & 0x07);
+  id.src = (uint8_t)can_id;
+  if (pf < 240) {
+    id.pgn = (dp << 16) | ((uint32_t)pf << 8);
+    id.dst = ps;
+  } else {
+    id.pgn = (dp << 16) | ((uint32_t)pf << 8) | ps;
+    id.dst = N2K_ADDR_GLOBAL;
+  }
+  return id;
+}
+
+static inline uint32_t n2k_make_id(uint32_t pgn, uint8_t prio, uint8_t src, uint8_t dst) {
+  uint32_t id = ((uint32_t)(prio & 0x07) << 26) | ((pgn & 0x3FFFF) << 8) | src;
+  if (((pgn >> 8) & 0xFF) < 240) id = (id & ~0xFF00u) | ((uint32_t)dst << 8);
+  return id;
+}
+
+// Complete NMEA2000 message. `data` points into the CAN frame (single-frame
+// PGNs) or into a reassembly slot (fast-packet) and is only valid for the
+// duration of the callback.
+struct n2k_msg_t {
+  uint32_t       pgn;
+  uint32_t       t_us;   // receive time of the last frame
+  const uint8_t* data;
+  uint8_t        len;
+  uint8_t        prio;
+  uint8_t        src;
+  uint8_t        dst;
+};
+
+// Standard PGNs transmitted as fast-packets (multi-frame, up to 223 bytes).
+// Must stay sorted; n2k_is_fast_packet() bisects it.
+static constexpr uint32_t k_n2k_fast_packet_pgns[] = {
+  126208, 126464, 126996, 126998, 127233, 127237, 127489, 127496, 127497, 127498,
+  127503, 127504, 127506, 127507, 127509, 127510, 127511, 127512, 127513, 127514,
+  128275, 128520, 129029, 129038, 129039, 129040, 129041, 129044, 129045, 129284,
+  129285, 129301, 129302, 129538, 129540, 129541, 129542, 129545, 129547, 129549,
+  129551, 129556, 129792, 129793, 129794, 129795, 129796, 129797, 129798, 129799,
+  129800, 129801, 129802, 129803, 129804, 129805, 129806, 129807, 129808, 129809,
+  129810, 130052, 130053, 130054, 130060, 130061, 130064, 130065, 130066, 130067,
+  130068, 130069, 130070, 130071, 130072, 130073, 130074, 130320, 130321, 130322,
+  130323, 130324, 130567, 130577, 130578,
+};
+
+static constexpr bool n2k_pgn_table_sorted(const uint32_t* t, uint32_t n) {
+  return n < 2 || (t[0] < t[1] && n2k_pgn_table_sorted(t + 1, n - 1));
+}
+static_assert(n2k_pgn_table_sorted(k_n2k_fast_packet_pgns,
+                                   sizeof(k_n2k_fast_packet_pgns) / sizeof(k_n2k_fast_packet_pgns[0])),
+              "k_n2k_fast_packet_pgns must be sorted");
+
+static inline bool n2k_is_fast_packet(uint32_t pgn) {
+  // Proprietary addressed (126720) and global (130816..131071) PGNs are fast-packet.
+  if (pgn == 126720 || (pgn >= 130816 && pgn <= 131071)) return true;
+  uint32_t lo = 0, hi = sizeof(k_n2k_fast_packet_pgns) / sizeof(k_n2k_fast_packet_pgns[0]);
+  while (lo < hi) {
+    const uint32_t mid = (lo + hi) / 2;
+    if (k_n2k_fast_packet_pgns[mid] < pgn) lo = mid + 1; else hi = mid;
+  }
+  return lo < sizeof(k_n2k_fast_packet_pgns) / sizeof(k_n2k_fast_packet_pgns[0]) &&
+         k_n2k_fast_packet_pgns[lo] == pgn;
+}
@@ -0,0 +1,249 @@
+#include "n2k_subs.h"
+#include "n2k_decode.h"
+#include "n2k_id.h"
+#include "logging_policy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string.h>
+
+// Each owner publishes its list seqlock style into one of two buffers: the
+// generation is odd while the writer fills the buffer that is not current
+// and even once it is, so buffer (gen / 2) & 1 is complete whenever the bus
+// task looks. A copy is only torn if the writer got round to that buffer
+// again, i.e. the generation moved more than one publish past the start.
+// Payload words are atomics for the same reason as in signal_store.cpp.
+struct owner_buf_t {
+  std::atomic<uint32_t> pgns[N2K_SUBS_MAX_PGNS];
+  std::atomic<uint8_t>  count;
+  std::atomic<bool>     all;
+};
+
+struct owner_subs_t {
+  std::atomic<uint32_t> gen;
+  owner_buf_t           buf[2];
+};
+
+static owner_subs_t      s_owners[N2K_SUB_OWNERS];
+static std::atomic<bool> s_dirty{false};
+static std::atomic<uint32_t> s_collisions{0};
+
+// Bus task only.
+static constexpr uint16_t UNION_MAX = N2K_SUB_OWNERS * N2K_SUBS_MAX_PGNS;
+static uint32_t        s_union[UNION_MAX];
+static uint16_t        s_union_count = 0;
+static bool            s_accept_all = true;
+static can_id_filter_t s_hw[CAN_RX_MAX_FILTERS];
+static uint8_t         s_hw_count = 0;
+static bool            s_apply_due = false;
+static uint32_t        s_apply_at = 0;
+static bool            s_sampling = false;
+static uint32_t        s_sample_start = 0;
+static uint32_t        s_sample_window = 0;
+static uint32_t        s_sample_frames = 0;
+static uint32_t        s_sample_rejects = 0;
+
+static std::atomic<uint32_t> s_sample_req{0};
+static std::atomic<uint32_t> s_frames{0};
+static std::atomic<uint32_t> s_sw_rejected{0};
+static std::atomic<uint32_t> s_non_ext{0};
+static std::atomic<uint32_t> s_reprograms{0};
+static std::atomic<uint32_t> s_apply_failures{0};
+static std::atomic<uint32_t> s_hw_reject_est{0};
+static std::atomic<uint32_t> s_hw_sample_frames{0};
+static std::atomic<uint16_t> s_stat_pgns{0};
+static std::atomic<uint8_t>  s_stat_hw_filters{0};
+static std::atomic<bool>     s_stat_accept_all{true};
+
+static inline void bump(std::atomic<uint32_t>& c) {
+  c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+// One task per owner, so the generation has a single writer.
+static void publish(n2k_sub_owner_t owner, const uint32_t* pgns, uint8_t count, bool all) {
+  owner_subs_t* o = &s_owners[owner];
+  const uint32_t gen = o->gen.load(std::memory_order_relaxed);
+  owner_buf_t* b = &o->buf[((gen >> 1) + 1) & 1];
+  o->gen.store(gen + 1, std::memory_order_relaxed);
+  for (uint8_t i = 0; i < count; ++i) b->pgns[i].store(pgns[i], std::memory_order_release);
+  b->count.store(count, std::memory_order_release);
+  b->all.store(all, std::memory_order_release);
+  o->gen.store(gen + 2, std::memory_order_release);
+  s_dirty.store(true, std::memory_order_release);
+}
+
+// Copies the owner's current list to `pgns`; false if the writer kept
+// overtaking the copy.
+static bool snapshot(const owner_subs_t* o, uint32_t* pgns, uint8_t* count, bool* all) {
+  for (int attempt = 0; attempt < N2K_SUBS_READ_TRIES; ++attempt) {
+    const uint32_t gen0 = o->gen.load(std::memory_order_acquire);
+    const owner_buf_t* b = &o->buf[(gen0 >> 1) & 1];
+    const uint8_t n = b->count.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n && i < N2K_SUBS_MAX_PGNS; ++i) pgns[i] = b->pgns[i].load(std::memory_order_acquire);
+    *all = b->all.load(std::memory_order_acquire);
+    if (o->gen.load(std::memory_order_relaxed) - (gen0 & ~1u) > 2) continue;
+    *count = n;
+    return true;
+  }
+  return false;
+}
+
+void n2k_subs_set(n2k_sub_owner_t owner, const uint32_t* pgns, uint8_t count) {
+  if (owner >= N2K_SUB_OWNERS) return;
+  const bool all = count > N2K_SUBS_MAX_PGNS;
+  publish(owner, pgns, all ? 0 : count, all);
+}
+
+void n2k_subs_set_signals(n2k_sub_owner_t owner, uint32_t signal_mask) {
+  uint32_t pgns[N2K_SUBS_MAX_PGNS + 1];
+  uint8_t n = 0;
+  for (uint16_t i = 0; i < n2k_decode_pgn_count() && n <= N2K_SUBS_MAX_PGNS; ++i) {
+    const uint32_t pgn = n2k_decode_pgn_at(i);
+    if (n2k_decode_pgn_signals(pgn) & signal_mask) pgns[n++] = pgn;
+  }
+  n2k_subs_set(owner, pgns, n);
+}
+
+void n2k_subs_set_all(n2k_sub_owner_t owner, bool all) {
+  if (owner >= N2K_SUB_OWNERS) return;
+  publish(owner, nullptr, 0, all);
+}
+
+// False, keeping the previous union, if an owner could not be copied.
+static bool rebuild_union(void) {
+  static uint32_t pgns[UNION_MAX];
+  uint16_t n = 0;
+  bool all = false;
+  for (const owner_subs_t& o : s_owners) {
+    uint8_t count;
+    bool owner_all;
+    if (!snapshot(&o, &pgns[n], &count, &owner_all)) {
+      s_collisions.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    all |= owner_all;
+    n += count;
+  }
+  memcpy(s_union, pgns, n * sizeof(pgns[0]));
+  std::sort(s_union, s_union + n);
+  s_union_count = (uint16_t)(std::unique(s_union, s_union + n) - s_union);
+  s_accept_all = all || s_union_count == 0;
+  s_stat_pgns.store(s_accept_all ? 0 : s_union_count, std::memory_order_relaxed);
+  s_stat_accept_all.store(s_accept_all, std::memory_order_relaxed);
+  return true;
+}
+
+// PDU1 PGNs carry the destination in PS; leave it (and priority/source)
+// open so addressed and broadcast copies both pass.
+static can_id_filter_t pgn_filter(uint32_t pgn) {
+  const bool pdu1 = ((pgn >> 8) & 0xFF) < 240;
+  return {(pgn & 0x3FFFF) << 8, pdu1 ? 0x03FF0000u : 0x03FFFF00u};
+}
+
+static void apply_hw(void) {
+  can_id_filter_t want[CAN_RX_MAX_FILTERS];
+  uint8_t count = 0;
+  if (!s_accept_all && s_union_count <= CAN_RX_MAX_FILTERS) {
+    for (uint16_t i = 0; i < s_union_count; ++i) want[count++] = pgn_filter(s_union[i]);
+  }
+  can_id_filter_t got[CAN_RX_MAX_FILTERS];
+  const int n = can_rx_set_filters(want, count, got);
+  if (n < 0) {
+    bump(s_apply_failures);
+    s_hw_count = 0;
+  } else if (n != s_hw_count || memcmp(got, s_hw, n * sizeof(got[0])) != 0) {
+    memcpy(s_hw, got, n * sizeof(got[0]));
+    s_hw_count = (uint8_t)n;
+    bump(s_reprograms);
+    DBG_LOGI("[subs] %u PGNs%s -> %u hardware filters", (unsigned)s_union_count,
+             s_accept_all ? " (accept all)" : "", (unsigned)s_hw_count);
+  }
+  s_stat_hw_filters.store(s_hw_count, std::memory_order_relaxed);
+}
+
+void n2k_subs_poll(uint32_t now_ms) {
+  if (s_dirty.exchange(false, std::memory_order_acquire)) {
+    if (rebuild_union()) {
+      s_apply_due = true;
+      s_apply_at = now_ms + N2K_SUBS_APPLY_DELAY_MS;
+    } else {
+      s_dirty.store(true, std::memory_order_relaxed);   // try again next poll
+    }
+  }
+
+  if (s_sampling) {
+    if (now_ms - s_sample_start < s_sample_window) return;
+    s_sampling = false;
+    const uint32_t elapsed = now_ms - s_sample_start;
+    s_hw_reject_est.store(elapsed ? (uint32_t)((uint64_t)s_sample_rejects * 1000 / elapsed) : 0,
+                          std::memory_order_relaxed);
+    s_hw_sample_frames.store(s_sample_frames, std::memory_order_relaxed);
+    s_hw_count = 0;   // the controller is open; force the reapply
+    apply_hw();
+    return;
+  }
+
+  const uint32_t window = s_sample_req.exchange(0, std::memory_order_relaxed);
+  if (window && s_hw_count) {
+    s_sample_frames = s_sample_rejects = 0;
+    s_sample_start = now_ms;
+    s_sample_window = window;
+    can_id_filter_t unused[1];
+    if (can_rx_set_filters(nullptr, 0, unused) == 0) {
+      s_sampling = true;
+      return;
+    }
+  } else if (window) {
+    s_hw_reject_est.store(0, std::memory_order_relaxed);   // nothing filtered in hardware
+  }
+
+  if (s_apply_due && (int32_t)(now_ms - s_apply_at) >= 0) {
+    s_apply_due = false;
+    apply_hw();
+  }
+}
+
+bool n2k_subs_accepts(const can_frame_t* frame) {
+  bump(s_frames);
+  if (!(frame->flags & CAN_FRAME_EXT)) {
+    bump(s_non_ext);
+    return false;
+  }
+  if (s_sampling) {
+    s_sample_frames++;
+    if (!can_filters_match(s_hw, s_hw_count, frame->id)) s_sample_rejects++;
+  }
+  if (s_accept_all) return true;
+  const uint32_t pgn = n2k_parse_id(frame->id).pgn;
+  if (std::binary_search(s_union, s_union + s_union_count, pgn)) return true;
+  bump(s_sw_rejected);
+  return false;
+}
+
+void n2k_subs_sample(uint32_t window_ms) {
+  if (window_ms) s_sample_req.store(window_ms, std::memory_order_relaxed);
+}
+
+void n2k_subs_get_stats(n2k_subs_stats_t* out) {
+  out->frames = s_frames.load(std::memory_order_relaxed);
+  out->sw_rejected = s_sw_rejected.load(std::memory_order_relaxed);
+  out->non_ext = s_non_ext.load(std::memory_order_relaxed);
+  out->reprograms = s_reprograms.load(std::memory_order_relaxed);
+  out->apply_failures = s_apply_failures.load(std::memory_order_relaxed);
+  out->hw_reject_est_per_s = s_hw_reject_est.load(std::memory_order_relaxed);
+  out->hw_sample_frames = s_hw_sample_frames.load(std::memory_order_relaxed);
+  out->collisions = s_collisions.load(std::memory_order_relaxed);
+  out->pgns = s_stat_pgns.load(std::memory_order_relaxed);
+  out->hw_filters = s_stat_hw_filters.load(std::memory_order_relaxed);
+  out->accept_all = s_stat_accept_all.load(std::memory_order_relaxed);
+}
+
+void n2k_subs_report(void) {
+  n2k_subs_stats_t s;
+  n2k_subs_get_stats(&s);
+  DBG_LOGI("[subs] pgns=%u%s hw_filters=%u frames=%u sw_rejected=%u non_ext=%u reprograms=%u failures=%u "
+           "hw_reject_est=%u/s (sample %u frames) collisions=%u",
+           (unsigned)s.pgns, s.accept_all ? " (all)" : "", (unsigned)s.hw_filters, (unsigned)s.frames,
+           (unsigned)s.sw_rejected, (unsigned)s.non_ext, (unsigned)s.reprograms, (unsigned)s.apply_failures,
+           (unsigned)s.hw_reject_est_per_s, (unsigned)s.hw_sample_frames, (unsigned)s.collisions);
+}
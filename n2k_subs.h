@@ -0,0 +1,83 @@
+#pragma once
+
+#include "can_rx.h"
+#include <stdint.h>
+
+// PGN subscriptions: which NMEA2000 traffic is worth receiving at all.
+//
+// Consumers (the visible page, the SD logger, diagnostics) register the
+// PGNs they need, directly or as signal masks resolved through the decoder
+// table. The union drives two filters:
+//   - hardware: can_rx_set_filters(), one mask filter per PGN (priority,
+//     source and PDU1 destination are don't-care). The TWAI controller has a
+//     single acceptance filter (one 29-bit or two 16-bit), so the set is
+//     widened until it fits and some unsubscribed traffic still arrives;
+//     SocketCAN takes the exact set. Reprogramming TWAI reinstalls the
+//     driver, so changes are debounced by N2K_SUBS_APPLY_DELAY_MS.
+//   - software: n2k_subs_accepts(), a binary search over the exact union in
+//     the bus task before fast-packet reassembly. Always active, so the
+//     result is exact whatever the hardware could express.
+// An empty union, or any owner subscribed to everything, accepts all.
+//
+// Neither controller counts the frames its filter drops. n2k_subs_sample()
+// opens the hardware filter for a short window and counts the frames it
+// would have rejected, giving an estimated hardware reject rate.
+//
+// Setters may be called from any task, but each owner from one task at a
+// time. They never block: every owner publishes into a double-buffered
+// snapshot with a generation counter that n2k_subs_poll() copies seqlock
+// style (see signal_store.h), retrying on the next poll if a writer kept
+// overtaking it. n2k_subs_poll() and n2k_subs_accepts() belong to the bus
+// task.
+
+#ifndef N2K_SUBS_MAX_PGNS
+  #define N2K_SUBS_MAX_PGNS        32     // per owner
+#endif
+#ifndef N2K_SUBS_READ_TRIES
+  #define N2K_SUBS_READ_TRIES      8      // snapshot attempts per owner and poll
+#endif
+#ifndef N2K_SUBS_APPLY_DELAY_MS
+  #define N2K_SUBS_APPLY_DELAY_MS  500    // settle time before reprogramming the controller
+#endif
+
+enum n2k_sub_owner_t : uint8_t {
+  N2K_SUB_LOGGER = 0,
+  N2K_SUB_PAGE,
+  N2K_SUB_DIAG,
+  N2K_SUB_OWNERS
+};
+
+struct n2k_subs_stats_t {
+  uint32_t frames;               // seen by the software filter
+  uint32_t sw_rejected;          // passed the hardware filter, not subscribed
+  uint32_t non_ext;              // 11-bit frames, never NMEA2000
+  uint32_t reprograms;           // hardware filter changes applied
+  uint32_t apply_failures;       // backend cannot filter (replay) or refused
+  uint32_t hw_reject_est_per_s;  // from the last n2k_subs_sample() window
+  uint32_t hw_sample_frames;     // frames seen in that window
+  uint32_t collisions;           // union rebuilds put off by a concurrent setter
+  uint16_t pgns;                 // size of the union (0 = accept all)
+  uint8_t  hw_filters;           // programmed in the controller (0 = open)
+  bool     accept_all;
+};
+
+// Replaces the owner's PGN list. More than N2K_SUBS_MAX_PGNS subscribes the
+// owner to everything.
+void n2k_subs_set(n2k_sub_owner_t owner, const uint32_t* pgns, uint8_t count);
+// Replaces the owner's list with every decoded PGN that can emit one of
+// the signals (1 << signal_id_t).
+void n2k_subs_set_signals(n2k_sub_owner_t owner, uint32_t signal_mask);
+// Subscribes the owner to all traffic (raw capture), or clears that.
+void n2k_subs_set_all(n2k_sub_owner_t owner, bool all);
+
+// Bus task: picks up subscription changes and applies the hardware filter
+// once they have settled.
+void n2k_subs_poll(uint32_t now_ms);
+// Bus task, per received frame: false if no subscriber wants it.
+bool n2k_subs_accepts(const can_frame_t* frame);
+
+// Opens the hardware filter for `window_ms` to estimate what it rejects.
+void n2k_subs_sample(uint32_t window_ms);
+
+void n2k_subs_get_stats(n2k_subs_stats_t* out);
+void n2k_subs_report(void);
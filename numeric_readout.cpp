@@ -0,0 +1,229 @@
+#include "numeric_readout.h"
+#include "raster_util.h"
+#include "platform.h"
+
+#include <string.h>
+
+static const char k_base_glyphs[] = "0123456789-+. ";
+
+struct readout_atlas_t {
+  const lv_font_t* font;
+  lv_color_t       fg;
+  lv_color_t       bg;
+  uint16_t         refs;
+  lv_coord_t       cell_h;
+  char             glyphs[48];
+  int8_t           index[128];   // ASCII -> glyph slot, -1 when absent
+  lv_coord_t       adv[48];
+  lv_img_dsc_t     img[48];      // one opaque image per glyph, into `pixels`
+  lv_color_t*      pixels;
+};
+
+struct readout_t {
+  readout_atlas_t* atlas;
+  char             text[NUMERIC_READOUT_MAX_CHARS + 1];
+  lv_coord_t       x[NUMERIC_READOUT_MAX_CHARS + 1];  // cell start offsets
+};
+
+static readout_atlas_t s_atlases[NUMERIC_READOUT_ATLAS_SLOTS];
+
+// ---- Atlas ----
+
+static void build_glyph_set(const char* extra, char* out, size_t cap) {
+  size_t n = 0;
+  const char* srcs[2] = {k_base_glyphs, extra};
+  for (int s = 0; s < 2; ++s) {
+    for (const char* p = srcs[s]; p && *p; ++p) {
+      if ((uint8_t)*p >= 128 || memchr(out, *p, n)) continue;
+      if (n + 1 >= cap) break;
+      out[n++] = *p;
+    }
+  }
+  out[n] = '\0';
+}
+
+static bool atlas_render(readout_atlas_t* a) {
+  const size_t n = strlen(a->glyphs);
+  a->cell_h = lv_font_get_line_height(a->font);
+
+  size_t total_px = 0;
+  for (size_t i = 0; i < n; ++i) {
+    a->adv[i] = (lv_coord_t)lv_font_get_glyph_width(a->font, (uint8_t)a->glyphs[i], 0);
+    total_px += (size_t)a->adv[i] * a->cell_h;
+  }
+
+  a->pixels = (lv_color_t*)plat_psram_alloc(total_px * sizeof(lv_color_t));
+  if (!a->pixels) return false;
+
+  memset(a->index, -1, sizeof(a->index));
+  lv_color_t* px = a->pixels;
+  for (size_t i = 0; i < n; ++i) {
+    raster_buf_t cell = {px, a->adv[i], a->cell_h};
+    raster_fill(&cell, a->bg);
+    raster_glyph(&cell, 0, 0, a->font, (uint8_t)a->glyphs[i], 0, a->fg);
+
+    lv_img_dsc_t* img = &a->img[i];
+    memset(img, 0, sizeof(*img));
+    img->header.cf = LV_IMG_CF_TRUE_COLOR;
+    img->header.w = a->adv[i];
+    img->header.h = a->cell_h;
+    img->data_size = (uint32_t)a->adv[i] * a->cell_h * sizeof(lv_color_t);
+    img->data = (const uint8_t*)px;
+
+    a->index[(uint8_t)a->glyphs[i]] = (int8_t)i;
+    px += (size_t)a->adv[i] * a->cell_h;
+  }
+  return true;
+}
+
+static readout_atlas_t* atlas_acquire(const lv_font_t* font, lv_color_t fg, lv_color_t bg, const char* extra) {
+  char glyphs[sizeof(((readout_atlas_t*)0)->glyphs)];
+  build_glyph_set(extra, glyphs, sizeof(glyphs));
+
+  readout_atlas_t* free_slot = nullptr;
+  for (int i = 0; i < NUMERIC_READOUT_ATLAS_SLOTS; ++i) {
+    readout_atlas_t* a = &s_atlases[i];
+    if (a->refs && a->font == font && a->fg.full == fg.full && a->bg.full == bg.full &&
+        strcmp(a->glyphs, glyphs) == 0) {
+      a->refs++;
+      return a;
+    }
+    if (!a->refs && !free_slot) free_slot = a;
+  }
+  if (!free_slot) return nullptr;
+
+  readout_atlas_t* a = free_slot;
+  memset(a, 0, sizeof(*a));
+  a->font = font;
+  a->fg = fg;
+  a->bg = bg;
+  memcpy(a->glyphs, glyphs, sizeof(glyphs));
+  if (!atlas_render(a)) return nullptr;
+  a->refs = 1;
+  return a;
+}
+
+static void atlas_release(readout_atlas_t* a) {
+  if (!a || !a->refs || --a->refs) return;
+  for (size_t i = 0; a->glyphs[i]; ++i) lv_img_cache_invalidate_src(&a->img[i]);
+  plat_free(a->pixels);
+  a->pixels = nullptr;
+}
+
+// ---- Widget ----
+
+static void layout_text(const readout_atlas_t* a, const char* txt, lv_coord_t* x) {
+  lv_coord_t pen = 0;
+  size_t i = 0;
+  for (; txt[i]; ++i) {
+    x[i] = pen;
+    const int8_t g = ((uint8_t)txt[i] < 128) ? a->index[(uint8_t)txt[i]] : -1;
+    pen += (g >= 0) ? a->adv[g] : a->adv[a->index[(uint8_t)' ']];
+  }
+  x[i] = pen;
+}
+
+static void invalidate_cells(lv_obj_t* obj, lv_coord_t x_from, lv_coord_t x_to, lv_coord_t h) {
+  if (x_to <= x_from) return;
+  lv_area_t area;
+  lv_obj_get_content_coords(obj, &area);
+  area.x2 = area.x1 + x_to - 1;
+  area.x1 = area.x1 + x_from;
+  area.y2 = area.y1 + h - 1;
+  lv_obj_invalidate_area(obj, &area);
+}
+
+static void readout_event_cb(lv_event_t* e) {
+  lv_obj_t* obj = lv_event_get_target(e);
+  readout_t* r = (readout_t*)lv_event_get_user_data(e);
+  const lv_event_code_t code = lv_event_get_code(e);
+
+  if (code == LV_EVENT_DRAW_MAIN) {
+    lv_draw_ctx_t* draw_ctx = lv_event_get_draw_ctx(e);
+    const readout_atlas_t* a = r->atlas;
+    lv_area_t base;
+    lv_obj_get_content_coords(obj, &base);
+
+    lv_draw_img_dsc_t dsc;
+    lv_draw_img_dsc_init(&dsc);
+    for (size_t i = 0; r->text[i]; ++i) {
+      const int8_t g = ((uint8_t)r->text[i] < 128) ? a->index[(uint8_t)r->text[i]] : -1;
+      if (g < 0) continue;
+      lv_area_t cell;
+      cell.x1 = base.x1 + r->x[i];
+      cell.y1 = base.y1;
+      cell.x2 = cell.x1 + a->adv[g] - 1;
+      cell.y2 = cell.y1 + a->cell_h - 1;
+      lv_area_t clipped;
+      if (!_lv_area_intersect(&clipped, &cell, draw_ctx->clip_area)) continue;
+      lv_draw_img(draw_ctx, &dsc, &cell, &a->img[g]);
+    }
+  } else if (code == LV_EVENT_DELETE) {
+    atlas_release(r->atlas);
+    lv_mem_free(r);
+  }
+}
+
+lv_obj_t* numeric_readout_create(lv_obj_t* parent, const lv_font_t* font,
+                                 lv_color_t fg, lv_color_t bg, const char* extra_glyphs) {
+  readout_atlas_t* atlas = atlas_acquire(font, fg, bg, extra_glyphs);
+  readout_t* r = atlas ? (readout_t*)lv_mem_alloc(sizeof(readout_t)) : nullptr;
+  if (!r) {
+    atlas_release(atlas);
+    lv_obj_t* lbl = lv_label_create(parent);
+    lv_obj_set_style_text_font(lbl, font, 0);
+    lv_obj_set_style_text_color(lbl, fg, 0);
+    return lbl;
+  }
+
+  memset(r, 0, sizeof(*r));
+  r->atlas = atlas;
+
+  lv_obj_t* obj = lv_obj_create(parent);
+  lv_obj_remove_style_all(obj);
+  lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_add_flag(obj, LV_OBJ_FLAG_EVENT_BUBBLE);
+  lv_obj_set_height(obj, atlas->cell_h);
+  lv_obj_add_event_cb(obj, readout_event_cb, LV_EVENT_ALL, r);
+  lv_obj_set_user_data(obj, r);
+  return obj;
+}
+
+void numeric_readout_set_text(lv_obj_t* obj, const char* txt) {
+  readout_t* r = (readout_t*)lv_obj_get_user_data(obj);
+  if (!r) {
+    lv_label_set_text(obj, txt);
+    return;
+  }
+  if (strncmp(r->text, txt, NUMERIC_READOUT_MAX_CHARS) == 0) return;
+
+  char next[NUMERIC_READOUT_MAX_CHARS + 1];
+  lv_coord_t next_x[NUMERIC_READOUT_MAX_CHARS + 1];
+  strncpy(next, txt, NUMERIC_READOUT_MAX_CHARS);
+  next[NUMERIC_READOUT_MAX_CHARS] = '\0';
+  layout_text(r->atlas, next, next_x);
+
+  // Invalidate only cells whose glyph or position changed; a width change
+  // shifts the tail, which then gets invalidated as one span.
+  const size_t old_len = strlen(r->text);
+  const size_t new_len = strlen(next);
+  const size_t n = (old_len > new_len) ? old_len : new_len;
+  const lv_coord_t h = r->atlas->cell_h;
+  for (size_t i = 0; i < n; ++i) {
+    const bool in_old = i < old_len;
+    const bool in_new = i < new_len;
+    if (in_old && in_new && r->text[i] == next[i] && r->x[i] == next_x[i] && r->x[i + 1] == next_x[i + 1]) {
+      continue;
+    }
+    lv_coord_t x0 = in_new ? next_x[i] : r->x[i];
+    lv_coord_t x1 = in_new ? next_x[i + 1] : r->x[i + 1];
+    if (in_old) {
+      if (r->x[i] < x0) x0 = r->x[i];
+      if (r->x[i + 1] > x1) x1 = r->x[i + 1];
+    }
+    invalidate_cells(obj, x0, x1, h);
+  }
+
+  memcpy(r->text, next, sizeof(next));
+  memcpy(r->x, next_x, sizeof(next_x));
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "lvgl.h"
+
+// Numeric readout widget backed by a pre-rasterized glyph atlas.
+//
+// Large values use the compressed 4 bpp Orbitron fonts, so an lv_label redraw
+// decompresses and alpha-blends every glyph again. A readout instead renders
+// digits, sign, decimal point, space and any extra unit glyphs once into an
+// RGB565 atlas at fixed foreground/background colors. Drawing is then one
+// opaque blit per character, and set_text() invalidates only the cells whose
+// glyph or position changed.
+//
+// Limitations: ASCII glyphs only, no kerning (cells advance by adv_w), and the
+// widget must sit on a solid background matching `bg`. Characters missing from
+// the atlas are left blank.
+
+#ifndef NUMERIC_READOUT_MAX_CHARS
+  #define NUMERIC_READOUT_MAX_CHARS 16
+#endif
+
+// Atlases are shared by readouts with the same font, colors and glyph set.
+#ifndef NUMERIC_READOUT_ATLAS_SLOTS
+  #define NUMERIC_READOUT_ATLAS_SLOTS 6
+#endif
+
+// `extra_glyphs` adds unit/label characters (e.g. "kts%") to the atlas.
+// Falls back to a plain label if the atlas cannot be allocated.
+lv_obj_t* numeric_readout_create(lv_obj_t* parent, const lv_font_t* font,
+                                 lv_color_t fg, lv_color_t bg, const char* extra_glyphs);
+
+// Works on readouts and on the label fallback.
+void numeric_readout_set_text(lv_obj_t* obj, const char* txt);
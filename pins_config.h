@@ -10,3 +10,34 @@
 #define TP_I2C_SCL 8
 #define TP_RST 22
 #define TP_INT 21
+
+// TJA1050 CAN transceiver (NMEA2000). Free header pins; adjust to your wiring.
+#ifndef CAN_TX_PIN
+  #define CAN_TX_PIN 5
+#endif
+#ifndef CAN_RX_PIN
+  #define CAN_RX_PIN 4
+#endif
+
+// UART to the ESP32-C6 coprocessor (c6_link.h). The board normally reaches
+// the C6 over SDIO for Wi-Fi; these are free header pins, adjust to your
+// wiring.
+#ifndef C6_LINK_UART_NUM
+  #define C6_LINK_UART_NUM 1
+#endif
+#ifndef C6_LINK_TX_PIN
+  #define C6_LINK_TX_PIN 32
+#endif
+#ifndef C6_LINK_RX_PIN
+  #define C6_LINK_RX_PIN 33
+#endif
+
+// microSD on SDMMC slot 0 (4-bit). These are the P4 IOMUX defaults.
+#ifndef SD_CLK_PIN
+  #define SD_CLK_PIN 43
+  #define SD_CMD_PIN 44
+  #define SD_D0_PIN  39
+  #define SD_D1_PIN  40
+  #define SD_D2_PIN  41
+  #define SD_D3_PIN  42
+#endif
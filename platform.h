@@ -0,0 +1,70 @@
+#pragma once
+
+// Thin platform shim for data-path modules that must build both on the
+// ESP32-P4 (Arduino core) and on a Linux host for load testing.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+typedef void (*plat_task_fn)(void* arg);
+
+#if defined(ARDUINO)
+  #include <Arduino.h>
+  #include "esp_heap_caps.h"
+
+  // Large, long-lived tables go to PSRAM; fall back to any 8-bit heap.
+  static inline void* plat_psram_alloc(size_t bytes) {
+    void* p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return p ? p : heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
+  }
+
+  static inline uint32_t plat_millis() { return millis(); }
+  static inline uint32_t plat_micros() { return micros(); }
+  static inline void     plat_delay_ms(uint32_t ms) { vTaskDelay(pdMS_TO_TICKS(ms)); }
+
+  // Detached worker task; core < 0 lets the scheduler pick. Stack is in bytes.
+  static inline bool plat_task_start(plat_task_fn fn, const char* name, uint32_t stack_bytes,
+                                     int priority, int core, void* arg) {
+    return xTaskCreatePinnedToCore(fn, name, stack_bytes, arg, priority, nullptr,
+                                   core < 0 ? tskNO_AFFINITY : core) == pdPASS;
+  }
+  // FreeRTOS tasks must not return; call this at the end of a task function.
+  static inline void plat_task_exit() { vTaskDelete(nullptr); }
+#else
+  #include <chrono>
+  #include <thread>
+
+  static inline void* plat_psram_alloc(size_t bytes) { return malloc(bytes); }
+
+  static inline uint32_t plat_micros() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+  static inline uint32_t plat_millis() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+  static inline void plat_delay_ms(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  }
+
+  // Host threads ignore name/stack/priority/core.
+  static inline bool plat_task_start(plat_task_fn fn, const char*, uint32_t, int, int, void* arg) {
+    std::thread(fn, arg).detach();
+    return true;
+  }
+  static inline void plat_task_exit() {}
+#endif
+
+static inline void plat_free(void* p) { free(p); }
+
+// Wall clock in ms since the Unix epoch, or 0 while the clock is unset
+// (no RTC/NTP/GNSS time yet).
+static inline int64_t plat_utc_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  if (tv.tv_sec < 1600000000) return 0;
+  return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
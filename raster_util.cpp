@@ -0,0 +1,83 @@
+#include "raster_util.h"
+#include <math.h>
+
+static inline void blend_px(raster_buf_t* b, lv_coord_t x, lv_coord_t y, lv_color_t c, lv_opa_t opa) {
+  if (x < 0 || y < 0 || x >= b->w || y >= b->h || opa == 0) return;
+  lv_color_t* dst = &b->px[(int32_t)y * b->w + x];
+  *dst = (opa >= LV_OPA_COVER) ? c : lv_color_mix(c, *dst, opa);
+}
+
+void raster_fill(raster_buf_t* b, lv_color_t color) {
+  const int32_t n = (int32_t)b->w * b->h;
+  for (int32_t i = 0; i < n; ++i) b->px[i] = color;
+}
+
+void raster_round_rect(raster_buf_t* b, const lv_area_t* a, lv_coord_t radius,
+                       lv_color_t color, lv_opa_t opa) {
+  const lv_coord_t w = a->x2 - a->x1 + 1;
+  const lv_coord_t h = a->y2 - a->y1 + 1;
+  if (w <= 0 || h <= 0) return;
+  if (radius > w / 2) radius = w / 2;
+  if (radius > h / 2) radius = h / 2;
+
+  const float r = (float)radius;
+  for (lv_coord_t y = 0; y < h; ++y) {
+    for (lv_coord_t x = 0; x < w; ++x) {
+      // Distance into the nearest corner circle, 0 when outside the corners.
+      float cx = 0.0f, cy = 0.0f;
+      if (x < radius)          cx = r - ((float)x + 0.5f);
+      else if (x >= w - radius) cx = ((float)x + 0.5f) - (float)(w - radius);
+      if (y < radius)          cy = r - ((float)y + 0.5f);
+      else if (y >= h - radius) cy = ((float)y + 0.5f) - (float)(h - radius);
+
+      uint32_t cov = 255;
+      if (cx > 0.0f && cy > 0.0f) {
+        const float d = sqrtf(cx * cx + cy * cy);
+        const float f = r - d + 0.5f;
+        if (f <= 0.0f) continue;
+        if (f < 1.0f) cov = (uint32_t)(f * 255.0f);
+      }
+      blend_px(b, a->x1 + x, a->y1 + y, color, (lv_opa_t)((cov * opa) / 255));
+    }
+  }
+}
+
+lv_coord_t raster_glyph(raster_buf_t* b, lv_coord_t x, lv_coord_t line_top,
+                        const lv_font_t* font, uint32_t letter, uint32_t next, lv_color_t color) {
+  lv_font_glyph_dsc_t g;
+  if (!lv_font_get_glyph_dsc(font, &g, letter, next)) return 0;
+
+  const lv_font_t* f = g.resolved_font ? g.resolved_font : font;
+  const uint8_t* bmp = (g.box_w && g.box_h) ? lv_font_get_glyph_bitmap(f, letter) : nullptr;
+  if (!bmp) return (lv_coord_t)g.adv_w;
+
+  // Same placement rule as lv_draw_letter().
+  const lv_coord_t gx = x + g.ofs_x;
+  const lv_coord_t gy = line_top + (font->line_height - font->base_line) - g.box_h - g.ofs_y;
+  const uint8_t bpp = g.bpp ? g.bpp : 4;
+  const uint32_t mask = (1u << bpp) - 1u;
+
+  // Glyph bitmaps are one continuous MSB-first bit stream (no row padding).
+  uint32_t bit = 0;
+  for (lv_coord_t yy = 0; yy < g.box_h; ++yy) {
+    for (lv_coord_t xx = 0; xx < g.box_w; ++xx, bit += bpp) {
+      const uint32_t v = (bmp[bit >> 3] >> (8 - bpp - (bit & 7))) & mask;
+      if (v) blend_px(b, gx + xx, gy + yy, color, (lv_opa_t)((v * 255u) / mask));
+    }
+  }
+  return (lv_coord_t)g.adv_w;
+}
+
+lv_coord_t raster_text(raster_buf_t* b, lv_coord_t x, lv_coord_t line_top,
+                       const lv_font_t* font, const char* txt, lv_color_t color) {
+  if (!txt) return x;
+  uint32_t i = 0;
+  uint32_t letter = _lv_txt_encoded_next(txt, &i);
+  while (letter) {
+    const uint32_t next = _lv_txt_encoded_next(txt, &i);
+    x += raster_glyph(b, x, line_top, font, letter, next, color);
+    if (x >= b->w) break;
+    letter = next;
+  }
+  return x;
+}
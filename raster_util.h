@@ -0,0 +1,26 @@
+#pragma once
+#include "lvgl.h"
+
+// Minimal software rasterizer for prebuilt RGB565 images (card chrome, glyph
+// atlases). Runs outside LVGL's draw pipeline, so it is safe to call from
+// event callbacks and during layout.
+
+struct raster_buf_t {
+  lv_color_t* px;
+  lv_coord_t  w;
+  lv_coord_t  h;
+};
+
+void raster_fill(raster_buf_t* b, lv_color_t color);
+
+// Anti-aliased rounded rectangle blended at `opa` over the existing pixels.
+void raster_round_rect(raster_buf_t* b, const lv_area_t* area, lv_coord_t radius,
+                       lv_color_t color, lv_opa_t opa);
+
+// Blend one glyph with its pen at (x, line_top). Returns the advance width.
+lv_coord_t raster_glyph(raster_buf_t* b, lv_coord_t x, lv_coord_t line_top,
+                        const lv_font_t* font, uint32_t letter, uint32_t next, lv_color_t color);
+
+// Blend a UTF-8 string on one line, clipped to the buffer. Returns the pen x.
+lv_coord_t raster_text(raster_buf_t* b, lv_coord_t x, lv_coord_t line_top,
+                       const lv_font_t* font, const char* txt, lv_color_t color);
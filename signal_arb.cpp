@@ -0,0 +1,185 @@
+#include "signal_arb.h"
+#include "spsc_ring.h"
+#include "logging_policy.h"
+
+#include <atomic>
+
+static_assert(SIG_ARB_PRIO_LEN == 4, "priority lists are packed into one 32-bit word");
+
+struct arb_source_t {
+  uint32_t last_ms;
+  uint16_t interval_ms;   // EWMA of the update gap, 0 until learned
+  uint8_t  src;
+  uint8_t  streak;        // consecutive on-time updates, saturating
+};
+
+struct arb_signal_t {
+  arb_source_t srcs[SIG_ARB_MAX_SOURCES];
+  uint8_t      count;
+  uint8_t      sel;       // index into srcs, SIG_ARB_NO_SOURCE if none
+};
+
+// Bus task only.
+static arb_signal_t s_sig[SIG_COUNT];
+static bool         s_init = false;
+
+// Shared.
+// Source addresses are stored +1 so that zero-initialised means empty.
+static std::atomic<uint32_t> s_prio[SIG_COUNT];       // byte i = rank i
+static std::atomic<uint8_t>  s_selected[SIG_COUNT];
+static std::atomic<uint8_t>  s_source_count[SIG_COUNT];
+static std::atomic<uint32_t> s_values{0};
+static std::atomic<uint32_t> s_rejected{0};
+static std::atomic<uint32_t> s_switches{0};
+static spsc_ring<signal_arb_event_t, SIG_ARB_EVENT_RING> s_events;
+
+static inline void bump(std::atomic<uint32_t>& c) {
+  c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+static void init_once(void) {
+  if (s_init) return;
+  for (auto& a : s_sig) a.sel = SIG_ARB_NO_SOURCE;
+  s_init = true;
+}
+
+static uint32_t timeout_ms(const arb_source_t* s) {
+  if (!s->interval_ms) return SIG_ARB_MAX_TIMEOUT_MS;
+  const uint32_t t = (uint32_t)s->interval_ms * SIG_ARB_TIMEOUT_FACTOR;
+  return t < SIG_ARB_MIN_TIMEOUT_MS ? SIG_ARB_MIN_TIMEOUT_MS : (t > SIG_ARB_MAX_TIMEOUT_MS ? SIG_ARB_MAX_TIMEOUT_MS : t);
+}
+
+static bool fresh(const arb_source_t* s, uint32_t now_ms) {
+  return now_ms - s->last_ms <= timeout_ms(s);
+}
+
+static uint8_t rank(uint32_t prio, uint8_t src) {
+  for (uint8_t i = 0; i < SIG_ARB_PRIO_LEN; ++i) {
+    if ((uint8_t)(prio >> (8 * i)) == (uint8_t)(src + 1)) return i;
+  }
+  return SIG_ARB_PRIO_LEN;
+}
+
+static void switch_to(signal_id_t sig, arb_signal_t* a, uint8_t idx, uint8_t reason, uint32_t now_ms) {
+  const uint8_t from = a->sel == SIG_ARB_NO_SOURCE ? SIG_ARB_NO_SOURCE : a->srcs[a->sel].src;
+  a->sel = idx;
+  s_selected[sig].store((uint8_t)(a->srcs[idx].src + 1), std::memory_order_relaxed);
+  if (reason != SIG_ARB_ACQUIRED) bump(s_switches);
+  const signal_arb_event_t ev = {now_ms, (uint8_t)sig, from, a->srcs[idx].src, reason};
+  s_events.push(ev);
+  if (reason != SIG_ARB_ACQUIRED) {
+    DBG_LOGI("[arb] %s: source %u -> %u (%s)", k_signal_meta[sig].key, (unsigned)from, (unsigned)ev.to_src,
+             reason == SIG_ARB_FAILOVER ? "failover" : "preferred");
+  }
+}
+
+// Slot for `src`, taking a free one or the stalest non-selected one.
+static uint8_t source_slot(signal_id_t sig, arb_signal_t* a, uint8_t src, uint32_t now_ms) {
+  for (uint8_t i = 0; i < a->count; ++i) {
+    if (a->srcs[i].src == src) return i;
+  }
+  uint8_t idx = a->count;
+  if (a->count < SIG_ARB_MAX_SOURCES) {
+    a->count++;
+    s_source_count[sig].store(a->count, std::memory_order_relaxed);
+  } else {
+    uint32_t oldest = 0;
+    for (uint8_t i = 0; i < a->count; ++i) {
+      if (i != a->sel && now_ms - a->srcs[i].last_ms >= oldest) {
+        oldest = now_ms - a->srcs[i].last_ms;
+        idx = i;
+      }
+    }
+  }
+  a->srcs[idx] = {now_ms, 0, src, 0};
+  return idx;
+}
+
+bool signal_arb_accept(signal_id_t sig, uint8_t src, uint32_t now_ms) {
+  if (sig >= SIG_COUNT) return false;
+  init_once();
+  bump(s_values);
+  arb_signal_t* a = &s_sig[sig];
+  const uint8_t idx = source_slot(sig, a, src, now_ms);
+  arb_source_t* s = &a->srcs[idx];
+
+  // Health: an on-time gap extends the streak, a late one restarts it. The
+  // interval follows every gap so a source that slows down is relearned.
+  // The first update after a (re)allocation only stamps last_ms.
+  if (s->streak == 0) {
+    s->streak = 1;
+  } else {
+    uint32_t gap = now_ms - s->last_ms;
+    if (gap <= timeout_ms(s)) {
+      if (s->streak < 255) s->streak++;
+    } else {
+      s->streak = 1;
+    }
+    if (gap > SIG_ARB_MAX_TIMEOUT_MS) gap = SIG_ARB_MAX_TIMEOUT_MS;
+    s->interval_ms = s->interval_ms ? (uint16_t)((3u * s->interval_ms + gap) / 4) : (uint16_t)(gap ? gap : 1);
+  }
+  s->last_ms = now_ms;
+
+  if (a->sel == SIG_ARB_NO_SOURCE) {
+    switch_to(sig, a, idx, SIG_ARB_ACQUIRED, now_ms);
+    return true;
+  }
+  if (a->sel == idx) return true;
+
+  const arb_source_t* cur = &a->srcs[a->sel];
+  const uint32_t prio = s_prio[sig].load(std::memory_order_relaxed);
+  if (!fresh(cur, now_ms)) {
+    // Best fresh candidate: healthy first, then priority rank.
+    uint8_t best = idx;
+    for (uint8_t i = 0; i < a->count; ++i) {
+      const arb_source_t* c = &a->srcs[i];
+      if (i == a->sel || !fresh(c, now_ms)) continue;
+      const arb_source_t* b = &a->srcs[best];
+      const bool ch = c->streak >= SIG_ARB_HEALTHY_UPDATES, bh = b->streak >= SIG_ARB_HEALTHY_UPDATES;
+      if (ch != bh ? ch : rank(prio, c->src) < rank(prio, b->src)) best = i;
+    }
+    switch_to(sig, a, best, SIG_ARB_FAILOVER, now_ms);
+  } else if (s->streak >= SIG_ARB_HEALTHY_UPDATES && rank(prio, src) < rank(prio, cur->src)) {
+    switch_to(sig, a, idx, SIG_ARB_PREFERRED, now_ms);
+  }
+  if (a->sel == idx) return true;
+  bump(s_rejected);
+  return false;
+}
+
+void signal_arb_set_priority(signal_id_t sig, const uint8_t* srcs, uint8_t count) {
+  if (sig >= SIG_COUNT) return;
+  uint32_t packed = 0;
+  for (uint8_t i = 0; i < count && i < SIG_ARB_PRIO_LEN; ++i) packed |= (uint32_t)(uint8_t)(srcs[i] + 1) << (8 * i);
+  s_prio[sig].store(packed, std::memory_order_relaxed);
+}
+
+uint8_t signal_arb_selected(signal_id_t sig) {
+  if (sig >= SIG_COUNT) return SIG_ARB_NO_SOURCE;
+  return (uint8_t)(s_selected[sig].load(std::memory_order_relaxed) - 1);
+}
+
+bool signal_arb_pop_event(signal_arb_event_t* out) {
+  return s_events.pop(out);
+}
+
+void signal_arb_get_stats(signal_arb_stats_t* out) {
+  out->values = s_values.load(std::memory_order_relaxed);
+  out->rejected = s_rejected.load(std::memory_order_relaxed);
+  out->switches = s_switches.load(std::memory_order_relaxed);
+  out->events_dropped = s_events.overruns();
+  for (int i = 0; i < SIG_COUNT; ++i) out->sources[i] = s_source_count[i].load(std::memory_order_relaxed);
+}
+
+void signal_arb_report(void) {
+  signal_arb_stats_t st;
+  signal_arb_get_stats(&st);
+  DBG_LOGI("[arb] values=%u rejected=%u switches=%u events_dropped=%u", (unsigned)st.values,
+           (unsigned)st.rejected, (unsigned)st.switches, (unsigned)st.events_dropped);
+  for (int i = 0; i < SIG_COUNT; ++i) {
+    if (st.sources[i] > 1) {
+      DBG_LOGI("[arb]   %-16s %u sources, selected %u", k_signal_meta[i].key, (unsigned)st.sources[i],
+               (unsigned)signal_arb_selected((signal_id_t)i));
+    }
+  }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "signals.h"
+#include <stdint.h>
+
+// Source arbitration for signals sent by more than one device (two GPS
+// units, an engine gateway and a tach sender). Without it the last writer
+// wins and the value flickers between sources.
+//
+// The bus task asks signal_arb_accept() for every decoded value; only the
+// selected source's values are published. Per signal it tracks up to
+// SIG_ARB_MAX_SOURCES NMEA2000 source addresses with their learned update
+// interval and a health streak (consecutive updates that arrived within the
+// source's timeout, SIG_ARB_TIMEOUT_FACTOR x its interval). Selection:
+//   - the first source seen is selected;
+//   - when the selected source has gone quiet past its timeout, the next
+//     value from another source fails over to the best fresh candidate;
+//   - a source ranked higher in the signal's priority list takes over on
+//     its SIG_ARB_HEALTHY_UPDATES-th update in a row with no late gap (with
+//     the default 3: the first update back, then two on time), so an
+//     intermittent preferred device does not flap. Unlisted sources never
+//     preempt.
+// Every decision touches a fixed number of slots, so the cost per value is
+// constant.
+//
+// Source addresses come from address claiming and can change when the
+// network is rewired; priority lists name addresses, not device NAMEs.
+
+#ifndef SIG_ARB_MAX_SOURCES
+  #define SIG_ARB_MAX_SOURCES      4
+#endif
+#ifndef SIG_ARB_TIMEOUT_FACTOR
+  #define SIG_ARB_TIMEOUT_FACTOR   3      // missed intervals before a source counts as stale
+#endif
+#ifndef SIG_ARB_MIN_TIMEOUT_MS
+  #define SIG_ARB_MIN_TIMEOUT_MS   300
+#endif
+#ifndef SIG_ARB_MAX_TIMEOUT_MS
+  #define SIG_ARB_MAX_TIMEOUT_MS   5000   // also used until an interval is learned
+#endif
+#ifndef SIG_ARB_HEALTHY_UPDATES
+  #define SIG_ARB_HEALTHY_UPDATES  3
+#endif
+#ifndef SIG_ARB_EVENT_RING
+  #define SIG_ARB_EVENT_RING       32     // power of two
+#endif
+
+#define SIG_ARB_NO_SOURCE 0xFF
+#define SIG_ARB_PRIO_LEN  4               // priority list entries per signal
+
+enum signal_arb_reason_t : uint8_t {
+  SIG_ARB_ACQUIRED = 0,   // first source for the signal
+  SIG_ARB_FAILOVER,       // selected source went stale
+  SIG_ARB_PREFERRED,      // higher-priority source healthy again
+};
+
+struct signal_arb_event_t {
+  uint32_t t_ms;
+  uint8_t  sig;           // signal_id_t
+  uint8_t  from_src;      // SIG_ARB_NO_SOURCE for SIG_ARB_ACQUIRED
+  uint8_t  to_src;
+  uint8_t  reason;        // signal_arb_reason_t
+};
+
+struct signal_arb_stats_t {
+  uint32_t values;        // offered by the decoder
+  uint32_t rejected;      // from a non-selected source
+  uint32_t switches;      // failovers + preferred takeovers
+  uint32_t events_dropped;
+  uint8_t  sources[SIG_COUNT];   // distinct sources seen per signal
+};
+
+// Priority list for one signal, best first (up to SIG_ARB_PRIO_LEN source
+// addresses). count 0 clears it. Any task.
+void signal_arb_set_priority(signal_id_t sig, const uint8_t* srcs, uint8_t count);
+
+// Bus task, once per decoded value: true if it comes from the selected
+// source and should be published.
+bool signal_arb_accept(signal_id_t sig, uint8_t src, uint32_t now_ms);
+
+// Selected source address, SIG_ARB_NO_SOURCE before the first value. Any task.
+uint8_t signal_arb_selected(signal_id_t sig);
+
+// Selection changes, oldest first; one consumer. Full ring drops new events.
+bool signal_arb_pop_event(signal_arb_event_t* out);
+
+void signal_arb_get_stats(signal_arb_stats_t* out);
+void signal_arb_report(void);
@@ -0,0 +1,259 @@
+#include "signal_history.h"
+#include "platform.h"
+#include "logging_policy.h"
+
+#include <atomic>
+#include <math.h>
+#include <string.h>
+
+static constexpr uint32_t CP = HISTORY_CHECKPOINT_EVERY;
+static constexpr uint16_t MAX_DELTA_MS = 0xFFFF;
+static constexpr int32_t  NO_DATA_16 = INT16_MIN;
+static constexpr int32_t  NO_DATA_32 = INT32_MIN;
+
+struct history_ring_t {
+  void*                 values;       // int16_t[] or int32_t[] by `bits`
+  uint16_t*             deltas;       // ms since the previous sample
+  uint32_t*             checkpoints;  // absolute t_ms of every CP-th sample
+  uint32_t              capacity;     // multiple of CP
+  uint32_t              n_checkpoints;
+  std::atomic<uint32_t> head{0};      // samples ever appended
+  uint32_t              last_t_ms;    // writer only
+  float                 scale;
+  uint16_t              period_ms;
+  uint8_t               bits;
+};
+
+static history_ring_t s_rings[SIG_COUNT];
+
+// Rings are read while the bus task appends; element access goes through
+// relaxed atomics and head (release/acquire) publishes new samples.
+template <typename T> static inline T ld(const T* p) { return __atomic_load_n(p, __ATOMIC_RELAXED); }
+template <typename T> static inline void st(T* p, T v) { __atomic_store_n(p, v, __ATOMIC_RELAXED); }
+
+static inline bool time_before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+static inline int32_t raw_at(const history_ring_t* r, uint32_t g) {
+  const uint32_t pos = g % r->capacity;
+  return (r->bits == 16) ? (int32_t)ld(&((const int16_t*)r->values)[pos])
+                         : ld(&((const int32_t*)r->values)[pos]);
+}
+
+static inline bool is_no_data(const history_ring_t* r, int32_t raw) {
+  return raw == ((r->bits == 16) ? NO_DATA_16 : NO_DATA_32);
+}
+
+// Oldest readable sample: the writer may be storing sample `head` into the
+// slot of `head - capacity`, and a block is only walkable from its checkpoint
+// while all of its deltas survive, so reads start at the next whole block.
+static inline uint32_t oldest_index(const history_ring_t* r, uint32_t head) {
+  if (head < r->capacity) return 0;
+  const uint32_t first = head - r->capacity + 1;
+  return ((first + CP - 1) / CP) * CP;
+}
+
+static void append(history_ring_t* r, int32_t raw, uint32_t t_ms) {
+  const uint32_t g = r->head.load(std::memory_order_relaxed);
+  const uint32_t pos = g % r->capacity;
+  if (g % CP == 0) st(&r->checkpoints[(g / CP) % r->n_checkpoints], t_ms);
+  st(&r->deltas[pos], (uint16_t)(g ? t_ms - r->last_t_ms : 0));
+  if (r->bits == 16) st(&((int16_t*)r->values)[pos], (int16_t)raw);
+  else st(&((int32_t*)r->values)[pos], raw);
+  r->last_t_ms = t_ms;
+  r->head.store(g + 1, std::memory_order_release);
+}
+
+bool signal_history_init(void) {
+  bool all = true;
+  for (uint8_t id = 0; id < SIG_COUNT; ++id) {
+    const signal_meta_t* m = &k_signal_meta[id];
+    history_ring_t* r = &s_rings[id];
+    if (r->values || !m->hist_span_s || !m->hist_period_ms) continue;
+
+    uint32_t cap = (uint32_t)(((uint64_t)m->hist_span_s * 1000u) / m->hist_period_ms);
+    cap = ((cap + CP - 1) / CP) * CP;
+    const uint32_t ncp = cap / CP + 1;   // one spare slot for the block being written
+    const size_t vbytes = (size_t)cap * (m->fixed_bits == 16 ? 2 : 4);
+
+    r->values = plat_psram_alloc(vbytes);
+    r->deltas = (uint16_t*)plat_psram_alloc((size_t)cap * sizeof(uint16_t));
+    r->checkpoints = (uint32_t*)plat_psram_alloc((size_t)ncp * sizeof(uint32_t));
+    if (!r->values || !r->deltas || !r->checkpoints) {
+      plat_free(r->values);
+      plat_free(r->deltas);
+      plat_free(r->checkpoints);
+      r->values = nullptr;
+      r->deltas = nullptr;
+      r->checkpoints = nullptr;
+      DBG_LOGW("[hist] %s: ring alloc failed (%u samples)", m->key, (unsigned)cap);
+      all = false;
+      continue;
+    }
+    r->capacity = cap;
+    r->n_checkpoints = ncp;
+    r->scale = m->fixed_scale;
+    r->period_ms = m->hist_period_ms;
+    r->bits = m->fixed_bits;
+    r->head.store(0, std::memory_order_relaxed);
+  }
+  return all;
+}
+
+void signal_history_record(signal_id_t id, float value, uint32_t t_ms) {
+  if (id >= SIG_COUNT) return;
+  history_ring_t* r = &s_rings[id];
+  if (!r->values) return;
+
+  const uint32_t head = r->head.load(std::memory_order_relaxed);
+  if (head && (uint32_t)(t_ms - r->last_t_ms) < r->period_ms) return;
+
+  // Bridge long gaps so every delta fits 16 bits; the chart sees "no data".
+  if (head) {
+    const int32_t no_data = (r->bits == 16) ? NO_DATA_16 : NO_DATA_32;
+    uint32_t fill = 0;
+    while ((uint32_t)(t_ms - r->last_t_ms) > MAX_DELTA_MS && fill++ < r->capacity) {
+      append(r, no_data, r->last_t_ms + MAX_DELTA_MS);
+    }
+    if ((uint32_t)(t_ms - r->last_t_ms) > MAX_DELTA_MS) r->last_t_ms = t_ms - MAX_DELTA_MS;
+  }
+
+  const float lim = (r->bits == 16) ? 32767.0f : 2147483520.0f;
+  float f = roundf(value * r->scale);
+  if (!(f > -lim)) f = -lim;   // also maps NaN away from the no-data marker
+  if (f > lim) f = lim;
+  append(r, (int32_t)f, t_ms);
+}
+
+uint32_t signal_history_count(signal_id_t id) {
+  if (id >= SIG_COUNT || !s_rings[id].values) return 0;
+  const history_ring_t* r = &s_rings[id];
+  const uint32_t head = r->head.load(std::memory_order_acquire);
+  return head - oldest_index(r, head);
+}
+
+static bool seek(const history_ring_t* r, uint32_t t_from_ms, signal_history_iter_t* it) {
+  const uint32_t head = r->head.load(std::memory_order_acquire);
+  const uint32_t oldest = oldest_index(r, head);
+  if (oldest >= head) return false;
+
+  // Last block whose checkpoint is not after t_from, then walk its deltas.
+  uint32_t lo = oldest / CP;
+  uint32_t hi = (head - 1) / CP;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo + 1) / 2;
+    if (time_before(t_from_ms, ld(&r->checkpoints[mid % r->n_checkpoints]))) hi = mid - 1;
+    else lo = mid;
+  }
+
+  const uint32_t start = lo * CP;
+  uint32_t g = start;
+  uint32_t t = ld(&r->checkpoints[lo % r->n_checkpoints]);
+  while (g + 1 < head && time_before(t, t_from_ms)) {
+    ++g;
+    t += ld(&r->deltas[g % r->capacity]);
+  }
+  // Lapped while walking: the caller retries from the new oldest block.
+  if (r->head.load(std::memory_order_acquire) >= start + r->capacity) return false;
+
+  it->g = g;
+  it->t_ms = t;
+  it->t_ready = 1;
+  return true;
+}
+
+bool signal_history_range(signal_id_t id, uint32_t t_from_ms, uint32_t t_to_ms, signal_history_iter_t* it) {
+  if (id >= SIG_COUNT || !s_rings[id].values) return false;
+  it->id = id;
+  it->t_to_ms = t_to_ms;
+  for (int attempt = 0; attempt < 3; ++attempt) {
+    if (seek(&s_rings[id], t_from_ms, it)) return true;
+  }
+  return false;
+}
+
+bool signal_history_next(signal_history_iter_t* it, uint32_t* t_ms, float* value) {
+  const history_ring_t* r = &s_rings[it->id];
+  for (;;) {
+    const uint32_t g = it->g;
+    if (g >= r->head.load(std::memory_order_acquire)) return false;
+    if (!it->t_ready) {
+      it->t_ms += ld(&r->deltas[g % r->capacity]);
+      it->t_ready = 1;
+    }
+    if (time_before(it->t_to_ms, it->t_ms)) return false;
+    const int32_t raw = raw_at(r, g);
+
+    // Sample g was valid only if the writer has not started reusing its
+    // slot; otherwise resume at the oldest block.
+    if (r->head.load(std::memory_order_acquire) >= g + r->capacity) {
+      if (!seek(r, it->t_ms, it)) return false;
+      continue;
+    }
+
+    it->g = g + 1;
+    it->t_ready = 0;
+    if (is_no_data(r, raw)) continue;
+    *t_ms = it->t_ms;
+    *value = (float)raw / r->scale;
+    return true;
+  }
+}
+
+uint16_t signal_history_decimate(signal_id_t id, uint32_t t_from_ms, uint32_t t_to_ms,
+                                 history_bucket_t* out, uint16_t columns) {
+  if (!columns) return 0;
+  for (uint16_t i = 0; i < columns; ++i) {
+    out[i].min = out[i].max = out[i].last = 0.0f;
+    out[i].count = 0;
+  }
+  const uint32_t span = t_to_ms - t_from_ms;
+  signal_history_iter_t it;
+  if (!span || !signal_history_range(id, t_from_ms, t_to_ms - 1, &it)) return 0;
+
+  uint16_t filled = 0;
+  uint32_t t;
+  float v;
+  while (signal_history_next(&it, &t, &v)) {
+    const uint32_t off = t - t_from_ms;
+    if (off >= span) continue;
+    history_bucket_t* b = &out[(uint32_t)(((uint64_t)off * columns) / span)];
+    if (!b->count++) {
+      b->min = b->max = v;
+      filled++;
+    } else {
+      if (v < b->min) b->min = v;
+      if (v > b->max) b->max = v;
+    }
+    b->last = v;
+  }
+  return filled;
+}
+
+bool signal_history_footprint(signal_id_t id, signal_history_footprint_t* out) {
+  if (id >= SIG_COUNT || !s_rings[id].values) return false;
+  const history_ring_t* r = &s_rings[id];
+  out->capacity = r->capacity;
+  out->bytes_per_sample = (uint16_t)((r->bits / 8) + sizeof(uint16_t));
+  out->bytes = r->capacity * out->bytes_per_sample + r->n_checkpoints * (uint32_t)sizeof(uint32_t);
+  out->span_s = (uint32_t)(((uint64_t)r->capacity * r->period_ms) / 1000u);
+  return true;
+}
+
+size_t signal_history_total_bytes(void) {
+  size_t total = 0;
+  signal_history_footprint_t f;
+  for (uint8_t id = 0; id < SIG_COUNT; ++id) {
+    if (signal_history_footprint((signal_id_t)id, &f)) total += f.bytes;
+  }
+  return total;
+}
+
+void signal_history_report(void) {
+  signal_history_footprint_t f;
+  for (uint8_t id = 0; id < SIG_COUNT; ++id) {
+    if (!signal_history_footprint((signal_id_t)id, &f)) continue;
+    DBG_LOGI("[hist] %-15s %6u samples x %u B, %5u s span, %7u B", k_signal_meta[id].key,
+             (unsigned)f.capacity, (unsigned)f.bytes_per_sample, (unsigned)f.span_s, (unsigned)f.bytes);
+  }
+  DBG_LOGI("[hist] total %u bytes", (unsigned)signal_history_total_bytes());
+}
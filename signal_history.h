@@ -0,0 +1,67 @@
+#pragma once
+
+#include "signals.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-signal in-RAM history for graph pages (no SD access).
+//
+// Each signal listed in k_signal_meta gets a PSRAM ring sized
+// hist_span_s * 1000 / hist_period_ms samples. A sample is a 16- or 32-bit
+// fixed-point value plus a 16-bit millisecond delta to the previous sample;
+// every HISTORY_CHECKPOINT_EVERY-th sample also records its absolute time,
+// so a range lookup bisects checkpoints and then walks at most one block of
+// deltas. Gaps longer than 65 s are bridged with "no data" samples.
+//
+// The bus task is the only writer; readers (UI, chart queries) detect
+// overwritten samples and skip forward to the oldest valid one.
+
+#ifndef HISTORY_CHECKPOINT_EVERY
+  #define HISTORY_CHECKPOINT_EVERY 256
+#endif
+
+struct signal_history_iter_t {
+  uint8_t  id;
+  uint8_t  t_ready;    // t_ms is the time of sample g (else of g - 1)
+  uint32_t g;          // global sample index of the next sample
+  uint32_t t_ms;
+  uint32_t t_to_ms;
+};
+
+// Min/max envelope of one chart column.
+struct history_bucket_t {
+  float    min;
+  float    max;
+  float    last;
+  uint16_t count;   // 0 = no data in this column
+};
+
+struct signal_history_footprint_t {
+  uint32_t capacity;           // samples
+  uint16_t bytes_per_sample;   // value + delta
+  uint32_t bytes;              // incl. checkpoints
+  uint32_t span_s;
+};
+
+// Allocates every ring from PSRAM. Signals whose ring cannot be allocated
+// simply keep no history.
+bool signal_history_init(void);
+
+// Writer side (bus task). Keeps at most one sample per hist_period_ms.
+void signal_history_record(signal_id_t id, float value, uint32_t t_ms);
+
+uint32_t signal_history_count(signal_id_t id);
+
+// Positions `it` at the first sample with t >= t_from_ms (or the oldest
+// retained one). Times compare wrap-safe relative to t_to_ms.
+bool signal_history_range(signal_id_t id, uint32_t t_from_ms, uint32_t t_to_ms, signal_history_iter_t* it);
+bool signal_history_next(signal_history_iter_t* it, uint32_t* t_ms, float* value);
+
+// Chart decimator: min/max/last per column over [t_from_ms, t_to_ms).
+// Returns the number of columns that received data.
+uint16_t signal_history_decimate(signal_id_t id, uint32_t t_from_ms, uint32_t t_to_ms,
+                                 history_bucket_t* out, uint16_t columns);
+
+bool   signal_history_footprint(signal_id_t id, signal_history_footprint_t* out);
+size_t signal_history_total_bytes(void);
+void   signal_history_report(void);
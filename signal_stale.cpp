@@ -0,0 +1,69 @@
+#include "signal_stale.h"
+#include "signal_store.h"
+#include "spsc_ring.h"
+#include "timer_wheel.h"
+#include "platform.h"
+
+#include <atomic>
+
+// Bus task only.
+static timer_wheel<SIG_COUNT> s_wheel;
+static bool                   s_init = false;
+
+static std::atomic<uint32_t> s_mask{0};
+static std::atomic<uint32_t> s_stale{0};
+static std::atomic<uint32_t> s_recovered{0};
+static std::atomic<uint32_t> s_tick_max_us{0};
+static spsc_ring<signal_stale_event_t, SIGNAL_STALE_EVENT_RING> s_events;
+
+static inline void bump(std::atomic<uint32_t>& c) {
+  c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+static void init_once(uint32_t now_ms) {
+  if (s_init) return;
+  s_wheel.init(now_ms, SIGNAL_STALE_TICK_MS);
+  s_init = true;
+}
+
+void signal_stale_update(signal_id_t sig, uint32_t now_ms) {
+  if (sig >= SIG_COUNT) return;
+  init_once(now_ms);
+  s_wheel.arm(sig, now_ms + k_signal_meta[sig].stale_ms);
+  const uint32_t bit = 1u << sig;
+  const uint32_t mask = s_mask.load(std::memory_order_relaxed);
+  if (!(mask & bit)) return;
+  s_mask.store(mask & ~bit, std::memory_order_relaxed);
+  bump(s_recovered);
+  s_events.push({now_ms, (uint8_t)sig, false});
+}
+
+void signal_stale_tick(uint32_t now_ms) {
+  if (!s_init) return;
+  const uint32_t t0 = plat_micros();
+  const uint32_t fired = s_wheel.advance(now_ms, [now_ms](uint16_t sig) {
+    signal_store_set_quality((signal_id_t)sig, SIG_QUALITY_STALE);
+    s_mask.store(s_mask.load(std::memory_order_relaxed) | (1u << sig), std::memory_order_relaxed);
+    bump(s_stale);
+    s_events.push({now_ms, (uint8_t)sig, true});
+  });
+  if (fired) {
+    const uint32_t us = plat_micros() - t0;
+    if (us > s_tick_max_us.load(std::memory_order_relaxed)) s_tick_max_us.store(us, std::memory_order_relaxed);
+  }
+}
+
+bool signal_stale_pop_event(signal_stale_event_t* out) {
+  return s_events.pop(out);
+}
+
+uint32_t signal_stale_mask(void) {
+  return s_mask.load(std::memory_order_relaxed);
+}
+
+void signal_stale_get_stats(signal_stale_stats_t* out) {
+  out->stale = s_stale.load(std::memory_order_relaxed);
+  out->recovered = s_recovered.load(std::memory_order_relaxed);
+  out->events_dropped = s_events.overruns();
+  out->tick_max_us = s_tick_max_us.load(std::memory_order_relaxed);
+}
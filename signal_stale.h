@@ -0,0 +1,47 @@
+#pragma once
+
+#include "signals.h"
+#include <stdint.h>
+
+// Stale/recovered detection for signals, driven by a timer wheel
+// (timer_wheel.h) instead of scanning every signal's timestamp.
+//
+// Each published value re-arms the signal's deadline (now + stale_ms from
+// signals.h). signal_stale_tick() advances the wheel and only touches the
+// signals whose deadline passed: their store quality becomes
+// SIG_QUALITY_STALE and a STALE event is queued. The next value queues a
+// RECOVERED event. The UI drains the events and updates only the affected
+// bindings, so both sides do O(transitions) work per tick.
+//
+// The bus task owns update and tick; one consumer pops events.
+
+#ifndef SIGNAL_STALE_TICK_MS
+  #define SIGNAL_STALE_TICK_MS     50     // wheel resolution; stale fires up to one tick late
+#endif
+#ifndef SIGNAL_STALE_EVENT_RING
+  #define SIGNAL_STALE_EVENT_RING  64     // power of two
+#endif
+
+struct signal_stale_event_t {
+  uint32_t t_ms;
+  uint8_t  sig;     // signal_id_t
+  bool     stale;   // false = recovered
+};
+
+struct signal_stale_stats_t {
+  uint32_t stale;            // transitions to stale
+  uint32_t recovered;
+  uint32_t events_dropped;   // consumer fell behind; resync from signal_stale_mask()
+  uint32_t tick_max_us;      // longest signal_stale_tick()
+};
+
+// Bus task: after each publish.
+void signal_stale_update(signal_id_t sig, uint32_t now_ms);
+// Bus task: every loop; cheap when nothing is due.
+void signal_stale_tick(uint32_t now_ms);
+
+// Consumer side (the UI).
+bool     signal_stale_pop_event(signal_stale_event_t* out);
+uint32_t signal_stale_mask(void);   // 1 << signal_id_t for each stale signal, any task
+
+void signal_stale_get_stats(signal_stale_stats_t* out);
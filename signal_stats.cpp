@@ -0,0 +1,170 @@
+#include "signal_stats.h"
+#include "platform.h"
+
+#include <string.h>
+
+static const uint32_t k_window_seconds[STATS_WIN_COUNT] = {
+  6u * 3600u,
+  12u * 3600u,
+  24u * 3600u,
+};
+
+uint32_t signal_stats_window_seconds(uint8_t window) {
+  return (window < STATS_WIN_COUNT) ? k_window_seconds[window] : 0;
+}
+
+// ---- Deque helpers (positions are absolute ring indices) ----
+
+static inline uint32_t dq_at(const stats_deque_t* d, uint32_t i) {
+  return d->pos[(d->head + i) % d->cap];
+}
+static inline uint32_t dq_front(const stats_deque_t* d) { return dq_at(d, 0); }
+static inline uint32_t dq_back(const stats_deque_t* d) { return dq_at(d, d->len - 1); }
+static inline void dq_pop_front(stats_deque_t* d) { d->head = (d->head + 1) % d->cap; d->len--; }
+static inline void dq_pop_back(stats_deque_t* d) { d->len--; }
+static inline void dq_push_back(stats_deque_t* d, uint32_t pos) {
+  d->pos[(d->head + d->len) % d->cap] = pos;
+  d->len++;
+}
+
+static inline const stats_bucket_t* ring_at(const signal_stats_t* s, uint32_t pos) {
+  return &s->ring[pos % s->ring_cap];
+}
+
+// ---- Window maintenance ----
+
+static void window_add(signal_stats_t* s, stats_window_t* w, uint32_t pos) {
+  const stats_bucket_t* b = ring_at(s, pos);
+  w->sum   += b->sum;
+  w->count += b->count;
+
+  while (w->dq_min.len && ring_at(s, dq_back(&w->dq_min))->min >= b->min) dq_pop_back(&w->dq_min);
+  dq_push_back(&w->dq_min, pos);
+  while (w->dq_max.len && ring_at(s, dq_back(&w->dq_max))->max <= b->max) dq_pop_back(&w->dq_max);
+  dq_push_back(&w->dq_max, pos);
+}
+
+// Drop closed buckets that fall out of the window when the open bucket is open_seq.
+static void window_expire(signal_stats_t* s, stats_window_t* w, uint32_t open_seq) {
+  const uint32_t lower = (open_seq + 1 >= w->span) ? (open_seq + 1 - w->span) : 0;
+  while (w->tail < s->ring_end && ring_at(s, w->tail)->seq < lower) {
+    const stats_bucket_t* b = ring_at(s, w->tail);
+    w->sum   -= b->sum;
+    w->count -= b->count;
+    w->tail++;
+  }
+  while (w->dq_min.len && dq_front(&w->dq_min) < w->tail) dq_pop_front(&w->dq_min);
+  while (w->dq_max.len && dq_front(&w->dq_max) < w->tail) dq_pop_front(&w->dq_max);
+}
+
+static void advance_to(signal_stats_t* s, uint32_t seq) {
+  if (seq <= s->open.seq) return;
+
+  if (s->open.count) {
+    const uint32_t pos = s->ring_end;
+    s->ring[pos % s->ring_cap] = s->open;
+    s->ring_end++;
+    for (int i = 0; i < STATS_WIN_COUNT; ++i) window_add(s, &s->win[i], pos);
+  }
+
+  memset(&s->open, 0, sizeof(s->open));
+  s->open.seq = seq;
+  for (int i = 0; i < STATS_WIN_COUNT; ++i) window_expire(s, &s->win[i], seq);
+}
+
+// ---- Public API ----
+
+bool signal_stats_init(signal_stats_t* s) {
+  memset(s, 0, sizeof(*s));
+
+  uint32_t max_span = 0;
+  for (int i = 0; i < STATS_WIN_COUNT; ++i) {
+    s->win[i].span = k_window_seconds[i] / SIGNAL_STATS_BUCKET_S;
+    if (s->win[i].span > max_span) max_span = s->win[i].span;
+  }
+
+  s->ring_cap = max_span;
+  s->ring = (stats_bucket_t*)plat_psram_alloc(sizeof(stats_bucket_t) * max_span);
+  bool ok = (s->ring != nullptr);
+
+  for (int i = 0; i < STATS_WIN_COUNT && ok; ++i) {
+    stats_window_t* w = &s->win[i];
+    w->dq_min.cap = w->span;
+    w->dq_max.cap = w->span;
+    w->dq_min.pos = (uint32_t*)plat_psram_alloc(sizeof(uint32_t) * w->span);
+    w->dq_max.pos = (uint32_t*)plat_psram_alloc(sizeof(uint32_t) * w->span);
+    ok = w->dq_min.pos && w->dq_max.pos;
+  }
+
+  if (!ok) signal_stats_free(s);
+  return ok;
+}
+
+void signal_stats_free(signal_stats_t* s) {
+  plat_free(s->ring);
+  s->ring = nullptr;
+  for (int i = 0; i < STATS_WIN_COUNT; ++i) {
+    plat_free(s->win[i].dq_min.pos);
+    plat_free(s->win[i].dq_max.pos);
+    s->win[i].dq_min.pos = nullptr;
+    s->win[i].dq_max.pos = nullptr;
+  }
+}
+
+void signal_stats_reset(signal_stats_t* s) {
+  s->ring_end = 0;
+  memset(&s->open, 0, sizeof(s->open));
+  s->current = 0;
+  s->has_sample = false;
+  for (int i = 0; i < STATS_WIN_COUNT; ++i) {
+    stats_window_t* w = &s->win[i];
+    w->tail = 0;
+    w->sum = 0;
+    w->count = 0;
+    w->dq_min.head = w->dq_min.len = 0;
+    w->dq_max.head = w->dq_max.len = 0;
+  }
+}
+
+void signal_stats_push(signal_stats_t* s, uint32_t t_s, int32_t value) {
+  advance_to(s, t_s / SIGNAL_STATS_BUCKET_S);
+
+  stats_bucket_t* b = &s->open;
+  if (b->count == 0) {
+    b->min = value;
+    b->max = value;
+  } else {
+    if (value < b->min) b->min = value;
+    if (value > b->max) b->max = value;
+  }
+  b->sum += value;
+  b->count++;
+
+  s->current = value;
+  s->has_sample = true;
+}
+
+bool signal_stats_get(signal_stats_t* s, uint8_t window, uint32_t now_s, signal_stats_result_t* out) {
+  if (window >= STATS_WIN_COUNT || !s->ring) return false;
+  advance_to(s, now_s / SIGNAL_STATS_BUCKET_S);
+
+  const stats_window_t* w = &s->win[window];
+  const uint32_t count = w->count + s->open.count;
+  if (count == 0) return false;
+
+  int32_t min_v = INT32_MAX;
+  int32_t max_v = INT32_MIN;
+  if (w->dq_min.len) min_v = ring_at(s, dq_front(&w->dq_min))->min;
+  if (w->dq_max.len) max_v = ring_at(s, dq_front(&w->dq_max))->max;
+  if (s->open.count) {
+    if (s->open.min < min_v) min_v = s->open.min;
+    if (s->open.max > max_v) max_v = s->open.max;
+  }
+
+  out->current = s->current;
+  out->avg     = (int32_t)((w->sum + s->open.sum) / (int64_t)count);
+  out->min     = min_v;
+  out->max     = max_v;
+  out->count   = count;
+  return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+
+// Sliding-window statistics (current/avg/min/max) for detail-page stat tiles.
+//
+// Samples are folded into fixed-width time buckets. Closed buckets go into one
+// shared ring; every window keeps a running sum plus monotonic min/max deques
+// over that ring, so push and query are O(1) amortized regardless of window
+// length. Late samples (older than the open bucket) are folded into the open
+// bucket.
+
+#ifndef SIGNAL_STATS_BUCKET_S
+  #define SIGNAL_STATS_BUCKET_S 60
+#endif
+
+enum signal_stats_window_t : uint8_t {
+  STATS_WIN_6H = 0,
+  STATS_WIN_12H,
+  STATS_WIN_24H,
+  STATS_WIN_COUNT,
+};
+
+struct signal_stats_result_t {
+  int32_t  current;
+  int32_t  avg;
+  int32_t  min;
+  int32_t  max;
+  uint32_t count;   // samples inside the window
+};
+
+struct stats_bucket_t {
+  int64_t  sum;
+  int32_t  min;
+  int32_t  max;
+  uint32_t count;
+  uint32_t seq;     // bucket number (t_s / SIGNAL_STATS_BUCKET_S)
+};
+
+// Fixed-capacity deque of absolute ring positions.
+struct stats_deque_t {
+  uint32_t* pos;
+  uint32_t  cap;
+  uint32_t  head;
+  uint32_t  len;
+};
+
+struct stats_window_t {
+  uint32_t      span;   // buckets covered, including the open one
+  uint32_t      tail;   // absolute ring position of the oldest bucket inside
+  int64_t       sum;
+  uint32_t      count;
+  stats_deque_t dq_min;
+  stats_deque_t dq_max;
+};
+
+struct signal_stats_t {
+  stats_bucket_t* ring;      // closed, non-empty buckets in time order
+  uint32_t        ring_cap;
+  uint32_t        ring_end;  // absolute position one past the newest bucket
+  stats_bucket_t  open;      // bucket currently accumulating samples
+  int32_t         current;
+  bool            has_sample;
+  stats_window_t  win[STATS_WIN_COUNT];
+};
+
+// Allocates ring/deque storage (PSRAM when available). Returns false on OOM.
+bool signal_stats_init(signal_stats_t* s);
+void signal_stats_free(signal_stats_t* s);
+void signal_stats_reset(signal_stats_t* s);
+
+void signal_stats_push(signal_stats_t* s, uint32_t t_s, int32_t value);
+
+// Rolls the windows forward to now_s and reports the aggregate of the given
+// window. Returns false when the window holds no samples.
+bool signal_stats_get(signal_stats_t* s, uint8_t window, uint32_t now_s, signal_stats_result_t* out);
+
+// Window length in seconds.
+uint32_t signal_stats_window_seconds(uint8_t window);
@@ -0,0 +1,92 @@
+#include "signal_store.h"
+
+#include <atomic>
+#include <string.h>
+
+static_assert(SIG_COUNT <= 32, "change masks are 32-bit");
+
+// Payload words are atomics so concurrent reads are well-defined. Release
+// stores keep them after the odd sequence value, acquire loads keep them
+// before the reader's re-check (no standalone fences, which TSan cannot model).
+struct alignas(32) signal_slot_t {
+  std::atomic<uint32_t> seq;
+  std::atomic<uint32_t> value_bits;
+  std::atomic<uint32_t> t_ms;
+  std::atomic<uint32_t> pgn;
+  std::atomic<uint32_t> meta;   // src | quality << 8
+};
+
+static signal_slot_t         s_slots[SIG_COUNT];
+static std::atomic<uint32_t> s_changed[SIG_CONSUMER_COUNT];
+static std::atomic<uint32_t> s_collisions{0};
+
+void signal_store_publish(signal_id_t id, float value, uint8_t quality, uint8_t src, uint32_t pgn,
+                          uint32_t t_ms) {
+  if (id >= SIG_COUNT) return;
+  signal_slot_t* s = &s_slots[id];
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  const uint32_t seq = s->seq.load(std::memory_order_relaxed);
+  s->seq.store(seq + 1, std::memory_order_relaxed);
+  s->value_bits.store(bits, std::memory_order_release);
+  s->t_ms.store(t_ms, std::memory_order_release);
+  s->pgn.store(pgn, std::memory_order_release);
+  s->meta.store((uint32_t)src | ((uint32_t)quality << 8), std::memory_order_release);
+  s->seq.store(seq + 2, std::memory_order_release);
+
+  const uint32_t bit = 1u << id;
+  for (uint8_t c = 0; c < SIG_CONSUMER_COUNT; ++c) {
+    s_changed[c].fetch_or(bit, std::memory_order_release);
+  }
+}
+
+void signal_store_set_quality(signal_id_t id, uint8_t quality) {
+  if (id >= SIG_COUNT) return;
+  signal_slot_t* s = &s_slots[id];
+  const uint32_t seq = s->seq.load(std::memory_order_relaxed);
+  if (seq == 0) return;
+  const uint32_t meta = (s->meta.load(std::memory_order_relaxed) & 0xFFu) | ((uint32_t)quality << 8);
+  s->seq.store(seq + 1, std::memory_order_relaxed);
+  s->meta.store(meta, std::memory_order_release);
+  s->seq.store(seq + 2, std::memory_order_release);
+
+  const uint32_t bit = 1u << id;
+  for (uint8_t c = 0; c < SIG_CONSUMER_COUNT; ++c) {
+    s_changed[c].fetch_or(bit, std::memory_order_release);
+  }
+}
+
+bool signal_store_read(signal_id_t id, signal_sample_t* out) {
+  if (id >= SIG_COUNT) return false;
+  const signal_slot_t* s = &s_slots[id];
+
+  for (int attempt = 0; attempt < SIGNAL_STORE_READ_TRIES; ++attempt) {
+    const uint32_t seq0 = s->seq.load(std::memory_order_acquire);
+    if (seq0 & 1) continue;
+    if (seq0 == 0) return false;
+    const uint32_t bits = s->value_bits.load(std::memory_order_acquire);
+    const uint32_t t_ms = s->t_ms.load(std::memory_order_acquire);
+    const uint32_t pgn = s->pgn.load(std::memory_order_acquire);
+    const uint32_t meta = s->meta.load(std::memory_order_acquire);
+    if (s->seq.load(std::memory_order_relaxed) != seq0) continue;
+
+    memcpy(&out->value, &bits, sizeof(bits));
+    out->t_ms = t_ms;
+    out->pgn = pgn;
+    out->src = (uint8_t)meta;
+    out->quality = (uint8_t)(meta >> 8);
+    return true;
+  }
+  s_collisions.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+uint32_t signal_store_take_changed(signal_consumer_t consumer) {
+  if (consumer >= SIG_CONSUMER_COUNT) return 0;
+  return s_changed[consumer].exchange(0, std::memory_order_acquire);
+}
+
+uint32_t signal_store_read_collisions(void) {
+  return s_collisions.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "signals.h"
+#include <stdint.h>
+
+// Latest value of every signal, shared between the bus task (writer) and the
+// LVGL loop (reader) without locks.
+//
+// Each slot is a seqlock: the single writer makes the sequence odd, stores
+// the fields and makes it even again; a reader retries if the sequence was
+// odd or moved while it copied. Reads are bounded (SIGNAL_STORE_READ_TRIES),
+// so a reader never waits on a preempted writer and rendering cannot stall.
+// Every publish also sets the signal's bit in one change mask per consumer.
+
+#ifndef SIGNAL_STORE_READ_TRIES
+  #define SIGNAL_STORE_READ_TRIES 8
+#endif
+
+enum signal_quality_t : uint8_t {
+  SIG_QUALITY_NONE = 0,   // never received
+  SIG_QUALITY_OK,
+  SIG_QUALITY_STALE,
+  SIG_QUALITY_INVALID,
+  SIG_QUALITY_ESTIMATED,
+};
+
+enum signal_consumer_t : uint8_t {
+  SIG_CONSUMER_UI = 0,
+  SIG_CONSUMER_COUNT
+};
+
+struct signal_sample_t {
+  float    value;
+  uint32_t t_ms;     // plat_millis() at decode
+  uint32_t pgn;
+  uint8_t  src;      // NMEA2000 source address
+  uint8_t  quality;  // signal_quality_t
+};
+
+// Writer side: one task per signal (the bus task).
+void signal_store_publish(signal_id_t id, float value, uint8_t quality, uint8_t src, uint32_t pgn,
+                          uint32_t t_ms);
+
+// Writer side: changes only the quality of the last published value (the
+// staleness engine marking it SIG_QUALITY_STALE). No-op if never published.
+void signal_store_set_quality(signal_id_t id, uint8_t quality);
+
+// Reader side. False if the signal was never published or every attempt
+// overlapped a write; the caller keeps its previous value in that case.
+bool signal_store_read(signal_id_t id, signal_sample_t* out);
+
+// Returns and clears the signals published since this consumer's last call.
+uint32_t signal_store_take_changed(signal_consumer_t consumer);
+
+// Reads that gave up after SIGNAL_STORE_READ_TRIES overlapping writes.
+uint32_t signal_store_read_collisions(void);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdint.h>
+
+// Normalized dashboard signals (NMEA2000_SD_LOGGING_PLAN.md, section 4/8).
+// Values are floats in the display unit below; decoders convert from the
+// PGN's SI units.
+
+enum signal_id_t : uint8_t {
+  SIG_RPM = 0,
+  SIG_STW,
+  SIG_SOG,
+  SIG_COG,
+  SIG_HEADING,
+  SIG_SOC,
+  SIG_PACK_VOLTAGE,
+  SIG_PACK_CURRENT,
+  SIG_XTE,
+  SIG_WIND_SPEED,
+  SIG_WIND_ANGLE,
+  SIG_COOLANT_TEMP,
+  SIG_LAT,
+  SIG_LON,
+  SIG_COUNT
+};
+
+// Logging priority (log_ingest.h). Under queue pressure BULK signals are
+// thinned first, then NORMAL; CRITICAL samples are never dropped by policy.
+enum signal_class_t : uint8_t {
+  SIG_CLASS_CRITICAL = 0,
+  SIG_CLASS_NORMAL,
+  SIG_CLASS_BULK,        // high-rate, redundant between samples
+  SIG_CLASS_COUNT
+};
+
+struct signal_meta_t {
+  const char* key;        // log/schema key
+  const char* unit;
+  uint8_t     decimals;   // display precision
+  signal_class_t log_class;   // logging priority under queue pressure
+  // In-RAM history (signal_history.h): stored as round(value * fixed_scale)
+  // in a 16- or 32-bit slot, one sample per hist_period_ms for hist_span_s.
+  float       fixed_scale;
+  uint8_t     fixed_bits;
+  uint16_t    hist_period_ms;
+  uint32_t    hist_span_s;
+  // No update for this long marks the value stale (signal_stale.h); about
+  // 2 s for fast PGNs, longer for ones sent every 1-2.5 s.
+  uint16_t    stale_ms;
+};
+
+static constexpr signal_meta_t k_signal_meta[SIG_COUNT] = {
+  // key             unit   dec class               scale    bits period span stale
+  {"rpm",            "rpm", 0, SIG_CLASS_CRITICAL,  1.0f,    16, 1000,  86400,  2000},
+  {"stw_kts",        "kn",  1, SIG_CLASS_CRITICAL,  100.0f,  16, 1000,  86400,  2000},
+  {"sog_kts",        "kn",  1, SIG_CLASS_BULK,      100.0f,  16, 1000,  86400,  2000},
+  {"cog_true_deg",   "deg", 0, SIG_CLASS_BULK,      10.0f,   16, 1000,  86400,  2000},
+  {"heading_deg",    "deg", 0, SIG_CLASS_CRITICAL,  10.0f,   16, 1000,  86400,  2000},
+  {"soc_pct",        "%",   0, SIG_CLASS_CRITICAL,  10.0f,   16, 10000, 86400,  5000},
+  {"pack_voltage_v", "V",   1, SIG_CLASS_CRITICAL,  1000.0f, 32, 1000,  86400,  5000},
+  {"pack_current_a", "A",   1, SIG_CLASS_NORMAL,    10.0f,   16, 1000,  86400,  5000},
+  {"xte_nm",         "nm",  2, SIG_CLASS_NORMAL,    1000.0f, 16, 1000,  21600,  3000},
+  {"aws_kts",        "kn",  1, SIG_CLASS_BULK,      10.0f,   16, 1000,  86400,  2000},
+  {"awa_deg",        "deg", 0, SIG_CLASS_BULK,      10.0f,   16, 1000,  86400,  2000},
+  {"coolant_c",      "C",   0, SIG_CLASS_NORMAL,    10.0f,   16, 5000,  86400,  2000},
+  {"lat_deg",        "deg", 5, SIG_CLASS_BULK,      1e7f,    32, 5000,  86400,  2000},
+  {"lon_deg",        "deg", 5, SIG_CLASS_BULK,      1e7f,    32, 5000,  86400,  2000},
+};
+
+static inline const signal_meta_t* signal_meta(signal_id_t id) {
+  return (id < SIG_COUNT) ? &k_signal_meta[id] : nullptr;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// Fixed-capacity lock-free single-producer/single-consumer ring.
+//
+// push() never blocks or allocates, so it is safe from an ISR or a
+// high-priority RX task; a full ring drops the new element and counts an
+// overrun. Head/tail are free-running 32-bit counters (N must be a power of
+// two), and only the producer writes head/overruns/high-water while only the
+// consumer writes tail.
+
+template <typename T, uint32_t N>
+class spsc_ring {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "spsc_ring capacity must be a power of two");
+
+public:
+  bool push(const T& item) {
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    const uint32_t used = head - tail_.load(std::memory_order_acquire);
+    if (used >= N) {
+      overruns_.store(overruns_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    buf_[head & (N - 1)] = item;
+    head_.store(head + 1, std::memory_order_release);
+    if (used + 1 > high_water_.load(std::memory_order_relaxed)) {
+      high_water_.store(used + 1, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  bool pop(T* out) {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) return false;
+    *out = buf_[tail & (N - 1)];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Peek at the oldest element without consuming it (consumer side only).
+  const T* front() const {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) return nullptr;
+    return &buf_[tail & (N - 1)];
+  }
+
+  uint32_t size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  static constexpr uint32_t capacity() { return N; }
+  uint32_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+  uint32_t high_water() const { return high_water_.load(std::memory_order_relaxed); }
+
+private:
+  T buf_[N];
+  alignas(32) std::atomic<uint32_t> head_{0};
+  alignas(32) std::atomic<uint32_t> tail_{0};
+  std::atomic<uint32_t> overruns_{0};
+  std::atomic<uint32_t> high_water_{0};
+};
@@ -0,0 +1,19 @@
+// Host driver for c6_link_bench(): runs the link protocol over a pty pair
+// and prints throughput, UART time at C6_LINK_BAUD, latency and errors.
+//   c6_link_bench [seconds] [signals_per_s] [corrupt_every]
+//   default: 3 s at max rate, every 50th message corrupted
+
+#include "bus_task.h"
+#include "c6_link.h"
+
+#include <stdlib.h>
+
+// c6_link.cpp's receiver service publishes through the bus task, which the
+// bench does not start.
+void bus_publish(signal_id_t, float, uint8_t, uint8_t, uint32_t, uint32_t) {}
+
+int main(int argc, char** argv) {
+  c6_link_bench(argc > 1 ? (uint32_t)atoi(argv[1]) : 3, argc > 2 ? (uint32_t)atoi(argv[2]) : 0,
+                argc > 3 ? (uint32_t)atoi(argv[3]) : 50);
+  return 0;
+}
@@ -0,0 +1,278 @@
+// c6_link framing: messages through c6_link_rx_feed() as the UART would
+// deliver them. Covers
+//   - COBS round-trip of random bodies up to C6_LINK_MAX_BODY, with zeros
+//     and runs past a COBS block, fed in random splits down to single bytes
+//   - CRC rejection of a body byte changed under valid COBS
+//   - resync after random flipped bytes: every untouched message arrives
+//     intact, every touched one is dropped, the gaps are counted as lost
+//   - sequence gap counting, across the 16-bit wrap
+//   - oversize frames, truncated and malformed COBS, and recovery after each
+
+#include "host_test.h"
+#include "bus_task.h"
+#include "c6_link.h"
+#include "crc32.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+// c6_link.cpp's receiver service publishes through the bus task, which is
+// not exercised here.
+void bus_publish(signal_id_t, float, uint8_t, uint8_t, uint32_t, uint32_t) {}
+
+struct received_t {
+  uint16_t             seq;
+  uint8_t              type;
+  std::vector<uint8_t> body;
+};
+
+static std::vector<received_t> s_got;
+
+static void on_message(const c6_link_hdr_t* hdr, const uint8_t* body, uint16_t len, void*) {
+  HT_CHECK_MSG(((uintptr_t)body & 3) == 0, "body not 4-byte aligned");
+  s_got.push_back({hdr->seq, hdr->type, std::vector<uint8_t>(body, body + len)});
+}
+
+// Body of the message with sequence number `seq`: its length and bytes
+// follow from the seq, so a receiver can check what it got. Zeros are
+// frequent and some bodies have long nonzero runs.
+static std::vector<uint8_t> body_for(uint16_t seq) {
+  ht_rng_t rng = {seq * 2654435761u + 1};
+  std::vector<uint8_t> b(rng.below(C6_LINK_MAX_BODY + 1));
+  const bool runs = rng.below(4) == 0;
+  for (uint8_t& x : b) x = runs ? (uint8_t)(1 + rng.below(255)) : rng.below(3) ? (uint8_t)rng.next() : 0;
+  return b;
+}
+
+static std::vector<uint8_t> encode(c6_link_tx_t* tx, const std::vector<uint8_t>& body) {
+  const size_t n = c6_link_encode(tx, C6_LINK_HEARTBEAT, body.data(), body.size());
+  return std::vector<uint8_t>(tx->wire, tx->wire + n);
+}
+
+static bool intact(const received_t& r) {
+  return r.type == C6_LINK_HEARTBEAT && r.body == body_for(r.seq);
+}
+
+// Feeds `wire` in random pieces, sometimes one byte at a time.
+static void feed_split(c6_link_rx_t* rx, const std::vector<uint8_t>& wire, ht_rng_t* rng) {
+  const size_t max_piece = rng->below(2) ? 1 : 1 + rng->below(700);
+  for (size_t i = 0; i < wire.size();) {
+    const size_t n = std::min(wire.size() - i, 1 + (size_t)rng->below((uint32_t)max_piece));
+    c6_link_rx_feed(rx, &wire[i], n);
+    i += n;
+  }
+}
+
+static void test_round_trip(void) {
+  static c6_link_tx_t tx;
+  static c6_link_rx_t rx;
+  c6_link_tx_init(&tx);
+  c6_link_rx_init(&rx, on_message, nullptr);
+  s_got.clear();
+  ht_rng_t rng = {7};
+  std::vector<uint8_t> stream;
+  const uint32_t k_msgs = 3000;
+  for (uint32_t i = 0; i < k_msgs; ++i) {
+    const std::vector<uint8_t> w = encode(&tx, body_for((uint16_t)i));
+    HT_CHECK(w.size() <= C6_LINK_MAX_WIRE);
+    HT_CHECK(w.back() == 0 && memchr(w.data(), 0, w.size() - 1) == nullptr);
+    stream.insert(stream.end(), w.begin(), w.end());
+  }
+  HT_CHECK(c6_link_encode(&tx, C6_LINK_HEARTBEAT, stream.data(), C6_LINK_MAX_BODY + 1) == 0);
+  feed_split(&rx, stream, &rng);
+
+  HT_CHECK_MSG(s_got.size() == k_msgs, "%u of %u messages", (unsigned)s_got.size(), (unsigned)k_msgs);
+  for (size_t i = 0; i < s_got.size() && !ht_bail(); ++i) {
+    HT_CHECK_MSG(s_got[i].seq == i && intact(s_got[i]), "message %u corrupted", (unsigned)i);
+  }
+  const c6_link_rx_stats_t& st = rx.stats;
+  HT_CHECK(st.messages == k_msgs && st.bytes == stream.size());
+  HT_CHECK(st.crc_errors == 0 && st.framing_errors == 0 && st.oversize == 0 && st.lost == 0);
+}
+
+// Changes one nonzero data byte (not a COBS code byte) to another nonzero
+// value, so framing stays valid and only the CRC can catch it.
+static void test_crc_rejection(void) {
+  static c6_link_tx_t tx;
+  static c6_link_rx_t rx;
+  c6_link_tx_init(&tx);
+  c6_link_rx_init(&rx, on_message, nullptr);
+  s_got.clear();
+  ht_rng_t rng = {11};
+  const uint16_t k_msgs = 502;   // the last one intact, so every gap shows
+  uint32_t bad = 0;
+  for (uint16_t seq = 0; seq < k_msgs; ++seq) {
+    std::vector<uint8_t> w = encode(&tx, body_for(seq));
+    if (seq % 3 == 1) {
+      std::vector<bool> code(w.size());
+      for (size_t at = 0; at < w.size() - 1; at += w[at]) code[at] = true;
+      size_t at;
+      do at = rng.below((uint32_t)w.size() - 1); while (code[at]);
+      w[at] = w[at] == 0xFF ? 1 : w[at] + 1;
+      ++bad;
+    }
+    c6_link_rx_feed(&rx, w.data(), w.size());
+  }
+  HT_CHECK(rx.stats.crc_errors == bad && rx.stats.framing_errors == 0);
+  HT_CHECK(s_got.size() == k_msgs - bad && rx.stats.messages == k_msgs - bad);
+  for (const received_t& r : s_got) HT_CHECK_MSG(r.seq % 3 != 1 && intact(r), "seq %u accepted", (unsigned)r.seq);
+  HT_CHECK_MSG(rx.stats.lost == bad, "lost %u, dropped %u", (unsigned)rx.stats.lost, (unsigned)bad);
+}
+
+// One random bit flipped in random messages, anywhere but the delimiter;
+// a flip to 0x00 splits the message on the wire.
+static void test_resync(void) {
+  static c6_link_tx_t tx;
+  static c6_link_rx_t rx;
+  c6_link_tx_init(&tx);
+  c6_link_rx_init(&rx, on_message, nullptr);
+  s_got.clear();
+  ht_rng_t rng = {23};
+  const uint16_t k_msgs = 4000;
+  std::vector<bool> hit(k_msgs);
+  std::vector<uint8_t> stream;
+  uint32_t corrupted = 0;
+  for (uint16_t seq = 0; seq < k_msgs; ++seq) {
+    std::vector<uint8_t> w = encode(&tx, body_for(seq));
+    if (seq && seq + 1 < k_msgs && rng.below(5) == 0) {
+      w[rng.below((uint32_t)w.size() - 1)] ^= (uint8_t)(1u << rng.below(8));
+      hit[seq] = true;
+      ++corrupted;
+    }
+    stream.insert(stream.end(), w.begin(), w.end());
+  }
+  feed_split(&rx, stream, &rng);
+
+  HT_CHECK_MSG(s_got.size() == k_msgs - corrupted, "%u received, %u sent, %u corrupted", (unsigned)s_got.size(),
+               (unsigned)k_msgs, (unsigned)corrupted);
+  for (const received_t& r : s_got) {
+    if (ht_bail()) break;
+    HT_CHECK_MSG(!hit[r.seq] && intact(r), "seq %u delivered %s", (unsigned)r.seq, hit[r.seq] ? "corrupted" : "wrong");
+  }
+  const c6_link_rx_stats_t& st = rx.stats;
+  HT_CHECK(st.crc_errors + st.framing_errors >= corrupted);
+  HT_CHECK(st.lost == corrupted && st.oversize == 0);
+  printf("c6_link_test: %u of %u messages corrupted: %u crc, %u framing errors\n", (unsigned)corrupted,
+         (unsigned)k_msgs, (unsigned)st.crc_errors, (unsigned)st.framing_errors);
+}
+
+static void test_sequence_gaps(void) {
+  static c6_link_tx_t tx;
+  static c6_link_rx_t rx;
+  c6_link_tx_init(&tx);
+  c6_link_rx_init(&rx, on_message, nullptr);
+  s_got.clear();
+  tx.seq = 0xFFF0;
+  ht_rng_t rng = {5};
+  uint32_t skipped = 0;
+  for (int i = 0; i < 2000; ++i) {
+    const std::vector<uint8_t> w = encode(&tx, {1, 2, 3});
+    // Never before the first delivered message: there is no gap to see yet.
+    if (i && i < 1999 && rng.below(10) == 0) {
+      ++skipped;
+      continue;
+    }
+    c6_link_rx_feed(&rx, w.data(), w.size());
+  }
+  HT_CHECK(tx.seq == (uint16_t)(0xFFF0 + 2000));
+  HT_CHECK_MSG(rx.stats.lost == skipped, "lost %u, skipped %u", (unsigned)rx.stats.lost, (unsigned)skipped);
+  HT_CHECK(rx.stats.messages == 2000 - skipped);
+
+  // A receiver joining mid-stream does not count what came before.
+  c6_link_rx_init(&rx, on_message, nullptr);
+  for (int i = 0; i < 3; ++i) {
+    const std::vector<uint8_t> w = encode(&tx, {});
+    c6_link_rx_feed(&rx, w.data(), w.size());
+  }
+  HT_CHECK(rx.stats.messages == 3 && rx.stats.lost == 0);
+}
+
+// Plain COBS, for frames c6_link_encode() refuses to build.
+static std::vector<uint8_t> cobs(const std::vector<uint8_t>& in) {
+  std::vector<uint8_t> out(1);
+  size_t code_at = 0;
+  for (uint8_t b : in) {
+    if (b) {
+      out.push_back(b);
+      if (out.size() - code_at < 0xFF) continue;
+    }
+    out[code_at] = (uint8_t)(out.size() - code_at);
+    code_at = out.size();
+    out.push_back(0);
+  }
+  out[code_at] = (uint8_t)(out.size() - code_at);
+  out.push_back(0);
+  return out;
+}
+
+static void test_bad_frames(void) {
+  static c6_link_tx_t tx;
+  static c6_link_rx_t rx;
+  c6_link_tx_init(&tx);
+  c6_link_rx_init(&rx, on_message, nullptr);
+  s_got.clear();
+  ht_rng_t rng = {99};
+  uint16_t next = 0;
+  auto good = [&]() {
+    const std::vector<uint8_t> w = encode(&tx, body_for(next++));
+    feed_split(&rx, w, &rng);
+  };
+  good();
+
+  // Longer than the receive buffer: discarded up to the next delimiter.
+  std::vector<uint8_t> junk(C6_LINK_MAX_WIRE * 3, 0x5A);
+  junk.push_back(0);
+  feed_split(&rx, junk, &rng);
+  HT_CHECK(rx.stats.oversize == 1);
+  good();
+
+  // Fits the buffer but decodes past C6_LINK_MAX_RAW, with a valid CRC.
+  c6_link_hdr_t hdr = {C6_LINK_SCHEMA_VERSION, C6_LINK_HEARTBEAT, next, 0};
+  std::vector<uint8_t> raw(C6_LINK_MAX_RAW + 1, 0x11);
+  memcpy(raw.data(), &hdr, sizeof(hdr));
+  const uint32_t crc = crc32_update(0, raw.data(), raw.size() - 4);
+  memcpy(&raw[raw.size() - 4], &crc, sizeof(crc));
+  const std::vector<uint8_t> big = cobs(raw);
+  HT_CHECK(big.size() - 1 <= C6_LINK_MAX_WIRE);
+  feed_split(&rx, big, &rng);
+  HT_CHECK(rx.stats.oversize == 2);
+  good();
+
+  // Shorter than a header plus CRC, and a code byte running past the end.
+  const uint8_t shorty[] = {0x04, 0x01, 0x02, 0x03, 0x00};
+  const uint8_t overrun[] = {0x40, 0x01, 0x02, 0x03, 0x00};
+  c6_link_rx_feed(&rx, shorty, sizeof(shorty));
+  c6_link_rx_feed(&rx, overrun, sizeof(overrun));
+  HT_CHECK(rx.stats.framing_errors == 2);
+  // Empty frames (back-to-back delimiters) are idle line, not errors.
+  const uint8_t idle[] = {0, 0, 0};
+  c6_link_rx_feed(&rx, idle, sizeof(idle));
+  HT_CHECK(rx.stats.framing_errors == 2);
+  good();
+
+  // Wrong schema version, otherwise valid.
+  raw.assign(sizeof(c6_link_hdr_t) + 2 + 4, 9);
+  hdr = {C6_LINK_SCHEMA_VERSION + 1, C6_LINK_HEARTBEAT, next, 0};
+  memcpy(raw.data(), &hdr, sizeof(hdr));
+  const uint32_t crc2 = crc32_update(0, raw.data(), raw.size() - 4);
+  memcpy(&raw[raw.size() - 4], &crc2, sizeof(crc2));
+  const std::vector<uint8_t> other = cobs(raw);
+  c6_link_rx_feed(&rx, other.data(), other.size());
+  HT_CHECK(rx.stats.schema_mismatch == 1);
+  good();
+
+  // None of the bad frames was taken for a message or cost one.
+  HT_CHECK_MSG(s_got.size() == 5, "%u good messages received", (unsigned)s_got.size());
+  for (const received_t& r : s_got) HT_CHECK_MSG(intact(r), "seq %u corrupted", (unsigned)r.seq);
+  HT_CHECK(rx.stats.crc_errors == 0 && rx.stats.lost == 0);
+}
+
+int main() {
+  test_round_trip();
+  test_crc_rejection();
+  test_resync();
+  test_sequence_gaps();
+  test_bad_frames();
+  return ht_finish("c6_link_test");
+}
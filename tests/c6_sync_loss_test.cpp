@@ -0,0 +1,318 @@
+// c6_sync over a lossy link: synthetic NMEA2000 traffic at typical PGN
+// rates through the real encoder, link framing and decoder, with a share of
+// the link messages dropped in both directions. Checks that
+//   - after every applied frame the receiver's table equals the sender's
+//   - a receiver that lost a frame is back in sync within
+//     C6_SYNC_KEYFRAME_MS, also when every RESYNC request is lost
+//   - delta sync needs fewer bytes than streaming the full state
+//   - malformed and oversized bodies are rejected without touching the
+//     table, and a keyframe recovers from them
+
+#include "host_test.h"
+#include "bus_task.h"
+#include "c6_sync.h"
+
+#include <string.h>
+
+// c6_link.cpp's receiver service publishes through the bus task, which is
+// not exercised here.
+void bus_publish(signal_id_t, float, uint8_t, uint8_t, uint32_t, uint32_t) {}
+
+// Typical transmit intervals of the PGNs behind each signal and how often
+// a new sample differs at the PGN's resolution, for a boat under way.
+struct sim_profile_t {
+  uint16_t period_ms;
+  float    quantum;      // display units per PGN LSB
+  float    p_change;
+  double   start;
+  uint32_t pgn;
+};
+
+static const sim_profile_t k_sim_profile[SIG_COUNT] = {
+  {100,  0.25f,     0.50f, 1800.0,   127488},   // rpm, engine rapid
+  {1000, 0.0194f,   0.70f, 6.5,      128259},   // stw
+  {250,  0.0194f,   0.80f, 6.8,      129026},   // sog
+  {250,  0.00573f,  0.80f, 215.0,    129026},   // cog
+  {100,  0.00573f,  0.60f, 210.0,    127250},   // heading
+  {1500, 1.0f,      0.01f, 80.0,     127506},   // soc
+  {1000, 0.01f,     0.30f, 52.4,     127508},   // pack voltage
+  {1000, 0.1f,      0.50f, -12.0,    127508},   // pack current
+  {1000, 0.0000054f, 0.50f, 0.02,    129283},   // xte
+  {100,  0.0194f,   0.90f, 14.0,     130306},   // aws
+  {100,  0.00573f,  0.90f, 40.0,     130306},   // awa
+  {500,  0.1f,      0.05f, 78.0,     127489},   // coolant
+  {100,  1e-7f,     0.90f, 50.1234567, 129025}, // lat
+  {100,  1e-7f,     0.90f, -4.1234567, 129025}, // lon
+};
+
+struct sim_rx_t {
+  c6_sync_rx_t sync;
+  bool         ok;        // last apply result
+  bool         applied;
+  uint32_t     published;
+};
+
+static void on_publish(signal_id_t, float, uint8_t, uint8_t, uint32_t, void* ctx) {
+  ((sim_rx_t*)ctx)->published++;
+}
+
+static void on_message(const c6_link_hdr_t* hdr, const uint8_t* body, uint16_t len, void* ctx) {
+  sim_rx_t* r = (sim_rx_t*)ctx;
+  if (hdr->type != C6_LINK_KEYFRAME && hdr->type != C6_LINK_DELTA) return;
+  r->ok = c6_sync_rx_apply(&r->sync, hdr->type, body, len, on_publish, r);
+  r->applied = true;
+}
+
+static bool same_slot(const c6_sync_slot_t& a, const c6_sync_slot_t& b) {
+  return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+struct sim_result_t {
+  uint32_t checks, mismatches;
+  uint32_t dropped, resyncs, recoveries, max_recovery_ms;
+  uint64_t delta_bytes, full_bytes, batch_bytes;
+};
+
+// `loss_pct` of the sync frames and RESYNC requests are dropped. With
+// `deaf`, no RESYNC request ever reaches the C6 and only deltas are
+// dropped, so recovery rests on the periodic keyframe alone.
+static sim_result_t simulate(uint32_t seconds, uint32_t loss_pct, bool deaf, uint32_t seed) {
+  static c6_sync_tx_t tx, full;
+  static c6_link_tx_t link, link_full, link_batch, link_p4;
+  static c6_link_rx_t link_rx;
+  static sim_rx_t rx;
+  c6_sync_tx_init(&tx);
+  c6_sync_tx_init(&full);
+  c6_link_tx_init(&link);
+  c6_link_tx_init(&link_full);
+  c6_link_tx_init(&link_batch);
+  c6_link_tx_init(&link_p4);
+  c6_sync_rx_init(&rx.sync);
+  rx.published = 0;
+  c6_link_rx_init(&link_rx, on_message, &rx);
+
+  ht_rng_t rng = {seed};
+  double   value[SIG_COUNT];
+  uint32_t due[SIG_COUNT];
+  for (int i = 0; i < SIG_COUNT; ++i) {
+    value[i] = k_sim_profile[i].start;
+    due[i] = rng.below(k_sim_profile[i].period_ms);
+  }
+  auto uniform = [&]() { return (rng.next() >> 8) * (1.0f / 16777216.0f); };
+  auto lost = [&]() { return rng.below(100) < loss_pct; };
+
+  sim_result_t r = {};
+  uint64_t fresh_sent = 0;
+  uint32_t resync_due = 0, last_resync = 0;
+  uint32_t stale_since = 0;   // first frame the receiver missed or refused
+  bool     resync_pending = false;
+  const uint32_t end = seconds * 1000u;
+
+  for (uint32_t t = 1; t <= end && !ht_bail(); ++t) {
+    for (int i = 0; i < SIG_COUNT; ++i) {
+      if (t < due[i]) continue;
+      const sim_profile_t& p = k_sim_profile[i];
+      due[i] += p.period_ms;
+      if (uniform() < p.p_change) {
+        const int steps = 1 + (int)rng.below(3);
+        value[i] += (rng.next() & 1 ? steps : -steps) * (double)p.quantum;
+      }
+      const float v = (float)value[i];
+      c6_sync_tx_update(&tx, (signal_id_t)i, v, 1, 0x23, p.pgn);
+      c6_sync_tx_update(&full, (signal_id_t)i, v, 1, 0x23, p.pgn);
+      if (!c6_link_batch_add(&link_batch, (signal_id_t)i, v, 1, 0x23, p.pgn, 0)) {
+        r.batch_bytes += c6_link_encode_batch(&link_batch);
+        c6_link_batch_add(&link_batch, (signal_id_t)i, v, 1, 0x23, p.pgn, 0);
+      }
+    }
+
+    if (resync_pending && t >= resync_due) {
+      resync_pending = false;
+      c6_sync_tx_request_keyframe(&tx);
+    }
+    if (t % C6_SYNC_PERIOD_MS) continue;
+
+    r.batch_bytes += c6_link_encode_batch(&link_batch);
+    c6_sync_tx_request_keyframe(&full);
+    r.full_bytes += c6_sync_tx_frame(&full, &link_full, t);
+
+    const uint32_t fresh = tx.fresh;
+    const size_t n = c6_sync_tx_frame(&tx, &link, t);
+    if (!n) continue;
+    fresh_sent += __builtin_popcount(fresh);
+    const bool key = link.raw[1] == C6_LINK_KEYFRAME;
+    rx.applied = false;
+    if (lost() && !(deaf && key)) {
+      r.dropped++;
+    } else {
+      c6_link_rx_feed(&link_rx, link.wire, n);
+    }
+
+    if (rx.applied && rx.ok) {
+      r.checks++;
+      bool match = rx.sync.valid == tx.sent_valid;
+      for (int i = 0; i < SIG_COUNT; ++i) {
+        if ((tx.sent_valid & (1u << i)) && !same_slot(rx.sync.slot[i], tx.sent[i])) match = false;
+      }
+      if (!match) r.mismatches++;
+      if (stale_since) {
+        const uint32_t took = t - stale_since;
+        if (took > r.max_recovery_ms) r.max_recovery_ms = took;
+        r.recoveries++;
+        stale_since = 0;
+      }
+    } else if (!stale_since) {
+      stale_since = t;
+    }
+
+    if (rx.applied && !rx.ok && t - last_resync >= C6_SYNC_RESYNC_MS) {
+      last_resync = t;
+      r.resyncs++;
+      c6_link_encode(&link_p4, C6_LINK_RESYNC, nullptr, 0);
+      if (!deaf && !lost()) {
+        resync_pending = true;
+        resync_due = t + 5;   // UART and C6 turnaround
+      }
+    }
+  }
+  r.delta_bytes = tx.stats.bytes;
+
+  const c6_sync_rx_stats_t& rs = rx.sync.stats;
+  if (!loss_pct) {
+    // Nothing lost: every fresh slot is published once, nothing resyncs.
+    HT_CHECK(r.dropped == 0 && r.resyncs == 0 && r.recoveries == 0 && rs.gaps == 0);
+    HT_CHECK_MSG(rx.published == fresh_sent, "published %u of %llu fresh slots", (unsigned)rx.published,
+                 (unsigned long long)fresh_sent);
+    HT_CHECK(rs.keyframes + rs.deltas == tx.stats.keyframes + tx.stats.deltas);
+  }
+  HT_CHECK_MSG(rs.malformed == 0 && link_rx.stats.crc_errors == 0, "%u malformed, %u crc errors", (unsigned)rs.malformed,
+               (unsigned)link_rx.stats.crc_errors);
+  printf("c6_sync_loss_test: %u%% loss%s: %u frames, %u dropped, %u gaps, %u resyncs, %u recoveries (max %u ms); "
+         "B/s delta %.0f, full state %.0f, batches %.0f\n",
+         (unsigned)loss_pct, deaf ? " (RESYNC lost)" : "", (unsigned)(tx.stats.keyframes + tx.stats.deltas),
+         (unsigned)r.dropped, (unsigned)rs.gaps, (unsigned)r.resyncs, (unsigned)r.recoveries,
+         (unsigned)r.max_recovery_ms, (double)r.delta_bytes / seconds, (double)r.full_bytes / seconds,
+         (double)r.batch_bytes / seconds);
+  return r;
+}
+
+static void check_run(uint32_t loss_pct, bool deaf, uint32_t seed) {
+  const sim_result_t r = simulate(120, loss_pct, deaf, seed);
+  HT_CHECK(r.checks > 0);
+  HT_CHECK_MSG(r.mismatches == 0, "%u%% loss: %u of %u applied frames left a different table", (unsigned)loss_pct,
+               (unsigned)r.mismatches, (unsigned)r.checks);
+  HT_CHECK_MSG(r.max_recovery_ms <= C6_SYNC_KEYFRAME_MS, "%u%% loss: %u ms to recover", (unsigned)loss_pct,
+               (unsigned)r.max_recovery_ms);
+  if (loss_pct) HT_CHECK(r.dropped > 0 && r.recoveries > 0);
+  HT_CHECK_MSG(r.delta_bytes < r.full_bytes, "%u%% loss: %llu delta bytes, %llu full state", (unsigned)loss_pct,
+               (unsigned long long)r.delta_bytes, (unsigned long long)r.full_bytes);
+}
+
+// ---- Malformed bodies ----
+
+struct frame_t {
+  alignas(4) uint8_t b[C6_LINK_MAX_BODY + 8];
+  uint16_t len;
+};
+
+static frame_t make_frame(uint16_t frame, uint32_t fresh, uint32_t values, uint32_t meta) {
+  frame_t f = {};
+  const c6_sync_hdr_t hdr = {frame, 0, fresh, values, meta};
+  memcpy(f.b, &hdr, sizeof(hdr));
+  f.len = sizeof(hdr);
+  for (uint32_t m = values; m; m &= m - 1) {
+    const float v = 1.5f * (float)__builtin_ctz(m) + frame;
+    memcpy(f.b + f.len, &v, 4);
+    f.len += 4;
+  }
+  for (uint32_t m = meta; m; m &= m - 1) {
+    const uint32_t w = c6_sync_meta_pack(127488, (uint8_t)__builtin_ctz(m), 1);
+    memcpy(f.b + f.len, &w, 4);
+    f.len += 4;
+  }
+  return f;
+}
+
+static void test_malformed(void) {
+  static c6_sync_rx_t rx;
+  c6_sync_rx_init(&rx);
+  const uint32_t all = (uint32_t)((1ull << SIG_COUNT) - 1);
+
+  frame_t key = make_frame(0, all, all, all);
+  HT_CHECK(c6_sync_rx_apply(&rx, C6_LINK_KEYFRAME, key.b, key.len, nullptr, nullptr));
+  frame_t delta = make_frame(1, 0x5, 0x5, 0);
+  HT_CHECK(c6_sync_rx_apply(&rx, C6_LINK_DELTA, delta.b, delta.len, nullptr, nullptr));
+  const c6_sync_rx_t good = rx;
+
+  struct bad_t {
+    const char* what;
+    uint8_t     type;
+    frame_t     f;
+  };
+  bad_t bad[] = {
+      {"empty", C6_LINK_DELTA, make_frame(2, 1, 1, 0)},
+      {"short header", C6_LINK_DELTA, make_frame(2, 1, 1, 0)},
+      {"missing value", C6_LINK_DELTA, make_frame(2, 0x3, 0x3, 0)},
+      {"trailing bytes", C6_LINK_DELTA, make_frame(2, 1, 1, 0)},
+      {"oversized", C6_LINK_KEYFRAME, make_frame(2, all, all, all)},
+      {"slot past SIG_COUNT", C6_LINK_DELTA, make_frame(2, 1u << SIG_COUNT, 1u << SIG_COUNT, 0)},
+      {"keyframe values != meta", C6_LINK_KEYFRAME, make_frame(2, 0x1, 0x3, 0x1)},
+      {"keyframe fresh not sent", C6_LINK_KEYFRAME, make_frame(2, 0x7, 0x3, 0x3)},
+      {"delta value not fresh", C6_LINK_DELTA, make_frame(2, 0x1, 0x3, 0)},
+  };
+  bad[0].f.len = 0;
+  bad[1].f.len = sizeof(c6_sync_hdr_t) - 1;
+  bad[2].f.len -= 4;
+  bad[3].f.len += 4;
+  bad[4].f.len = C6_LINK_MAX_BODY;
+
+  uint32_t malformed = 0;
+  for (const bad_t& x : bad) {
+    c6_sync_rx_t before = rx;
+    HT_CHECK_MSG(!c6_sync_rx_apply(&rx, x.type, x.f.b, x.f.len, nullptr, nullptr), "%s accepted", x.what);
+    HT_CHECK_MSG(rx.stats.malformed == ++malformed, "%s not counted as malformed", x.what);
+    HT_CHECK_MSG(!rx.synced, "%s left the receiver synced", x.what);
+    HT_CHECK_MSG(memcmp(rx.slot, before.slot, sizeof(rx.slot)) == 0 && rx.valid == before.valid,
+                 "%s changed the table", x.what);
+    rx.synced = true;   // as if nothing happened, to try the next one
+  }
+
+  // A delta for a slot the receiver never held must bring value and meta.
+  static c6_sync_rx_t fresh_rx;
+  c6_sync_rx_init(&fresh_rx);
+  frame_t part = make_frame(0, 0x1, 0x1, 0x1);
+  HT_CHECK(c6_sync_rx_apply(&fresh_rx, C6_LINK_KEYFRAME, part.b, part.len, nullptr, nullptr));
+  frame_t unknown = make_frame(1, 0x2, 0x2, 0);
+  HT_CHECK(!c6_sync_rx_apply(&fresh_rx, C6_LINK_DELTA, unknown.b, unknown.len, nullptr, nullptr));
+  HT_CHECK(fresh_rx.stats.malformed == 1 && fresh_rx.valid == 0x1);
+
+  // Once out of sync, deltas are discarded until a keyframe arrives.
+  rx.synced = false;
+  frame_t next = make_frame(2, 0x1, 0x1, 0);
+  HT_CHECK(!c6_sync_rx_apply(&rx, C6_LINK_DELTA, next.b, next.len, nullptr, nullptr));
+  HT_CHECK(rx.stats.discarded == 1 && memcmp(rx.slot, good.slot, sizeof(rx.slot)) == 0);
+  key = make_frame(7, all, all, all);
+  HT_CHECK(c6_sync_rx_apply(&rx, C6_LINK_KEYFRAME, key.b, key.len, nullptr, nullptr));
+  next = make_frame(8, 0x1, 0x1, 0);
+  HT_CHECK(c6_sync_rx_apply(&rx, C6_LINK_DELTA, next.b, next.len, nullptr, nullptr));
+  HT_CHECK(rx.synced && rx.valid == all && rx.stats.malformed == malformed);
+
+  // Random bodies must never be applied as anything but a valid frame.
+  ht_rng_t rng = {4711};
+  frame_t junk;
+  for (int i = 0; i < 200000; ++i) {
+    junk.len = (uint16_t)rng.below(C6_LINK_MAX_BODY + 1);
+    for (uint16_t k = 0; k < junk.len; ++k) junk.b[k] = (uint8_t)rng.next();
+    c6_sync_rx_apply(&rx, rng.below(2) ? C6_LINK_KEYFRAME : C6_LINK_DELTA, junk.b, junk.len, nullptr, nullptr);
+  }
+  HT_CHECK((rx.valid & ~all) == 0);
+}
+
+int main() {
+  check_run(0, false, 1);
+  check_run(10, false, 2);
+  check_run(10, false, 3);
+  check_run(10, true, 4);
+  test_malformed();
+  return ht_finish("c6_sync_loss_test");
+}
@@ -0,0 +1,200 @@
+// chart_cache: lookups of stored chart windows. Every column carries its
+// absolute column number, so a hit can be checked column by column. Checks
+//   - a window shifted by k columns reuses the first settled - k of them,
+//     and a shift past the settled columns (or backwards) misses
+//   - an entry taken under a clock offset more than
+//     CHART_CACHE_CLOCK_SLACK_MS away is dropped
+//   - the least recently used entry is the one evicted
+//   - lookups, hits, misses, reused/edge columns, evictions and entries
+//     match every call
+
+#include "host_test.h"
+#include "chart_cache.h"
+
+#include <string.h>
+
+static const uint16_t k_columns = 720;
+
+static history_bucket_t s_in[k_columns + 1];
+static history_bucket_t s_out[k_columns];
+
+static chart_cache_key_t key(uint32_t span_s, uint16_t columns = k_columns, uint8_t sig = 1, int8_t tier = 0) {
+  chart_cache_key_t k = {};
+  k.sig = sig;
+  k.tier = tier;
+  k.columns = columns;
+  k.span_s = span_s;
+  return k;
+}
+
+// A window starting at absolute column `first_col`.
+static void put(const chart_cache_key_t& k, int64_t first_col, uint16_t settled, int64_t clock_off_ms = 0,
+                uint8_t stage = 1) {
+  for (uint16_t c = 0; c < k.columns; ++c) {
+    const float v = (float)(first_col + c);
+    s_in[c] = {v, v + 0.5f, v + 0.25f, (uint16_t)(1 + c % 100)};
+  }
+  chart_cache_put(&k, first_col, settled, clock_off_ms, stage, s_in);
+}
+
+// Looks up `k` at `first_col` and expects `want` columns back, each the
+// stored column of the same absolute number, with the counters moving by
+// exactly this one lookup.
+static void get(const chart_cache_key_t& k, int64_t first_col, uint16_t want, int64_t clock_off_ms = 0,
+                uint8_t want_stage = 1) {
+  chart_cache_stats_t a, b;
+  chart_cache_get_stats(&a);
+  memset(s_out, 0xA5, sizeof(s_out));
+  uint8_t stage = 0xFF;
+  const uint16_t n = chart_cache_get(&k, first_col, clock_off_ms, s_out, &stage);
+  chart_cache_get_stats(&b);
+  HT_CHECK_MSG(n == want, "span %u at column %lld: %u columns, want %u", (unsigned)k.span_s, (long long)first_col,
+               (unsigned)n, (unsigned)want);
+  for (uint16_t c = 0; c < n && c < want; ++c) {
+    const float v = (float)(first_col + c);
+    if (s_out[c].min != v || s_out[c].max != v + 0.5f || s_out[c].last != v + 0.25f) {
+      HT_CHECK_MSG(false, "column %u holds absolute column %.0f, want %.0f", (unsigned)c, s_out[c].min, v);
+      break;
+    }
+  }
+  if (n) HT_CHECK(stage == want_stage);
+  HT_CHECK(b.lookups == a.lookups + 1);
+  HT_CHECK(b.hits == a.hits + (n ? 1 : 0));
+  HT_CHECK(b.misses == a.misses + (n ? 0 : 1));
+  HT_CHECK(b.reused_columns == a.reused_columns + n);
+  HT_CHECK(b.edge_columns == a.edge_columns + (n ? k.columns - n : 0));
+  HT_CHECK(b.evictions == a.evictions);
+}
+
+static uint16_t entries_used(void) {
+  chart_cache_stats_t s;
+  chart_cache_get_stats(&s);
+  return s.entries_used;
+}
+
+static uint32_t evictions(void) {
+  chart_cache_stats_t s;
+  chart_cache_get_stats(&s);
+  return s.evictions;
+}
+
+static void test_shift(void) {
+  chart_cache_clear();
+  const chart_cache_key_t k = key(6 * 3600);
+  get(k, 1000, 0);
+  put(k, 1000, 700, 0, 2);
+  HT_CHECK(entries_used() == 1);
+
+  static const uint16_t k_shifts[] = {0, 1, 2, 5, 60, 350, 698, 699};
+  for (uint16_t s : k_shifts) get(k, 1000 + s, (uint16_t)(700 - s), 0, 2);
+  // Nothing settled is left in the window, or it moved backwards.
+  get(k, 1000 + 700, 0);
+  get(k, 1000 + 701, 0);
+  get(k, 1000 + 100000, 0);
+  HT_CHECK(entries_used() == 1);
+  get(k, 1000, 700, 0, 2);
+  get(k, 999, 0);
+  HT_CHECK(entries_used() == 0);
+  get(k, 1000, 0);
+
+  // A fully settled window is reused whole; settled is capped at columns.
+  put(k, 5000, k_columns + 10);
+  get(k, 5000, k_columns);
+  get(k, 5003, k_columns - 3);
+
+  // Re-storing a key replaces its entry.
+  put(k, 6000, 10);
+  HT_CHECK(entries_used() == 1);
+  get(k, 6004, 6);
+
+  // Other keys miss; empty and oversized windows are not stored.
+  get(key(6 * 3600, k_columns, 2), 6000, 0);
+  get(key(6 * 3600, k_columns, 1, 1), 6000, 0);
+  get(key(6 * 3600, 360), 6000, 0);
+  get(key(12 * 3600), 6000, 0);
+  put(key(24 * 3600), 6000, 0);
+  get(key(24 * 3600), 6000, 0);
+  put(key(24 * 3600, k_columns + 1), 6000, 5);
+  get(key(24 * 3600, k_columns + 1), 6000, 0);
+  HT_CHECK(entries_used() == 1);
+}
+
+static void test_clock(void) {
+  chart_cache_clear();
+  const chart_cache_key_t k = key(12 * 3600);
+  const int64_t off = 1700000000000LL;
+  put(k, 100, 500, off);
+  get(k, 100, 500, off + CHART_CACHE_CLOCK_SLACK_MS);
+  get(k, 101, 499, off - CHART_CACHE_CLOCK_SLACK_MS);
+  get(k, 100, 0, off + CHART_CACHE_CLOCK_SLACK_MS + 1);
+  HT_CHECK(entries_used() == 0);
+  get(k, 100, 0, off);   // dropped, not just skipped
+
+  put(k, 100, 500, off);
+  get(k, 100, 0, off - CHART_CACHE_CLOCK_SLACK_MS - 1);
+  get(k, 100, 0, off);
+  // Clock set for the first time: a huge step.
+  put(k, 100, 500, 0);
+  get(k, 100, 0, off);
+  HT_CHECK(entries_used() == 0);
+}
+
+static void test_lru(void) {
+  chart_cache_clear();
+  HT_CHECK(entries_used() == 0);
+  const uint32_t ev0 = evictions();
+  for (uint32_t i = 0; i < CHART_CACHE_ENTRIES; ++i) put(key(3600 * (i + 1)), 10 * i, 50);
+  HT_CHECK(entries_used() == CHART_CACHE_ENTRIES);
+  HT_CHECK(evictions() == ev0);
+
+  // Use every entry except 3, oldest first, so 3 is least recent.
+  for (uint32_t i = 0; i < CHART_CACHE_ENTRIES; ++i) {
+    if (i != 3) get(key(3600 * (i + 1)), 10 * i, 50);
+  }
+  put(key(3600 * 100), 0, 50);
+  HT_CHECK(evictions() == ev0 + 1);
+  HT_CHECK(entries_used() == CHART_CACHE_ENTRIES);
+  get(key(3600 * 4), 30, 0);
+  get(key(3600 * 100), 0, 50);
+
+  // Now entry 0 is the oldest; a put refreshes like a hit does.
+  put(key(3600 * 1), 0, 50);
+  put(key(3600 * 101), 0, 50);
+  HT_CHECK(evictions() == ev0 + 2);
+  get(key(3600 * 1), 0, 50);
+  get(key(3600 * 2), 10, 0);
+
+  // A run of new keys replaces the cache in use order.
+  for (uint32_t i = 0; i < CHART_CACHE_ENTRIES; ++i) put(key(3600 * (200 + i)), 0, 50);
+  HT_CHECK(evictions() == ev0 + 2 + CHART_CACHE_ENTRIES);
+  for (uint32_t i = 0; i < CHART_CACHE_ENTRIES; ++i) get(key(3600 * (200 + i)), 0, 50);
+  get(key(3600 * 1), 0, 0);
+
+  chart_cache_clear();
+  HT_CHECK(entries_used() == 0);
+  get(key(3600 * 200), 0, 0);
+}
+
+int main() {
+  // Before init nothing is stored or counted.
+  const chart_cache_key_t k = key(3600);
+  put(k, 0, 50);
+  HT_CHECK(chart_cache_get(&k, 0, 0, s_out, nullptr) == 0);
+  chart_cache_stats_t s;
+  chart_cache_get_stats(&s);
+  HT_CHECK(s.lookups == 0 && s.entries_used == 0 && s.bytes == 0);
+
+  HT_CHECK(chart_cache_init(k_columns));
+  HT_CHECK(chart_cache_init(k_columns));
+  chart_cache_get_stats(&s);
+  HT_CHECK(s.bytes == CHART_CACHE_ENTRIES * k_columns * sizeof(history_bucket_t));
+
+  test_shift();
+  test_clock();
+  test_lru();
+
+  chart_cache_get_stats(&s);
+  printf("chart_cache_test: %u lookups, %u hits, %u evictions, %u reused / %u edge columns\n", (unsigned)s.lookups,
+         (unsigned)s.hits, (unsigned)s.evictions, (unsigned)s.reused_columns, (unsigned)s.edge_columns);
+  return ht_finish("chart_cache_test");
+}
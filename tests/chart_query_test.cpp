@@ -0,0 +1,214 @@
+// chart_query: the worker answering chart windows in stages while this
+// thread polls like the UI timer. A day of 1 Hz RPM rollups sits on the
+// simulated SD card (with read latency, so scans take a while) and the last
+// 30 minutes are in RAM history. Checks that
+//   - the RAM stage is the first result of a request
+//   - SD stages follow coarse to fine, and only the target tier's result
+//     is final
+//   - a superseded request stops publishing and the new one is answered
+//     right away
+//   - chart_query_poll() never returns a result for an older request
+
+#include "host_test.h"
+#include "chart_cache.h"
+#include "chart_query.h"
+#include "log_rollup.h"
+#include "log_storage.h"
+#include "platform.h"
+
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+static const char* k_root = "chart_query_sd";
+static const uint32_t k_sd_hours = 26;
+static const uint32_t k_ram_minutes = 30;
+
+struct seen_t {
+  uint8_t  stage;
+  int8_t   tier;
+  bool     partial;
+  bool     final;
+  uint16_t filled;
+  uint32_t elapsed_ms;
+};
+
+// Polls until the final result for `id`. Every result must belong to it.
+static std::vector<seen_t> follow(uint16_t id) {
+  std::vector<seen_t> seen;
+  const uint32_t t0 = plat_millis();
+  while (plat_millis() - t0 < 20000) {
+    const chart_query_result_t* r = chart_query_poll();
+    if (!r) {
+      std::this_thread::yield();
+      continue;
+    }
+    HT_CHECK_MSG(r->id == id, "poll returned request %u while waiting for %u", (unsigned)r->id, (unsigned)id);
+    seen.push_back({r->stage, r->tier, r->partial, r->final, r->filled, r->elapsed_ms});
+    if (r->final) return seen;
+  }
+  HT_CHECK_MSG(false, "request %u: no final result after 20 s", (unsigned)id);
+  return seen;
+}
+
+static int target_tier(uint32_t span_s, uint16_t columns) {
+  const int64_t col_ms = (int64_t)span_s * 1000 / columns;
+  return log_rollup_pick_tier(col_ms * columns, columns);
+}
+
+// Stage order for one window that is not cached yet.
+static void test_stages(uint32_t hours, uint16_t columns) {
+  const uint32_t span_s = hours * 3600;
+  const int target = target_tier(span_s, columns);
+  HT_CHECK(target >= 0);
+  const std::vector<seen_t> seen = follow(chart_query_request(SIG_RPM, span_s, columns));
+  if (seen.empty()) return;
+
+  HT_CHECK_MSG(seen[0].stage == CHART_QUERY_RAM && !seen[0].partial && !seen[0].final && seen[0].filled > 0,
+               "%uh: first result stage %u", (unsigned)hours, (unsigned)seen[0].stage);
+  int tier = LOG_ROLLUP_TIERS;      // last complete tier
+  int scanning = LOG_ROLLUP_TIERS;  // tier of the last partial result
+  std::vector<int> complete;
+  for (size_t i = 1; i < seen.size(); ++i) {
+    const seen_t& s = seen[i];
+    HT_CHECK_MSG(s.stage == CHART_QUERY_ROLLUP, "%uh: result %u has stage %u", (unsigned)hours, (unsigned)i,
+                 (unsigned)s.stage);
+    HT_CHECK(s.elapsed_ms >= seen[i - 1].elapsed_ms);
+    if (s.partial) {
+      HT_CHECK_MSG(s.tier < tier && s.tier <= scanning && !s.final, "%uh: partial tier %d after tier %d",
+                   (unsigned)hours, s.tier, tier);
+      scanning = s.tier;
+      continue;
+    }
+    HT_CHECK_MSG(s.tier < tier && s.tier >= target, "%uh: tier %d after tier %d (target %d)", (unsigned)hours,
+                 s.tier, tier, target);
+    HT_CHECK_MSG(s.final == (s.tier == target), "%uh: tier %d final=%d, target %d", (unsigned)hours, s.tier,
+                 (int)s.final, target);
+    tier = s.tier;
+    complete.push_back(s.tier);
+  }
+  // Reads sleep, so this thread sees every complete stage.
+  HT_CHECK_MSG(complete.size() == (size_t)(LOG_ROLLUP_TIERS - target), "%uh: %u complete SD stages for target %d",
+               (unsigned)hours, (unsigned)complete.size(), target);
+  // The newest column may not have a sample yet.
+  HT_CHECK_MSG(seen.back().final && seen.back().filled + 1 >= columns, "%uh: final result fills %u of %u columns",
+               (unsigned)hours, (unsigned)seen.back().filled, (unsigned)columns);
+
+  // No more results once the final one is out.
+  plat_delay_ms(50);
+  HT_CHECK(chart_query_poll() == nullptr);
+  printf("chart_query_test: %2uh: %u results, RAM after %u ms, final tier %s after %u ms\n", (unsigned)hours,
+         (unsigned)seen.size(), (unsigned)seen[0].elapsed_ms,
+         k_log_rollup_tiers[seen.back().tier < 0 ? 0 : seen.back().tier].name, (unsigned)seen.back().elapsed_ms);
+}
+
+// A slow 24h request, superseded in the middle of its 1 min tier scan.
+// Column counts differ from the earlier windows, so neither is a cache hit.
+static void test_supersede(void) {
+  // Bucket reads (1.5 KB) take 24 ms, binary-search probes well under 1 ms.
+  log_storage_set_read_latency(0, 16000);
+  chart_query_stats_t before;
+  chart_query_get_stats(&before);
+
+  const uint16_t slow = chart_query_request(SIG_RPM, 24 * 3600, 719);
+  const uint32_t t0 = plat_millis();
+  bool coarse = false;   // the 10 min stage is out, the 1 min scan has begun
+  while (!coarse && plat_millis() - t0 < 5000) {
+    const chart_query_result_t* r = chart_query_poll();
+    if (!r) {
+      std::this_thread::yield();
+      continue;
+    }
+    HT_CHECK(r->id == slow && !r->final);
+    coarse = r->stage == CHART_QUERY_ROLLUP && r->tier == LOG_ROLLUP_TIERS - 1 && !r->partial;
+  }
+  HT_CHECK(coarse);
+  plat_delay_ms(100);   // a few reads into the 1 min tier
+
+  chart_query_stats_t mid;
+  chart_query_get_stats(&mid);
+  const uint32_t t_new = plat_millis();
+  const std::vector<seen_t> seen = follow(chart_query_request(SIG_RPM, 6 * 3600, 721));
+  HT_CHECK(!seen.empty() && seen[0].stage == CHART_QUERY_RAM);
+  // The worker leaves the old scan after the read in flight, not at the end
+  // of the tier (20+ reads).
+  HT_CHECK_MSG(!seen.empty() && seen[0].elapsed_ms < 100, "first result of the new request after %u ms",
+               seen.empty() ? 0u : (unsigned)seen[0].elapsed_ms);
+
+  chart_query_stats_t after;
+  chart_query_get_stats(&after);
+  HT_CHECK(after.superseded == before.superseded + 1);
+  // The superseded request published nothing more, and nothing publishes
+  // once the new one is final.
+  HT_CHECK_MSG(after.results - mid.results >= seen.size(), "%u results since the new request, %u seen",
+               (unsigned)(after.results - mid.results), (unsigned)seen.size());
+  plat_delay_ms(100);
+  chart_query_stats_t idle;
+  chart_query_get_stats(&idle);
+  HT_CHECK(idle.results == after.results);
+  HT_CHECK(chart_query_poll() == nullptr);
+  printf("chart_query_test: superseded after %u ms, new request first result after %u ms, final after %u ms\n",
+         (unsigned)(t_new - t0), seen.empty() ? 0u : (unsigned)seen[0].elapsed_ms,
+         seen.empty() ? 0u : (unsigned)seen.back().elapsed_ms);
+  log_storage_set_read_latency(300, 200);
+}
+
+// Requests faster than the worker can answer, cache hits among them:
+// whatever poll returns is for the newest one.
+static void test_no_stale_ids(void) {
+  static const uint32_t k_hours[] = {3, 6, 12, 24};
+  ht_rng_t rng = {2024};
+  uint32_t returned = 0;
+  uint16_t id = 0;
+  for (int i = 0; i < 400 && !ht_bail(); ++i) {
+    const signal_id_t sig = rng.below(3) ? SIG_RPM : SIG_SOG;
+    id = chart_query_request(sig, k_hours[rng.below(4)] * 3600, (uint16_t)(100 + 100 * rng.below(7)));
+    const uint32_t polls = rng.below(50);
+    for (uint32_t p = 0; p < polls; ++p) {
+      if (const chart_query_result_t* r = chart_query_poll()) {
+        ++returned;
+        HT_CHECK_MSG(r->id == id, "poll returned request %u, newest is %u", (unsigned)r->id, (unsigned)id);
+      }
+      if (rng.below(8) == 0) plat_delay_ms(1);
+    }
+  }
+  const std::vector<seen_t> last = follow(id);
+  HT_CHECK(!last.empty() && last.back().final);
+  chart_query_stats_t s;
+  chart_query_get_stats(&s);
+  chart_cache_stats_t cs;
+  chart_cache_get_stats(&cs);
+  printf("chart_query_test: 400 overlapping requests, %u results returned, %u superseded, %u cache hits\n",
+         (unsigned)returned, (unsigned)s.superseded, (unsigned)cs.hits);
+}
+
+int main() {
+  char cmd[128];
+  snprintf(cmd, sizeof(cmd), "rm -rf %s && mkdir -p %s", k_root, k_root);
+  if (system(cmd) != 0) return 1;
+  log_storage_set_root(k_root);
+  if (!log_storage_begin() || !signal_history_init()) return 1;
+
+  // SD: rollups of 1 Hz RPM samples up to a few minutes ago.
+  const int64_t now_utc = plat_utc_ms();
+  for (int64_t t = now_utc - (int64_t)k_sd_hours * 3600000; t < now_utc - 300000; t += 1000) {
+    log_rollup_add(SIG_RPM, t, 1500.0f + (float)(t / 1000 % 600));
+  }
+  log_rollup_tick(now_utc + 3600000);
+  log_rollup_sync();
+
+  // RAM: the last k_ram_minutes of history.
+  const uint32_t now_ms = plat_millis();
+  const uint32_t period = k_signal_meta[SIG_RPM].hist_period_ms;
+  for (uint32_t t = k_ram_minutes * 60000; t >= period; t -= period) {
+    signal_history_record(SIG_RPM, 2000.0f + (float)(t % 7000) / 20.0f, now_ms - t);
+  }
+
+  if (!chart_query_start()) return 1;
+  log_storage_set_read_latency(300, 200);   // roughly a 4-bit SDMMC card behind FATFS
+  test_stages(6, 720);
+  test_stages(24, 720);
+  test_supersede();
+  test_no_stale_ids();
+  return ht_finish("chart_query_test");
+}
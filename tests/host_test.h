@@ -0,0 +1,54 @@
+#pragma once
+
+// Minimal checks for the host tests in this directory. Each test is one
+// executable built by run_host_tests.sh; it prints every failed check and
+// exits non-zero if there was one.
+
+#include <stdint.h>
+#include <stdio.h>
+
+static int g_host_test_failures = 0;
+
+#define HT_CHECK(cond)                                                        \
+  do {                                                                        \
+    if (!(cond)) {                                                            \
+      ++g_host_test_failures;                                                 \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    }                                                                         \
+  } while (0)
+
+#define HT_CHECK_MSG(cond, ...)                                               \
+  do {                                                                        \
+    if (!(cond)) {                                                            \
+      ++g_host_test_failures;                                                 \
+      fprintf(stderr, "%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond); \
+      fprintf(stderr, __VA_ARGS__);                                           \
+      fputc('\n', stderr);                                                    \
+    }                                                                         \
+  } while (0)
+
+// Stops after this many failures so a broken invariant does not flood the log.
+#define HT_BAIL_AFTER 20
+
+static inline bool ht_bail(void) { return g_host_test_failures >= HT_BAIL_AFTER; }
+
+static inline int ht_finish(const char* name) {
+  if (g_host_test_failures) {
+    fprintf(stderr, "%s: %d check(s) failed\n", name, g_host_test_failures);
+    return 1;
+  }
+  printf("%s: ok\n", name);
+  return 0;
+}
+
+// Deterministic PRNG (xorshift32) so failures reproduce from the seed.
+struct ht_rng_t {
+  uint32_t s;
+  uint32_t next() {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+  }
+  uint32_t below(uint32_t n) { return n ? next() % n : 0; }
+};
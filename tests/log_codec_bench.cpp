@@ -0,0 +1,12 @@
+// Host driver for log_codec_benchmark(): encodes a synthetic voyage with the
+// raw and delta-of-delta codecs and prints size, ratio and throughput.
+//   log_codec_bench [hours]      default: 24
+
+#include "log_codec.h"
+
+#include <stdlib.h>
+
+int main(int argc, char** argv) {
+  log_codec_benchmark(argc > 1 ? (uint32_t)atoi(argv[1]) : 24);
+  return 0;
+}
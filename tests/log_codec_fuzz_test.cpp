@@ -0,0 +1,145 @@
+// log_codec: random records round-trip through both block codecs, then
+// mutated and fully random blocks go through log_block_decode(). Blocks and
+// output arrays are exactly sized heap buffers so ASan flags any access past
+// the payload or past `max` records.
+
+#include "host_test.h"
+#include "log_codec.h"
+
+#include <math.h>
+#include <string.h>
+
+static const size_t k_payload = LOG_BLOCK_PAYLOAD;
+
+static float random_value(ht_rng_t* rng) {
+  switch (rng->below(16)) {
+    case 0: return NAN;
+    case 1: return INFINITY;
+    case 2: return 3.0e38f;   // out of fixed-point range
+    case 3: {
+      uint32_t bits = rng->next();
+      float f;
+      memcpy(&f, &bits, sizeof(f));
+      return f;
+    }
+    default: return (float)((int32_t)rng->below(200000) - 100000) / 10.0f;
+  }
+}
+
+static log_record_t random_record(ht_rng_t* rng, uint32_t* t_ms) {
+  log_record_t r = {};
+  *t_ms += rng->below(8) == 0 ? rng->next() : rng->below(2000);
+  r.t_ms = *t_ms;
+  r.value = random_value(rng);
+  r.sig = (uint8_t)rng->below(32);   // includes ids past SIG_COUNT
+  r.quality = (uint8_t)rng->below(4);
+  r.src = (uint8_t)(rng->below(4) ? 10 + rng->below(3) : rng->next());
+  return r;
+}
+
+// What a record decodes to: fixed-point values come back at the signal's
+// resolution, anything else bit-exact.
+static bool same_record(const log_record_t& in, const log_record_t& out, uint8_t codec) {
+  if (codec == LOG_CODEC_RAW) return memcmp(&in, &out, sizeof(in)) == 0;
+  if (in.t_ms != out.t_ms || in.sig != out.sig || in.quality != out.quality || in.src != out.src) return false;
+  if (in.sig < SIG_COUNT && isfinite(in.value)) {
+    const float f = roundf(in.value * k_signal_meta[in.sig].fixed_scale);
+    if (fabsf(f) < 2147483520.0f) return out.value == (float)(int32_t)f / k_signal_meta[in.sig].fixed_scale;
+  }
+  return memcmp(&in.value, &out.value, sizeof(float)) == 0;
+}
+
+// Fills `block` with as many records as fit; returns the count.
+static uint16_t encode_block(ht_rng_t* rng, uint8_t codec, uint8_t* block, log_record_t* in) {
+  memset(block, 0, LOG_BLOCK_BYTES);
+  log_block_header_t* h = (log_block_header_t*)block;
+  uint32_t t_ms = rng->next();
+  const uint32_t base_ms = t_ms;
+  log_encoder_t e;
+  log_encoder_reset(&e, codec, base_ms);
+  const uint16_t want = (uint16_t)(1 + rng->below(rng->below(4) ? 60 : LOG_CODEC_MAX_RECORDS));
+  while (e.count < want) {
+    const log_record_t r = random_record(rng, &t_ms);
+    if (!log_encoder_append(&e, block + sizeof(log_block_header_t), (uint16_t)k_payload, &r)) break;
+    in[e.count - 1] = r;
+  }
+  h->magic = LOG_BLOCK_MAGIC;
+  h->version = LOG_FORMAT_VERSION;
+  h->codec = codec;
+  h->base_ms = base_ms;
+  h->count = e.count;
+  h->payload_bytes = e.bytes;
+  return e.count;
+}
+
+static int decode_bounded(const uint8_t* block, uint16_t max) {
+  log_record_t* out = new log_record_t[max ? max : 1];
+  const int n = log_block_decode(block, out, max);
+  delete[] out;
+  return n;
+}
+
+int main() {
+  uint8_t* block = new uint8_t[LOG_BLOCK_BYTES];
+  log_record_t* in = new log_record_t[LOG_CODEC_MAX_RECORDS];
+  log_record_t* out = new log_record_t[LOG_CODEC_MAX_RECORDS];
+  ht_rng_t rng = {2024};
+  uint32_t round_trips = 0, mutants = 0, accepted = 0;
+
+  for (int it = 0; it < 20000 && !ht_bail(); ++it) {
+    const uint8_t codec = (uint8_t)(it & 1);
+    const uint16_t n = encode_block(&rng, codec, block, in);
+    HT_CHECK(n > 0);
+    const int got = log_block_decode(block, out, LOG_CODEC_MAX_RECORDS);
+    HT_CHECK_MSG(got == n, "codec %u: decoded %d of %u", (unsigned)codec, got, (unsigned)n);
+    for (int i = 0; i < got && i < n; ++i) {
+      HT_CHECK_MSG(same_record(in[i], out[i], codec), "codec %u record %d sig %u differs", (unsigned)codec, i,
+                   (unsigned)in[i].sig);
+    }
+    ++round_trips;
+
+    // Too small an output array is refused, never overrun.
+    if (n > 1) HT_CHECK(decode_bounded(block, (uint16_t)rng.below(n)) == -1);
+
+    // Mutations of a valid block: flipped payload bytes, wrong counts and
+    // lengths, truncation, an unknown codec.
+    log_block_header_t* h = (log_block_header_t*)block;
+    for (int m = 0; m < 8; ++m) {
+      switch (rng.below(5)) {
+        case 0:
+          if (h->payload_bytes) block[sizeof(log_block_header_t) + rng.below(h->payload_bytes)] ^= (uint8_t)(1 + rng.below(255));
+          break;
+        case 1: h->count = (uint16_t)rng.below(h->count + 8); break;
+        case 2: h->payload_bytes = (uint16_t)rng.below(k_payload + 1); break;
+        case 3: h->payload_bytes = (uint16_t)(h->payload_bytes ? rng.below(h->payload_bytes) : 0); break;
+        case 4: h->codec = (uint8_t)rng.below(4); break;
+      }
+      const uint16_t max = (uint16_t)(rng.below(2) ? LOG_CODEC_MAX_RECORDS : rng.below(LOG_CODEC_MAX_RECORDS + 1));
+      const int r = decode_bounded(block, max);
+      HT_CHECK(r == -1 || (r == h->count && r <= max));
+      accepted += r >= 0;
+      ++mutants;
+    }
+  }
+
+  // Headers and payloads of random bytes.
+  for (int it = 0; it < 200000 && !ht_bail(); ++it) {
+    for (size_t i = 0; i < LOG_BLOCK_BYTES; ++i) block[i] = (uint8_t)rng.next();
+    log_block_header_t* h = (log_block_header_t*)block;
+    h->codec = (uint8_t)rng.below(3);
+    h->payload_bytes = (uint16_t)rng.below(k_payload + 1);
+    h->count = (uint16_t)rng.below(it % 2 ? 50 : 2000);
+    const uint16_t max = (uint16_t)rng.below(LOG_CODEC_MAX_RECORDS + 1);
+    const int r = decode_bounded(block, max);
+    HT_CHECK(r == -1 || (r == h->count && r <= max));
+    accepted += r >= 0;
+    ++mutants;
+  }
+
+  printf("log_codec_fuzz_test: %u round trips, %u corrupt blocks (%u decoded)\n", (unsigned)round_trips,
+         (unsigned)mutants, (unsigned)accepted);
+  delete[] out;
+  delete[] in;
+  delete[] block;
+  return ht_finish("log_codec_fuzz_test");
+}
@@ -0,0 +1,125 @@
+// log_ingest under a 100% bus-load burst: quiet N2K traffic with a burst in
+// the middle 60% of the run where every frame on a saturated 250 kbit/s bus
+// decodes to one record, against a consumer with periodic SD stalls. The
+// same traffic goes through the priority queue and through a plain FIFO of
+// the same depth. The queue must log every critical record, in order; the
+// FIFO must lose some, or the load is too light to show anything.
+
+#include "host_test.h"
+#include "log_ingest.h"
+#include "log_writer.h"
+#include "spsc_ring.h"
+
+#include <math.h>
+#include <string.h>
+
+// 29-bit frame with 8 data bytes is ~128 bits on the wire after stuffing.
+static constexpr uint32_t k_bus_frames_per_s = 250000 / 128;
+static constexpr uint32_t k_stall_every_ms = 2000;
+static constexpr uint32_t k_stall_ms = 400;
+static constexpr uint32_t k_seconds = 60;
+static constexpr uint32_t k_drain_per_s = 1000;
+
+struct sim_result_t {
+  uint32_t generated[SIG_CLASS_COUNT];
+  uint32_t received[SIG_CLASS_COUNT];
+  uint32_t out_of_order;
+  uint32_t max_lag_ms;       // push-to-pop delay of the oldest record
+};
+
+static spsc_ring<log_record_t, LOG_QUEUE_DEPTH> s_fifo;   // baseline: one plain ring
+
+static bool fifo_push(const log_record_t* r) { return s_fifo.push(*r); }
+static bool fifo_pop(log_record_t* r) { return s_fifo.pop(r); }
+
+// Quiet traffic at typical N2K transmit rates plus the burst, a quarter of
+// it critical. The consumer stalls like an SD card in a long write.
+static void simulate(bool (*push)(const log_record_t*), bool (*pop)(log_record_t*), sim_result_t* res) {
+  static const float k_rate_hz[SIG_COUNT] = {10, 2, 1, 5, 10, 0.1f, 1, 2, 1, 2, 2, 0.5f, 1, 1};
+  static const uint8_t k_burst_mix[] = {
+    SIG_RPM, SIG_SOG, SIG_COG, SIG_STW, SIG_WIND_SPEED, SIG_WIND_ANGLE, SIG_PACK_CURRENT,
+    SIG_HEADING, SIG_LAT, SIG_LON, SIG_SOG, SIG_SOC, SIG_COG, SIG_XTE, SIG_WIND_SPEED,
+    SIG_PACK_VOLTAGE, SIG_WIND_ANGLE, SIG_LAT, SIG_COOLANT_TEMP, SIG_LON,
+  };
+  memset(res, 0, sizeof(*res));
+  ht_rng_t rng = {2024};
+
+  const uint32_t end_ms = k_seconds * 1000;
+  const uint32_t burst_from = end_ms / 5, burst_to = end_ms - end_ms / 5;
+  double next_ms[SIG_COUNT] = {};
+  float value[SIG_COUNT] = {};
+  double burst_acc = 0, drain_acc = 0;
+  uint32_t mix_pos = 0, last_out_t = 0;
+
+  // Values wander by up to two display steps so the deadband has work to do.
+  auto emit = [&](uint8_t sig, uint32_t t) {
+    const float step = powf(10.0f, -(float)k_signal_meta[sig].decimals);
+    value[sig] += step * ((float)rng.below(4001) / 1000.0f - 2.0f);
+    const log_record_t r = {t, value[sig], sig, 1, 0x20, 0};
+    res->generated[k_signal_meta[sig].log_class]++;
+    push(&r);
+  };
+
+  for (uint32_t t = 0; t < end_ms + 5000; ++t) {
+    if (t < end_ms) {
+      for (uint8_t s = 0; s < SIG_COUNT; ++s) {
+        if (next_ms[s] > t) continue;
+        next_ms[s] += 1000.0 / k_rate_hz[s];
+        emit(s, t);
+      }
+      if (t >= burst_from && t < burst_to) {
+        for (burst_acc += k_bus_frames_per_s / 1000.0; burst_acc >= 1; burst_acc -= 1) {
+          emit(k_burst_mix[mix_pos++ % sizeof(k_burst_mix)], t);
+        }
+      }
+    }
+    if (t % k_stall_every_ms < k_stall_ms) continue;
+    for (drain_acc += k_drain_per_s / 1000.0; drain_acc >= 1; drain_acc -= 1) {
+      log_record_t r;
+      if (!pop(&r)) {
+        drain_acc = 0;
+        break;
+      }
+      res->received[k_signal_meta[r.sig].log_class]++;
+      if ((int32_t)(r.t_ms - last_out_t) < 0) res->out_of_order++;
+      last_out_t = r.t_ms;
+      if (t - r.t_ms > res->max_lag_ms) res->max_lag_ms = t - r.t_ms;
+    }
+  }
+}
+
+int main() {
+  static const char* const k_class_name[SIG_CLASS_COUNT] = {"critical", "normal", "bulk"};
+  sim_result_t fifo, prio;
+  simulate(fifo_push, fifo_pop, &fifo);
+  simulate(log_ingest_push, log_ingest_pop, &prio);
+
+  log_ingest_stats_t st;
+  log_ingest_get_stats(&st);
+  for (int c = 0; c < SIG_CLASS_COUNT; ++c) {
+    HT_CHECK(fifo.generated[c] == prio.generated[c]);
+    HT_CHECK(prio.received[c] == st.cls[c].accepted);
+    printf("log_ingest_load_test: %-8s generated %u | fifo logged %u lost %u | queue logged %u decimated %u "
+           "dropped %u\n",
+           k_class_name[c], (unsigned)prio.generated[c], (unsigned)fifo.received[c],
+           (unsigned)(fifo.generated[c] - fifo.received[c]), (unsigned)prio.received[c],
+           (unsigned)st.cls[c].decimated, (unsigned)st.cls[c].dropped);
+  }
+
+  const uint32_t crit = prio.generated[SIG_CLASS_CRITICAL];
+  HT_CHECK_MSG(prio.received[SIG_CLASS_CRITICAL] == crit, "queue lost %u of %u critical records",
+               (unsigned)(crit - prio.received[SIG_CLASS_CRITICAL]), (unsigned)crit);
+  HT_CHECK(st.cls[SIG_CLASS_CRITICAL].dropped == 0);
+  HT_CHECK_MSG(prio.out_of_order == 0, "%u records left out of order", (unsigned)prio.out_of_order);
+  HT_CHECK_MSG(fifo.received[SIG_CLASS_CRITICAL] < crit, "the plain FIFO lost no critical records");
+  // The burst must overflow the critical ring into the shared one, and the
+  // other classes must have been thinned to make room.
+  HT_CHECK(st.crit_spilled > 0);
+  HT_CHECK(st.cls[SIG_CLASS_BULK].decimated > 0 && st.cls[SIG_CLASS_NORMAL].decimated > 0);
+
+  printf("log_ingest_load_test: spilled %u, crit hw %u/%u, shared hw %u/%u, max lag %u ms (fifo %u ms)\n",
+         (unsigned)st.crit_spilled, (unsigned)st.crit_high_water, (unsigned)LOG_QUEUE_CRIT_DEPTH,
+         (unsigned)st.shared_high_water, (unsigned)LOG_QUEUE_DEPTH, (unsigned)prio.max_lag_ms,
+         (unsigned)fifo.max_lag_ms);
+  return ht_finish("log_ingest_load_test");
+}
@@ -0,0 +1,199 @@
+// SD log crash safety: the writer runs in a child process that loses power
+// on its k-th storage write (keeping a random prefix of that write), for
+// every k until a run completes without reaching it. A fresh process then
+// runs recovery, and a third one resumes logging. After each step every
+// segment must hold only whole valid blocks, every index entry must point
+// at one, every rollup record must be valid, and no byte covered by the
+// last journal commit may be lost.
+//
+// The wall clock is faked to run 8x, starting two seconds before midnight,
+// so cuts also land on the day rollover. run_host_tests.sh builds this with
+// short flush/sync intervals and small segments so each run is short and
+// still rotates segments.
+
+#include "host_test.h"
+#include "log_index.h"
+#include "log_journal.h"
+#include "log_rollup.h"
+#include "log_storage.h"
+#include "log_writer.h"
+#include "platform.h"
+
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static const char*   k_root = "power_cut_sd";
+static const int64_t k_midnight_s = 1792281600;   // 2026-10-18T00:00:00Z
+static const uint32_t k_max_writes = 2000;
+
+// plat_utc_ms() reads gettimeofday(); this definition takes precedence over
+// libc's in the test binary.
+static struct timespec s_clock_t0;
+
+extern "C" int gettimeofday(struct timeval* __restrict tv, void* __restrict) __THROW {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const int64_t real_us = (int64_t)(now.tv_sec - s_clock_t0.tv_sec) * 1000000 + (now.tv_nsec - s_clock_t0.tv_nsec) / 1000;
+  const int64_t us = (k_midnight_s - 2) * 1000000 + real_us * 8;
+  tv->tv_sec = (time_t)(us / 1000000);
+  tv->tv_usec = (suseconds_t)(us % 1000000);
+  return 0;
+}
+
+static int32_t file_size(const char* rel) {
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s", k_root, rel);
+  struct stat st;
+  return stat(path, &st) == 0 ? (int32_t)st.st_size : -1;
+}
+
+static FILE* open_rel(const char* rel) {
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s", k_root, rel);
+  return fopen(path, "rb");
+}
+
+// Checks both days of the run; returns the number of valid blocks.
+static uint32_t validate(int k, const char* step) {
+  uint32_t blocks = 0;
+  static uint8_t block[LOG_BLOCK_BYTES];
+  for (uint32_t day = k_midnight_s / 86400 - 1; day <= k_midnight_s / 86400; ++day) {
+    char name[9], rel[64];
+    log_day_name(name, day);
+    int32_t seg_bytes[100] = {};
+    for (uint8_t nn = 0; nn < 100; ++nn) {
+      log_segment_path(rel, sizeof(rel), name, nn);
+      const int32_t size = file_size(rel);
+      if (size < 0) break;
+      seg_bytes[nn] = size;
+      HT_CHECK_MSG(size % LOG_BLOCK_BYTES == 0, "cut %d %s: %s is %d bytes", k, step, rel, size);
+      FILE* f = open_rel(rel);
+      for (int32_t off = 0; f && fread(block, 1, LOG_BLOCK_BYTES, f) == LOG_BLOCK_BYTES; off += LOG_BLOCK_BYTES) {
+        HT_CHECK_MSG(log_block_valid(block), "cut %d %s: %s invalid block at %d", k, step, rel, off);
+        ++blocks;
+      }
+      if (f) fclose(f);
+    }
+
+    log_index_path(rel, sizeof(rel), name);
+    const int32_t idx_size = file_size(rel);
+    if (idx_size >= 0) {
+      HT_CHECK_MSG(idx_size % sizeof(log_index_entry_t) == 0, "cut %d %s: %s is %d bytes", k, step, rel, idx_size);
+      FILE* f = open_rel(rel);
+      log_index_entry_t e;
+      while (f && fread(&e, 1, sizeof(e), f) == sizeof(e)) {
+        HT_CHECK_MSG(log_index_entry_valid(&e) && e.seg < 100 && e.offset + LOG_BLOCK_BYTES <= (uint32_t)seg_bytes[e.seg],
+                     "cut %d %s: %s entry seg %u offset %u", k, step, rel, (unsigned)e.seg, (unsigned)e.offset);
+      }
+      if (f) fclose(f);
+    }
+
+    for (int t = 0; t < LOG_ROLLUP_TIERS; ++t) {
+      log_rollup_path(rel, sizeof(rel), day, t);
+      const int32_t size = file_size(rel);
+      if (size < 0) continue;
+      HT_CHECK_MSG(size % sizeof(log_rollup_bucket_t) == 0, "cut %d %s: %s is %d bytes", k, step, rel, size);
+      FILE* f = open_rel(rel);
+      log_rollup_bucket_t b;
+      while (f && fread(&b, 1, sizeof(b), f) == sizeof(b)) {
+        HT_CHECK_MSG(log_rollup_bucket_valid(&b), "cut %d %s: %s invalid bucket", k, step, rel);
+      }
+      if (f) fclose(f);
+    }
+  }
+  return blocks;
+}
+
+static void push_records(uint32_t n, uint32_t t_ms) {
+  for (uint32_t i = 0; i < n; ++i) {
+    const log_record_t r = {t_ms + i, (float)(i % 5000) * 0.5f, (uint8_t)(i % SIG_COUNT), 1, 0x10, 0};
+    log_writer_push(&r);
+  }
+}
+
+// Child: logs across midnight and loses power on write `cut_on`. Exits 0 if
+// the cut happened, 1 if the run finished first.
+static void run_writer(uint32_t cut_on, uint32_t keep) {
+  clock_gettime(CLOCK_MONOTONIC, &s_clock_t0);
+  log_storage_set_root(k_root);
+  if (!log_writer_start()) _exit(2);
+  log_storage_set_power_cut(cut_on, keep);
+  for (int step = 0; step < 30 && !log_storage_power_lost(); ++step) {
+    push_records(400, (uint32_t)step * 1000);
+    plat_delay_ms(25);
+  }
+  for (int i = 0; i < 40 && !log_storage_power_lost(); ++i) plat_delay_ms(10);
+  _exit(log_storage_power_lost() ? 0 : 1);
+}
+
+static void run_recovery(int fd) {
+  clock_gettime(CLOCK_MONOTONIC, &s_clock_t0);
+  log_storage_set_root(k_root);
+  log_storage_begin();
+  log_recovery_report_t rep;
+  log_recovery_run(&rep);
+  (void)!write(fd, &rep, sizeof(rep));
+  _exit(0);
+}
+
+static void run_resume(void) {
+  clock_gettime(CLOCK_MONOTONIC, &s_clock_t0);
+  log_storage_set_root(k_root);
+  if (!log_writer_start()) _exit(2);
+  push_records(2000, 50000);
+  plat_delay_ms(250);
+  _exit(0);
+}
+
+static int wait_child(pid_t pid) {
+  int st = 0;
+  waitpid(pid, &st, 0);
+  return WIFEXITED(st) ? WEXITSTATUS(st) : -1;
+}
+
+int main() {
+  ht_rng_t rng = {31337};
+  uint32_t max_recovery_us = 0, truncated = 0, k = 1;
+  for (; k <= k_max_writes && !ht_bail(); ++k) {
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s && mkdir -p %s", k_root, k_root);
+    if (system(cmd) != 0) return 1;
+
+    const uint32_t keep = rng.below(LOG_BATCH_BLOCKS * LOG_BLOCK_BYTES);
+    pid_t pid = fork();
+    if (!pid) run_writer(k, keep);
+    const int cut = wait_child(pid);
+    HT_CHECK_MSG(cut == 0 || cut == 1, "cut %u: writer exited with %d", (unsigned)k, cut);
+    if (cut == 1) break;   // past the last write of a full run
+
+    int fds[2];
+    if (pipe(fds) != 0) return 1;
+    pid = fork();
+    if (!pid) run_recovery(fds[1]);
+    close(fds[1]);
+    log_recovery_report_t rep = {};
+    HT_CHECK(read(fds[0], &rep, sizeof(rep)) == (ssize_t)sizeof(rep));
+    close(fds[0]);
+    wait_child(pid);
+    HT_CHECK_MSG(rep.lost_bytes == 0, "cut %u keep %u: %u committed bytes lost", (unsigned)k, (unsigned)keep,
+                 (unsigned)rep.lost_bytes);
+    if (rep.elapsed_us > max_recovery_us) max_recovery_us = rep.elapsed_us;
+    truncated += rep.truncated_bytes;
+    const uint32_t recovered = validate((int)k, "after recovery");
+
+    pid = fork();
+    if (!pid) run_resume();
+    HT_CHECK(wait_child(pid) == 0);
+    const uint32_t resumed = validate((int)k, "after resume");
+    HT_CHECK_MSG(resumed > recovered, "cut %u: resume wrote no blocks (%u)", (unsigned)k, (unsigned)resumed);
+  }
+  HT_CHECK_MSG(k <= k_max_writes, "a full run took more than %u writes", (unsigned)k_max_writes);
+
+  printf("log_power_cut_test: cut at each of %u writes, %u bytes truncated, recovery max %u us\n",
+         (unsigned)(k - 1), (unsigned)truncated, (unsigned)max_recovery_us);
+  return ht_finish("log_power_cut_test");
+}
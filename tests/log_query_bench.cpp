@@ -0,0 +1,17 @@
+// Host driver for log_query_benchmark(): writes synthetic logs under
+// query_bench_sd/ and prints cold and warm 1h/6h/24h RPM window reads and
+// chart decimation times.
+//   log_query_bench [days [rate_hz]]      defaults: 2 days at 20 records/s
+
+#include "log_query.h"
+#include "log_storage.h"
+
+#include <stdlib.h>
+
+int main(int argc, char** argv) {
+  const uint32_t days = argc > 1 ? (uint32_t)atoi(argv[1]) : 2;
+  const uint32_t rate_hz = argc > 2 ? (uint32_t)atoi(argv[2]) : 20;
+  log_storage_set_root("query_bench_sd");
+  log_query_benchmark(days, rate_hz);
+  return 0;
+}
@@ -0,0 +1,93 @@
+// n2k_decode: random payloads of every length for every handled PGN, each in
+// an exactly sized heap buffer so ASan flags any read past the message.
+// Every emitted value must be finite and belong to the PGN's signal set.
+
+#include "host_test.h"
+#include "n2k_decode.h"
+#include "n2k_fast_packet.h"
+
+#include <math.h>
+#include <string.h>
+
+struct sink_state_t {
+  const n2k_msg_t* msg;
+  uint32_t         allowed;
+  int              calls;
+};
+
+static void sink(signal_id_t sig, float value, const n2k_msg_t* msg, void* ctx) {
+  sink_state_t* st = (sink_state_t*)ctx;
+  ++st->calls;
+  HT_CHECK_MSG(sig < SIG_COUNT && (st->allowed >> sig & 1u), "pgn %u emitted signal %u",
+               (unsigned)st->msg->pgn, (unsigned)sig);
+  HT_CHECK_MSG(isfinite(value), "pgn %u signal %u: non-finite value", (unsigned)st->msg->pgn, (unsigned)sig);
+  HT_CHECK(msg == st->msg);
+}
+
+static void decode_one(uint32_t pgn, const uint8_t* bytes, uint8_t len) {
+  uint8_t* buf = new uint8_t[len ? len : 1];
+  memcpy(buf, bytes, len);
+  n2k_msg_t m = {};
+  m.pgn = pgn;
+  m.data = len ? buf : nullptr;
+  m.len = len;
+  sink_state_t st = {&m, n2k_decode_pgn_signals(pgn), 0};
+  const int r = n2k_decode(&m, sink, &st);
+  HT_CHECK_MSG(r == st.calls, "pgn %u len %u: returned %d for %d values", (unsigned)pgn, (unsigned)len, r, st.calls);
+  delete[] buf;
+}
+
+int main() {
+  HT_CHECK(n2k_decode_pgn_count() > 0);
+  uint8_t bytes[N2K_FP_MAX_LEN];
+  ht_rng_t rng = {0xC0FFEE};
+
+  for (uint16_t i = 0; i < n2k_decode_pgn_count() && !ht_bail(); ++i) {
+    const uint32_t pgn = n2k_decode_pgn_at(i);
+    HT_CHECK(n2k_decode_handles(pgn));
+    HT_CHECK(n2k_decode_pgn_signals(pgn) != 0);
+    for (int len = 0; len <= N2K_FP_MAX_LEN; ++len) {
+      // Sentinel-heavy payloads hit the NA/error paths, random ones the rest.
+      memset(bytes, 0xFF, sizeof(bytes));
+      decode_one(pgn, bytes, (uint8_t)len);
+      memset(bytes, 0x00, sizeof(bytes));
+      decode_one(pgn, bytes, (uint8_t)len);
+      for (int k = 0; k < 200; ++k) {
+        for (int j = 0; j < len; ++j) bytes[j] = (uint8_t)rng.next();
+        decode_one(pgn, bytes, (uint8_t)len);
+      }
+    }
+  }
+
+  // Random PGNs, handled or not.
+  for (int k = 0; k < 200000 && !ht_bail(); ++k) {
+    const uint32_t pgn = rng.below(0x20000) | (rng.below(2) ? 0x10000 : 0);
+    const uint8_t len = (uint8_t)rng.below(N2K_FP_MAX_LEN + 1);
+    for (int j = 0; j < len; ++j) bytes[j] = (uint8_t)rng.next();
+    n2k_msg_t m = {};
+    m.pgn = pgn;
+    m.data = bytes;
+    m.len = len;
+    sink_state_t st = {&m, n2k_decode_pgn_signals(pgn), 0};
+    const int r = n2k_decode(&m, sink, &st);
+    HT_CHECK(n2k_decode_handles(pgn) ? r == st.calls : r == -1 && st.calls == 0);
+  }
+
+  // One known vector: engine speed 8000 * 0.25 rpm on instance 0.
+  static const uint8_t rpm[] = {0x00, 0x40, 0x1F, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF};
+  n2k_msg_t m = {};
+  m.pgn = 127488;
+  m.data = rpm;
+  m.len = sizeof(rpm);
+  float got = 0;
+  const int r = n2k_decode(&m, [](signal_id_t sig, float v, const n2k_msg_t*, void* ctx) {
+    if (sig == SIG_RPM) *(float*)ctx = v;
+  }, &got);
+  HT_CHECK(r == 1 && got == 2000.0f);
+
+  n2k_decode_stats_t stats;
+  n2k_decode_get_stats(&stats);
+  printf("n2k_decode_fuzz_test: %u messages, %u values, %u NA, %u short\n", (unsigned)stats.messages,
+         (unsigned)stats.signals, (unsigned)stats.not_available, (unsigned)stats.short_payload);
+  return ht_finish("n2k_decode_fuzz_test");
+}
@@ -0,0 +1,233 @@
+// n2k_fast_packet: interleaved transfers from 40 sources, slot pool
+// exhaustion, timeout eviction and sequence restarts.
+
+#include "host_test.h"
+#include "n2k_fast_packet.h"
+
+#include <map>
+#include <string.h>
+#include <vector>
+
+static const uint32_t k_pgns[] = {129029, 127489, 129540, 126996};
+
+struct transfer_t {
+  uint8_t                  src;
+  uint32_t                 pgn;
+  uint8_t                  seq;
+  std::vector<uint8_t>     payload;
+  std::vector<can_frame_t> frames;
+  size_t                   next;
+};
+
+static std::map<uint64_t, std::vector<uint8_t>> s_expected;
+static uint32_t s_delivered = 0;
+
+static uint64_t key(uint8_t src, uint32_t pgn, uint8_t seq) {
+  return (uint64_t)src << 32 | (uint64_t)pgn << 3 | seq;
+}
+
+// Payload byte 0 carries the sequence id so a delivery maps to its transfer.
+static void on_msg(const n2k_msg_t* m, void*) {
+  if (!n2k_is_fast_packet(m->pgn)) return;
+  auto it = s_expected.find(key(m->src, m->pgn, m->data[0] & 7));
+  HT_CHECK_MSG(it != s_expected.end(), "unexpected delivery src %u pgn %u", (unsigned)m->src, (unsigned)m->pgn);
+  if (it == s_expected.end()) return;
+  HT_CHECK_MSG(it->second.size() == m->len && memcmp(it->second.data(), m->data, m->len) == 0,
+               "payload mismatch src %u pgn %u len %u", (unsigned)m->src, (unsigned)m->pgn, (unsigned)m->len);
+  s_expected.erase(it);
+  ++s_delivered;
+}
+
+static transfer_t make_transfer(ht_rng_t* rng, uint8_t src, uint32_t pgn, uint8_t seq, size_t len) {
+  transfer_t t = {src, pgn, seq, std::vector<uint8_t>(len), {}, 0};
+  for (uint8_t& b : t.payload) b = (uint8_t)rng->next();
+  t.payload[0] = (uint8_t)((t.payload[0] & ~7) | seq);
+  size_t off = 0;
+  for (uint8_t counter = 0; counter == 0 || off < len; ++counter) {
+    can_frame_t f = {};
+    f.id = n2k_make_id(pgn, 3, src, 255);
+    f.flags = CAN_FRAME_EXT;
+    f.dlc = 8;
+    memset(f.data, 0xFF, sizeof(f.data));
+    f.data[0] = (uint8_t)(seq << 5 | counter);
+    if (counter == 0) {
+      f.data[1] = (uint8_t)len;
+      const size_t n = len < 6 ? len : 6;
+      memcpy(&f.data[2], &t.payload[0], n);
+      off = n;
+    } else {
+      const size_t n = len - off < 7 ? len - off : 7;
+      memcpy(&f.data[1], &t.payload[off], n);
+      off += n;
+    }
+    t.frames.push_back(f);
+  }
+  return t;
+}
+
+static void feed(n2k_fp_t* fp, can_frame_t f, uint32_t t_us) {
+  f.t_us = t_us;
+  n2k_fp_feed(fp, &f);
+}
+
+// Up to N2K_FP_SLOTS - 8 transfers from 40 sources in flight at once, frames
+// picked at random, occasional repeated frames: every payload arrives intact.
+static void test_interleaved(void) {
+  static n2k_fp_t fp;
+  n2k_fp_init(&fp, on_msg, nullptr);
+  s_expected.clear();
+  s_delivered = 0;
+  ht_rng_t rng = {12345};
+  uint8_t seqs[40][4] = {};
+  std::vector<transfer_t> active;
+  uint32_t started = 0, dups = 0, t_us = 0;
+
+  for (int step = 0; step < 200000 && !ht_bail(); ++step) {
+    while (active.size() < N2K_FP_SLOTS - 8) {
+      const uint8_t src = (uint8_t)rng.below(40);
+      const uint8_t pi = (uint8_t)rng.below(4);
+      bool busy = false;
+      for (const transfer_t& a : active) busy |= a.src == src && a.pgn == k_pgns[pi];
+      if (busy) continue;
+      const uint8_t seq = (uint8_t)(seqs[src][pi]++ & 7);
+      active.push_back(make_transfer(&rng, src, k_pgns[pi], seq, 1 + rng.below(N2K_FP_MAX_LEN)));
+      s_expected[key(src, k_pgns[pi], seq)] = active.back().payload;
+      ++started;
+    }
+    const size_t k = rng.below((uint32_t)active.size());
+    transfer_t& t = active[k];
+    t_us += 400;
+    // A repeated final frame would legitimately start or orphan a packet.
+    if (t.next + 1 < t.frames.size() && rng.below(500) == 0) {
+      feed(&fp, t.frames[t.next], t_us);
+      ++dups;
+    }
+    feed(&fp, t.frames[t.next++], t_us);
+    if (t.next == t.frames.size()) active.erase(active.begin() + (long)k);
+  }
+
+  n2k_fp_stats_t st;
+  n2k_fp_get_stats(&fp, &st);
+  const uint32_t finished = started - (uint32_t)active.size();
+  HT_CHECK_MSG(s_delivered == finished, "delivered %u of %u", (unsigned)s_delivered, (unsigned)finished);
+  HT_CHECK(st.completed == finished);
+  HT_CHECK(st.duplicates == dups);
+  HT_CHECK(st.pool_exhausted == 0 && st.out_of_order == 0 && st.orphans == 0 && st.abandoned == 0);
+  HT_CHECK(st.in_flight == active.size());
+  HT_CHECK(st.in_flight_high_water <= N2K_FP_SLOTS - 8);
+}
+
+// More concurrent transfers than slots: the extra first frames are dropped
+// and counted, the rest of those transfers are orphans, and the transfers
+// that got a slot still complete.
+static void test_pool_exhaustion(void) {
+  static n2k_fp_t fp;
+  n2k_fp_init(&fp, on_msg, nullptr);
+  s_expected.clear();
+  s_delivered = 0;
+  ht_rng_t rng = {777};
+  const int extra = 8;
+  std::vector<transfer_t> ts;
+  for (int i = 0; i < N2K_FP_SLOTS + extra; ++i) {
+    ts.push_back(make_transfer(&rng, (uint8_t)(i / 4), k_pgns[i % 4], 1, 20));
+    if (i < N2K_FP_SLOTS) s_expected[key(ts.back().src, ts.back().pgn, 1)] = ts.back().payload;
+  }
+  uint32_t t_us = 1000;
+  for (transfer_t& t : ts) feed(&fp, t.frames[0], t_us += 100);
+  n2k_fp_stats_t st;
+  n2k_fp_get_stats(&fp, &st);
+  HT_CHECK(st.pool_exhausted == (uint32_t)extra);
+  HT_CHECK(st.in_flight == N2K_FP_SLOTS);
+
+  for (size_t f = 1; f < ts[0].frames.size(); ++f) {
+    for (transfer_t& t : ts) feed(&fp, t.frames[f], t_us += 100);
+  }
+  n2k_fp_get_stats(&fp, &st);
+  HT_CHECK_MSG(s_delivered == N2K_FP_SLOTS, "delivered %u", (unsigned)s_delivered);
+  HT_CHECK(st.orphans == (uint32_t)extra * (uint32_t)(ts[0].frames.size() - 1));
+  HT_CHECK(st.in_flight == 0);
+}
+
+// Transfers whose sender went quiet are evicted after N2K_FP_TIMEOUT_US of
+// frame time, which frees their slots; one that keeps going survives.
+static void test_timeout_eviction(void) {
+  static n2k_fp_t fp;
+  n2k_fp_init(&fp, on_msg, nullptr);
+  s_expected.clear();
+  s_delivered = 0;
+  ht_rng_t rng = {99};
+  std::vector<transfer_t> stalled;
+  uint32_t t_us = 5000;
+  for (int i = 0; i < N2K_FP_SLOTS - 1; ++i) {
+    stalled.push_back(make_transfer(&rng, (uint8_t)(i / 4), k_pgns[i % 4], 2, 100));
+    feed(&fp, stalled.back().frames[0], t_us += 10);
+  }
+  transfer_t live = make_transfer(&rng, 200, k_pgns[0], 3, 223);
+  s_expected[key(200, k_pgns[0], 3)] = live.payload;
+  feed(&fp, live.frames[live.next++], t_us += 10);
+
+  n2k_fp_stats_t st;
+  n2k_fp_get_stats(&fp, &st);
+  HT_CHECK(st.in_flight == N2K_FP_SLOTS);
+
+  // The live sender keeps a 200 ms frame gap, well inside the timeout.
+  while (live.next < live.frames.size()) feed(&fp, live.frames[live.next++], t_us += 200000);
+  n2k_fp_get_stats(&fp, &st);
+  HT_CHECK(s_delivered == 1);
+  HT_CHECK(st.abandoned == (uint32_t)stalled.size());
+  HT_CHECK(st.in_flight == 0);
+
+  // Their late continuations are now orphans, and the freed pool takes a
+  // full set of new transfers again.
+  feed(&fp, stalled[0].frames[1], t_us += 10);
+  n2k_fp_get_stats(&fp, &st);
+  HT_CHECK(st.orphans == 1);
+  for (int i = 0; i < N2K_FP_SLOTS; ++i) {
+    transfer_t t = make_transfer(&rng, (uint8_t)(100 + i / 4), k_pgns[i % 4], 4, 30);
+    feed(&fp, t.frames[0], t_us += 10);
+  }
+  n2k_fp_get_stats(&fp, &st);
+  HT_CHECK(st.pool_exhausted == 0 && st.in_flight == N2K_FP_SLOTS);
+
+  // n2k_fp_expire() on a quiet bus clears them without further frames.
+  n2k_fp_expire(&fp, t_us + N2K_FP_TIMEOUT_US + 1);
+  n2k_fp_get_stats(&fp, &st);
+  HT_CHECK(st.in_flight == 0);
+}
+
+// A new frame 0 for a sequence id in flight restarts it; a repeated frame 0
+// is a duplicate; a skipped counter drops the packet.
+static void test_restart_and_gaps(void) {
+  static n2k_fp_t fp;
+  n2k_fp_init(&fp, on_msg, nullptr);
+  s_expected.clear();
+  s_delivered = 0;
+  ht_rng_t rng = {4242};
+  uint32_t t_us = 100;
+
+  transfer_t a = make_transfer(&rng, 7, k_pgns[1], 5, 40);
+  transfer_t b = make_transfer(&rng, 7, k_pgns[1], 5, 60);
+  s_expected[key(7, k_pgns[1], 5)] = b.payload;
+  feed(&fp, a.frames[0], t_us += 10);
+  feed(&fp, a.frames[0], t_us += 10);
+  feed(&fp, a.frames[1], t_us += 10);
+  for (const can_frame_t& f : b.frames) feed(&fp, f, t_us += 10);
+  n2k_fp_stats_t st;
+  n2k_fp_get_stats(&fp, &st);
+  HT_CHECK(st.duplicates == 1 && st.abandoned == 1 && s_delivered == 1);
+
+  transfer_t c = make_transfer(&rng, 8, k_pgns[2], 0, 50);
+  feed(&fp, c.frames[0], t_us += 10);
+  feed(&fp, c.frames[2], t_us += 10);
+  feed(&fp, c.frames[1], t_us += 10);
+  n2k_fp_get_stats(&fp, &st);
+  HT_CHECK(st.out_of_order == 1 && st.orphans == 1 && st.in_flight == 0 && s_delivered == 1);
+}
+
+int main() {
+  test_interleaved();
+  test_pool_exhaustion();
+  test_timeout_eviction();
+  test_restart_and_gaps();
+  return ht_finish("n2k_fast_packet_test");
+}
@@ -0,0 +1,84 @@
+// n2k_subs under TSan: two owners republish their PGN lists from their own
+// threads while the bus task polls and filters. Each owner flips between
+// two disjoint lists, so a torn snapshot shows up as a union that holds
+// part of one list and part of the other. Once the writers stop, one more
+// poll must leave exactly their last lists.
+
+#include "host_test.h"
+#include "n2k_id.h"
+#include "n2k_subs.h"
+
+#include <atomic>
+#include <thread>
+
+static const uint32_t k_publishes = 200000;
+
+// Per owner: list 0 and list 1, disjoint and of different lengths.
+static const uint32_t k_lists[2][2][N2K_SUBS_MAX_PGNS] = {
+    {{127250, 127251, 127257, 127258, 128259, 128267, 129025, 129026, 129029, 130306, 130310, 130311},
+     {127488, 127489, 127493, 127505, 127508}},
+    {{130312, 130313, 130314, 130316},
+     {126992, 127245, 128275, 129283, 129284, 129539, 129540, 130577, 130842, 65280, 65284, 61184, 59904}},
+};
+static const uint8_t k_counts[2][2] = {{12, 5}, {4, 13}};
+static const n2k_sub_owner_t k_owners[2] = {N2K_SUB_LOGGER, N2K_SUB_PAGE};
+
+static bool accepts(uint32_t pgn) {
+  can_frame_t f = {};
+  f.id = n2k_make_id(pgn, 3, 0x22, 0xFF);
+  f.flags = CAN_FRAME_EXT;
+  f.dlc = 8;
+  return n2k_subs_accepts(&f);
+}
+
+// Which list of owner `w` the union holds: 0, 1, or -1 for a mix or neither.
+static int list_in_union(int w) {
+  int hits[2] = {};
+  for (int l = 0; l < 2; ++l) {
+    for (uint8_t i = 0; i < k_counts[w][l]; ++i) hits[l] += accepts(k_lists[w][l][i]);
+  }
+  if (hits[0] == k_counts[w][0] && hits[1] == 0) return 0;
+  if (hits[1] == k_counts[w][1] && hits[0] == 0) return 1;
+  return -1;
+}
+
+int main() {
+  std::atomic<int> done{0};
+  int last[2] = {};
+
+  std::thread writers[2];
+  for (int w = 0; w < 2; ++w) {
+    writers[w] = std::thread([&, w] {
+      for (uint32_t n = 0; n < k_publishes; ++n) {
+        last[w] = (int)((n * 7 + w) % 3 == 0);
+        n2k_subs_set(k_owners[w], k_lists[w][last[w]], k_counts[w][last[w]]);
+      }
+      done.fetch_add(1, std::memory_order_release);
+    });
+  }
+
+  // The bus task: no backend is running, so every hardware apply fails and
+  // only the software filter is exercised.
+  uint32_t polls = 0, torn = 0;
+  while (done.load(std::memory_order_acquire) < 2 && !ht_bail()) {
+    n2k_subs_poll(polls++);
+    n2k_subs_stats_t st;
+    n2k_subs_get_stats(&st);
+    if (st.accept_all) continue;   // before the first rebuild
+    for (int w = 0; w < 2; ++w) torn += list_in_union(w) < 0;
+  }
+  for (std::thread& t : writers) t.join();
+
+  n2k_subs_poll(polls++);
+  for (int w = 0; w < 2; ++w) {
+    HT_CHECK_MSG(list_in_union(w) == last[w], "owner %d: union does not hold its last list %d", w, last[w]);
+  }
+  HT_CHECK(!accepts(60928));   // nobody asked for address claims
+  HT_CHECK_MSG(torn == 0, "%u torn unions in %u polls", (unsigned)torn, (unsigned)polls);
+
+  n2k_subs_stats_t st;
+  n2k_subs_get_stats(&st);
+  HT_CHECK(!st.accept_all && st.pgns == k_counts[0][last[0]] + k_counts[1][last[1]]);
+  printf("n2k_subs_tsan_test: %u polls, %u rebuilds put off\n", (unsigned)polls, (unsigned)st.collisions);
+  return ht_finish("n2k_subs_tsan_test");
+}
@@ -0,0 +1,97 @@
+#!/usr/bin/env bash
+# Builds and runs the host tests with the system compiler.
+#   tests/run_host_tests.sh            all tests
+#   tests/run_host_tests.sh NAME...    only these (file name without .cpp)
+#   tests/run_host_tests.sh --bench    the benchmarks instead (-O2, no sanitizers)
+# Build output goes to $HOST_TEST_OUT (default: build/host_tests).
+set -eu
+cd "$(dirname "$0")/.."
+
+CXX=${CXX:-g++}
+OUT=${HOST_TEST_OUT:-build/host_tests}
+export HOST_TEST_DATA="$PWD/tests/data"   # captures used by the tests
+CXXFLAGS="-std=gnu++17 -O1 -g -Wall -Wextra -I. -Itests"
+ASAN="-fsanitize=address,undefined -fno-sanitize-recover=all -fno-omit-frame-pointer"
+TSAN="-fsanitize=thread"
+BENCHFLAGS="-std=gnu++17 -O2 -Wall -Wextra -I. -Itests"
+mkdir -p "$OUT"
+
+failed=()
+ran=0
+
+# host_test NAME "EXTRA FLAGS" SOURCES...
+host_test() {
+  local name=$1 flags=$2
+  shift 2
+  if [ "$BENCH" = 1 ] || { [ "${#SELECTED[@]}" -gt 0 ] && [[ ! " ${SELECTED[*]} " =~ " $name " ]]; }; then return; fi
+  ran=$((ran + 1))
+  echo "== $name"
+  if ! $CXX $CXXFLAGS $flags -o "$OUT/$name" "tests/$name.cpp" "$@" -lpthread; then
+    failed+=("$name (build)")
+    return
+  fi
+  if ! (cd "$OUT" && "./$name"); then failed+=("$name"); fi
+}
+
+# host_bench NAME "ARGS" SOURCES...: runs with --bench or when named.
+host_bench() {
+  local name=$1 args=$2
+  shift 2
+  if [ "${#SELECTED[@]}" -gt 0 ]; then
+    [[ " ${SELECTED[*]} " =~ " $name " ]] || return 0
+  elif [ "$BENCH" = 0 ]; then
+    return 0
+  fi
+  ran=$((ran + 1))
+  echo "== $name $args"
+  if ! $CXX $BENCHFLAGS -o "$OUT/$name" "tests/$name.cpp" "$@" -lpthread; then
+    failed+=("$name (build)")
+    return
+  fi
+  # shellcheck disable=SC2086
+  if ! (cd "$OUT" && "./$name" $args); then failed+=("$name"); fi
+}
+
+BENCH=0
+if [ "${1:-}" = "--bench" ]; then
+  BENCH=1
+  shift
+fi
+SELECTED=("$@")
+
+host_test signal_stats_test "$ASAN" signal_stats.cpp
+host_test n2k_fast_packet_test "$ASAN" n2k_fast_packet.cpp
+host_test n2k_decode_fuzz_test "$ASAN" n2k_decode.cpp logging_policy.cpp
+host_test signal_store_tsan_test "$TSAN" signal_store.cpp
+host_test n2k_subs_tsan_test "$TSAN" n2k_subs.cpp n2k_decode.cpp n2k_fast_packet.cpp can_rx.cpp can_socketcan.cpp \
+  can_capture.cpp bus_stats.cpp log_storage.cpp logging_policy.cpp
+host_test timer_wheel_test "$ASAN"
+host_test signal_arb_replay_test "$ASAN" signal_arb.cpp n2k_decode.cpp n2k_fast_packet.cpp can_capture.cpp \
+  log_storage.cpp logging_policy.cpp
+host_test log_codec_fuzz_test "$ASAN" log_codec.cpp log_writer.cpp log_ingest.cpp log_journal.cpp log_index.cpp \
+  log_rollup.cpp log_query.cpp log_storage.cpp crc32.cpp logging_policy.cpp
+host_test log_ingest_load_test "$ASAN" log_ingest.cpp logging_policy.cpp
+host_test c6_link_test "$ASAN" c6_link.cpp c6_link_posix.cpp c6_sync.cpp crc32.cpp signal_history.cpp \
+  signal_stale.cpp signal_store.cpp logging_policy.cpp
+host_test c6_sync_loss_test "$ASAN" c6_sync.cpp c6_link.cpp c6_link_posix.cpp crc32.cpp signal_history.cpp \
+  signal_stale.cpp signal_store.cpp logging_policy.cpp
+host_test log_power_cut_test "$ASAN -DLOG_FLUSH_INTERVAL_MS=50 -DLOG_BLOCK_MAX_AGE_MS=100 -DLOG_SYNC_INTERVAL_MS=100 \
+  -DLOG_SEGMENT_BYTES=16384" log_writer.cpp log_codec.cpp log_ingest.cpp log_journal.cpp log_index.cpp \
+  log_rollup.cpp log_query.cpp log_storage.cpp crc32.cpp logging_policy.cpp
+host_test chart_query_test "$TSAN" chart_query.cpp chart_cache.cpp log_rollup.cpp log_query.cpp log_index.cpp \
+  log_storage.cpp log_codec.cpp log_writer.cpp log_ingest.cpp log_journal.cpp crc32.cpp signal_history.cpp \
+  logging_policy.cpp
+host_test chart_cache_test "$ASAN" chart_cache.cpp logging_policy.cpp
+
+host_bench log_query_bench "2 20" log_query.cpp log_index.cpp log_rollup.cpp log_storage.cpp log_codec.cpp \
+  log_writer.cpp log_ingest.cpp log_journal.cpp crc32.cpp logging_policy.cpp
+host_bench log_codec_bench "24" log_codec.cpp log_writer.cpp log_ingest.cpp log_journal.cpp log_index.cpp \
+  log_rollup.cpp log_query.cpp log_storage.cpp crc32.cpp logging_policy.cpp
+host_bench c6_link_bench "3 0 50" c6_link.cpp c6_link_posix.cpp c6_sync.cpp crc32.cpp signal_history.cpp \
+  signal_stale.cpp signal_store.cpp logging_policy.cpp
+
+if [ "${#failed[@]}" -gt 0 ]; then
+  echo "FAILED: ${failed[*]}"
+  exit 1
+fi
+echo "all $ran host test(s) passed"
@@ -0,0 +1,137 @@
+// signal_arb on recorded multi-source traffic: tests/data/two_gps.log is a
+// 30 s candump capture with two GPS units and two engine-speed senders.
+//   - GPS A (0x10): 129025 at 10 Hz, 129026 at 4 Hz; silent from 10 s to 16 s
+//   - GPS B (0x1C): 129025 at 5 Hz, 129026 at 4 Hz
+//   - tach sender 0x30 at 10 Hz and engine gateway 0x40 at 2 Hz (127488)
+// The frames go through fast-packet reassembly, decode and arbitration with
+// the capture timestamps as the clock, as the bus task would run them. A is
+// preferred for the GPS signals; RPM has no priority list.
+
+#include "host_test.h"
+#include "can_capture.h"
+#include "log_storage.h"
+#include "n2k_decode.h"
+#include "n2k_fast_packet.h"
+#include "signal_arb.h"
+
+#include <map>
+#include <stdlib.h>
+#include <vector>
+
+static const uint8_t k_gps_a = 0x10, k_gps_b = 0x1C, k_tach = 0x30, k_gateway = 0x40;
+static const signal_id_t k_gps_sigs[] = {SIG_LAT, SIG_LON, SIG_COG, SIG_SOG};
+
+struct published_t {
+  uint8_t  last_src = SIG_ARB_NO_SOURCE;
+  uint32_t changes = 0;
+  uint32_t count = 0;
+};
+
+static published_t s_pub[SIG_COUNT];
+static std::map<uint32_t, std::vector<uint32_t>> s_gps_a_ms;   // by PGN
+static uint8_t s_first_rpm_src = SIG_ARB_NO_SOURCE;
+static uint32_t s_other_rpm_values = 0;
+
+static void on_signal(signal_id_t sig, float, const n2k_msg_t* msg, void*) {
+  if (sig == SIG_RPM) {
+    if (s_first_rpm_src == SIG_ARB_NO_SOURCE) s_first_rpm_src = msg->src;
+    if (msg->src != s_first_rpm_src) ++s_other_rpm_values;
+  }
+  if (!signal_arb_accept(sig, msg->src, msg->t_us / 1000)) return;
+  published_t& p = s_pub[sig];
+  if (p.count++ && p.last_src != msg->src) ++p.changes;
+  p.last_src = msg->src;
+}
+
+static void on_message(const n2k_msg_t* msg, void*) {
+  if (msg->src == k_gps_a) {
+    std::vector<uint32_t>& v = s_gps_a_ms[msg->pgn];
+    if (v.empty() || v.back() != msg->t_us / 1000) v.push_back(msg->t_us / 1000);
+  }
+  n2k_decode(msg, on_signal, nullptr);
+}
+
+static uint32_t pgn_of(signal_id_t sig) { return sig == SIG_LAT || sig == SIG_LON ? 129025 : 129026; }
+static uint32_t interval_ms(uint32_t pgn) { return pgn == 129025 ? 100 : 250; }
+
+int main() {
+  const char* data = getenv("HOST_TEST_DATA");
+  log_storage_set_root(data ? data : "tests/data");
+  log_storage_begin();
+  const uint8_t prio[] = {k_gps_a, k_gps_b};
+  for (signal_id_t sig : k_gps_sigs) signal_arb_set_priority(sig, prio, 2);
+
+  static n2k_fp_t fp;
+  n2k_fp_init(&fp, on_message, nullptr);
+  can_log_reader_t rd;
+  if (!can_log_open(&rd, "two_gps.log")) {
+    fprintf(stderr, "cannot open two_gps.log under %s\n", data ? data : "tests/data");
+    return 1;
+  }
+  can_frame_t f;
+  uint64_t t_us, t0_us = 0;
+  uint32_t frames = 0;
+  while (can_log_next(&rd, &f, &t_us)) {
+    if (!frames++) t0_us = t_us;
+    f.t_us = (uint32_t)(t_us - t0_us);
+    n2k_fp_feed(&fp, &f);
+  }
+  HT_CHECK(rd.bad_lines == 0);
+  can_log_close(&rd);
+  HT_CHECK(frames == 966);
+
+  std::vector<signal_arb_event_t> events[SIG_COUNT];
+  signal_arb_event_t ev;
+  while (signal_arb_pop_event(&ev)) events[ev.sig].push_back(ev);
+
+  for (signal_id_t sig : k_gps_sigs) {
+    const std::vector<uint32_t>& a = s_gps_a_ms[pgn_of(sig)];
+    const uint32_t iv = interval_ms(pgn_of(sig));
+    size_t gap = 1;
+    while (gap < a.size() && a[gap] - a[gap - 1] < 2 * iv) ++gap;
+    HT_CHECK(gap + SIG_ARB_HEALTHY_UPDATES <= a.size());
+    if (gap + SIG_ARB_HEALTHY_UPDATES > a.size()) continue;
+    const uint32_t a_last = a[gap - 1];
+    const uint32_t timeout = iv * SIG_ARB_TIMEOUT_FACTOR;
+
+    const std::vector<signal_arb_event_t>& e = events[sig];
+    HT_CHECK_MSG(e.size() == 3, "%s: %u events", k_signal_meta[sig].key, (unsigned)e.size());
+    if (e.size() != 3) continue;
+    HT_CHECK(e[0].reason == SIG_ARB_ACQUIRED && e[0].to_src == k_gps_a && e[0].t_ms == a[0]);
+
+    // B takes over on its first value after A's timeout (within a few ms of
+    // capture jitter of the learned interval).
+    HT_CHECK(e[1].reason == SIG_ARB_FAILOVER && e[1].from_src == k_gps_a && e[1].to_src == k_gps_b);
+    HT_CHECK_MSG(e[1].t_ms + 10 >= a_last + timeout && e[1].t_ms <= a_last + timeout + 2 * iv + 10,
+                 "%s: failover at %u ms, A last seen at %u ms", k_signal_meta[sig].key, (unsigned)e[1].t_ms,
+                 (unsigned)a_last);
+
+    // A is preferred again on its SIG_ARB_HEALTHY_UPDATES-th update after
+    // it came back: the late first one restarts the streak at 1, and each
+    // on-time update after it adds one.
+    HT_CHECK(e[2].reason == SIG_ARB_PREFERRED && e[2].from_src == k_gps_b && e[2].to_src == k_gps_a);
+    HT_CHECK_MSG(e[2].t_ms == a[gap + SIG_ARB_HEALTHY_UPDATES - 1], "%s: preferred at %u ms, A back at %u ms",
+                 k_signal_meta[sig].key, (unsigned)e[2].t_ms, (unsigned)a[gap]);
+
+    // What reached the store followed the selection without flicker.
+    HT_CHECK(s_pub[sig].changes == 2 && s_pub[sig].last_src == k_gps_a);
+    HT_CHECK(signal_arb_selected(sig) == k_gps_a);
+  }
+
+  // No priority for RPM: the first sender keeps it, the other never gets in.
+  HT_CHECK(s_first_rpm_src == k_tach || s_first_rpm_src == k_gateway);
+  HT_CHECK(events[SIG_RPM].size() == 1 && events[SIG_RPM][0].to_src == s_first_rpm_src);
+  HT_CHECK(signal_arb_selected(SIG_RPM) == s_first_rpm_src);
+  HT_CHECK(s_other_rpm_values > 0);
+  HT_CHECK(s_pub[SIG_RPM].changes == 0 && s_pub[SIG_RPM].count > 0);
+
+  signal_arb_stats_t st;
+  signal_arb_get_stats(&st);
+  HT_CHECK(st.switches == 8 && st.events_dropped == 0);
+  HT_CHECK(st.sources[SIG_SOG] == 2 && st.sources[SIG_RPM] == 2);
+  HT_CHECK(st.rejected >= s_other_rpm_values);
+
+  printf("signal_arb_replay_test: %u frames, %u values, %u rejected\n", (unsigned)frames, (unsigned)st.values,
+         (unsigned)st.rejected);
+  return ht_finish("signal_arb_replay_test");
+}
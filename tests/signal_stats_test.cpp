@@ -0,0 +1,94 @@
+// signal_stats: O(1) window aggregates against a brute-force scan of every
+// sample pushed, over random time steps, gaps, late samples and windows.
+
+#include "host_test.h"
+#include "signal_stats.h"
+
+#include <stdint.h>
+#include <vector>
+
+struct ref_sample_t {
+  uint32_t seq;     // bucket the engine folded it into
+  int32_t  value;
+};
+
+static bool reference(const std::vector<ref_sample_t>& samples, uint32_t open_seq, uint8_t window,
+                      signal_stats_result_t* out) {
+  const uint32_t span = signal_stats_window_seconds(window) / SIGNAL_STATS_BUCKET_S;
+  const uint32_t lower = open_seq + 1 >= span ? open_seq + 1 - span : 0;
+  int64_t sum = 0;
+  uint32_t count = 0;
+  int32_t lo = INT32_MAX, hi = INT32_MIN;
+  for (const ref_sample_t& r : samples) {
+    if (r.seq < lower) continue;
+    sum += r.value;
+    ++count;
+    if (r.value < lo) lo = r.value;
+    if (r.value > hi) hi = r.value;
+  }
+  if (!count) return false;
+  out->current = samples.back().value;
+  out->avg = (int32_t)(sum / (int64_t)count);
+  out->min = lo;
+  out->max = hi;
+  out->count = count;
+  return true;
+}
+
+static void run_seed(uint32_t seed) {
+  signal_stats_t s;
+  if (!signal_stats_init(&s)) {
+    HT_CHECK_MSG(false, "signal_stats_init failed");
+    return;
+  }
+  ht_rng_t rng = {seed};
+  std::vector<ref_sample_t> samples;
+  uint32_t now_s = rng.below(100000);
+  uint32_t open_seq = 0;
+
+  for (int step = 0; step < 20000 && !ht_bail(); ++step) {
+    const uint32_t r = rng.below(1000);
+    if (r < 5) now_s += 3600 + rng.below(30 * 3600);   // outage, may clear windows
+    else if (r < 900) now_s += rng.below(120);
+    else now_s += rng.below(900);
+
+    // Late samples land in the open bucket.
+    uint32_t t_s = now_s;
+    if (rng.below(20) == 0 && now_s > 600) t_s = now_s - rng.below(600);
+    const int32_t value = (int32_t)rng.below(40000) - 20000;
+    signal_stats_push(&s, t_s, value);
+    if (t_s / SIGNAL_STATS_BUCKET_S > open_seq) open_seq = t_s / SIGNAL_STATS_BUCKET_S;
+    samples.push_back({open_seq, value});
+
+    if (rng.below(4)) continue;
+    const uint32_t query_s = now_s + (rng.below(10) == 0 ? rng.below(7200) : 0);
+    if (query_s / SIGNAL_STATS_BUCKET_S > open_seq) open_seq = query_s / SIGNAL_STATS_BUCKET_S;
+    for (uint8_t w = 0; w < STATS_WIN_COUNT; ++w) {
+      signal_stats_result_t got = {}, want = {};
+      const bool got_ok = signal_stats_get(&s, w, query_s, &got);
+      const bool want_ok = reference(samples, open_seq, w, &want);
+      HT_CHECK_MSG(got_ok == want_ok, "seed %u step %d window %u: has data %d, want %d", (unsigned)seed, step,
+                   (unsigned)w, got_ok, want_ok);
+      if (!got_ok || !want_ok) continue;
+      HT_CHECK_MSG(got.count == want.count && got.avg == want.avg && got.min == want.min &&
+                       got.max == want.max && got.current == want.current,
+                   "seed %u step %d window %u: n %u avg %d min %d max %d cur %d, want n %u avg %d min %d "
+                   "max %d cur %d",
+                   (unsigned)seed, step, (unsigned)w, (unsigned)got.count, (int)got.avg, (int)got.min,
+                   (int)got.max, (int)got.current, (unsigned)want.count, (int)want.avg, (int)want.min,
+                   (int)want.max, (int)want.current);
+    }
+  }
+
+  // reset() starts from scratch: old samples must not leak into new windows.
+  signal_stats_reset(&s);
+  signal_stats_push(&s, now_s, 7);
+  signal_stats_result_t got = {};
+  HT_CHECK(signal_stats_get(&s, STATS_WIN_24H, now_s, &got) && got.count == 1 && got.min == 7 && got.max == 7);
+  signal_stats_free(&s);
+}
+
+int main() {
+  for (uint32_t seed = 1; seed <= 8 && !ht_bail(); ++seed) run_seed(seed * 2654435761u);
+  return ht_finish("signal_stats_test");
+}
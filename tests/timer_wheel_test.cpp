@@ -0,0 +1,76 @@
+// timer_wheel: random arm/re-arm/cancel against a reference model while the
+// millisecond clock runs through the 32-bit wrap. A timer must fire exactly
+// once per arming, never before its deadline and at most one tick plus one
+// advance step after it, and armed() must match the model throughout.
+
+#include "host_test.h"
+#include "timer_wheel.h"
+
+static const uint16_t k_timers = 500;
+static const uint32_t k_max_step_ms = 30;
+
+struct model_t {
+  bool     armed;
+  uint32_t due_ms;
+};
+
+static void run(uint32_t seed, uint32_t start_ms, uint32_t tick_ms, int steps) {
+  static timer_wheel<k_timers> w;
+  static model_t m[k_timers];
+  ht_rng_t rng = {seed};
+  uint32_t now = start_ms;
+  w.init(now, tick_ms);
+  for (model_t& t : m) t = {false, 0};
+  uint32_t fired = 0, wrapped = 0;
+
+  for (int step = 0; step < steps && !ht_bail(); ++step) {
+    const uint16_t id = (uint16_t)rng.below(k_timers);
+    const uint32_t op = rng.below(10);
+    if (op < 6) {
+      // Mostly near deadlines, some past the top level's 64^3-tick span.
+      const uint32_t ahead = rng.below(4) ? rng.below(3000) : rng.below(64u * 64u * 64u * tick_ms + 500000);
+      w.arm(id, now + ahead);
+      m[id] = {true, now + ahead};
+    } else if (op == 6) {
+      w.cancel(id);
+      m[id].armed = false;
+    }
+
+    const uint32_t before = now;
+    now += rng.below(k_max_step_ms + 1);
+    if (now < before) ++wrapped;
+    w.advance(now, [&](uint16_t i) {
+      ++fired;
+      HT_CHECK_MSG(m[i].armed, "seed %u: timer %u fired while not armed", (unsigned)seed, (unsigned)i);
+      const int32_t lag = (int32_t)(now - m[i].due_ms);
+      HT_CHECK_MSG(lag >= 0, "seed %u: timer %u fired %d ms early", (unsigned)seed, (unsigned)i, -lag);
+      HT_CHECK_MSG(lag <= (int32_t)(tick_ms + k_max_step_ms), "seed %u: timer %u fired %d ms late", (unsigned)seed,
+                   (unsigned)i, lag);
+      m[i].armed = false;
+    });
+
+    if (step % 1024 == 0) {
+      for (uint16_t i = 0; i < k_timers; ++i) {
+        HT_CHECK_MSG(w.armed(i) == m[i].armed, "seed %u: timer %u armed() mismatch", (unsigned)seed, (unsigned)i);
+        if (m[i].armed) {
+          const int32_t overdue = (int32_t)(now - m[i].due_ms);
+          HT_CHECK_MSG(overdue <= (int32_t)tick_ms, "seed %u: timer %u overdue by %d ms", (unsigned)seed,
+                       (unsigned)i, overdue);
+        }
+      }
+    }
+  }
+  HT_CHECK_MSG(wrapped > 0 || start_ms < 0x80000000u, "seed %u: clock never wrapped", (unsigned)seed);
+  printf("timer_wheel_test: seed %u tick %u ms: %u fired, %u wraps\n", (unsigned)seed, (unsigned)tick_ms,
+         (unsigned)fired, (unsigned)wrapped);
+}
+
+int main() {
+  // 2M steps of up to 30 ms cover ~30M ms, so a start 15M ms before the
+  // wrap crosses it half way through.
+  run(12345, 0xFFFFFFFFu - 15000000u, 10, 2000000);
+  run(777, 0xFFFFFFFFu - 1000u, 1, 1000000);
+  run(4242, 0xFFFFFFFFu - 5000000u, 7, 1000000);
+  run(99, 0, 10, 500000);
+  return ht_finish("timer_wheel_test");
+}
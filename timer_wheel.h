@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stdint.h>
+
+// Hierarchical timer wheel for N fixed timers (ids 0..N-1), no heap.
+//
+// Three levels of 64 slots; a level-k slot spans 64^k ticks, so deadlines
+// up to 64^3 ticks ahead are exact and later ones wait in the last level.
+// Timers live in intrusive doubly-linked slot lists, so arm() and cancel()
+// are O(1) and advance() costs one step per elapsed tick plus the timers it
+// expires or moves down a level (each timer moves at most twice).
+//
+// Not thread-safe: arm, cancel and advance belong to one task.
+
+template <uint16_t N>
+class timer_wheel {
+  static constexpr uint16_t NIL = 0xFFFF;
+  static constexpr uint32_t BITS = 6;
+  static constexpr uint32_t SLOTS = 1u << BITS;
+  static constexpr uint32_t LEVELS = 3;
+  static_assert(N < NIL, "timer ids are 16-bit");
+
+public:
+  // Deadlines are in ms; `tick_ms` is the resolution (timers fire up to one
+  // tick late, never early).
+  void init(uint32_t now_ms, uint32_t tick_ms) {
+    tick_ms_ = tick_ms ? tick_ms : 1;
+    now_tick_ = 0;
+    tick_start_ms_ = now_ms;
+    for (auto& level : head_) {
+      for (auto& h : level) h = NIL;
+    }
+    for (auto& t : timers_) t = {NIL, NIL, 0, NIL};
+  }
+
+  void arm(uint16_t id, uint32_t deadline_ms) {
+    if (id >= N) return;
+    unlink(id);
+    // Relative to the current tick, rounded up so a timer never fires
+    // before its deadline; wraps with the 32-bit millisecond clock.
+    const int32_t ahead = (int32_t)(deadline_ms - tick_start_ms_);
+    timers_[id].expires = now_tick_ + (ahead > 0 ? ((uint32_t)ahead + tick_ms_ - 1) / tick_ms_ : 0);
+    insert(id);
+  }
+
+  void cancel(uint16_t id) {
+    if (id < N) unlink(id);
+  }
+
+  bool armed(uint16_t id) const { return id < N && timers_[id].slot != NIL; }
+
+  // Runs every tick up to `now_ms`, calling on_expire(id) for each timer
+  // that comes due. Returns the number expired.
+  template <typename F>
+  uint32_t advance(uint32_t now_ms, F&& on_expire) {
+    uint32_t fired = 0;
+    while ((int32_t)(now_ms - (tick_start_ms_ + tick_ms_)) >= 0) {
+      tick_start_ms_ += tick_ms_;
+      ++now_tick_;
+      // Entering a new span of an upper level: move its timers down.
+      for (uint32_t level = 1; level < LEVELS; ++level) {
+        if (now_tick_ & ((1u << (BITS * level)) - 1)) break;
+        cascade(level, (now_tick_ >> (BITS * level)) & (SLOTS - 1));
+      }
+      uint16_t* h = &head_[0][now_tick_ & (SLOTS - 1)];
+      while (*h != NIL) {
+        const uint16_t id = *h;
+        unlink(id);
+        on_expire(id);
+        ++fired;
+      }
+    }
+    return fired;
+  }
+
+private:
+  struct timer_t_ {
+    uint16_t next;
+    uint16_t prev;
+    uint32_t expires;   // tick
+    uint16_t slot;      // level * SLOTS + index, NIL when not armed
+  };
+
+  // `cascading`: called from advance() before the current tick's slot is
+  // run, so a timer due now still fires this tick.
+  void insert(uint16_t id, bool cascading = false) {
+    timer_t_* t = &timers_[id];
+    const int32_t delta = (int32_t)(t->expires - now_tick_);
+    uint32_t at = t->expires;
+    if (delta < 0 || (delta == 0 && !cascading)) {
+      at = t->expires = now_tick_ + (cascading ? 0 : 1);   // overdue: fire as soon as possible
+    } else if ((uint32_t)delta >= (1u << (BITS * LEVELS))) {
+      // Beyond the top level: park at its far edge, re-placed on cascade.
+      at = now_tick_ + (1u << (BITS * LEVELS)) - 1;
+    }
+    const uint32_t d = at - now_tick_;
+    uint32_t level = 0;
+    while (level + 1 < LEVELS && d >= (1u << (BITS * (level + 1)))) ++level;
+    const uint16_t slot = (uint16_t)(level * SLOTS + ((at >> (BITS * level)) & (SLOTS - 1)));
+    uint16_t* h = &head_[0][0] + slot;
+    t->slot = slot;
+    t->prev = NIL;
+    t->next = *h;
+    if (*h != NIL) timers_[*h].prev = id;
+    *h = id;
+  }
+
+  void unlink(uint16_t id) {
+    timer_t_* t = &timers_[id];
+    if (t->slot == NIL) return;
+    if (t->prev != NIL) {
+      timers_[t->prev].next = t->next;
+    } else {
+      (&head_[0][0])[t->slot] = t->next;
+    }
+    if (t->next != NIL) timers_[t->next].prev = t->prev;
+    t->slot = t->next = t->prev = NIL;
+  }
+
+  void cascade(uint32_t level, uint32_t index) {
+    uint16_t id = head_[level][index];
+    head_[level][index] = NIL;
+    while (id != NIL) {
+      const uint16_t next = timers_[id].next;
+      timers_[id].slot = NIL;
+      insert(id, true);
+      id = next;
+    }
+  }
+
+  uint16_t head_[LEVELS][SLOTS];
+  timer_t_ timers_[N];
+  uint32_t now_tick_ = 0;
+  uint32_t tick_start_ms_ = 0;   // clock time at which now_tick_ began
+  uint32_t tick_ms_ = 1;
+};
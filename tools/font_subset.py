@@ -0,0 +1,430 @@
+#!/usr/bin/env python3
+"""UI glyph inventory and Orbitron font subsetting.
+
+Extracts every string literal and printf-style format pattern from the UI
+sources, computes the glyph set each generated font actually needs and:
+
+  --check    fails (exit 1) if a glyph used by the UI is missing from a font
+  --report   prints used vs. shipped glyph counts per font
+  --commands prints lv_font_conv command lines that regenerate subset fonts
+  --regen    runs those commands (needs lv_font_conv and the source TTFs)
+
+Each literal counts toward the font it is drawn with:
+
+  * lv_label_set_text()/numeric_readout_set_text() with a literal, or with a
+    local variable a literal is assigned to: the font of the target object in
+    the same function, from lv_obj_add_style() (both arms of a `? :`) and
+    lv_obj_set_style_text_font(), with styles resolved through
+    lv_style_set_text_font();
+  * text that reaches a label through a helper or a stored pointer: the
+    rules in font_glyphs.txt, keyed by helper argument, function or variable
+    rather than by string, so editing text never touches the manifest.
+
+--check fails on literals it cannot attribute. Glyphs LVGL renders at run
+time (chart tick labels) go to the fonts set on lv_chart objects.
+"""
+
+import argparse
+import glob
+import os
+import re
+import shlex
+import subprocess
+import sys
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# UI sources: ui.cpp, future page modules, and widgets with built-in glyph sets.
+UI_SOURCES = ["ui.cpp", "ui_*.cpp", "page_*.cpp", "numeric_readout.cpp"]
+FONT_GLOB = "orbitron_*.c"
+MANIFEST = "font_glyphs.txt"
+
+# Rendered by LVGL itself (chart axis ticks), never present as literals.
+RUNTIME_GLYPHS = "0123456789-. "
+
+# Format conversions -> glyphs they can produce.
+FORMAT_GLYPHS = {
+    "d": "0123456789-", "i": "0123456789-", "u": "0123456789",
+    "f": "0123456789-.", "x": "0123456789abcdef", "X": "0123456789ABCDEF",
+    "c": "", "s": "",
+}
+
+STRING_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+FORMAT_RE = re.compile(r"%[-+ #0]*\d*(?:\.\d+)?(?:hh|h|ll|l|z)?([diufxXcs%])")
+FONT_REF_RE = re.compile(r"\b(orbitron_\d+_\d+)\b")
+ALIAS_RE = re.compile(r"\b(FONT_\w+)\s*=\s*&\s*(orbitron_\d+_\d+)")
+RULE_RE = re.compile(r"^(\w+)(?:\((\d+)\)|(\{\})|(=))\s+(.+)$")
+STYLE_FONT_RE = re.compile(r"lv_style_set_text_font\(\s*&\s*(\w+)\s*,\s*&?\s*(\w+)")
+OBJ_STYLE_RE = re.compile(r"lv_obj_add_style\(\s*(\w+)\s*,\s*([^,]+),")
+OBJ_FONT_RE = re.compile(r"lv_obj_set_style_text_font\(\s*(\w+)\s*,\s*&?\s*(\w+)")
+CHART_RE = re.compile(r"\b(\w+)\s*=\s*lv_chart_create\(")
+SET_TEXT_FUNCS = {"lv_label_set_text", "lv_label_set_text_static", "numeric_readout_set_text"}
+SET_TEXT_VAR_RE = re.compile(r"\b(?:%s)\(\s*(\w+)\s*,\s*(\w+)\s*\)" % "|".join(SET_TEXT_FUNCS))
+ASSIGN_RE = re.compile(r"\b(\w+)\s*(?:\[[^\]]*\])?\s*=(?!=)")
+SKIP_LINE_RE = re.compile(r"^\s*#\s*include|DBG_LOG|Serial\.|static_assert")
+
+
+def decode_c_string(body):
+    out = bytearray()
+    i = 0
+    raw = body.encode("utf-8")
+    while i < len(raw):
+        c = raw[i]
+        if c != 0x5C:  # backslash
+            out.append(c)
+            i += 1
+            continue
+        n = chr(raw[i + 1])
+        simple = {"n": 10, "t": 9, "r": 13, "0": 0, "\\": 92, '"': 34, "'": 39}
+        if n == "x":
+            m = re.match(rb"[0-9a-fA-F]+", raw[i + 2:])
+            out.append(int(m.group(0), 16) & 0xFF)
+            i += 2 + len(m.group(0))
+        elif n == "u":
+            out += chr(int(raw[i + 2:i + 6], 16)).encode("utf-8")
+            i += 6
+        else:
+            out.append(simple.get(n, ord(n)))
+            i += 2
+    return out.decode("utf-8", errors="replace")
+
+
+def literal_glyphs(text):
+    """Glyphs a literal can put on screen, expanding format conversions."""
+    glyphs = set()
+    pos = 0
+    for m in FORMAT_RE.finditer(text):
+        glyphs.update(text[pos:m.start()])
+        conv = m.group(1)
+        glyphs.update("%" if conv == "%" else FORMAT_GLYPHS[conv])
+        pos = m.end()
+    glyphs.update(text[pos:])
+    return {g for g in glyphs if ord(g) >= 0x20}
+
+
+def strip_comments(src):
+    src = re.sub(r"/\*.*?\*/", lambda m: "\n" * m.group(0).count("\n"), src, flags=re.S)
+    return re.sub(r"//[^\n]*", "", src)
+
+
+def mask_strings(src):
+    """Blanks string literal contents so brackets and commas in text are ignored."""
+    return STRING_RE.sub(lambda m: '"' + "x" * (len(m.group(0)) - 2) + '"', src)
+
+
+def split_scopes(src):
+    """Maps each line number (0-based) to the index of its top-level brace block,
+    and each block index to the function it belongs to (first `name(` before it)."""
+    scope_of_line, names, depth, scope, head = [], {}, 0, 0, ""
+    for line in src.split("\n"):
+        scope_of_line.append(scope if depth else -1)
+        directive = line.lstrip().startswith("#")
+        for ch in line:
+            if directive:
+                break
+            if ch == "{":
+                if depth == 0:
+                    scope += 1
+                    m = re.search(r"(\w+)\s*\(", head)
+                    names[scope] = m.group(1) if m else None
+                depth += 1
+            elif ch == "}":
+                depth -= 1
+                if depth == 0:
+                    head = ""
+            elif depth == 0:
+                head = "" if ch == ";" else head + ch
+        if depth == 0:
+            head += " "
+        if depth and scope_of_line[-1] == -1:
+            scope_of_line[-1] = scope
+    return scope_of_line, names
+
+
+def enclosing_call(masked, pos):
+    """(function name, 1-based argument index, offset of '(') of the innermost
+    call whose argument list contains `pos`, or None."""
+    depth, arg = 0, 1
+    for i in range(pos - 1, -1, -1):
+        ch = masked[i]
+        if ch in ")]}":
+            depth += 1
+        elif ch in "([{":
+            if depth:
+                depth -= 1
+                continue
+            if ch != "(":
+                return None
+            m = re.search(r"(\w+)\s*$", masked[:i])
+            return (m.group(1), arg, i) if m else None
+        elif depth == 0 and ch == ",":
+            arg += 1
+        elif depth == 0 and ch == ";":
+            return None
+    return None
+
+
+def assigned_name(masked, pos):
+    """Variable a literal initialises or is assigned to (through an initializer
+    list if need be), or None."""
+    depth = 0
+    for i in range(pos - 1, -1, -1):
+        ch = masked[i]
+        if ch in ")]}":
+            depth += 1
+            if ch == "}" and depth == 1:
+                break
+        elif ch in "([{":
+            if depth:
+                depth -= 1
+            elif ch == "{" and not masked[:i].rstrip().endswith("="):
+                break
+        elif depth == 0 and ch == ";":
+            break
+    else:
+        i = -1
+    names = ASSIGN_RE.findall(masked[i + 1:pos])
+    return names[-1] if names else None
+
+
+def load_manifest(path):
+    """Rules of font_glyphs.txt: {(func, N): fonts}, {func: fonts}, {var: fonts}."""
+    calls, bodies, names = {}, {}, {}
+    if not os.path.exists(path):
+        return calls, bodies, names
+    with open(path, encoding="utf-8") as f:
+        for n, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            m = RULE_RE.match(line)
+            if not m:
+                sys.exit("%s:%d: cannot parse rule: %s" % (os.path.basename(path), n, line))
+            name, idx, body, assign, fonts = m.groups()
+            if idx:
+                calls[(name, int(idx))] = fonts.split()
+            elif body:
+                bodies[name] = fonts.split()
+            else:
+                names[name] = fonts.split()
+    return calls, bodies, names
+
+
+def resolve_fonts(tokens, aliases, call_fonts):
+    """Font names from a manifest rule; `none` yields no fonts."""
+    out = set()
+    for t in tokens:
+        if t == "none":
+            continue
+        if t.startswith("@"):
+            out |= call_fonts(t[1:])
+        else:
+            out.add(aliases.get(t, t))
+    return out
+
+
+class Literal:
+    def __init__(self, path, line, text):
+        self.path, self.line, self.text = path, line, text
+        self.fonts = None  # None: not attributed; empty set: never drawn
+
+
+def scan_sources(paths, manifest):
+    """Returns (literals with their fonts, fonts used for chart ticks)."""
+    raw = {}
+    aliases = {}
+    for path in paths:
+        with open(path, encoding="utf-8") as f:
+            raw[path] = f.read()
+        aliases.update(ALIAS_RE.findall(strip_comments(raw[path])))
+
+    style_fonts = {}
+    for src in raw.values():
+        for style, font in STYLE_FONT_RE.findall(strip_comments(src)):
+            style_fonts.setdefault(style, set()).add(aliases.get(font, font))
+
+    def call_fonts(spec):
+        func, _, idx = spec.partition(":")
+        out = set()
+        for src in raw.values():
+            for m in re.finditer(r"\b%s\(([^;]*?)\)\s*;" % re.escape(func), strip_comments(src)):
+                args = [a.strip() for a in m.group(1).split(",")]
+                if int(idx) <= len(args):
+                    arg = args[int(idx) - 1].lstrip("&")
+                    out.add(aliases.get(arg, arg))
+        return out
+
+    call_rules, body_rules, name_rules = load_manifest(manifest)
+    literals, chart_fonts = [], set()
+    for path, text in raw.items():
+        src = strip_comments(text)
+        masked = mask_strings(src)
+        lines = src.split("\n")
+        scopes, scope_names = split_scopes(masked)
+
+        # Object -> fonts, per top-level block (function) and file-wide.
+        obj_fonts = {}
+        def add(scope, obj, fonts):
+            obj_fonts.setdefault((scope, obj), set()).update(fonts)
+            obj_fonts.setdefault((None, obj), set()).update(fonts)
+        charts = set()
+        var_targets = {}
+        for n, line in enumerate(lines):
+            for obj, arg in OBJ_STYLE_RE.findall(line):
+                styles = re.findall(r"&\s*(\w+)", arg)
+                add(scopes[n], obj, set().union(*(style_fonts.get(st, set()) for st in styles)) if styles else set())
+            for obj, font in OBJ_FONT_RE.findall(line):
+                add(scopes[n], obj, {aliases.get(font, font)})
+            for obj, var in SET_TEXT_VAR_RE.findall(line):
+                var_targets[(scopes[n], var)] = obj
+            charts.update(CHART_RE.findall(line))
+        for obj in charts:
+            chart_fonts |= obj_fonts.get((None, obj), set())
+
+        def fonts_of(scope, obj):
+            fonts = obj_fonts.get((scope, obj)) or obj_fonts.get((None, obj))
+            return set(fonts) if fonts else None
+
+        line_start = [0]
+        for line in lines:
+            line_start.append(line_start[-1] + len(line) + 1)
+
+        for n, line in enumerate(lines):
+            if SKIP_LINE_RE.search(line):
+                continue
+            for m in STRING_RE.finditer(line):
+                pos = line_start[n] + m.start()
+                lit = Literal(os.path.relpath(path, REPO), n + 1, decode_c_string(m.group(1)))
+                call = enclosing_call(masked, pos)
+                name = assigned_name(masked, pos)
+                func = scope_names.get(scopes[n])
+                if call and (call[0], call[1]) in call_rules:
+                    lit.fonts = resolve_fonts(call_rules[(call[0], call[1])], aliases, call_fonts)
+                elif call and call[0] in SET_TEXT_FUNCS and call[1] == 2:
+                    obj = re.match(r"\s*(\w+)", masked[call[2] + 1:])
+                    lit.fonts = fonts_of(scopes[n], obj.group(1)) if obj else None
+                elif name in name_rules:
+                    lit.fonts = resolve_fonts(name_rules[name], aliases, call_fonts)
+                elif (scopes[n], name) in var_targets:
+                    lit.fonts = fonts_of(scopes[n], var_targets[(scopes[n], name)])
+                elif func in body_rules:
+                    lit.fonts = resolve_fonts(body_rules[func], aliases, call_fonts)
+                literals.append(lit)
+    return literals, chart_fonts
+
+
+def parse_font(path):
+    """Codepoints present in a generated LVGL font and its lv_font_conv options."""
+    with open(path, encoding="utf-8") as f:
+        src = f.read()
+    opts = re.search(r"\* Opts: (.*)", src).group(1).strip()
+    lists = {}
+    for name, body in re.findall(r"static const uint16_t (unicode_list_\d+)\[\] = \{(.*?)\};", src, re.S):
+        lists[name] = [int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", body)]
+    present = set()
+    for m in re.finditer(r"\.range_start = (\d+), \.range_length = (\d+).*?\.unicode_list = (\w+)", src, re.S):
+        start, length, ulist = int(m.group(1)), int(m.group(2)), m.group(3)
+        if ulist == "NULL":
+            present.update(range(start, start + length))
+        else:
+            present.update(start + ofs for ofs in lists[ulist])
+    return present, opts
+
+
+def compress_ranges(cps):
+    cps = sorted(cps)
+    out = []
+    for cp in cps:
+        if out and cp == out[-1][1] + 1:
+            out[-1][1] = cp
+        else:
+            out.append([cp, cp])
+    return ["0x%X" % a if a == b else "0x%X-0x%X" % (a, b) for a, b in out]
+
+
+def parse_range(token):
+    a, _, b = token.partition("-")
+    return int(a, 16), int(b or a, 16)
+
+
+def subset_command(opts, used):
+    """Rewrite an lv_font_conv command keeping only `used` codepoints per --font."""
+    args = shlex.split(opts.replace("\\", "/"))
+    head, groups, tail = [], [], []
+    i = 0
+    while i < len(args):
+        a = args[i]
+        if a == "--font":
+            groups.append([args[i + 1], []])
+            i += 2
+        elif a == "-r" and groups:
+            groups[-1][1].append(parse_range(args[i + 1]))
+            i += 2
+        elif a == "-o":
+            tail += [a, args[i + 1]]
+            i += 2
+        else:
+            (tail if groups else head).append(a)
+            i += 1
+    cmd = ["lv_font_conv"] + head
+    for font, ranges in groups:
+        keep = {cp for cp in used if any(lo <= cp <= hi for lo, hi in ranges)}
+        if not keep:
+            continue
+        cmd += ["--font", font]
+        for r in compress_ranges(keep):
+            cmd += ["-r", r]
+    return cmd + tail
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--check", action="store_true", help="fail if a UI glyph is missing from a font")
+    ap.add_argument("--report", action="store_true", help="print per-font glyph usage")
+    ap.add_argument("--commands", action="store_true", help="print lv_font_conv subset commands")
+    ap.add_argument("--regen", action="store_true", help="run lv_font_conv subset commands")
+    args = ap.parse_args()
+    if not (args.check or args.commands or args.regen):
+        args.report = True
+
+    sources = sorted({p for pat in UI_SOURCES for p in glob.glob(os.path.join(REPO, pat))})
+    fonts = {os.path.splitext(os.path.basename(p))[0]: p for p in glob.glob(os.path.join(REPO, FONT_GLOB))}
+    literals, chart_fonts = scan_sources(sources, os.path.join(REPO, MANIFEST))
+
+    used = {name: set() for name in fonts}
+    unattributed = [lit for lit in literals if lit.fonts is None]
+    for lit in literals:
+        for name in (lit.fonts or set()) & set(fonts):
+            used[name] |= {ord(g) for g in literal_glyphs(lit.text)}
+    for name in chart_fonts & set(fonts):
+        used[name] |= {ord(g) for g in RUNTIME_GLYPHS}
+    ui_fonts = {name for name in fonts if used[name]}
+
+    failed = False
+    for lit in unattributed:
+        failed = True
+        print("UNATTRIBUTED %s:%d \"%s\": add a rule for its helper to %s" % (lit.path, lit.line, lit.text, MANIFEST))
+    for name in sorted(fonts):
+        present, opts = parse_font(fonts[name])
+        missing = sorted(used[name] - present)
+        if args.report or args.check:
+            state = "unused by UI" if name not in ui_fonts else "%d used / %d shipped" % (len(used[name]), len(present))
+            print("%-16s %s" % (name, state))
+        if missing:
+            failed = True
+            print("  MISSING in %s: %s" % (name, " ".join("U+%04X(%s)" % (c, chr(c)) for c in missing)))
+        if (args.commands or args.regen) and name in ui_fonts:
+            cmd = subset_command(opts, used[name])
+            print(" ".join(shlex.quote(c) for c in cmd))
+            if args.regen:
+                subprocess.run(cmd, cwd=REPO, check=True)
+
+    if args.check and failed:
+        print("font glyph check FAILED: add manifest rules or regenerate fonts with the missing glyphs",
+              file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,6 +1,14 @@
 #include "ui.h"
 #include "fonts.h"
 #include "debug_config.h"
+#include "signal_stats.h"
+#include "card_chrome.h"
+#include "numeric_readout.h"
+#include "glyph_cache.h"
+#include "signal_store.h"
+#include "n2k_subs.h"
+#include "signal_stale.h"
+#include "chart_query.h"
 #include <cstdio>
 
 // ---------- Font selection (no external fonts required) ----------
@@ -28,6 +36,8 @@ static const lv_color_t COL_GRAPH_GRID = lv_color_hex(0x202633);
 // ---- Styles ----
 static lv_style_t st_screen, st_navbar, st_card, st_caption, st_value_big, st_value_medium, st_label;
 static lv_style_t st_chip, st_chip_checked, st_chip_ghost, st_chart_bg;
+static lv_style_t st_card_cached;  // card padding only; chrome comes from card_chrome
+static lv_coord_t g_card_pad = 16;
 
 static lv_coord_t g_screen_w = 0;
 static lv_coord_t g_screen_h = 0;
@@ -51,7 +61,9 @@ static lv_obj_t* lbl_stat_min = nullptr;
 
 // ---- Forward declarations ----
 static void show_rpm_detail(bool show);
+static bool rpm_detail_visible();
 static void set_rpm_resolution(int idx);
+static void update_stat_tiles(signal_stats_t* stats, uint8_t window, uint32_t now_s, const char* unit);
 static lv_obj_t* make_chip_button(lv_obj_t* parent,
                                  const char* text,
                                  lv_event_cb_t cb,
@@ -68,11 +80,77 @@ static lv_obj_t* make_detail_stat_tile(lv_obj_t* parent,
 // ---- Page state (single page) ----
 static int s_current_page = 0; // 0 .. ui_page_count()-1
 
+// ---- Detail-page history (demo data until the bus feed is wired) ----
+static const lv_coord_t data_6h[]  = {1320, 1340, 1360, 1380, 1420, 1460, 1480, 1500, 1470, 1440};
+static const lv_coord_t data_12h[] = {1280, 1300, 1310, 1330, 1345, 1360, 1390, 1420, 1450, 1490, 1520, 1500};
+static const lv_coord_t data_24h[] = {1200, 1220, 1250, 1270, 1300, 1320, 1350, 1365, 1380, 1400, 1420, 1430, 1440, 1460, 1475, 1490};
+
+static signal_stats_t s_rpm_stats;
+static bool s_rpm_stats_ready = false;
+static bool s_rpm_stats_live = false;   // demo history replaced by bus samples
+static uint32_t s_rpm_stats_now_s = 0;
+static uint32_t s_rpm_stats_last_ms = 0;
+static uint8_t s_rpm_resolution = 0;    // 6h/12h/24h chip
+
+// ---- Live bus values: card value views bound to signal_store slots ----
+struct card_binding_t {
+    signal_id_t sig;
+    lv_obj_t*   value;
+    const char* fmt;    // printf format for the float value
+};
+static card_binding_t s_card_bindings[8];
+static uint8_t s_card_binding_count = 0;
+static uint32_t s_signals_pending = 0;  // changed but not yet read (collision)
+
+// Value view: large values blit from a prebuilt glyph atlas, others are labels
+static lv_obj_t* make_value_view(lv_obj_t* card, const char* value, bool tall_value)
+{
+#if UI_NUMERIC_READOUT
+    if (tall_value) {
+        lv_obj_t* readout = numeric_readout_create(card, FONT_LG, COL_WHITE, COL_BG_CARD, value);
+        numeric_readout_set_text(readout, value);
+        return readout;
+    }
+#endif
+    lv_obj_t* lbl_value = lv_label_create(card);
+    lv_obj_add_style(lbl_value, tall_value ? &st_value_big : &st_value_medium, 0);
+    lv_label_set_text(lbl_value, value);
+    lv_label_set_long_mode(lbl_value, LV_LABEL_LONG_CLIP);
+    return lbl_value;
+}
+
 // Utility: make a titled metric card
-static lv_obj_t* make_metric_card(lv_obj_t* parent, const char* title, const char* value, lv_color_t accent, bool tall_value = false)
+static lv_obj_t* make_metric_card(lv_obj_t* parent, const char* title, const char* value, lv_color_t accent,
+                                  bool tall_value = false, lv_obj_t** out_value = nullptr)
 {
     lv_obj_t* card = lv_obj_create(parent);
     lv_obj_remove_style_all(card);
+
+#if UI_CARD_CHROME_CACHE
+    // Static chrome (background, outline, divider, caption) is baked into a
+    // cached image; only the value label is drawn live.
+    lv_obj_add_style(card, &st_card_cached, 0);
+
+    card_chrome_dsc_t chrome = {};
+    chrome.caption        = title;
+    chrome.caption_font   = FONT_SM;
+    chrome.caption_color  = COL_MUTED_TEXT;
+    chrome.caption_x      = g_card_pad + 12;
+    chrome.caption_y      = (g_card_pad - 2) + 8;
+    chrome.bg_color       = COL_BG_CARD;
+    chrome.radius         = 16;
+    chrome.outline_color  = COL_GRAPH_GRID;
+    chrome.outline_opa    = LV_OPA_40;
+    chrome.outline_width  = 1;
+    chrome.accent_color   = accent;
+    chrome.accent_opa     = LV_OPA_80;
+    chrome.divider_height = 3;
+    chrome.divider_bottom = 6;
+    chrome.pad_left       = g_card_pad;
+    chrome.pad_right      = g_card_pad;
+    chrome.pad_bottom     = g_card_pad;
+    card_chrome_attach(card, &chrome);
+#else
     lv_obj_add_style(card, &st_card, 0);
 
     // Title
@@ -82,15 +160,15 @@ static lv_obj_t* make_metric_card(lv_obj_t* parent, const char* title, const cha
     lv_label_set_long_mode(lbl_title, LV_LABEL_LONG_CLIP);
     lv_obj_set_width(lbl_title, LV_PCT(100));
     lv_obj_align(lbl_title, LV_ALIGN_TOP_LEFT, 12, 8);
+#endif
 
     // Value
-    lv_obj_t* lbl_value = lv_label_create(card);
-    lv_obj_add_style(lbl_value, tall_value ? &st_value_big : &st_value_medium, 0);
-    lv_label_set_text(lbl_value, value);
-    lv_label_set_long_mode(lbl_value, LV_LABEL_LONG_CLIP);
+    lv_obj_t* lbl_value = make_value_view(card, value, tall_value);
     lv_obj_set_width(lbl_value, LV_PCT(100));
     lv_obj_align(lbl_value, LV_ALIGN_LEFT_MID, 12, 8);
+    if (out_value) *out_value = lbl_value;
 
+#if !UI_CARD_CHROME_CACHE
     // Accent divider
     lv_obj_t* divider = lv_obj_create(card);
     lv_obj_remove_style_all(divider);
@@ -98,6 +176,7 @@ static lv_obj_t* make_metric_card(lv_obj_t* parent, const char* title, const cha
     lv_obj_set_style_bg_opa(divider, LV_OPA_80, 0);
     lv_obj_set_size(divider, LV_PCT(100), 3);
     lv_obj_align(divider, LV_ALIGN_BOTTOM_MID, 0, -6);
+#endif
 
     return card;
 }
@@ -136,6 +215,13 @@ static void apply_styles()
     lv_style_set_pad_top(&st_card, card_pad - 2);
     lv_style_set_pad_bottom(&st_card, card_pad);
 
+    g_card_pad = card_pad;
+    lv_style_init(&st_card_cached);
+    lv_style_set_pad_left(&st_card_cached, card_pad);
+    lv_style_set_pad_right(&st_card_cached, card_pad);
+    lv_style_set_pad_top(&st_card_cached, card_pad - 2);
+    lv_style_set_pad_bottom(&st_card_cached, card_pad);
+
     lv_style_init(&st_caption);
     lv_style_set_text_color(&st_caption, COL_MUTED_TEXT);
     lv_style_set_text_font(&st_caption, FONT_SM);
@@ -189,6 +275,9 @@ static void apply_styles()
     lv_style_set_outline_color(&st_chart_bg, COL_GRAPH_GRID);
     lv_style_set_outline_opa(&st_chart_bg, LV_OPA_40);
     lv_style_set_outline_width(&st_chart_bg, 1);
+
+    // Cached card chrome bakes in style values; rebuild it after any restyle.
+    card_chrome_invalidate_all();
 }
 
 static void build_navbar(lv_obj_t* parent, lv_coord_t w)
@@ -207,6 +296,86 @@ static void build_navbar(lv_obj_t* parent, lv_coord_t w)
     lv_obj_set_width(lbl_title, LV_PCT(100));
 }
 
+static void bind_card_value(lv_obj_t* value, signal_id_t sig, const char* fmt)
+{
+    if (!value || s_card_binding_count >= sizeof(s_card_bindings) / sizeof(s_card_bindings[0])) return;
+    s_card_bindings[s_card_binding_count++] = {sig, value, fmt};
+}
+
+// Stale values are dimmed.
+static void set_binding_stale(const card_binding_t* b, bool stale)
+{
+    lv_obj_set_style_opa(b->value, stale ? LV_OPA_40 : LV_OPA_COVER, 0);
+}
+
+// Only bindings of signals that changed state are touched. If events were
+// dropped, every binding resyncs from the stale mask.
+static void apply_stale_events(void)
+{
+    static uint32_t s_dropped_seen = 0;
+    signal_stale_event_t ev;
+    while (signal_stale_pop_event(&ev)) {
+        for (uint8_t i = 0; i < s_card_binding_count; ++i) {
+            if (s_card_bindings[i].sig == ev.sig) set_binding_stale(&s_card_bindings[i], ev.stale);
+        }
+    }
+    signal_stale_stats_t st;
+    signal_stale_get_stats(&st);
+    if (st.events_dropped != s_dropped_seen) {
+        s_dropped_seen = st.events_dropped;
+        const uint32_t mask = signal_stale_mask();
+        for (uint8_t i = 0; i < s_card_binding_count; ++i) {
+            set_binding_stale(&s_card_bindings[i], (mask >> s_card_bindings[i].sig) & 1u);
+        }
+    }
+}
+
+// The first live RPM sample drops the demo history. Stats time counts
+// seconds of sample time, accumulated wrap-safe from plat_millis() stamps.
+static void feed_rpm_stats(const signal_sample_t* smp)
+{
+    if (!s_rpm_stats_ready) return;
+    if (!s_rpm_stats_live) {
+        signal_stats_reset(&s_rpm_stats);
+        s_rpm_stats_live = true;
+        s_rpm_stats_now_s = 0;
+        s_rpm_stats_last_ms = smp->t_ms;
+    }
+    const uint32_t dt_ms = smp->t_ms - s_rpm_stats_last_ms;
+    s_rpm_stats_now_s += dt_ms / 1000;
+    s_rpm_stats_last_ms += dt_ms - dt_ms % 1000;
+    const int32_t v = (int32_t)(smp->value + (smp->value < 0 ? -0.5f : 0.5f));
+    signal_stats_push(&s_rpm_stats, s_rpm_stats_now_s, v);
+    if (rpm_detail_visible()) update_stat_tiles(&s_rpm_stats, s_rpm_resolution, s_rpm_stats_now_s, "rpm");
+}
+
+// Runs on the LVGL loop: touch only the cards whose signal was published
+// since the last poll. Seqlock reads never block the bus task.
+static void poll_signals_cb(lv_timer_t* t)
+{
+    LV_UNUSED(t);
+    apply_stale_events();
+    const uint32_t changed = signal_store_take_changed(SIG_CONSUMER_UI) | s_signals_pending;
+    if (!changed) return;
+    s_signals_pending = 0;
+
+    char buf[NUMERIC_READOUT_MAX_CHARS + 1];
+    for (uint8_t i = 0; i < s_card_binding_count; ++i) {
+        const card_binding_t* b = &s_card_bindings[i];
+        const uint32_t bit = 1u << b->sig;
+        if (!(changed & bit)) continue;
+
+        signal_sample_t smp;
+        if (!signal_store_read(b->sig, &smp)) {
+            s_signals_pending |= bit;
+            continue;
+        }
+        std::snprintf(buf, sizeof(buf), b->fmt, (double)smp.value);
+        numeric_readout_set_text(b->value, buf);
+        if (b->sig == SIG_RPM) feed_rpm_stats(&smp);
+    }
+}
+
 static void build_grid(lv_obj_t* parent, lv_coord_t w, lv_coord_t h)
 {
     LV_UNUSED(w);
@@ -235,13 +404,23 @@ static void build_grid(lv_obj_t* parent, lv_coord_t w, lv_coord_t h)
     lv_obj_set_style_pad_column(cont_grid, grid_gap, 0);
     lv_obj_set_style_pad_all(cont_grid, 0, 0);
 
-    lv_obj_t* c_speed = make_metric_card(cont_grid, "SPEED", "7.4 kts", COL_CYAN, true);
-    lv_obj_t* c_rpm   = make_metric_card(cont_grid, "ENGINE RPM", "1350", COL_ORANGE, true);
+    lv_obj_t* v_speed = nullptr;
+    lv_obj_t* v_rpm   = nullptr;
+    lv_obj_t* v_batt  = nullptr;
+    lv_obj_t* v_stw   = nullptr;
+    lv_obj_t* c_speed = make_metric_card(cont_grid, "SPEED", "7.4 kts", COL_CYAN, true, &v_speed);
+    lv_obj_t* c_rpm   = make_metric_card(cont_grid, "ENGINE RPM", "1350", COL_ORANGE, true, &v_rpm);
     card_rpm = c_rpm;
-    lv_obj_t* c_batt  = make_metric_card(cont_grid, "REMAINING POWER", "78%", COL_GREEN, true);
-    lv_obj_t* c_wind  = make_metric_card(cont_grid, "STW", "14.2 kts", COL_CYAN);
+    lv_obj_t* c_batt  = make_metric_card(cont_grid, "REMAINING POWER", "78%", COL_GREEN, true, &v_batt);
+    lv_obj_t* c_wind  = make_metric_card(cont_grid, "STW", "14.2 kts", COL_CYAN, false, &v_stw);
     lv_obj_t* c_ap    = make_metric_card(cont_grid, "AUTOPILOT", "TRACK", COL_ORANGE);
 
+    // Demo text stays until the first bus value arrives.
+    bind_card_value(v_speed, SIG_SOG, "%.1f kts");
+    bind_card_value(v_rpm, SIG_RPM, "%.0f");
+    bind_card_value(v_batt, SIG_SOC, "%.0f%%");
+    bind_card_value(v_stw, SIG_STW, "%.1f kts");
+
     if (portrait) {
         lv_obj_set_grid_cell(c_speed, LV_GRID_ALIGN_STRETCH, 0, 2, LV_GRID_ALIGN_STRETCH, 0, 1);
         lv_obj_set_grid_cell(c_rpm,   LV_GRID_ALIGN_STRETCH, 0, 1, LV_GRID_ALIGN_STRETCH, 1, 1);
@@ -287,10 +466,39 @@ static void build_grid(lv_obj_t* parent, lv_coord_t w, lv_coord_t h)
     }, LV_EVENT_RELEASED, nullptr);
 }
 
+// RPM detail windows for the 6h/12h/24h chips.
+static const uint32_t k_rpm_window_s[3] = {6 * 3600, 12 * 3600, 24 * 3600};
+static bool s_rpm_chart_live = false;   // the chart shows queried data, not the demo series
+
+// Ask the chart query worker for the selected window; results arrive in
+// poll_chart_cb() and replace the chart as they refine.
+static void request_rpm_chart()
+{
+    chart_query_request(SIG_RPM, k_rpm_window_s[s_rpm_resolution], UI_CHART_COLUMNS);
+}
+
+static bool rpm_detail_visible()
+{
+    return cont_rpm_detail && !lv_obj_has_flag(cont_rpm_detail, LV_OBJ_FLAG_HIDDEN);
+}
+
+// PGN filters follow the visible page: the bound cards on the grid, only RPM
+// on the detail page. RPM stays subscribed on the grid for the stat tiles.
+static uint32_t page_signals(bool detail)
+{
+    uint32_t mask = 1u << SIG_RPM;
+    if (detail) return mask;
+    for (uint8_t i = 0; i < s_card_binding_count; ++i) mask |= 1u << s_card_bindings[i].sig;
+    return mask;
+}
+
 static void show_rpm_detail(bool show)
 {
     if (!cont_rpm_detail) return;
+    n2k_subs_set_signals(N2K_SUB_PAGE, page_signals(show));
     if (show) {
+        request_rpm_chart();
+        update_stat_tiles(s_rpm_stats_ready ? &s_rpm_stats : nullptr, s_rpm_resolution, s_rpm_stats_now_s, "rpm");
         lv_obj_clear_flag(cont_rpm_detail, LV_OBJ_FLAG_HIDDEN);
         lv_obj_set_style_opa(cont_rpm_detail, LV_OPA_COVER, 0);
         lv_obj_move_foreground(cont_rpm_detail);
@@ -299,6 +507,47 @@ static void show_rpm_detail(bool show)
     }
 }
 
+static void set_stat_tile(lv_obj_t* lbl, int32_t value, const char* unit)
+{
+    if (!lbl) return;
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "%d %s", (int)value, unit);
+    lv_label_set_text(lbl, buf);
+}
+
+// Stat tiles read O(1) window aggregates from the shared stats engine instead
+// of rescanning history on every update.
+static void update_stat_tiles(signal_stats_t* stats, uint8_t window, uint32_t now_s, const char* unit)
+{
+    signal_stats_result_t r;
+    if (!stats || !signal_stats_get(stats, window, now_s, &r)) return;
+
+    set_stat_tile(lbl_stat_current, r.current, unit);
+    set_stat_tile(lbl_stat_avg, r.avg, unit);
+    set_stat_tile(lbl_stat_max, r.max, unit);
+    set_stat_tile(lbl_stat_min, r.min, unit);
+}
+
+// Feed the demo 24h series into the stats engine at one sample per minute;
+// shown until feed_rpm_stats() gets the first bus sample.
+static void seed_rpm_demo_history()
+{
+    if (!signal_stats_init(&s_rpm_stats)) return;
+    s_rpm_stats_ready = true;
+
+    const uint32_t span_s = signal_stats_window_seconds(STATS_WIN_24H);
+    const uint16_t cnt = sizeof(data_24h) / sizeof(data_24h[0]);
+    for (uint32_t t = 0; t < span_s; t += 60) {
+        const uint32_t pos = (uint32_t)(((uint64_t)t * (cnt - 1) * 256) / span_s);
+        const uint16_t i = (uint16_t)(pos >> 8);
+        const int32_t a = data_24h[i];
+        const int32_t b = data_24h[(i + 1 < cnt) ? i + 1 : i];
+        signal_stats_push(&s_rpm_stats, t, a + ((b - a) * (int32_t)(pos & 0xFF)) / 256);
+    }
+    signal_stats_push(&s_rpm_stats, span_s, data_24h[cnt - 1]);
+    s_rpm_stats_now_s = span_s;
+}
+
 static void set_rpm_resolution(int idx)
 {
     for (int i = 0; i < 3; ++i) {
@@ -309,10 +558,6 @@ static void set_rpm_resolution(int idx)
         }
     }
 
-    static const lv_coord_t data_6h[]  = {1320, 1340, 1360, 1380, 1420, 1460, 1480, 1500, 1470, 1440};
-    static const lv_coord_t data_12h[] = {1280, 1300, 1310, 1330, 1345, 1360, 1390, 1420, 1450, 1490, 1520, 1500};
-    static const lv_coord_t data_24h[] = {1200, 1220, 1250, 1270, 1300, 1320, 1350, 1365, 1380, 1400, 1420, 1430, 1440, 1460, 1475, 1490};
-
     const lv_coord_t* data = data_6h;
     uint16_t cnt = sizeof(data_6h) / sizeof(data_6h[0]);
     const char* time_scale = "Time (6h)";
@@ -331,43 +576,52 @@ static void set_rpm_resolution(int idx)
         break;
     }
 
-    lv_chart_set_point_count(chart_rpm, cnt);
-
-    int sum = 0;
-    lv_coord_t min_v = data[0];
-    lv_coord_t max_v = data[0];
-    for (uint16_t i = 0; i < cnt; ++i) {
-        lv_chart_set_value_by_id(chart_rpm, chart_series_rpm, i, data[i]);
-        sum += data[i];
-        if (data[i] < min_v) min_v = data[i];
-        if (data[i] > max_v) max_v = data[i];
+    // Demo series until the query worker delivers logged data.
+    if (!s_rpm_chart_live) {
+        lv_chart_set_point_count(chart_rpm, cnt);
+        for (uint16_t i = 0; i < cnt; ++i) {
+            lv_chart_set_value_by_id(chart_rpm, chart_series_rpm, i, data[i]);
+        }
+        lv_chart_refresh(chart_rpm);
     }
-    lv_chart_refresh(chart_rpm);
 
     if (lbl_axis_x) {
         lv_label_set_text(lbl_axis_x, time_scale);
     }
 
-    const lv_coord_t current_v = data[cnt - 1];
-    const lv_coord_t avg_v = (lv_coord_t)(sum / (int)cnt);
-    char buf[24];
+    update_stat_tiles(s_rpm_stats_ready ? &s_rpm_stats : nullptr, (uint8_t)idx, s_rpm_stats_now_s, "rpm");
 
-    if (lbl_stat_current) {
-        std::snprintf(buf, sizeof(buf), "%d rpm", (int)current_v);
-        lv_label_set_text(lbl_stat_current, buf);
-    }
-    if (lbl_stat_avg) {
-        std::snprintf(buf, sizeof(buf), "%d rpm", (int)avg_v);
-        lv_label_set_text(lbl_stat_avg, buf);
-    }
-    if (lbl_stat_max) {
-        std::snprintf(buf, sizeof(buf), "%d rpm", (int)max_v);
-        lv_label_set_text(lbl_stat_max, buf);
-    }
-    if (lbl_stat_min) {
-        std::snprintf(buf, sizeof(buf), "%d rpm", (int)min_v);
-        lv_label_set_text(lbl_stat_min, buf);
+    s_rpm_resolution = (uint8_t)idx;
+    if (rpm_detail_visible()) request_rpm_chart();
+}
+
+// Runs on the LVGL loop: draws each progressive result (RAM first, then
+// coarse-to-fine SD tiers) as it arrives. One point per column at the
+// column's last value, with the Y range fitted to the column envelopes.
+static void poll_chart_cb(lv_timer_t* t)
+{
+    LV_UNUSED(t);
+    const chart_query_result_t* r = chart_query_poll();
+    if (!r || !r->filled || !chart_rpm || r->sig != SIG_RPM) return;
+
+    float lo = 0, hi = 0;
+    bool any = false;
+    lv_chart_set_point_count(chart_rpm, r->columns);
+    for (uint16_t c = 0; c < r->columns; ++c) {
+        const history_bucket_t& b = r->col[c];
+        if (!b.count) {
+            lv_chart_set_value_by_id(chart_rpm, chart_series_rpm, c, LV_CHART_POINT_NONE);
+            continue;
+        }
+        if (!any || b.min < lo) lo = b.min;
+        if (!any || b.max > hi) hi = b.max;
+        any = true;
+        lv_chart_set_value_by_id(chart_rpm, chart_series_rpm, c, (lv_coord_t)(b.last + 0.5f));
     }
+    const lv_coord_t pad = (lv_coord_t)((hi - lo) * 0.05f) + 10;
+    lv_chart_set_range(chart_rpm, LV_CHART_AXIS_PRIMARY_Y, (lv_coord_t)lo - pad, (lv_coord_t)hi + pad);
+    lv_chart_refresh(chart_rpm);
+    s_rpm_chart_live = true;
 }
 
 static lv_obj_t* make_chip_button(lv_obj_t* parent,
@@ -572,9 +826,33 @@ static void build_rpm_detail(lv_obj_t* parent, lv_coord_t w, lv_coord_t h)
     lv_obj_align(lbl_axis_x, LV_ALIGN_BOTTOM_RIGHT, -4, -4);
 
     chart_series_rpm = lv_chart_add_series(chart_rpm, COL_GREEN, LV_CHART_AXIS_PRIMARY_Y);
+    seed_rpm_demo_history();
     set_rpm_resolution(0);
 }
 
+// Route all UI fonts through the decompressed glyph cache.
+static void wrap_fonts_with_glyph_cache()
+{
+#if UI_GLYPH_CACHE
+#if GLYPH_CACHE_BENCH
+    // Strings actually shown by the dashboard, to measure decompression cost.
+  
+    static const char* const bench_strings[] = {
+        "Marine Overview", "SPEED", "7.4 kts", "ENGINE RPM", "1350", "REMAINING POWER", "78%",
+        "STW", "14.2 kts", "AUTOPILOT", "TRACK", "NO ALARMS", "RPM Monitor", "CURRENT",
+        "AVERAGE", "MAXIMUM", "MINIMUM", "1350 rpm", "1362 rpm", "RPM OVER TIME (6h)", "Time (24h)",
+    };
+    const uint16_t n = sizeof(bench_strings) / sizeof(bench_strings[0]);
+    glyph_cache_benchmark(FONT_SM, bench_strings, n, 20);
+    glyph_cache_benchmark(FONT_MD, bench_strings, n, 20);
+    glyph_cache_benchmark(FONT_LG, bench_strings, n, 20);
+#endif
+    FONT_SM = glyph_cache_wrap(FONT_SM);
+    FONT_MD = glyph_cache_wrap(FONT_MD);
+    FONT_LG = glyph_cache_wrap(FONT_LG);
+#endif
+}
+
 void ui_init(void)
 {
     if (ui_root) return;
@@ -585,6 +863,7 @@ void ui_init(void)
 
     g_screen_w = w;
     g_screen_h = h;
+    wrap_fonts_with_glyph_cache();
     apply_styles();
 
     ui_root = lv_obj_create(lv_scr_act());
@@ -599,6 +878,11 @@ void ui_init(void)
     build_navbar(ui_root, w);
     build_grid(ui_root, w, h);
     build_rpm_detail(ui_root, w, h);
+
+    n2k_subs_set_signals(N2K_SUB_PAGE, page_signals(false));
+
+    lv_timer_create(poll_signals_cb, UI_SIGNAL_POLL_MS, nullptr);
+    lv_timer_create(poll_chart_cb, UI_CHART_POLL_MS, nullptr);
 }
 
 /* ------- Compatibility shims ------- */